@@ -30,8 +30,12 @@ extern int munmap(void *addr, size_t length);
 
 #else
 
+#include <stddef.h>
 #include <sys/mman.h>
 
 #endif /* __WIN32__ */
 
+/** Number of bytes of the range which are resident in the host memory */
+extern size_t mmap_resident(const void *addr, size_t length);
+
 #endif
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ */
+
+#include "../mmap.h"
+
+#ifndef __WIN32__
+
+#include <stdint.h>
+#include <unistd.h>
+
+/** Number of pages queried by a single mincore() call */
+#define RESIDENT_CHUNK 1024
+
+#ifdef __APPLE__
+typedef char mincore_vec_t;
+#else
+typedef unsigned char mincore_vec_t;
+#endif
+
+size_t mmap_resident(const void *addr, size_t length)
+{
+    if (length == 0) {
+        return 0;
+    }
+
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    uintptr_t start = ((uintptr_t) addr) & ~((uintptr_t) page_size - 1);
+    uintptr_t end = (uintptr_t) addr + length;
+    size_t pages = (end - start + page_size - 1) / page_size;
+    size_t resident = 0;
+
+    mincore_vec_t vec[RESIDENT_CHUNK];
+
+    while (pages > 0) {
+        size_t count = (pages < RESIDENT_CHUNK) ? pages : RESIDENT_CHUNK;
+
+        if (mincore((void *) start, count * page_size, vec) != 0) {
+            /* Not a mapped range, consider it resident */
+            return length;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            if (vec[i] & 1) {
+                resident += page_size;
+            }
+        }
+
+        start += count * page_size;
+        pages -= count;
+    }
+
+    /* The partial pages at both ends are counted as whole */
+    return (resident < length) ? resident : length;
+}
+
+#endif /* __WIN32__ */
@@ -56,8 +56,19 @@ void *mmap(void *addr, size_t length, int prot, int flags, int fd,
         }
     }
 
+    /* Private writable mappings are copy-on-write */
+    if (((flags & MAP_PRIVATE) == MAP_PRIVATE)
+            && ((prot & PROT_WRITE) == PROT_WRITE)) {
+        protect = ((prot & PROT_EXEC) == PROT_EXEC)
+                ? PAGE_EXECUTE_WRITECOPY : PAGE_WRITECOPY;
+        access = FILE_MAP_COPY;
+    }
+
+    /* The mapping object covers the file up to the end of the view */
+    uint64_t end = ((uint64_t) offset) + length;
+
     HANDLE handle = CreateFileMapping(fh, NULL, protect,
-            ((uint64_t) length) >> 32, length & UINT32_C(0xffffffff), NULL);
+            end >> 32, end & UINT32_C(0xffffffff), NULL);
     if (handle == NULL) {
         errno = EPERM;
         return MAP_FAILED;
@@ -83,4 +94,10 @@ int munmap(void *addr, size_t length)
     return 0;
 }
 
+size_t mmap_resident(const void *addr, size_t length)
+{
+    /* Residency is not queried, all memory is considered resident */
+    return length;
+}
+
 #endif /* __WIN32__ */
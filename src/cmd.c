@@ -23,13 +23,22 @@
 #include "cmd.h"
 #include "debug/breakpoint.h"
 #include "debug/debug.h"
+#include "debug/inject.h"
+#include "debug/memusage.h"
+#include "debug/profile.h"
+#include "debug/sample.h"
+#include "debug/statehash.h"
+#include "debug/symtab.h"
+#include "device/cpu/general_cpu.h"
 #include "device/cpu/mips_r4000/cpu.h"
 #include "device/cpu/mips_r4000/debug.h"
 #include "device/cpu/riscv_rv32ima/cpu.h"
 #include "device/cpu/riscv_rv32ima/debug.h"
 #include "device/device.h"
+#include "elf.h"
 #include "env.h"
 #include "fault.h"
+#include "machine.h"
 #include "main.h"
 #include "utils.h"
 
@@ -162,7 +171,7 @@ static bool system_dumpins(token_t *parm, void *data)
     ASSERT(parm != NULL);
 
     char *_cpu = parm_str_next(&parm);
-    uint64_t _addr = ALIGN_DOWN(parm_uint_next(&parm), 4);
+    uint64_t _addr = parm_uint_next(&parm);
     uint64_t _cnt = parm_uint(parm);
 
     bool is_rv = strcmp(_cpu, "rv") == 0;
@@ -172,6 +181,9 @@ static bool system_dumpins(token_t *parm, void *data)
         return false;
     }
 
+    /* RISC-V instructions are 2-byte aligned (C extension) */
+    _addr = ALIGN_DOWN(_addr, is_rv ? 2 : 4);
+
     if (!phys_range(_addr)) {
         error("Physical address out of range");
         return false;
@@ -190,17 +202,26 @@ static bool system_dumpins(token_t *parm, void *data)
     ptr36_t addr;
     len36_t cnt;
 
-    for (addr = (ptr36_t) _addr, cnt = (len36_t) _cnt; cnt > 0;
-            addr += 4, cnt--) {
+    for (addr = (ptr36_t) _addr, cnt = (len36_t) _cnt; cnt > 0; cnt--) {
+
+        const char *label = symtab_label_phys(addr);
+        if (label != NULL) {
+            printf("%s:\n", label);
+        }
 
         if (is_r4k) {
             r4k_instr_t instr;
             instr.val = physmem_read32(-1, addr, false);
             r4k_idump_phys(addr, instr);
+            addr += 4;
         } else if (is_rv) {
             rv_instr_t instr;
-            instr.val = physmem_read32(-1, addr, false);
+            instr.val = physmem_read16(-1, addr, false);
+            if (!RV_INSTR_IS_COMPRESSED(instr.val)) {
+                instr.val |= (uint32_t) physmem_read16(-1, addr + 2, false) << 16;
+            }
             rv_idump_phys(addr, instr);
+            addr += RV_INSTR_LENGTH(instr.val);
         }
     }
 
@@ -240,9 +261,15 @@ static bool system_break(token_t *parm, void *data)
 {
     ASSERT(parm != NULL);
 
-    uint64_t addr = parm_uint_next(&parm);
+    uint64_t addr;
+
+    if (!symtab_parm_addr(parm, true, &addr)) {
+        return false;
+    }
+
+    parm_next(&parm);
     uint64_t size = parm_uint_next(&parm);
-    const char *rw = parm_str(parm);
+    const char *rw = parm_str_next(&parm);
 
     if (!phys_range(addr)) {
         error("Physical address out of range");
@@ -274,8 +301,17 @@ static bool system_break(token_t *parm, void *data)
         return false;
     }
 
-    physmem_breakpoint_add((ptr36_t) addr, (len36_t) size,
-            BREAKPOINT_KIND_SIMULATOR, access_flags);
+    breakpoint_action_t action;
+    bpcond_t cond;
+
+    if (!breakpoint_parse_condition(parm, &action, &cond, NULL)) {
+        return false;
+    }
+
+    physmem_breakpoint_t *breakpoint = physmem_breakpoint_add((ptr36_t) addr,
+            (len36_t) size, BREAKPOINT_KIND_SIMULATOR, access_flags);
+    breakpoint->action = action;
+    breakpoint->cond = cond;
 
     return true;
 }
@@ -297,7 +333,11 @@ static bool system_rembreak(token_t *parm, void *data)
 {
     ASSERT(parm != NULL);
 
-    uint64_t addr = parm_uint(parm);
+    uint64_t addr;
+
+    if (!symtab_parm_addr(parm, true, &addr)) {
+        return false;
+    }
 
     if (!phys_range(addr)) {
         error("Physical address out of range");
@@ -324,6 +364,281 @@ static bool system_stat(token_t *parm, void *data)
     return true;
 }
 
+/** Profile command implementation
+ *
+ * Print the most frequently executed instructions.
+ *
+ */
+static bool system_profile(token_t *parm, void *data)
+{
+    ASSERT(parm != NULL);
+
+    switch (parm_type(parm)) {
+    case tt_end:
+        profile_print(PROFILE_DEFAULT_COUNT);
+        break;
+    case tt_uint:
+        profile_print(parm_uint(parm));
+        break;
+    default:
+        intr_error("Unexpected parameter type");
+        return false;
+    }
+
+    return true;
+}
+
+/** Fastfwd command implementation
+ *
+ * Fast-forward the simulation until a trigger.
+ *
+ */
+static bool system_fastfwd(token_t *parm, void *data)
+{
+    ASSERT(parm != NULL);
+
+    const char *trigger = parm_str_next(&parm);
+    bool has_value = (parm_type(parm) == tt_uint);
+    uint64_t value = has_value ? parm_uint(parm) : 0;
+
+    if (strcmp(trigger, "off") == 0) {
+        sample_fast_forward(SAMPLE_TRIGGER_NONE, 0);
+        return true;
+    }
+
+    if (strcmp(trigger, "roi") == 0) {
+        sample_fast_forward(SAMPLE_TRIGGER_ROI, 0);
+        return true;
+    }
+
+    if ((strcmp(trigger, "cycle") != 0) && (strcmp(trigger, "pc") != 0)) {
+        error("Unknown trigger (cycle, pc, roi or off expected)");
+        return false;
+    }
+
+    if (!has_value) {
+        error("Trigger value expected");
+        return false;
+    }
+
+    if (trigger[0] == 'c') {
+        sample_fast_forward(SAMPLE_TRIGGER_CYCLE, value);
+    } else {
+        sample_fast_forward(SAMPLE_TRIGGER_PC, value);
+    }
+
+    return true;
+}
+
+/** Sample command implementation
+ *
+ * Configure periodic detailed windows of the sampled simulation.
+ *
+ */
+static bool system_sample(token_t *parm, void *data)
+{
+    ASSERT(parm != NULL);
+
+    uint64_t detail = parm_uint_next(&parm);
+    uint64_t period = parm_uint(parm);
+
+    if ((detail > 0) && (period <= detail)) {
+        error("Sampling period must be longer than the detailed window");
+        return false;
+    }
+
+    sample_set_windows(detail, period);
+    return true;
+}
+
+/** Memusage command implementation
+ *
+ * Print the host memory used by the simulator components.
+ *
+ */
+static bool system_memusage(token_t *parm, void *data)
+{
+    ASSERT(parm != NULL);
+
+    if (parm_type(parm) == tt_end) {
+        memusage_print(stdout, false);
+        return true;
+    }
+
+    if (strcmp(parm_str_next(&parm), "json") != 0) {
+        error("Unknown format (only json is supported)");
+        return false;
+    }
+
+    if (parm_type(parm) == tt_end) {
+        memusage_print(stdout, true);
+        return true;
+    }
+
+    return memusage_write(parm_str(parm));
+}
+
+/** Statehash command implementation
+ *
+ * Start or stop periodic state hashing.
+ *
+ */
+static bool system_statehash(token_t *parm, void *data)
+{
+    ASSERT(parm != NULL);
+
+    uint64_t interval = parm_uint_next(&parm);
+
+    if (interval == 0) {
+        statehash_stop();
+        return true;
+    }
+
+    if (parm_type(parm) != tt_str) {
+        error("Log file name expected");
+        return false;
+    }
+
+    return statehash_start(parm_str(parm), interval);
+}
+
+/** Statecmp command implementation
+ *
+ * Compare two state hash logs.
+ *
+ */
+static bool system_statecmp(token_t *parm, void *data)
+{
+    ASSERT(parm != NULL);
+
+    const char *filename1 = parm_str_next(&parm);
+    const char *filename2 = parm_str(parm);
+
+    return statehash_compare(filename1, filename2);
+}
+
+/** Inject command implementation
+ *
+ * Load a fault injection schedule or print the injection state.
+ *
+ */
+static bool system_inject(token_t *parm, void *data)
+{
+    ASSERT(parm != NULL);
+
+    if (parm_type(parm) == tt_end) {
+        inject_print();
+        return true;
+    }
+
+    const char *schedule = parm_str_next(&parm);
+
+    if (strcmp(schedule, "off") == 0) {
+        inject_stop();
+        return true;
+    }
+
+    const char *log = (parm_type(parm) == tt_str) ? parm_str(parm) : NULL;
+
+    return inject_start(schedule, log);
+}
+
+/** Find the processor of a processor device */
+static general_cpu_t *system_cpu_by_name(const char *name)
+{
+    device_t *dev = dev_by_name(name);
+
+    if (dev != NULL) {
+        for (unsigned int i = 0; i < MAX_CPUS; i++) {
+            general_cpu_t *cpu = get_cpu(i);
+
+            if ((cpu != NULL) && (cpu == dev->data)) {
+                return cpu;
+            }
+        }
+    }
+
+    error("Unknown processor \"%s\"", name);
+    return NULL;
+}
+
+/** Import the symbols and the address regions of a loaded ELF file */
+static bool system_elf_symbols(elf_t *elf)
+{
+    elf_symbol_t *symbols;
+    size_t count;
+
+    if (!elf_read_symbols(elf, &symbols, &count)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        symtab_add(elf_virt(elf, symbols[i].value), symbols[i].size,
+                symbols[i].name);
+    }
+
+    elf_free_symbols(symbols, count);
+
+    for (unsigned int i = 0; i < elf->segment_count; i++) {
+        elf_segment_t *segment = &elf->segments[i];
+
+        if ((segment->type == ELF_SEGMENT_LOAD) && (segment->memsz > 0)) {
+            symtab_add_region(elf_segment_phys(elf, segment),
+                    elf_virt(elf, segment->vaddr), segment->memsz);
+        }
+    }
+
+    return true;
+}
+
+/** ELF command implementation
+ *
+ * Load an ELF executable into the physical memory areas.
+ *
+ */
+static bool system_elf(token_t *parm, void *data)
+{
+    ASSERT(parm != NULL);
+
+    const char *action = parm_str_next(&parm);
+    if (strcmp(action, "load") != 0) {
+        error("Unknown action (supported actions: load)");
+        return false;
+    }
+
+    const char *path = parm_str_next(&parm);
+    general_cpu_t *cpu = NULL;
+
+    if (parm_type(parm) != tt_end) {
+        cpu = system_cpu_by_name(parm_str(parm));
+        if (cpu == NULL) {
+            return false;
+        }
+    }
+
+    elf_t elf;
+    if (!elf_open(&elf, path)) {
+        return false;
+    }
+
+    if ((elf.machine != ELF_MACHINE_MIPS) && (elf.machine != ELF_MACHINE_RISCV)) {
+        error("Unsupported machine type %u (%s)", elf.machine, path);
+        elf_close(&elf);
+        return false;
+    }
+
+    bool ok = (elf_load_segments(&elf)) && (system_elf_symbols(&elf));
+
+    if ((ok) && (cpu != NULL)) {
+        ptr64_t entry;
+        entry.ptr = elf_virt(&elf, elf.entry);
+        cpu_set_pc(cpu, entry);
+    }
+
+    elf_close(&elf);
+    return ok;
+}
+
 /** Dump memory command implementation
  *
  * Dump physical memory.
@@ -484,6 +799,8 @@ static bool setup_apply(const char *buf)
     size_t lineno = 1;
 
     while ((*buf) && (!machine_halt)) {
+        const char *line = buf;
+
         set_lineno(lineno);
         if (!interpret(buf)) {
             return false;
@@ -498,6 +815,8 @@ static bool setup_apply(const char *buf)
             buf++;
         }
 
+        machine_record(line, buf - line);
+
         lineno++;
     }
 
@@ -542,9 +861,15 @@ void script(void)
 
     string_t str;
     string_init(&str);
-    string_fread(&str, file);
 
-    safe_fclose(file, config_file);
+    bool compiled = machine_is_compiled(file);
+    if (compiled) {
+        if (!machine_read_script(file, config_file, &str)) {
+            die(ERR_INIT, "Error in compiled machine");
+        }
+    } else {
+        string_fread(&str, file);
+    }
 
     if (!setup_apply(str.str)) {
         die(ERR_INIT, "Error in configuration file");
@@ -552,6 +877,12 @@ void script(void)
 
     unset_script();
     string_done(&str);
+
+    if ((compiled) && (!machine_map_memory(file, config_file))) {
+        die(ERR_INIT, "Error in compiled machine");
+    }
+
+    safe_fclose(file, config_file);
 }
 
 /** Generate a list of device types
@@ -852,6 +1183,18 @@ static cmd_t system_cmds_array[] = {
             "Add a new device into the system",
             REQ STR "type/Device type" NEXT
                     REQ STR "name/Device name" CONT },
+    { "elf",
+            system_elf,
+            DEFAULT,
+            DEFAULT,
+            "Load an ELF executable",
+            "Load the loadable segments of an ELF executable into the "
+            "physical memory areas (which must already exist), import "
+            "its symbol table and optionally set the program counter "
+            "of the given processor to the entry point.",
+            REQ STR "action/load" NEXT
+                    REQ STR "file/ELF file name" NEXT
+                            OPT STR "cpu/processor name" END },
     { "dumpmem",
             system_dumpmem,
             DEFAULT,
@@ -888,10 +1231,14 @@ static cmd_t system_cmds_array[] = {
             DEFAULT,
             DEFAULT,
             "Add a new physical memory breakpoint",
-            "Add a new physical memory breakpoint",
-            REQ INT "addr/memory address" NEXT
+            "Add a new physical memory breakpoint at an address "
+            "or a symbol. The optional action (stop, log or count) "
+            "is taken when the optional condition holds.",
+            REQ VAR "addr/memory address or symbol" NEXT
                     REQ INT "cnt/count" NEXT
-                            REQ STR "type/Read or write breakpoint" END },
+                            REQ STR "type/Read or write breakpoint" NEXT
+                                    OPT STR "action/stop, log or count" NEXT
+                                            OPT STR "cond/condition" END },
     { "dumpbreak",
             system_dumpbreak,
             DEFAULT,
@@ -905,7 +1252,7 @@ static cmd_t system_cmds_array[] = {
             DEFAULT,
             "Remove a physical memory breakpoint",
             "Remove a physical memory breakpoint",
-            REQ INT "addr/memory address" END },
+            REQ VAR "addr/memory address or symbol" END },
     { "stat",
             system_stat,
             DEFAULT,
@@ -913,6 +1260,80 @@ static cmd_t system_cmds_array[] = {
             "Print system statistics",
             "Print system statistics",
             NOCMD },
+    { "profile",
+            system_profile,
+            DEFAULT,
+            DEFAULT,
+            "Print the most frequently executed instructions",
+            "Print the most frequently executed instructions",
+            OPT INT "cnt/number of instructions" END },
+    { "fastfwd",
+            system_fastfwd,
+            DEFAULT,
+            DEFAULT,
+            "Fast-forward the simulation until a trigger",
+            "Run without tracing, profiling and statistics until the given "
+            "machine cycle (cycle), instruction address (pc) or the "
+            "beginning of the region of interest (roi) is reached. "
+            "Use off to cancel the fast-forward.",
+            REQ STR "trigger/cycle, pc, roi or off" NEXT
+                    OPT INT "value/cycle or address" END },
+    { "sample",
+            system_sample,
+            DEFAULT,
+            DEFAULT,
+            "Configure sampling windows",
+            "After the fast-forward trigger, simulate in the detailed mode "
+            "only for detail cycles every period cycles. Zero detail "
+            "disables the sampling windows.",
+            REQ INT "detail/detailed window length" NEXT
+                    REQ INT "period/sampling period" END },
+    { "memusage",
+            system_memusage,
+            DEFAULT,
+            DEFAULT,
+            "Print the host memory used by the simulator",
+            "Print the host memory used by the devices and by the "
+            "simulator components (guest RAM, frame tables, decoded "
+            "instruction caches, TLBs, breakpoints, trace buffers and "
+            "device images). Both the allocated and the resident size "
+            "is shown. With json the output is in JSON, optionally "
+            "written to the given file.",
+            OPT STR "format/json" NEXT
+                    OPT STR "file/output file name" END },
+    { "statehash",
+            system_statehash,
+            DEFAULT,
+            DEFAULT,
+            "Log state hashes periodically",
+            "Every interval cycles write a hash of the architectural state "
+            "of all processors and of the memory frames written during "
+            "the interval to the log file. Zero interval stops the logging.",
+            REQ INT "interval/number of cycles" NEXT
+                    OPT STR "file/log file name" END },
+    { "statecmp",
+            system_statecmp,
+            DEFAULT,
+            DEFAULT,
+            "Compare two state hash logs",
+            "Print the first interval where two logs written by statehash "
+            "differ together with the diverging processor and register "
+            "or memory frame.",
+            REQ STR "file1/first log file name" NEXT
+                    REQ STR "file2/second log file name" END },
+    { "inject",
+            system_inject,
+            DEFAULT,
+            DEFAULT,
+            "Inject faults according to a schedule",
+            "Load a fault injection schedule (memory and register bit "
+            "flips, spurious interrupts, disk errors and dropped TLB "
+            "entries triggered at cycles, addresses or randomly). "
+            "Every injection is written to the log file (or printed) "
+            "in the schedule format. Use off to cancel the injection, "
+            "without parameters the state is printed.",
+            OPT STR "file/schedule file name or off" NEXT
+                    OPT STR "log/log file name" END },
     { "echo",
             system_echo,
             DEFAULT,
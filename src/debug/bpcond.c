@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Breakpoint conditions
+ *
+ * A condition is a conjunction of comparisons written by the user, e.g.
+ *
+ *   a0 == 5 && hits >= 100 && priv == 0
+ *
+ * The left side of a comparison is a general purpose register (by the
+ * name of the processor or as rN, xN or $N), pc, priv, asid, hits or
+ * a word of physical memory (mem8[addr], mem16[addr], mem32[addr] or
+ * mem64[addr]). The right side is a number. Supported comparisons are
+ * ==, !=, <, <=, >, >= and & (any of the bits set). All values are
+ * compared as unsigned 64-bit integers.
+ *
+ * The text is compiled when the breakpoint is set, the hit site only
+ * walks the array of terms without any parsing.
+ *
+ */
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../device/cpu/general_cpu.h"
+#include "../fault.h"
+#include "../main.h"
+#include "../physmem.h"
+#include "../utils.h"
+#include "bpcond.h"
+
+/** Longest identifier in a condition */
+#define BPCOND_IDENT_LEN 16
+
+static const char *const op_names[] = {
+    [BPCOND_EQ] = "==",
+    [BPCOND_NE] = "!=",
+    [BPCOND_LT] = "<",
+    [BPCOND_LE] = "<=",
+    [BPCOND_GT] = ">",
+    [BPCOND_GE] = ">=",
+    [BPCOND_AND] = "&"
+};
+
+#define OP_COUNT (sizeof(op_names) / sizeof(op_names[0]))
+
+static const char *skip_spaces(const char *str)
+{
+    while (isspace((unsigned char) *str)) {
+        str++;
+    }
+
+    return str;
+}
+
+/** Parse a number (with an optional minus sign)
+ *
+ * @return Pointer after the number or NULL on error.
+ *
+ */
+static const char *parse_number(const char *str, uint64_t *value)
+{
+    bool negative = false;
+
+    str = skip_spaces(str);
+    if (*str == '-') {
+        negative = true;
+        str++;
+    }
+
+    if (!isdigit((unsigned char) *str)) {
+        return NULL;
+    }
+
+    char *end;
+    uint64_t number = strtoull(str, &end, 0);
+
+    *value = negative ? -number : number;
+    return end;
+}
+
+/** Parse the register name
+ *
+ * @return Register number or -1 if the name is not known.
+ *
+ */
+static int parse_register(const char *name, char *const *regnames)
+{
+    if (((name[0] == 'r') || (name[0] == 'x') || (name[0] == '$'))
+            && (isdigit((unsigned char) name[1]))) {
+        char *end;
+        unsigned long reg = strtoul(name + 1, &end, 10);
+
+        if ((*end == '\0') && (reg < CPU_STATE_REGS)) {
+            return (int) reg;
+        }
+
+        return -1;
+    }
+
+    if (regnames != NULL) {
+        for (int reg = 0; reg < CPU_STATE_REGS; reg++) {
+            if (strcmp(name, regnames[reg]) == 0) {
+                return reg;
+            }
+        }
+    }
+
+    return -1;
+}
+
+/** Parse the left side of a comparison
+ *
+ * @return Pointer after the operand or NULL on error.
+ *
+ */
+static const char *parse_operand(const char *str, bpcond_term_t *term,
+        char *const *regnames)
+{
+    char name[BPCOND_IDENT_LEN + 1];
+    size_t len = 0;
+
+    str = skip_spaces(str);
+    while ((isalnum((unsigned char) *str)) || (*str == '_') || (*str == '$')) {
+        if (len == BPCOND_IDENT_LEN) {
+            error("Operand name too long");
+            return NULL;
+        }
+
+        name[len++] = *str++;
+    }
+    name[len] = '\0';
+
+    if (len == 0) {
+        error("Operand expected");
+        return NULL;
+    }
+
+    term->index = 0;
+    term->addr = 0;
+
+    if (strcmp(name, "pc") == 0) {
+        term->operand = BPCOND_PC;
+    } else if (strcmp(name, "priv") == 0) {
+        term->operand = BPCOND_PRIV;
+    } else if (strcmp(name, "asid") == 0) {
+        term->operand = BPCOND_ASID;
+    } else if (strcmp(name, "hits") == 0) {
+        term->operand = BPCOND_HITS;
+    } else if (strncmp(name, "mem", 3) == 0) {
+        unsigned int width = atoi(name + 3);
+        if ((width != 8) && (width != 16) && (width != 32) && (width != 64)) {
+            error("Unknown memory operand \"%s\"", name);
+            return NULL;
+        }
+
+        uint64_t addr;
+        str = skip_spaces(str);
+        if (*str != '[') {
+            error("Memory address expected");
+            return NULL;
+        }
+
+        str = parse_number(str + 1, &addr);
+        if (str == NULL) {
+            error("Memory address expected");
+            return NULL;
+        }
+
+        str = skip_spaces(str);
+        if (*str != ']') {
+            error("Missing ]");
+            return NULL;
+        }
+        str++;
+
+        if (!phys_range(addr)) {
+            error("Physical address out of range");
+            return NULL;
+        }
+
+        if (!IS_ALIGNED(addr, width / 8)) {
+            error("Memory operand address not aligned");
+            return NULL;
+        }
+
+        term->operand = BPCOND_MEM;
+        term->index = width / 8;
+        term->addr = addr;
+    } else {
+        int reg = parse_register(name, regnames);
+        if (reg < 0) {
+            error("Unknown operand \"%s\"", name);
+            return NULL;
+        }
+
+        term->operand = BPCOND_REG;
+        term->index = reg;
+    }
+
+    return str;
+}
+
+/** Parse the comparison operator
+ *
+ * @return Pointer after the operator or NULL on error.
+ *
+ */
+static const char *parse_op(const char *str, bpcond_op_t *op)
+{
+    str = skip_spaces(str);
+
+    /* Two character operators first */
+    for (unsigned int i = 0; i < OP_COUNT; i++) {
+        size_t len = strlen(op_names[i]);
+        if ((len == 2) && (strncmp(str, op_names[i], len) == 0)) {
+            *op = i;
+            return str + len;
+        }
+    }
+
+    for (unsigned int i = 0; i < OP_COUNT; i++) {
+        size_t len = strlen(op_names[i]);
+        if ((len == 1) && (strncmp(str, op_names[i], len) == 0)
+                && (str[1] != '&')) {
+            *op = i;
+            return str + len;
+        }
+    }
+
+    error("Comparison operator expected");
+    return NULL;
+}
+
+/** Compile the condition
+ *
+ * @param cond     Compiled condition.
+ * @param text     Condition as written by the user.
+ * @param regnames Names of the general purpose registers of the
+ *                 processor or NULL if only the numeric names are
+ *                 allowed.
+ *
+ * @return True if the condition is valid.
+ *
+ */
+bool bpcond_compile(bpcond_t *cond, const char *text, char *const *regnames)
+{
+    cond->count = 0;
+
+    const char *str = skip_spaces(text);
+    if (*str == '\0') {
+        return true;
+    }
+
+    while (true) {
+        if (cond->count == BPCOND_MAX_TERMS) {
+            error("Too many terms in the condition (at most %u)",
+                    BPCOND_MAX_TERMS);
+            return false;
+        }
+
+        bpcond_term_t *term = &cond->terms[cond->count];
+
+        str = parse_operand(str, term, regnames);
+        if (str == NULL) {
+            return false;
+        }
+
+        str = parse_op(str, &term->op);
+        if (str == NULL) {
+            return false;
+        }
+
+        str = parse_number(str, &term->value);
+        if (str == NULL) {
+            error("Number expected");
+            return false;
+        }
+
+        cond->count++;
+
+        str = skip_spaces(str);
+        if (*str == '\0') {
+            return true;
+        }
+
+        if (strncmp(str, "&&", 2) != 0) {
+            error("Unexpected \"%s\" in the condition", str);
+            return false;
+        }
+
+        str += 2;
+    }
+}
+
+/** Read the value of a memory operand without any side effects */
+static bool read_mem(unsigned int procno, const bpcond_term_t *term,
+        uint64_t *value)
+{
+    if (physmem_find_frame(term->addr) == NULL) {
+        return false;
+    }
+
+    switch (term->index) {
+    case 1:
+        *value = physmem_read8(procno, term->addr, false);
+        break;
+    case 2:
+        *value = physmem_read16(procno, term->addr, false);
+        break;
+    case 4:
+        *value = physmem_read32(procno, term->addr, false);
+        break;
+    default:
+        *value = physmem_read64(procno, term->addr, false);
+        break;
+    }
+
+    return true;
+}
+
+static const cpu_value_t cpu_values[] = {
+    [BPCOND_PC] = CPU_VALUE_PC,
+    [BPCOND_REG] = CPU_VALUE_REG,
+    [BPCOND_PRIV] = CPU_VALUE_PRIV,
+    [BPCOND_ASID] = CPU_VALUE_ASID
+};
+
+/** Evaluate the condition
+ *
+ * @param cond   Compiled condition.
+ * @param procno Processor which hit the breakpoint.
+ * @param hits   Number of hits of the breakpoint including this one.
+ *
+ * @return True if the condition holds. Terms that cannot be evaluated
+ *         (e.g. a memory operand outside of the memory) do not hold.
+ *
+ */
+bool bpcond_eval(const bpcond_t *cond, unsigned int procno, uint64_t hits)
+{
+    general_cpu_t *cpu = NULL;
+
+    for (unsigned int i = 0; i < cond->count; i++) {
+        const bpcond_term_t *term = &cond->terms[i];
+        uint64_t value;
+
+        switch (term->operand) {
+        case BPCOND_HITS:
+            value = hits;
+            break;
+        case BPCOND_MEM:
+            if (!read_mem(procno, term, &value)) {
+                return false;
+            }
+            break;
+        default:
+            if (cpu == NULL) {
+                cpu = get_cpu(procno);
+            }
+
+            if ((cpu == NULL) || (!cpu_value(cpu, cpu_values[term->operand], term->index, &value))) {
+                return false;
+            }
+            break;
+        }
+
+        bool holds;
+
+        switch (term->op) {
+        case BPCOND_EQ:
+            holds = (value == term->value);
+            break;
+        case BPCOND_NE:
+            holds = (value != term->value);
+            break;
+        case BPCOND_LT:
+            holds = (value < term->value);
+            break;
+        case BPCOND_LE:
+            holds = (value <= term->value);
+            break;
+        case BPCOND_GT:
+            holds = (value > term->value);
+            break;
+        case BPCOND_GE:
+            holds = (value >= term->value);
+            break;
+        case BPCOND_AND:
+            holds = ((value & term->value) != 0);
+            break;
+        default:
+            die(ERR_INTERN, "Unexpected breakpoint condition operator");
+        }
+
+        if (!holds) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** Print the condition in the form accepted by bpcond_compile */
+void bpcond_print(const bpcond_t *cond, char *const *regnames)
+{
+    for (unsigned int i = 0; i < cond->count; i++) {
+        const bpcond_term_t *term = &cond->terms[i];
+
+        if (i > 0) {
+            printf(" && ");
+        }
+
+        switch (term->operand) {
+        case BPCOND_PC:
+            printf("pc");
+            break;
+        case BPCOND_REG:
+            if (regnames != NULL) {
+                printf("%s", regnames[term->index]);
+            } else {
+                printf("r%u", term->index);
+            }
+            break;
+        case BPCOND_PRIV:
+            printf("priv");
+            break;
+        case BPCOND_ASID:
+            printf("asid");
+            break;
+        case BPCOND_HITS:
+            printf("hits");
+            break;
+        case BPCOND_MEM:
+            printf("mem%u[%#" PRIx64 "]", term->index * 8, term->addr);
+            break;
+        }
+
+        printf(" %s %#" PRIx64, op_names[term->op], term->value);
+    }
+}
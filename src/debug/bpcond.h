@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Breakpoint conditions
+ *
+ */
+
+#ifndef BPCOND_H_
+#define BPCOND_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../main.h"
+
+/** Maximal number of terms of a condition */
+#define BPCOND_MAX_TERMS 8
+
+/** Value tested by a condition term */
+typedef enum {
+    BPCOND_PC, /**< Program counter */
+    BPCOND_REG, /**< General purpose register */
+    BPCOND_PRIV, /**< Privilege level */
+    BPCOND_ASID, /**< Current address space identifier */
+    BPCOND_HITS, /**< Number of breakpoint hits (including this one) */
+    BPCOND_MEM /**< Physical memory */
+} bpcond_operand_t;
+
+/** Comparison of a condition term */
+typedef enum {
+    BPCOND_EQ,
+    BPCOND_NE,
+    BPCOND_LT,
+    BPCOND_LE,
+    BPCOND_GT,
+    BPCOND_GE,
+    BPCOND_AND /**< Any of the bits is set */
+} bpcond_op_t;
+
+/** Condition term */
+typedef struct {
+    bpcond_operand_t operand;
+    bpcond_op_t op;
+    /** Register number or memory access width in bytes */
+    unsigned int index;
+    /** Physical address of the memory operand */
+    ptr36_t addr;
+    uint64_t value;
+} bpcond_term_t;
+
+/** Compiled breakpoint condition
+ *
+ * The condition holds if all of its terms hold. The condition
+ * without any terms always holds.
+ */
+typedef struct {
+    unsigned int count;
+    bpcond_term_t terms[BPCOND_MAX_TERMS];
+} bpcond_t;
+
+extern bool bpcond_compile(bpcond_t *cond, const char *text,
+        char *const *regnames);
+extern bool bpcond_eval(const bpcond_t *cond, unsigned int procno,
+        uint64_t hits);
+extern void bpcond_print(const bpcond_t *cond, char *const *regnames);
+
+#endif
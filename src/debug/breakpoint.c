@@ -28,9 +28,16 @@
  * the next command from the debugger. Simulator breakpoint hit is handled
  * by showing message to the user of the simulator and waiting for next command
  * from him. They work with virtual address.
+ *
+ * Simulator breakpoints can have a condition and an action. The condition
+ * is compiled when the breakpoint is set (see bpcond.c) and evaluated
+ * on every hit. If it holds, the breakpoint either stops the simulation,
+ * dumps the registers of the processor or only counts the hit, so that
+ * breakpoints on hot paths can stay in place during long runs.
  */
 
 #include <inttypes.h>
+#include <string.h>
 
 #include "../assert.h"
 #include "../device/cpu/general_cpu.h"
@@ -41,10 +48,83 @@
 #include "../main.h"
 #include "../utils.h"
 #include "breakpoint.h"
+#include "memusage.h"
 #include "gdb.h"
 
 list_t physmem_breakpoints = LIST_INITIALIZER;
 
+/************************************************************************/
+/* Conditions and actions                                               */
+/************************************************************************/
+
+static const char *const action_names[] = {
+    [BREAKPOINT_ACTION_STOP] = "stop",
+    [BREAKPOINT_ACTION_LOG] = "log",
+    [BREAKPOINT_ACTION_COUNT] = "count"
+};
+
+#define ACTION_COUNT (sizeof(action_names) / sizeof(action_names[0]))
+
+/** Parse the optional action and condition of a simulator breakpoint
+ *
+ * The action (stop, log or count) comes first and defaults to stop,
+ * the condition follows. Both parameters are optional.
+ *
+ * @param parm     First of the parameters.
+ * @param action   Parsed action.
+ * @param cond     Compiled condition.
+ * @param regnames Register names of the processor (see bpcond_compile).
+ *
+ * @return True if the parameters are valid.
+ *
+ */
+bool breakpoint_parse_condition(token_t *parm, breakpoint_action_t *action,
+        bpcond_t *cond, char *const *regnames)
+{
+    *action = BREAKPOINT_ACTION_STOP;
+    cond->count = 0;
+
+    if (parm_type(parm) == tt_end) {
+        return true;
+    }
+
+    for (unsigned int i = 0; i < ACTION_COUNT; i++) {
+        if (strcmp(parm_str(parm), action_names[i]) == 0) {
+            *action = i;
+            parm_next(&parm);
+            break;
+        }
+    }
+
+    if (parm_type(parm) == tt_end) {
+        return true;
+    }
+
+    return bpcond_compile(cond, parm_str(parm), regnames);
+}
+
+/** Print the action and the condition of a simulator breakpoint */
+void breakpoint_print_condition(breakpoint_action_t action,
+        const bpcond_t *cond, char *const *regnames)
+{
+    printf("%s", action_names[action]);
+
+    if (cond->count > 0) {
+        printf(" if ");
+        bpcond_print(cond, regnames);
+    }
+}
+
+/** Dump the registers of the processor which hit a logging breakpoint */
+static void breakpoint_log(unsigned int procno)
+{
+    general_cpu_t *cpu = get_cpu(procno);
+
+    if (cpu != NULL) {
+        cpu_reg_dump(cpu);
+    }
+}
+
 /************************************************************************/
 /* Memory breakpoints                                                   */
 /************************************************************************/
@@ -72,6 +152,9 @@ static physmem_breakpoint_t *physmem_breakpoint_init(ptr36_t address,
     breakpoint->size = size;
     breakpoint->hits = 0;
     breakpoint->access_flags = access_flags;
+    breakpoint->action = BREAKPOINT_ACTION_STOP;
+    breakpoint->cond.count = 0;
+    breakpoint->matches = 0;
 
     return breakpoint;
 }
@@ -85,13 +168,17 @@ static physmem_breakpoint_t *physmem_breakpoint_init(ptr36_t address,
  * @param access_flags Specifies the access condition, under the breakpoint
  *                     will be hit.
  *
+ * @return The new breakpoint (unconditional, stopping the simulation).
+ *
  */
-void physmem_breakpoint_add(ptr36_t address, len36_t length,
+physmem_breakpoint_t *physmem_breakpoint_add(ptr36_t address, len36_t length,
         breakpoint_kind_t kind, access_filter_t access_flags)
 {
     physmem_breakpoint_t *breakpoint = physmem_breakpoint_init(address, length, kind, access_flags);
 
     list_append(&physmem_breakpoints, &breakpoint->item);
+
+    return breakpoint;
 }
 
 /** Deactivate memory breakpoint with specified address
@@ -145,7 +232,7 @@ void physmem_breakpoint_remove_filtered(breakpoint_filter_t filter)
 /** Print activated memory breakpoints for the user */
 void physmem_breakpoint_print_list(void)
 {
-    printf("[address         ] [mode] [hits              ]\n");
+    printf("[address         ] [mode] [hits              ] [matches           ]\n");
 
     physmem_breakpoint_t *breakpoint = NULL;
     for_each(physmem_breakpoints, breakpoint, physmem_breakpoint_t)
@@ -153,10 +240,18 @@ void physmem_breakpoint_print_list(void)
         bool read = breakpoint->access_flags & ACCESS_READ;
         bool write = breakpoint->access_flags & ACCESS_WRITE;
 
-        printf("%#018" PRIx64 " %c%c     %20" PRIu64 "\n",
+        printf("%#018" PRIx64 " %c%c     %20" PRIu64 " %20" PRIu64,
                 breakpoint->addr,
                 read ? 'r' : '-', write ? 'w' : '-',
-                breakpoint->hits);
+                breakpoint->hits, breakpoint->matches);
+
+        if (breakpoint->kind == BREAKPOINT_KIND_SIMULATOR) {
+            printf(" ");
+            breakpoint_print_condition(breakpoint->action,
+                    &breakpoint->cond, NULL);
+        }
+
+        printf("\n");
     }
 }
 
@@ -167,15 +262,30 @@ void physmem_breakpoint_print_list(void)
  *
  * @param breakpoint  Breakpoint to be fired.
  * @param access_type Specifies type of access operation.
+ * @param procno      Processor performing the access.
+ *
+ * @return True if the breakpoint condition held.
  *
  */
-void physmem_breakpoint_hit(physmem_breakpoint_t *breakpoint,
-        access_t access_type)
+bool physmem_breakpoint_hit(physmem_breakpoint_t *breakpoint,
+        access_t access_type, unsigned int procno)
 {
     ASSERT(breakpoint != NULL);
 
     switch (breakpoint->kind) {
     case BREAKPOINT_KIND_SIMULATOR:
+        breakpoint->hits++;
+
+        if (!bpcond_eval(&breakpoint->cond, procno, breakpoint->hits)) {
+            return false;
+        }
+
+        breakpoint->matches++;
+
+        if (breakpoint->action == BREAKPOINT_ACTION_COUNT) {
+            break;
+        }
+
         if (access_type == ACCESS_READ) {
             alert("Debug: Read from address %#0" PRIx64,
                     breakpoint->addr);
@@ -184,8 +294,11 @@ void physmem_breakpoint_hit(physmem_breakpoint_t *breakpoint,
                     breakpoint->addr);
         }
 
-        breakpoint->hits++;
-        machine_interactive = true;
+        if (breakpoint->action == BREAKPOINT_ACTION_LOG) {
+            breakpoint_log(procno);
+        } else {
+            machine_interactive = true;
+        }
         break;
     case BREAKPOINT_KIND_DEBUGGER:
         gdb_handle_event(GDB_EVENT_BREAKPOINT);
@@ -193,6 +306,8 @@ void physmem_breakpoint_hit(physmem_breakpoint_t *breakpoint,
     default:
         die(ERR_INTERN, "Unexpected physical memory breakpoint kind");
     }
+
+    return true;
 }
 
 /************************************************************************/
@@ -215,6 +330,9 @@ breakpoint_t *breakpoint_init(ptr64_t address, breakpoint_kind_t kind)
     breakpoint->pc = address;
     breakpoint->hits = 0;
     breakpoint->kind = kind;
+    breakpoint->action = BREAKPOINT_ACTION_STOP;
+    breakpoint->cond.count = 0;
+    breakpoint->matches = 0;
 
     return breakpoint;
 }
@@ -222,16 +340,35 @@ breakpoint_t *breakpoint_init(ptr64_t address, breakpoint_kind_t kind)
 /** Fires given breakpoint
  *
  * @param breakpoint Breakpoint structure to be fired
+ * @param procno     Processor which hit the breakpoint
+ *
+ * @return True if the breakpoint condition held.
  *
  */
-static void breakpoint_hit(breakpoint_t *breakpoint)
+static bool breakpoint_hit(breakpoint_t *breakpoint, unsigned int procno)
 {
     breakpoint->hits++;
 
     switch (breakpoint->kind) {
     case BREAKPOINT_KIND_SIMULATOR:
-        alert("Debug: Hit breakpoint at %#0" PRIx64, breakpoint->pc.ptr);
-        machine_interactive = true;
+        if (!bpcond_eval(&breakpoint->cond, procno, breakpoint->hits)) {
+            return false;
+        }
+
+        breakpoint->matches++;
+
+        switch (breakpoint->action) {
+        case BREAKPOINT_ACTION_STOP:
+            alert("Debug: Hit breakpoint at %#0" PRIx64, breakpoint->pc.ptr);
+            machine_interactive = true;
+            break;
+        case BREAKPOINT_ACTION_LOG:
+            alert("Debug: Hit breakpoint at %#0" PRIx64, breakpoint->pc.ptr);
+            breakpoint_log(procno);
+            break;
+        case BREAKPOINT_ACTION_COUNT:
+            break;
+        }
         break;
     case BREAKPOINT_KIND_DEBUGGER:
         gdb_handle_event(GDB_EVENT_BREAKPOINT);
@@ -239,6 +376,8 @@ static void breakpoint_hit(breakpoint_t *breakpoint)
     default:
         die(ERR_INTERN, "Unexpected breakpoint kind");
     }
+
+    return true;
 }
 
 /** Search for a breakpoint
@@ -248,19 +387,20 @@ static void breakpoint_hit(breakpoint_t *breakpoint)
  *
  * @param breakpoints List of code breakpoints of some processor.
  * @param address     Address of executed instruction.
+ * @param procno      Processor executing the instruction.
  *
  * @return True, if at least one breakpoint has been hit.
  *
  */
-static bool breakpoint_hit_by_address(list_t breakpoints, ptr64_t address)
+static bool breakpoint_hit_by_address(list_t breakpoints, ptr64_t address,
+        unsigned int procno)
 {
     bool hit = false;
 
     breakpoint_t *breakpoint = NULL;
     for_each(breakpoints, breakpoint, breakpoint_t)
     {
-        if (breakpoint->pc.ptr == address.ptr) {
-            breakpoint_hit(breakpoint);
+        if ((breakpoint->pc.ptr == address.ptr) && (breakpoint_hit(breakpoint, procno))) {
             hit = true;
         }
     }
@@ -314,10 +454,30 @@ bool breakpoint_check_for_code_breakpoints(void)
     while (dev_next(&dev, DEVICE_FILTER_R4K_PROCESSOR)) {
         r4k_cpu_t *cpu = get_r4k(dev);
 
-        if (breakpoint_hit_by_address(cpu->bps, cpu->pc)) {
+        if (breakpoint_hit_by_address(cpu->bps, cpu->pc, cpu->procno)) {
             hit = true;
         }
     }
 
     return hit;
 }
+
+/** Account the memory breakpoints */
+void breakpoint_memusage(memusage_t *usage)
+{
+    physmem_breakpoint_t *breakpoint = NULL;
+    for_each(physmem_breakpoints, breakpoint, physmem_breakpoint_t)
+    {
+        memusage_add(usage, MEMUSAGE_BREAKPOINTS, sizeof(physmem_breakpoint_t));
+    }
+}
+
+/** Account the code breakpoints of a processor */
+void breakpoint_list_memusage(list_t *breakpoints, memusage_t *usage)
+{
+    breakpoint_t *breakpoint = NULL;
+    for_each(*breakpoints, breakpoint, breakpoint_t)
+    {
+        memusage_add(usage, MEMUSAGE_BREAKPOINTS, sizeof(breakpoint_t));
+    }
+}
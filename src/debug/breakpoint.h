@@ -13,6 +13,8 @@
 
 #include "../list.h"
 #include "../main.h"
+#include "../parser.h"
+#include "bpcond.h"
 
 /** Kind of code breakpoints */
 typedef enum {
@@ -27,6 +29,13 @@ typedef enum {
     BREAKPOINT_FILTER_ANY = BREAKPOINT_KIND_DEBUGGER | BREAKPOINT_KIND_SIMULATOR
 } breakpoint_filter_t;
 
+/** Action of a simulator breakpoint when its condition holds */
+typedef enum {
+    BREAKPOINT_ACTION_STOP = 0, /**< Switch to the interactive mode */
+    BREAKPOINT_ACTION_LOG, /**< Dump the registers and continue */
+    BREAKPOINT_ACTION_COUNT /**< Only count the hit and continue */
+} breakpoint_action_t;
+
 /** Memory access types */
 typedef enum {
     ACCESS_READ = 0x01,
@@ -48,6 +57,11 @@ typedef struct {
     breakpoint_kind_t kind;
     ptr64_t pc;
     uint64_t hits;
+
+    /* Simulator breakpoints only */
+    breakpoint_action_t action;
+    bpcond_t cond;
+    uint64_t matches;
 } breakpoint_t;
 
 /** Structure for the memory breakpoints */
@@ -59,6 +73,11 @@ typedef struct {
     len36_t size;
     uint64_t hits;
     access_filter_t access_flags;
+
+    /* Simulator breakpoints only */
+    breakpoint_action_t action;
+    bpcond_t cond;
+    uint64_t matches;
 } physmem_breakpoint_t;
 
 /** List of all the memory breakpoints */
@@ -66,14 +85,21 @@ extern list_t physmem_breakpoints;
 
 /* Memory breakpoints interface */
 
-extern void physmem_breakpoint_add(ptr36_t address, len36_t size,
-        breakpoint_kind_t kind, access_filter_t access_flags);
+extern physmem_breakpoint_t *physmem_breakpoint_add(ptr36_t address,
+        len36_t size, breakpoint_kind_t kind, access_filter_t access_flags);
 extern bool physmem_breakpoint_remove(ptr36_t address);
 extern void physmem_breakpoint_remove_filtered(breakpoint_filter_t filter);
-extern void physmem_breakpoint_hit(physmem_breakpoint_t *breakpoint,
-        access_t access_type);
+extern bool physmem_breakpoint_hit(physmem_breakpoint_t *breakpoint,
+        access_t access_type, unsigned int procno);
 extern void physmem_breakpoint_print_list(void);
 
+/* Conditions and actions */
+
+extern bool breakpoint_parse_condition(token_t *parm,
+        breakpoint_action_t *action, bpcond_t *cond, char *const *regnames);
+extern void breakpoint_print_condition(breakpoint_action_t action,
+        const bpcond_t *cond, char *const *regnames);
+
 /* Code breakpoints interface */
 
 extern breakpoint_t *breakpoint_init(ptr64_t address, breakpoint_kind_t kind);
@@ -81,4 +107,11 @@ extern breakpoint_t *breakpoint_find_by_address(list_t breakpoints,
         ptr64_t address, breakpoint_filter_t filter);
 extern bool breakpoint_check_for_code_breakpoints(void);
 
+/* Host memory accounting */
+
+struct memusage;
+extern void breakpoint_memusage(struct memusage *usage);
+extern void breakpoint_list_memusage(list_t *breakpoints,
+        struct memusage *usage);
+
 #endif
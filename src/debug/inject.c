@@ -0,0 +1,837 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Deterministic fault injection
+ *
+ * Faults are injected according to a schedule file. Every line of the
+ * schedule contains a trigger followed by a fault, empty lines and
+ * everything after # is ignored:
+ *
+ *   seed <value>
+ *   at <cycle> <fault>             once at the given machine cycle
+ *   pc <addr> <fault>              once when a processor reaches the address
+ *   every <period> <count> <fault> every period cycles
+ *   prob <p> <count> <fault>       in every cycle with the probability p
+ *
+ * Zero count means no limit. The faults are:
+ *
+ *   memflip <addr> <size> <bits>   flip bits of a random word of the area
+ *   memxor <addr> <mask>           flip bits of a physical memory word
+ *   regflip <cpu> <bits>           flip bits of a random register
+ *   regxor <cpu> <reg> <mask>      flip bits of a general purpose register
+ *   sysflip <cpu> <reg> <bits>     flip random bits of a CP0 register or CSR
+ *   sysxor <cpu> <reg> <mask>      flip bits of a CP0 register or CSR
+ *   irq <cpu> <no>                 spurious interrupt (for one cycle)
+ *   diskerr <disk>                 fail the next disk command
+ *   diskflip <disk> <sector> <bits> flip bits of a random byte of a sector
+ *   diskxor <disk> <offset> <mask> flip bits of a byte of a disk image
+ *   tlbdrop <cpu> [<index>]        drop a (random) TLB entry
+ *
+ * The random choices are made by a generator seeded from the schedule,
+ * the probabilistic triggers draw the cycle of the next injection in
+ * advance. Hence the simulation loop only compares the cycle counter
+ * with the next scheduled cycle, the processors are polled every cycle
+ * only while a pc trigger is pending.
+ *
+ * Every injection is logged with all the random choices resolved as
+ * a line of a schedule (e.g. memflip becomes memxor with the cycle
+ * of the injection), so the log itself replays the same faults.
+ *
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../assert.h"
+#include "../device/cpu/general_cpu.h"
+#include "../device/ddisk.h"
+#include "../device/device.h"
+#include "../fault.h"
+#include "../main.h"
+#include "../physmem.h"
+#include "../utils.h"
+#include "inject.h"
+
+/** Header of the log file */
+#define INJECT_HEADER "# MSIM fault injection log"
+
+/** Maximal length of a schedule line */
+#define INJECT_LINE_LENGTH 1024
+
+/** Maximal number of tokens on a schedule line */
+#define INJECT_TOKENS 8
+
+/** Maximal interrupt number of a spurious interrupt
+ *
+ * The processor rejects the numbers of interrupts it does not have.
+ *
+ */
+#define INJECT_IRQ_MAX 64
+
+/** Machine cycle of the next fault injection check */
+uint64_t inject_next = UINT64_MAX;
+
+typedef enum {
+    TRIGGER_AT,
+    TRIGGER_PC,
+    TRIGGER_EVERY,
+    TRIGGER_PROB
+} trigger_t;
+
+typedef enum {
+    FAULT_MEMFLIP,
+    FAULT_MEMXOR,
+    FAULT_REGFLIP,
+    FAULT_REGXOR,
+    FAULT_SYSFLIP,
+    FAULT_SYSXOR,
+    FAULT_IRQ,
+    FAULT_DISKERR,
+    FAULT_DISKFLIP,
+    FAULT_DISKXOR,
+    FAULT_TLBDROP
+} fault_kind_t;
+
+/** Fault type description */
+typedef struct {
+    const char *name;
+    fault_kind_t kind;
+
+    /** The first argument is a device name */
+    bool device;
+
+    /** Number of the (numeric) arguments */
+    unsigned int min_args;
+    unsigned int max_args;
+} fault_type_t;
+
+static const fault_type_t fault_types[] = {
+    { "memflip", FAULT_MEMFLIP, false, 3, 3 },
+    { "memxor", FAULT_MEMXOR, false, 2, 2 },
+    { "regflip", FAULT_REGFLIP, false, 2, 2 },
+    { "regxor", FAULT_REGXOR, false, 3, 3 },
+    { "sysflip", FAULT_SYSFLIP, false, 3, 3 },
+    { "sysxor", FAULT_SYSXOR, false, 3, 3 },
+    { "irq", FAULT_IRQ, false, 2, 2 },
+    { "diskerr", FAULT_DISKERR, true, 0, 0 },
+    { "diskflip", FAULT_DISKFLIP, true, 2, 2 },
+    { "diskxor", FAULT_DISKXOR, true, 2, 2 },
+    { "tlbdrop", FAULT_TLBDROP, false, 1, 2 }
+};
+
+#define FAULT_TYPES (sizeof(fault_types) / sizeof(fault_types[0]))
+
+/** Scheduled fault */
+typedef struct {
+    /** Line of the schedule */
+    unsigned int line;
+
+    trigger_t trigger;
+
+    /** Cycle, address or period */
+    uint64_t value;
+    double probability;
+
+    /** Remaining injections (0 for unlimited) */
+    uint64_t remaining;
+
+    /** Cycle of the next injection */
+    uint64_t next;
+    bool active;
+
+    const fault_type_t *type;
+    char *device;
+    unsigned int argc;
+    uint64_t args[3];
+} fault_t;
+
+/** Resolved fault (with all random choices made) */
+typedef struct {
+    fault_kind_t kind;
+    const char *device;
+    unsigned int argc;
+    uint64_t args[3];
+} injection_t;
+
+/** Schedule */
+static fault_t *faults = NULL;
+static size_t fault_count = 0;
+
+/** Generator state */
+static uint64_t seed = 0;
+static uint64_t rng_state = 0;
+
+/** Number of injections */
+static uint64_t injected = 0;
+
+/** Spurious interrupts to cancel in the next cycle
+ *
+ * Only the lines which were not asserted before the injection
+ * are recorded, the other ones are left asserted.
+ *
+ */
+static uint64_t raised_irqs[MAX_CPUS];
+static bool irqs_raised = false;
+
+/** Log file */
+static FILE *log_file = NULL;
+static char *log_name = NULL;
+
+/** SplitMix64 generator */
+static uint64_t rng_next(void)
+{
+    uint64_t z = (rng_state += UINT64_C(0x9e3779b97f4a7c15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return z ^ (z >> 31);
+}
+
+/** Mask with the given number of random bits set
+ *
+ * @param bits  Number of bits.
+ * @param width Width of the mask.
+ *
+ */
+static uint64_t rng_mask(uint64_t bits, unsigned int width)
+{
+    uint64_t mask = 0;
+    unsigned int set = 0;
+
+    if (bits > width) {
+        bits = width;
+    }
+
+    while (set < bits) {
+        uint64_t bit = UINT64_C(1) << (rng_next() % width);
+        if ((mask & bit) == 0) {
+            mask |= bit;
+            set++;
+        }
+    }
+
+    return mask;
+}
+
+/** Number of cycles until the next event of the given probability
+ *
+ * The number is drawn from the geometric distribution.
+ *
+ */
+static uint64_t rng_geometric(double probability)
+{
+    if (probability >= 1.0) {
+        return 1;
+    }
+
+    double uniform = (double) (rng_next() >> 11) / (double) (UINT64_C(1) << 53);
+    double cycles = floor(log1p(-uniform) / log1p(-probability)) + 1.0;
+
+    if (cycles >= (double) (UINT64_MAX / 2)) {
+        return UINT64_MAX / 2;
+    }
+
+    return (uint64_t) cycles;
+}
+
+/** Plan the next injection of a fault */
+static void fault_plan(fault_t *fault)
+{
+    switch (fault->trigger) {
+    case TRIGGER_AT:
+    case TRIGGER_PC:
+        break;
+    case TRIGGER_EVERY:
+        fault->next = machine_steps + fault->value;
+        break;
+    case TRIGGER_PROB:
+        fault->next = machine_steps + rng_geometric(fault->probability);
+        break;
+    }
+}
+
+/** Compute the cycle of the next check */
+static void schedule_next(void)
+{
+    uint64_t next = UINT64_MAX;
+
+    for (size_t i = 0; i < fault_count; i++) {
+        fault_t *fault = &faults[i];
+        if (!fault->active) {
+            continue;
+        }
+
+        if (fault->trigger == TRIGGER_PC) {
+            next = machine_steps + 1;
+            break;
+        }
+
+        if (fault->next < next) {
+            next = fault->next;
+        }
+    }
+
+    if (irqs_raised) {
+        next = machine_steps + 1;
+    }
+
+    inject_next = next;
+}
+
+static bool parse_number(const char *str, uint64_t *val)
+{
+    char *endp;
+    *val = strtoull(str, &endp, 0);
+
+    return (endp != str) && (*endp == 0);
+}
+
+/** Parse a schedule line
+ *
+ * @param tokens Tokens of the line.
+ * @param count  Number of the tokens.
+ * @param fault  Fault to fill in.
+ *
+ * @return Error message or NULL.
+ *
+ */
+static const char *parse_fault(char **tokens, unsigned int count, fault_t *fault)
+{
+    unsigned int pos;
+
+    if (strcmp(tokens[0], "at") == 0) {
+        fault->trigger = TRIGGER_AT;
+        pos = 2;
+    } else if (strcmp(tokens[0], "pc") == 0) {
+        fault->trigger = TRIGGER_PC;
+        pos = 2;
+    } else if (strcmp(tokens[0], "every") == 0) {
+        fault->trigger = TRIGGER_EVERY;
+        pos = 3;
+    } else if (strcmp(tokens[0], "prob") == 0) {
+        fault->trigger = TRIGGER_PROB;
+        pos = 3;
+    } else {
+        return "Unknown trigger";
+    }
+
+    if (count <= pos) {
+        return "Fault expected";
+    }
+
+    if (fault->trigger == TRIGGER_PROB) {
+        char *endp;
+        fault->probability = strtod(tokens[1], &endp);
+
+        if ((endp == tokens[1]) || (*endp != 0)
+                || (!(fault->probability > 0.0)) || (fault->probability > 1.0)) {
+            return "Probability within (0, 1] expected";
+        }
+    } else if (!parse_number(tokens[1], &fault->value)) {
+        return "Trigger value expected";
+    }
+
+    fault->remaining = 1;
+    if ((pos == 3) && (!parse_number(tokens[2], &fault->remaining))) {
+        return "Number of injections expected";
+    }
+
+    if ((fault->trigger == TRIGGER_AT) && (fault->value <= machine_steps)) {
+        return "Cycle already passed";
+    }
+
+    if ((fault->trigger == TRIGGER_EVERY) && (fault->value == 0)) {
+        return "Period cannot be zero";
+    }
+
+    fault->type = NULL;
+    for (size_t i = 0; i < FAULT_TYPES; i++) {
+        if (strcmp(tokens[pos], fault_types[i].name) == 0) {
+            fault->type = &fault_types[i];
+            break;
+        }
+    }
+
+    if (fault->type == NULL) {
+        return "Unknown fault";
+    }
+
+    pos++;
+
+    if (fault->type->device) {
+        if (count <= pos) {
+            return "Device name expected";
+        }
+
+        fault->device = safe_strdup(tokens[pos]);
+        pos++;
+    }
+
+    fault->argc = count - pos;
+    if ((fault->argc < fault->type->min_args) || (fault->argc > fault->type->max_args)) {
+        return "Wrong number of fault arguments";
+    }
+
+    for (unsigned int i = 0; i < fault->argc; i++) {
+        if (!parse_number(tokens[pos + i], &fault->args[i])) {
+            return "Numeric fault argument expected";
+        }
+    }
+
+    switch (fault->type->kind) {
+    case FAULT_MEMFLIP:
+        if (fault->args[1] < 4) {
+            return "Memory area smaller than a word";
+        }
+        /* Fallthrough */
+    case FAULT_REGFLIP:
+    case FAULT_SYSFLIP:
+    case FAULT_DISKFLIP:
+        if (fault->args[fault->argc - 1] == 0) {
+            return "Number of bits cannot be zero";
+        }
+        break;
+    case FAULT_MEMXOR:
+        if (!IS_ALIGNED(fault->args[0], 4)) {
+            return "Memory address must be word aligned";
+        }
+        break;
+    case FAULT_IRQ:
+        if (fault->args[1] >= INJECT_IRQ_MAX) {
+            return "Interrupt number out of range";
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (((fault->type->kind == FAULT_MEMFLIP) || (fault->type->kind == FAULT_MEMXOR))
+            && (!phys_range(fault->args[0]))) {
+        return "Physical memory address out of range";
+    }
+
+    if ((!fault->type->device) && (fault->type->kind != FAULT_MEMFLIP)
+            && (fault->type->kind != FAULT_MEMXOR) && (fault->args[0] >= MAX_CPUS)) {
+        return "Processor number out of range";
+    }
+
+    return NULL;
+}
+
+/** Load a schedule file */
+static bool load_schedule(const char *filename)
+{
+    FILE *file = try_fopen(filename, "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    char line[INJECT_LINE_LENGTH];
+    unsigned int lineno = 0;
+    bool ok = true;
+
+    while ((ok) && (fgets(line, sizeof(line), file) != NULL)) {
+        lineno++;
+
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = 0;
+        }
+
+        char *tokens[INJECT_TOKENS];
+        unsigned int count = 0;
+
+        for (char *token = strtok(line, " \t\r\n"); token != NULL;
+                token = strtok(NULL, " \t\r\n")) {
+            if (count == INJECT_TOKENS) {
+                error("Too many tokens in %s on line %u", filename, lineno);
+                ok = false;
+                break;
+            }
+
+            tokens[count] = token;
+            count++;
+        }
+
+        if ((!ok) || (count == 0)) {
+            continue;
+        }
+
+        if (strcmp(tokens[0], "seed") == 0) {
+            if ((count != 2) || (!parse_number(tokens[1], &seed))) {
+                error("Seed expected in %s on line %u", filename, lineno);
+                ok = false;
+            }
+
+            rng_state = seed;
+            continue;
+        }
+
+        faults = realloc(faults, (fault_count + 1) * sizeof(fault_t));
+        if (faults == NULL) {
+            die(ERR_MEM, "Not enough memory");
+        }
+
+        fault_t *fault = &faults[fault_count];
+        memset(fault, 0, sizeof(fault_t));
+        fault->line = lineno;
+        fault_count++;
+
+        const char *msg = parse_fault(tokens, count, fault);
+        if (msg != NULL) {
+            error("%s in %s on line %u", msg, filename, lineno);
+            ok = false;
+        }
+    }
+
+    if ((ok) && (ferror(file))) {
+        io_error(filename);
+        ok = false;
+    }
+
+    safe_fclose(file, filename);
+    return ok;
+}
+
+/** Start fault injection
+ *
+ * @param schedule Name of the schedule file.
+ * @param log      Name of the log file (NULL to report the injections
+ *                 as alerts).
+ *
+ * @return True if the schedule has been loaded.
+ *
+ */
+bool inject_start(const char *schedule, const char *log)
+{
+    ASSERT(schedule != NULL);
+
+    inject_stop();
+
+    seed = 0;
+    rng_state = 0;
+    injected = 0;
+
+    if (!load_schedule(schedule)) {
+        inject_stop();
+        return false;
+    }
+
+    if (log != NULL) {
+        log_file = try_fopen(log, "w");
+        if (log_file == NULL) {
+            inject_stop();
+            return false;
+        }
+
+        log_name = safe_strdup(log);
+        fprintf(log_file, "%s\n", INJECT_HEADER);
+    }
+
+    /* Plan after the whole file is read, so the seed applies */
+    for (size_t i = 0; i < fault_count; i++) {
+        faults[i].active = true;
+        faults[i].next = faults[i].value;
+        fault_plan(&faults[i]);
+    }
+
+    schedule_next();
+    return true;
+}
+
+/** Cancel the spurious interrupts raised in the previous cycle */
+static void lower_irqs(void)
+{
+    for (unsigned int i = 0; i < MAX_CPUS; i++) {
+        general_cpu_t *cpu = get_cpu(i);
+
+        for (unsigned int no = 0; no < INJECT_IRQ_MAX; no++) {
+            if ((raised_irqs[i] & (UINT64_C(1) << no)) != 0) {
+                if (cpu != NULL) {
+                    cpu_interrupt_down(cpu, no);
+                }
+            }
+        }
+
+        raised_irqs[i] = 0;
+    }
+
+    irqs_raised = false;
+}
+
+/** Stop fault injection */
+void inject_stop(void)
+{
+    if (irqs_raised) {
+        lower_irqs();
+    }
+
+    if (log_file != NULL) {
+        safe_fclose(log_file, log_name);
+        log_file = NULL;
+        safe_free(log_name);
+    }
+
+    for (size_t i = 0; i < fault_count; i++) {
+        safe_free(faults[i].device);
+    }
+
+    safe_free(faults);
+    fault_count = 0;
+
+    inject_next = UINT64_MAX;
+}
+
+/** Print the state of fault injection */
+void inject_print(void)
+{
+    size_t pending = 0;
+    for (size_t i = 0; i < fault_count; i++) {
+        if (faults[i].active) {
+            pending++;
+        }
+    }
+
+    printf("[seed              ] [pending ] [injected          ]\n");
+    printf("%20" PRIu64 " %10zu %20" PRIu64 "\n", seed, pending, injected);
+}
+
+/** Make the random choices of a fault */
+static void resolve(const fault_t *fault, injection_t *injection)
+{
+    injection->kind = fault->type->kind;
+    injection->device = fault->device;
+    injection->argc = fault->argc;
+    memcpy(injection->args, fault->args, sizeof(injection->args));
+
+    switch (fault->type->kind) {
+    case FAULT_MEMFLIP: {
+        uint64_t words = fault->args[1] / 4;
+        injection->kind = FAULT_MEMXOR;
+        injection->argc = 2;
+        injection->args[0] = ALIGN_DOWN(fault->args[0], 4) + (rng_next() % words) * 4;
+        injection->args[1] = rng_mask(fault->args[2], 32);
+        break;
+    }
+    case FAULT_REGFLIP:
+        /* The zero register is hardwired */
+        injection->kind = FAULT_REGXOR;
+        injection->argc = 3;
+        injection->args[1] = 1 + (rng_next() % 31);
+        injection->args[2] = rng_mask(fault->args[1], 32);
+        break;
+    case FAULT_SYSFLIP:
+        injection->kind = FAULT_SYSXOR;
+        injection->args[2] = rng_mask(fault->args[2], 32);
+        break;
+    case FAULT_DISKFLIP:
+        injection->kind = FAULT_DISKXOR;
+        injection->args[0] = fault->args[0] * 512 + (rng_next() % 512);
+        injection->args[1] = rng_mask(fault->args[1], 8);
+        break;
+    case FAULT_TLBDROP:
+        if (fault->argc == 1) {
+            injection->argc = 2;
+            injection->args[1] = (uint32_t) rng_next();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/** Inject a resolved fault
+ *
+ * @return False if the target of the fault does not exist.
+ *
+ */
+static bool apply(const injection_t *injection)
+{
+    const uint64_t *args = injection->args;
+
+    switch (injection->kind) {
+    case FAULT_MEMXOR: {
+        if (physmem_find_frame(args[0]) == NULL) {
+            return false;
+        }
+
+        uint32_t val = physmem_read32(-1, args[0], false);
+        return physmem_write32(-1, args[0], val ^ (uint32_t) args[1], false);
+    }
+    case FAULT_REGXOR:
+    case FAULT_SYSXOR:
+    case FAULT_TLBDROP: {
+        general_cpu_t *cpu = get_cpu(args[0]);
+        if (cpu == NULL) {
+            return false;
+        }
+
+        if (injection->kind == FAULT_REGXOR) {
+            return cpu_inject(cpu, CPU_FAULT_REG, args[1], args[2]);
+        }
+
+        if (injection->kind == FAULT_SYSXOR) {
+            return cpu_inject(cpu, CPU_FAULT_SYSREG, args[1], args[2]);
+        }
+
+        return cpu_inject(cpu, CPU_FAULT_TLB, args[1], 0);
+    }
+    case FAULT_IRQ: {
+        general_cpu_t *cpu = get_cpu(args[0]);
+        if (cpu == NULL) {
+            return false;
+        }
+
+        uint64_t asserted = 0;
+        cpu_value(cpu, CPU_VALUE_IRQ, args[1], &asserted);
+
+        if (!cpu_inject(cpu, CPU_FAULT_IRQ, args[1], 0)) {
+            return false;
+        }
+
+        if (asserted == 0) {
+            raised_irqs[args[0]] |= UINT64_C(1) << args[1];
+            irqs_raised = true;
+        }
+
+        return true;
+    }
+    case FAULT_DISKERR:
+    case FAULT_DISKXOR: {
+        device_t *dev = dev_by_name(injection->device);
+        if (dev == NULL) {
+            return false;
+        }
+
+        if (injection->kind == FAULT_DISKERR) {
+            return ddisk_inject_error(dev);
+        }
+
+        return ddisk_inject_corruption(dev, args[0], args[1]);
+    }
+    default:
+        break;
+    }
+
+    return false;
+}
+
+/** Format a resolved fault as a schedule line */
+static void describe(const injection_t *injection, string_t *str)
+{
+    const char *name = "?";
+    for (size_t i = 0; i < FAULT_TYPES; i++) {
+        if (fault_types[i].kind == injection->kind) {
+            name = fault_types[i].name;
+            break;
+        }
+    }
+
+    string_printf(str, "at %" PRIu64 " %s", machine_steps, name);
+
+    if (injection->device != NULL) {
+        string_printf(str, " %s", injection->device);
+    }
+
+    for (unsigned int i = 0; i < injection->argc; i++) {
+        /* Processors, registers and interrupts in decimal */
+        bool decimal = (injection->kind != FAULT_MEMXOR)
+                && (injection->kind != FAULT_DISKXOR) && (i < 2);
+
+        if (decimal) {
+            string_printf(str, " %" PRIu64, injection->args[i]);
+        } else {
+            string_printf(str, " 0x%" PRIx64, injection->args[i]);
+        }
+    }
+}
+
+/** Inject a scheduled fault */
+static void fire(fault_t *fault)
+{
+    injection_t injection;
+    resolve(fault, &injection);
+
+    string_t str;
+    string_init(&str);
+    describe(&injection, &str);
+
+    if (apply(&injection)) {
+        injected++;
+
+        if (log_file != NULL) {
+            fprintf(log_file, "%s\n", str.str);
+        } else {
+            alert("Inject: %s", str.str);
+        }
+    } else {
+        alert("Inject: Target of the fault on line %u does not exist (%s)",
+                fault->line, str.str);
+    }
+
+    string_done(&str);
+
+    if (fault->remaining > 0) {
+        fault->remaining--;
+
+        if (fault->remaining == 0) {
+            fault->active = false;
+            return;
+        }
+    }
+
+    fault_plan(fault);
+}
+
+/** Check whether a processor has reached an address */
+static bool pc_reached(uint64_t addr)
+{
+    for (unsigned int i = 0; i < MAX_CPUS; i++) {
+        general_cpu_t *cpu = get_cpu(i);
+        uint64_t pc;
+
+        if ((cpu == NULL) || (!cpu_value(cpu, CPU_VALUE_PC, 0, &pc))) {
+            continue;
+        }
+
+        /* Sign-extended 32-bit addresses of MIPS */
+        if ((pc == addr) || (pc == (UINT64_C(0xffffffff00000000) | addr))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** Inject the faults scheduled for the current cycle */
+void inject_event(void)
+{
+    if (irqs_raised) {
+        lower_irqs();
+    }
+
+    for (size_t i = 0; i < fault_count; i++) {
+        fault_t *fault = &faults[i];
+        if (!fault->active) {
+            continue;
+        }
+
+        bool hit = (fault->trigger == TRIGGER_PC)
+                ? pc_reached(fault->value)
+                : (fault->next == machine_steps);
+
+        if (hit) {
+            fire(fault);
+        }
+    }
+
+    schedule_next();
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Deterministic fault injection
+ *
+ */
+
+#ifndef INJECT_H_
+#define INJECT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Machine cycle of the next fault injection check */
+extern uint64_t inject_next;
+
+extern bool inject_start(const char *schedule, const char *log);
+extern void inject_stop(void);
+extern void inject_print(void);
+extern void inject_event(void);
+
+#endif
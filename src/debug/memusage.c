@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Host memory accounting
+ *
+ * The memory is accounted by the owners of the data structures: the
+ * devices report their own memory (guest RAM, disk images, TLBs and
+ * code breakpoints of the processors), the rest of the simulator
+ * (frame tables, memory breakpoints, the decoded instruction caches
+ * shared by all processors of an architecture and the debugging
+ * buffers) is reported as shared.
+ *
+ * The size is the allocated (or configured) size, the resident size
+ * is the part which actually occupies the host memory. Only the guest
+ * RAM and the device images are queried for residency, the heap
+ * structures are considered resident as a whole.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../arch/mmap.h"
+#include "../device/cpu/mips_r4000/cpu.h"
+#include "../device/cpu/riscv_rv32ima/cpu.h"
+#include "../device/cpu/riscv_rv_ima/rv_ima.h"
+#include "../device/device.h"
+#include "../fault.h"
+#include "../physmem.h"
+#include "../replay.h"
+#include "../utils.h"
+#include "breakpoint.h"
+#include "memusage.h"
+#include "profile.h"
+#include "symtab.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+/** Names of the components (used in JSON as well) */
+static const char *const component_names[MEMUSAGE_COUNT] = {
+    [MEMUSAGE_GUEST_RAM] = "guest_ram",
+    [MEMUSAGE_FRAMES] = "frames",
+    [MEMUSAGE_DECODE_CACHE] = "decode_cache",
+    [MEMUSAGE_TLB] = "tlb",
+    [MEMUSAGE_BREAKPOINTS] = "breakpoints",
+    [MEMUSAGE_TRACE] = "trace",
+    [MEMUSAGE_DEVICE_IMAGES] = "device_images"
+};
+
+void memusage_init(memusage_t *usage)
+{
+    memset(usage, 0, sizeof(memusage_t));
+}
+
+/** Account a heap structure (considered resident) */
+void memusage_add(memusage_t *usage, memusage_component_t component,
+        uint64_t size)
+{
+    usage->size[component] += size;
+    usage->resident[component] += size;
+}
+
+/** Account a (possibly sparsely resident) memory range */
+void memusage_add_mapped(memusage_t *usage, memusage_component_t component,
+        const void *ptr, uint64_t size)
+{
+    usage->size[component] += size;
+    usage->resident[component] += mmap_resident(ptr, size);
+}
+
+static void memusage_sum(memusage_t *total, const memusage_t *usage)
+{
+    for (unsigned int i = 0; i < MEMUSAGE_COUNT; i++) {
+        total->size[i] += usage->size[i];
+        total->resident[i] += usage->resident[i];
+    }
+}
+
+static uint64_t memusage_total(const memusage_t *usage, bool resident)
+{
+    uint64_t total = 0;
+
+    for (unsigned int i = 0; i < MEMUSAGE_COUNT; i++) {
+        total += resident ? usage->resident[i] : usage->size[i];
+    }
+
+    return total;
+}
+
+/** Memory not owned by any device */
+static void memusage_shared(memusage_t *usage)
+{
+    memusage_init(usage);
+
+    physmem_memusage(usage);
+    breakpoint_memusage(usage);
+    profile_memusage(usage);
+    replay_memusage(usage);
+    symtab_memusage(usage);
+
+    r4k_cache_memusage(usage);
+    rv_cache_memusage(usage);
+    rv32_cache_memusage(usage);
+    rv64_cache_memusage(usage);
+}
+
+/** Resident set size of the whole process (0 if unknown) */
+static uint64_t memusage_rss(void)
+{
+#ifdef __linux__
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    uint64_t pages;
+    uint64_t resident;
+    int count = fscanf(file, "%" SCNu64 " %" SCNu64, &pages, &resident);
+    fclose(file);
+
+    if (count != 2) {
+        return 0;
+    }
+
+    return resident * (uint64_t) sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
+static void print_text_line(FILE *file, const char *name, uint64_t size,
+        uint64_t resident)
+{
+    fprintf(file, "%-16s %20" PRIu64 " %20" PRIu64 "\n",
+            name, size, resident);
+}
+
+/** Print a member of a JSON object (members are separated by commas) */
+static void print_json_member(FILE *file, const char *name, uint64_t size,
+        uint64_t resident, bool *first)
+{
+    fprintf(file, "%s        \"%s\": { \"size\": %" PRIu64
+                  ", \"resident\": %" PRIu64 " }",
+            *first ? "" : ",\n", name, size, resident);
+    *first = false;
+}
+
+static void print_devices(FILE *file, bool json, memusage_t *total)
+{
+    device_t *dev = NULL;
+    bool first = true;
+
+    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
+        if (dev->type->memusage == NULL) {
+            continue;
+        }
+
+        memusage_t usage;
+        memusage_init(&usage);
+        dev->type->memusage(dev, &usage);
+        memusage_sum(total, &usage);
+
+        if (json) {
+            print_json_member(file, dev->name, memusage_total(&usage, false),
+                    memusage_total(&usage, true), &first);
+        } else {
+            print_text_line(file, dev->name, memusage_total(&usage, false),
+                    memusage_total(&usage, true));
+        }
+    }
+}
+
+/** Print the host memory usage
+ *
+ * @param file Output file.
+ * @param json Print in JSON instead of the human readable tables.
+ *
+ */
+void memusage_print(FILE *file, bool json)
+{
+    memusage_t shared;
+    memusage_t total;
+
+    memusage_shared(&shared);
+    memusage_init(&total);
+
+    uint64_t rss = memusage_rss();
+
+    if (json) {
+        fprintf(file, "{\n    \"devices\": {\n");
+        print_devices(file, true, &total);
+        memusage_sum(&total, &shared);
+
+        fprintf(file, "\n    },\n"
+                      "    \"shared\": { \"size\": %" PRIu64
+                      ", \"resident\": %" PRIu64 " },\n"
+                      "    \"components\": {\n",
+                memusage_total(&shared, false), memusage_total(&shared, true));
+
+        bool first = true;
+        for (unsigned int i = 0; i < MEMUSAGE_COUNT; i++) {
+            print_json_member(file, component_names[i], total.size[i],
+                    total.resident[i], &first);
+        }
+
+        fprintf(file, "\n    },\n"
+                      "    \"total\": { \"size\": %" PRIu64
+                      ", \"resident\": %" PRIu64 " },\n"
+                      "    \"rss\": %" PRIu64 "\n}\n",
+                memusage_total(&total, false), memusage_total(&total, true),
+                rss);
+        return;
+    }
+
+    fprintf(file, "[device        ] [size              ] [resident          ]\n");
+    print_devices(file, false, &total);
+    memusage_sum(&total, &shared);
+
+    print_text_line(file, "(shared)", memusage_total(&shared, false),
+            memusage_total(&shared, true));
+
+    fprintf(file, "[component     ] [size              ] [resident          ]\n");
+    for (unsigned int i = 0; i < MEMUSAGE_COUNT; i++) {
+        print_text_line(file, component_names[i], total.size[i],
+                total.resident[i]);
+    }
+
+    print_text_line(file, "(total)", memusage_total(&total, false),
+            memusage_total(&total, true));
+
+    if (rss != 0) {
+        fprintf(file, "Process RSS: %" PRIu64 " bytes\n", rss);
+    }
+}
+
+/** Write the host memory usage in JSON to a file
+ *
+ * @return True on success.
+ *
+ */
+bool memusage_write(const char *filename)
+{
+    FILE *file = try_fopen(filename, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    memusage_print(file, true);
+    safe_fclose(file, filename);
+
+    return true;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Host memory accounting
+ *
+ */
+
+#ifndef MEMUSAGE_H_
+#define MEMUSAGE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Simulator components accounted separately */
+typedef enum {
+    MEMUSAGE_GUEST_RAM, /**< Contents of the memory devices */
+    MEMUSAGE_FRAMES, /**< Frame descriptors and frame tables */
+    MEMUSAGE_DECODE_CACHE, /**< Decoded instruction caches */
+    MEMUSAGE_TLB, /**< Simulated TLBs */
+    MEMUSAGE_BREAKPOINTS, /**< Code and memory breakpoints */
+    MEMUSAGE_TRACE, /**< Profile, replay, dirty frame and symbol buffers */
+    MEMUSAGE_DEVICE_IMAGES, /**< Disk images */
+    MEMUSAGE_COUNT
+} memusage_component_t;
+
+/** Host memory used by a part of the simulator */
+typedef struct memusage {
+    /** Allocated (or configured) bytes */
+    uint64_t size[MEMUSAGE_COUNT];
+
+    /** Bytes actually resident in the host memory */
+    uint64_t resident[MEMUSAGE_COUNT];
+} memusage_t;
+
+extern void memusage_init(memusage_t *usage);
+extern void memusage_add(memusage_t *usage, memusage_component_t component,
+        uint64_t size);
+extern void memusage_add_mapped(memusage_t *usage,
+        memusage_component_t component, const void *ptr, uint64_t size);
+
+extern void memusage_print(FILE *file, bool json);
+extern bool memusage_write(const char *filename);
+
+#endif
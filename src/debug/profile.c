@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Flat instruction profiler
+ *
+ * The profiler counts how many times each instruction address has been
+ * executed by each processor. The counters are kept in an open addressing
+ * hash table which grows as needed, so the cost of a hit is a few memory
+ * accesses independent of the size of the guest.
+ *
+ * The profiler is active only when the machine_profile variable is set.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../assert.h"
+#include "../main.h"
+#include "../utils.h"
+#include "memusage.h"
+#include "profile.h"
+#include "symtab.h"
+
+/** Initial number of slots in the hash table (power of 2) */
+#define PROFILE_INITIAL_SIZE 4096
+
+typedef struct {
+    uint64_t addr;
+    uint64_t hits;
+    unsigned int cpuno;
+} profile_entry_t;
+
+/** Hash table of the counters */
+static profile_entry_t *table = NULL;
+static size_t table_size = 0;
+static size_t table_used = 0;
+
+/** Total number of hits since the last reset */
+static uint64_t total_hits = 0;
+
+static size_t profile_hash(unsigned int cpuno, uint64_t addr)
+{
+    uint64_t key = (addr >> 2) ^ ((uint64_t) cpuno << 58);
+
+    /* Fibonacci hashing */
+    return (size_t) ((key * UINT64_C(0x9E3779B97F4A7C15)) >> 20);
+}
+
+static profile_entry_t *profile_slot(profile_entry_t *entries, size_t size,
+        unsigned int cpuno, uint64_t addr)
+{
+    size_t mask = size - 1;
+    size_t i = profile_hash(cpuno, addr) & mask;
+
+    while (entries[i].hits != 0) {
+        if ((entries[i].addr == addr) && (entries[i].cpuno == cpuno)) {
+            break;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    return &entries[i];
+}
+
+static void profile_grow(void)
+{
+    size_t new_size = (table_size == 0) ? PROFILE_INITIAL_SIZE : 2 * table_size;
+    profile_entry_t *new_table = safe_malloc(new_size * sizeof(profile_entry_t));
+    memset(new_table, 0, new_size * sizeof(profile_entry_t));
+
+    for (size_t i = 0; i < table_size; i++) {
+        if (table[i].hits != 0) {
+            *profile_slot(new_table, new_size, table[i].cpuno,
+                    table[i].addr)
+                    = table[i];
+        }
+    }
+
+    safe_free(table);
+    table = new_table;
+    table_size = new_size;
+}
+
+/** Count one execution of an instruction
+ *
+ * @param cpuno Processor which executed the instruction.
+ * @param addr  Virtual address of the instruction.
+ *
+ */
+void profile_hit(unsigned int cpuno, uint64_t addr)
+{
+    /* Keep the load factor below 1/2 */
+    if (2 * (table_used + 1) > table_size) {
+        profile_grow();
+    }
+
+    profile_entry_t *entry = profile_slot(table, table_size, cpuno, addr);
+    if (entry->hits == 0) {
+        entry->addr = addr;
+        entry->cpuno = cpuno;
+        table_used++;
+    }
+
+    entry->hits++;
+    total_hits++;
+}
+
+/** Forget all collected counters */
+void profile_reset(void)
+{
+    if (table != NULL) {
+        memset(table, 0, table_size * sizeof(profile_entry_t));
+    }
+
+    table_used = 0;
+    total_hits = 0;
+}
+
+static int profile_compare(const void *a, const void *b)
+{
+    const profile_entry_t *ea = (const profile_entry_t *) a;
+    const profile_entry_t *eb = (const profile_entry_t *) b;
+
+    if (ea->hits != eb->hits) {
+        return (ea->hits < eb->hits) ? 1 : -1;
+    }
+
+    if (ea->cpuno != eb->cpuno) {
+        return (ea->cpuno > eb->cpuno) ? 1 : -1;
+    }
+
+    if (ea->addr != eb->addr) {
+        return (ea->addr > eb->addr) ? 1 : -1;
+    }
+
+    return 0;
+}
+
+/** Print the most frequently executed instructions
+ *
+ * @param count Maximal number of entries to print.
+ *
+ */
+void profile_print(unsigned int count)
+{
+    if (total_hits == 0) {
+        printf("No profile samples collected.\n");
+        return;
+    }
+
+    profile_entry_t *sorted = safe_malloc(table_used * sizeof(profile_entry_t));
+    size_t n = 0;
+
+    for (size_t i = 0; i < table_size; i++) {
+        if (table[i].hits != 0) {
+            sorted[n++] = table[i];
+        }
+    }
+
+    ASSERT(n == table_used);
+    qsort(sorted, n, sizeof(profile_entry_t), profile_compare);
+
+    if (count > n) {
+        count = n;
+    }
+
+    /* The symbol column is shown only when symbols are loaded */
+    bool symbols = !symtab_empty();
+
+    printf("[cpu] [address         ] [hits              ] [share ]%s\n",
+            symbols ? " [symbol]" : "");
+    for (size_t i = 0; i < count; i++) {
+        printf("%5u %#018" PRIx64 " %20" PRIu64 " %6.2f%%",
+                sorted[i].cpuno, sorted[i].addr, sorted[i].hits,
+                100.0 * sorted[i].hits / total_hits);
+
+        uint64_t offset;
+        const char *name = symbols ? symtab_find(sorted[i].addr, &offset) : NULL;
+
+        if (name != NULL) {
+            printf("  %s+%#" PRIx64, name, offset);
+        }
+
+        printf("\n");
+    }
+
+    printf("Total: %" PRIu64 " instructions at %zu addresses\n",
+            total_hits, n);
+
+    safe_free(sorted);
+}
+
+/** Account the hash table of the counters */
+void profile_memusage(memusage_t *usage)
+{
+    memusage_add(usage, MEMUSAGE_TRACE, table_size * sizeof(profile_entry_t));
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Flat instruction profiler
+ *
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+
+/** Number of entries printed at the end of a region of interest */
+#define PROFILE_DEFAULT_COUNT 10
+
+extern void profile_hit(unsigned int cpuno, uint64_t addr);
+extern void profile_reset(void);
+extern void profile_print(unsigned int count);
+
+struct memusage;
+extern void profile_memusage(struct memusage *usage);
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Region of interest markers
+ *
+ * The guest code marks the beginning and the end of the region of interest
+ * (ROI) using special instructions (see XROI/XROE for MIPS and EROIB/EROIE
+ * for RISC-V). Crossing the beginning marker resets the statistics and the
+ * profiler and switches the simulator to the detailed mode. Crossing the
+ * end marker prints the statistics of the region and switches the simulator
+ * to the fast-forward mode.
+ *
+ * In the fast-forward mode the instrumentation (tracing, profiling and
+ * processor statistics) is turned off. The settings are restored when
+ * the simulator switches back to the detailed mode.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "../device/cpu/mips_r4000/cpu.h"
+#include "../device/device.h"
+#include "../device/dr4kcpu.h"
+#include "../fault.h"
+#include "../main.h"
+#include "profile.h"
+#include "roi.h"
+#include "sample.h"
+
+/** Inside of the region of interest */
+static bool roi_active = false;
+
+/** Machine cycle counter at the beginning of the region */
+static uint64_t roi_start = 0;
+
+/** Instrumentation settings saved while in the fast-forward mode */
+static bool saved_trace = false;
+static bool saved_profile = false;
+
+/** Switch between the fast-forward and the detailed mode
+ *
+ * @param fast True to enter the fast-forward mode.
+ *
+ * @return Always true.
+ *
+ */
+bool roi_set_fast(bool fast)
+{
+    if (fast == machine_fast) {
+        return true;
+    }
+
+    if (fast) {
+        saved_trace = machine_trace;
+        saved_profile = machine_profile;
+        machine_trace = false;
+        machine_profile = false;
+    } else {
+        machine_trace = saved_trace;
+        machine_profile = saved_profile;
+    }
+
+    machine_fast = fast;
+    return true;
+}
+
+/** Reset statistics of all processors */
+void roi_reset_stats(void)
+{
+    device_t *dev = NULL;
+    while (dev_next(&dev, DEVICE_FILTER_R4K_PROCESSOR)) {
+        r4k_reset_stats(get_r4k(dev));
+    }
+}
+
+/** Enter the region of interest
+ *
+ * @param cpuno Processor which crossed the marker.
+ *
+ */
+void roi_begin(unsigned int cpuno)
+{
+    roi_set_fast(false);
+    roi_reset_stats();
+    profile_reset();
+
+    roi_active = true;
+    roi_start = machine_steps;
+
+    sample_roi_begin();
+}
+
+/** Leave the region of interest
+ *
+ * @param cpuno Processor which crossed the marker.
+ *
+ */
+void roi_end(unsigned int cpuno)
+{
+    if (!roi_active) {
+        alert("ROI: End marker outside of the region of interest");
+        return;
+    }
+
+    sample_roi_end();
+
+    printf("ROI: %" PRIu64 " cycles (cpu%u)\n", machine_steps - roi_start,
+            cpuno);
+
+    if (machine_profile) {
+        profile_print(PROFILE_DEFAULT_COUNT);
+    }
+
+    roi_active = false;
+    roi_set_fast(true);
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Region of interest markers
+ *
+ */
+
+#ifndef ROI_H_
+#define ROI_H_
+
+#include <stdbool.h>
+
+extern void roi_begin(unsigned int cpuno);
+extern void roi_end(unsigned int cpuno);
+
+extern bool roi_set_fast(bool fast);
+extern void roi_reset_stats(void);
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Sampled simulation
+ *
+ * The simulation runs in the fast-forward mode (see roi.c) until
+ * a trigger is reached. The trigger is either a machine cycle,
+ * an instruction address or the beginning of the region of interest.
+ *
+ * After the trigger the statistics and the profiler are reset and
+ * the simulation continues in the detailed mode. Optionally, the
+ * detailed mode is used only in periodic windows (a window of detail
+ * cycles every period cycles) and the rest of the time is fast-forwarded.
+ * The statistics and the profile are then accumulated over all windows.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../fault.h"
+#include "../main.h"
+#include "profile.h"
+#include "roi.h"
+#include "sample.h"
+
+/** Machine cycle of the next sampling event */
+uint64_t sample_next = UINT64_MAX;
+
+/** Instruction address which ends the fast-forward phase */
+bool sample_pc_armed = false;
+uint64_t sample_pc = 0;
+
+/** Pending trigger */
+static sample_trigger_t sample_trigger = SAMPLE_TRIGGER_NONE;
+
+/** Sampling windows configuration (zero detail means no windows) */
+static uint64_t window_detail = 0;
+static uint64_t window_period = 0;
+
+/** Sampling windows state */
+static bool windows_running = false;
+static bool window_open = false;
+static uint64_t window_start = 0;
+
+static void sample_window_begin(void)
+{
+    window_open = true;
+    window_start = machine_steps;
+    sample_next = machine_steps + window_detail;
+    roi_set_fast(false);
+}
+
+static void sample_window_end(void)
+{
+    window_open = false;
+    sample_next = window_start + window_period;
+    roi_set_fast(true);
+}
+
+static void sample_windows_stop(void)
+{
+    windows_running = false;
+    window_open = false;
+    sample_next = UINT64_MAX;
+}
+
+/** The trigger has been reached, start the detailed simulation */
+static void sample_triggered(void)
+{
+    alert("Sample: Detailed simulation from cycle %" PRIu64, machine_steps);
+
+    sample_trigger = SAMPLE_TRIGGER_NONE;
+    sample_pc_armed = false;
+    sample_next = UINT64_MAX;
+
+    roi_reset_stats();
+    profile_reset();
+
+    if (window_detail > 0) {
+        windows_running = true;
+        sample_window_begin();
+    } else {
+        roi_set_fast(false);
+    }
+}
+
+/** Fast-forward the simulation until a trigger
+ *
+ * @param trigger Event which ends the fast-forward phase.
+ *                SAMPLE_TRIGGER_NONE cancels the fast-forward.
+ * @param value   Machine cycle or instruction address of the trigger.
+ *
+ */
+void sample_fast_forward(sample_trigger_t trigger, uint64_t value)
+{
+    sample_windows_stop();
+
+    sample_trigger = trigger;
+    sample_pc_armed = false;
+
+    switch (trigger) {
+    case SAMPLE_TRIGGER_NONE:
+        roi_set_fast(false);
+        return;
+    case SAMPLE_TRIGGER_CYCLE:
+        if (value <= machine_steps) {
+            sample_triggered();
+            return;
+        }
+        sample_next = value;
+        break;
+    case SAMPLE_TRIGGER_PC:
+        sample_pc = value;
+        sample_pc_armed = true;
+        break;
+    case SAMPLE_TRIGGER_ROI:
+        break;
+    }
+
+    roi_set_fast(true);
+}
+
+/** Configure the sampling windows
+ *
+ * @param detail Length of the detailed window in cycles
+ *               (zero disables the windows).
+ * @param period Distance of the beginnings of two windows in cycles.
+ *
+ */
+void sample_set_windows(uint64_t detail, uint64_t period)
+{
+    window_detail = detail;
+    window_period = period;
+}
+
+/** Handle the sampling event scheduled at the current machine cycle */
+void sample_event(void)
+{
+    if (sample_trigger == SAMPLE_TRIGGER_CYCLE) {
+        sample_triggered();
+        return;
+    }
+
+    if (!windows_running) {
+        sample_next = UINT64_MAX;
+        return;
+    }
+
+    if (window_open) {
+        sample_window_end();
+    } else {
+        sample_window_begin();
+    }
+}
+
+/** Handle an instruction address trigger
+ *
+ * @param cpuno Processor which reached the trigger address.
+ *
+ */
+void sample_hit_pc(unsigned int cpuno)
+{
+    if (sample_trigger == SAMPLE_TRIGGER_PC) {
+        sample_triggered();
+    }
+}
+
+/** Handle the beginning of the region of interest */
+void sample_roi_begin(void)
+{
+    if (sample_trigger == SAMPLE_TRIGGER_ROI) {
+        sample_triggered();
+    }
+}
+
+/** Handle the end of the region of interest */
+void sample_roi_end(void)
+{
+    sample_windows_stop();
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Sampled simulation
+ *
+ */
+
+#ifndef SAMPLE_H_
+#define SAMPLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Events which end the fast-forward phase */
+typedef enum {
+    SAMPLE_TRIGGER_NONE,
+    SAMPLE_TRIGGER_CYCLE,
+    SAMPLE_TRIGGER_PC,
+    SAMPLE_TRIGGER_ROI
+} sample_trigger_t;
+
+/** Machine cycle of the next sampling event */
+extern uint64_t sample_next;
+
+/** Instruction address which ends the fast-forward phase */
+extern bool sample_pc_armed;
+extern uint64_t sample_pc;
+
+extern void sample_fast_forward(sample_trigger_t trigger, uint64_t value);
+extern void sample_set_windows(uint64_t detail, uint64_t period);
+
+extern void sample_event(void);
+extern void sample_hit_pc(unsigned int cpuno);
+extern void sample_roi_begin(void);
+extern void sample_roi_end(void);
+
+#endif
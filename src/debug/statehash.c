@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Periodic state hashing
+ *
+ * Every interval cycles the architectural state of all processors and
+ * the contents of the memory frames written during the interval are
+ * hashed and written to a log. Two logs of the same configuration
+ * should be identical as long as the simulation is deterministic,
+ * so comparing them finds the first interval where two runs (e.g.
+ * before and after a change of the simulator) diverge.
+ *
+ * The log is a text file with one record per line (all numbers
+ * except the cycle and the processor number are hexadecimal):
+ *
+ *   interval <cycles>
+ *   <cycle> cpu <no> <hash> <pc> <reg0> ... <reg31>
+ *   <cycle> page <addr> <hash>
+ *
+ * The processor records contain the program counter and the general
+ * purpose registers verbatim and a hash of the rest of the architectural
+ * state. The page records are sorted by the physical address.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../assert.h"
+#include "../device/cpu/general_cpu.h"
+#include "../fault.h"
+#include "../main.h"
+#include "../physmem.h"
+#include "../utils.h"
+#include "statehash.h"
+
+/** Header of the log file */
+#define STATEHASH_HEADER "# MSIM state hash log"
+
+/** Maximal length of a log line */
+#define STATEHASH_LINE_LENGTH 1024
+
+/** Machine cycle of the next state hash */
+uint64_t statehash_next = UINT64_MAX;
+
+/** Hashing interval */
+static uint64_t statehash_interval = 0;
+
+/** Log file */
+static FILE *log_file = NULL;
+static char *log_name = NULL;
+
+typedef enum {
+    RECORD_CPU,
+    RECORD_PAGE
+} record_type_t;
+
+/** Parsed log record */
+typedef struct {
+    uint64_t cycle;
+    record_type_t type;
+
+    /** Processor number or page address */
+    uint64_t key;
+
+    /** Processor state (only the hash is used for pages) */
+    cpu_state_t state;
+} record_t;
+
+/** Start periodic state hashing
+ *
+ * @param filename Name of the log file.
+ * @param interval Number of cycles between two hashes.
+ *
+ * @return True if the log file has been created.
+ *
+ */
+bool statehash_start(const char *filename, uint64_t interval)
+{
+    ASSERT(filename != NULL);
+    ASSERT(interval > 0);
+
+    statehash_stop();
+
+    log_file = try_fopen(filename, "w");
+    if (log_file == NULL) {
+        return false;
+    }
+
+    log_name = safe_strdup(filename);
+    statehash_interval = interval;
+    statehash_next = machine_steps + interval;
+
+    fprintf(log_file, "%s\n", STATEHASH_HEADER);
+    fprintf(log_file, "interval %" PRIu64 "\n", interval);
+
+    physmem_dirty_tracking(true);
+    return true;
+}
+
+/** Stop periodic state hashing */
+void statehash_stop(void)
+{
+    if (log_file != NULL) {
+        safe_fclose(log_file, log_name);
+        log_file = NULL;
+        safe_free(log_name);
+        physmem_dirty_tracking(false);
+    }
+
+    statehash_next = UINT64_MAX;
+}
+
+static int frame_compare(const void *a, const void *b)
+{
+    ptr36_t fa = *((const ptr36_t *) a);
+    ptr36_t fb = *((const ptr36_t *) b);
+
+    if (fa == fb) {
+        return 0;
+    }
+
+    return (fa > fb) ? 1 : -1;
+}
+
+/** Hash the state at the end of an interval */
+void statehash_event(void)
+{
+    ASSERT(log_file != NULL);
+
+    for (unsigned int i = 0; i < MAX_CPUS; i++) {
+        general_cpu_t *cpu = get_cpu(i);
+        if (cpu == NULL) {
+            continue;
+        }
+
+        cpu_state_t state;
+        cpu_state(cpu, &state);
+
+        fprintf(log_file, "%" PRIu64 " cpu %u %016" PRIx64 " %" PRIx64,
+                machine_steps, i, state.hash, state.pc);
+
+        for (unsigned int reg = 0; reg < CPU_STATE_REGS; reg++) {
+            fprintf(log_file, " %" PRIx64, state.regs[reg]);
+        }
+
+        fprintf(log_file, "\n");
+    }
+
+    ptr36_t *frames;
+    size_t count = physmem_dirty_collect(&frames);
+    qsort(frames, count, sizeof(ptr36_t), frame_compare);
+
+    for (size_t i = 0; i < count; i++) {
+        frame_t *frame = physmem_find_frame(frames[i]);
+        if (frame == NULL) {
+            continue;
+        }
+
+        fprintf(log_file, "%" PRIu64 " page 0x%09" PRIx64 " %016" PRIx64 "\n",
+                machine_steps, frames[i],
+                hash64(frame->data, FRAME_SIZE, 0));
+    }
+
+    statehash_next += statehash_interval;
+}
+
+static bool parse_number(char **str, int base, uint64_t *val)
+{
+    char *endp;
+    *val = strtoull(*str, &endp, base);
+
+    if (endp == *str) {
+        return false;
+    }
+
+    *str = endp;
+    return true;
+}
+
+/** Read the next record of a log
+ *
+ * @param file     Log file.
+ * @param filename Name of the log file.
+ * @param record   Record to fill in.
+ *
+ * @return False on the end of the file or an error.
+ *
+ */
+static bool read_record(FILE *file, const char *filename, record_t *record)
+{
+    char line[STATEHASH_LINE_LENGTH];
+    memset(record, 0, sizeof(record_t));
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if ((line[0] == '#') || (line[0] == '\n') || (prefix("interval", line))) {
+            continue;
+        }
+
+        char *str = line;
+        char kind[8];
+        int pos = 0;
+
+        if ((!parse_number(&str, 10, &record->cycle))
+                || (sscanf(str, "%7s%n", kind, &pos) != 1)) {
+            break;
+        }
+
+        str += pos;
+
+        if (strcmp(kind, "cpu") == 0) {
+            record->type = RECORD_CPU;
+
+            bool ok = parse_number(&str, 10, &record->key)
+                    && parse_number(&str, 16, &record->state.hash)
+                    && parse_number(&str, 16, &record->state.pc);
+
+            for (unsigned int i = 0; (ok) && (i < CPU_STATE_REGS); i++) {
+                ok = parse_number(&str, 16, &record->state.regs[i]);
+            }
+
+            if (ok) {
+                return true;
+            }
+        } else if (strcmp(kind, "page") == 0) {
+            record->type = RECORD_PAGE;
+
+            if ((parse_number(&str, 16, &record->key))
+                    && (parse_number(&str, 16, &record->state.hash))) {
+                return true;
+            }
+        }
+
+        break;
+    }
+
+    if (ferror(file)) {
+        io_error(filename);
+    } else if (!feof(file)) {
+        error("Malformed record in %s", filename);
+    }
+
+    return false;
+}
+
+/** Order of the records in a log */
+static int record_compare(const record_t *a, const record_t *b)
+{
+    if (a->cycle != b->cycle) {
+        return (a->cycle > b->cycle) ? 1 : -1;
+    }
+
+    if (a->type != b->type) {
+        return (a->type > b->type) ? 1 : -1;
+    }
+
+    if (a->key != b->key) {
+        return (a->key > b->key) ? 1 : -1;
+    }
+
+    return 0;
+}
+
+static void print_record(const record_t *record)
+{
+    if (record->type == RECORD_CPU) {
+        printf("cpu%" PRIu64, record->key);
+    } else {
+        printf("page 0x%09" PRIx64, record->key);
+    }
+}
+
+/** Describe the difference of two matching records */
+static void print_difference(const record_t *a, const record_t *b)
+{
+    print_record(a);
+
+    if (a->type == RECORD_PAGE) {
+        printf(": contents differ\n");
+        return;
+    }
+
+    if (a->state.pc != b->state.pc) {
+        printf(": pc %#" PRIx64 " vs. %#" PRIx64 "\n",
+                a->state.pc, b->state.pc);
+        return;
+    }
+
+    for (unsigned int i = 0; i < CPU_STATE_REGS; i++) {
+        if (a->state.regs[i] != b->state.regs[i]) {
+            printf(": register %u %#" PRIx64 " vs. %#" PRIx64 "\n",
+                    i, a->state.regs[i], b->state.regs[i]);
+            return;
+        }
+    }
+
+    printf(": system state (system registers, TLB, etc.) differs\n");
+}
+
+/** Compare two state hash logs
+ *
+ * Print the first interval where the logs differ.
+ *
+ * @param filename1 First log file.
+ * @param filename2 Second log file.
+ *
+ * @return False if the logs could not be read.
+ *
+ */
+bool statehash_compare(const char *filename1, const char *filename2)
+{
+    ASSERT(filename1 != NULL);
+    ASSERT(filename2 != NULL);
+
+    FILE *file1 = try_fopen(filename1, "r");
+    if (file1 == NULL) {
+        return false;
+    }
+
+    FILE *file2 = try_fopen(filename2, "r");
+    if (file2 == NULL) {
+        safe_fclose(file1, filename1);
+        return false;
+    }
+
+    uint64_t interval_start = 0;
+    uint64_t interval_end = 0;
+    uint64_t intervals = 0;
+
+    while (true) {
+        record_t rec1;
+        record_t rec2;
+
+        bool ok1 = read_record(file1, filename1, &rec1);
+        bool ok2 = read_record(file2, filename2, &rec2);
+
+        if ((!ok1) && (!ok2)) {
+            printf("No divergence in %" PRIu64 " intervals\n", intervals);
+            break;
+        }
+
+        if ((!ok1) || (!ok2)) {
+            printf("%s ends at cycle %" PRIu64 "\n",
+                    ok1 ? filename2 : filename1, interval_end);
+            break;
+        }
+
+        uint64_t cycle = (rec1.cycle < rec2.cycle) ? rec1.cycle : rec2.cycle;
+        if (cycle != interval_end) {
+            interval_start = interval_end;
+            interval_end = cycle;
+            intervals++;
+        }
+
+        int cmp = record_compare(&rec1, &rec2);
+        if ((cmp == 0) && (memcmp(&rec1.state, &rec2.state, sizeof(cpu_state_t)) == 0)) {
+            continue;
+        }
+
+        printf("First divergence between cycles %" PRIu64 " and %" PRIu64 "\n",
+                interval_start, interval_end);
+
+        if (cmp == 0) {
+            print_difference(&rec1, &rec2);
+        } else {
+            /* The smaller record is missing in the other log */
+            print_record((cmp < 0) ? &rec1 : &rec2);
+            printf(" only in %s\n", (cmp < 0) ? filename1 : filename2);
+        }
+
+        break;
+    }
+
+    safe_fclose(file1, filename1);
+    safe_fclose(file2, filename2);
+
+    return true;
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Periodic state hashing
+ *
+ */
+
+#ifndef STATEHASH_H_
+#define STATEHASH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Machine cycle of the next state hash */
+extern uint64_t statehash_next;
+
+extern bool statehash_start(const char *filename, uint64_t interval);
+extern void statehash_stop(void);
+extern void statehash_event(void);
+
+extern bool statehash_compare(const char *filename1, const char *filename2);
+
+#endif
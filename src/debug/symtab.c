@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Guest symbol table
+ *
+ * Symbols are imported by the elf load command and used by the
+ * instruction dumps, traces, breakpoints and the profiler to show
+ * names instead of raw addresses.
+ *
+ * The symbols are kept in an array sorted by their (virtual) address,
+ * so a lookup is a binary search. The regions map the physical
+ * addresses of the loaded segments to their virtual addresses, which
+ * allows to name physical addresses as well.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../assert.h"
+#include "../fault.h"
+#include "../utils.h"
+#include "memusage.h"
+#include "symtab.h"
+
+typedef struct {
+    uint64_t addr;
+    uint64_t size;
+    char *name;
+} symbol_t;
+
+typedef struct {
+    ptr36_t phys;
+    uint64_t virt;
+    len36_t size;
+} region_t;
+
+static symbol_t *symbols = NULL;
+static size_t symbols_count = 0;
+static size_t symbols_size = 0;
+
+/** The array is sorted lazily before the first lookup */
+static bool symbols_sorted = true;
+
+static region_t *regions = NULL;
+static size_t regions_count = 0;
+
+/** Add a symbol
+ *
+ * @param addr Virtual address of the symbol.
+ * @param size Size of the symbol (0 if unknown).
+ * @param name Name of the symbol (copied).
+ *
+ */
+void symtab_add(uint64_t addr, uint64_t size, const char *name)
+{
+    ASSERT(name != NULL);
+
+    if (symbols_count == symbols_size) {
+        symbols_size = (symbols_size == 0) ? 256 : 2 * symbols_size;
+        symbols = realloc(symbols, symbols_size * sizeof(symbol_t));
+        if (symbols == NULL) {
+            die(ERR_MEM, "Not enough memory");
+        }
+    }
+
+    symbols[symbols_count].addr = addr;
+    symbols[symbols_count].size = size;
+    symbols[symbols_count].name = safe_strdup(name);
+    symbols_count++;
+
+    symbols_sorted = false;
+}
+
+/** Add a mapping between the physical and virtual addresses
+ *
+ * @param phys Physical address of the region.
+ * @param virt Virtual address of the region.
+ * @param size Size of the region.
+ *
+ */
+void symtab_add_region(ptr36_t phys, uint64_t virt, len36_t size)
+{
+    regions = realloc(regions, (regions_count + 1) * sizeof(region_t));
+    if (regions == NULL) {
+        die(ERR_MEM, "Not enough memory");
+    }
+
+    regions[regions_count].phys = phys;
+    regions[regions_count].virt = virt;
+    regions[regions_count].size = size;
+    regions_count++;
+}
+
+/** Remove all symbols and regions */
+void symtab_clear(void)
+{
+    for (size_t i = 0; i < symbols_count; i++) {
+        safe_free(symbols[i].name);
+    }
+
+    safe_free(symbols);
+    safe_free(regions);
+
+    symbols_count = 0;
+    symbols_size = 0;
+    symbols_sorted = true;
+    regions_count = 0;
+}
+
+/** Account the symbol table */
+void symtab_memusage(memusage_t *usage)
+{
+    memusage_add(usage, MEMUSAGE_TRACE, symbols_size * sizeof(symbol_t)
+                    + regions_count * sizeof(region_t));
+
+    for (size_t i = 0; i < symbols_count; i++) {
+        memusage_add(usage, MEMUSAGE_TRACE, strlen(symbols[i].name) + 1);
+    }
+}
+
+/** Check whether any symbols are loaded */
+bool symtab_empty(void)
+{
+    return symbols_count == 0;
+}
+
+/** Order by address, prefer the sized symbols at the same address */
+static int symtab_compare(const void *a, const void *b)
+{
+    const symbol_t *sa = (const symbol_t *) a;
+    const symbol_t *sb = (const symbol_t *) b;
+
+    if (sa->addr != sb->addr) {
+        return (sa->addr < sb->addr) ? -1 : 1;
+    }
+
+    if (sa->size != sb->size) {
+        return (sa->size > sb->size) ? -1 : 1;
+    }
+
+    return strcmp(sa->name, sb->name);
+}
+
+static void symtab_sort(void)
+{
+    if (!symbols_sorted) {
+        qsort(symbols, symbols_count, sizeof(symbol_t), symtab_compare);
+        symbols_sorted = true;
+    }
+}
+
+static const region_t *region_by_virt(uint64_t addr)
+{
+    for (size_t i = 0; i < regions_count; i++) {
+        if ((addr >= regions[i].virt) && (addr - regions[i].virt < regions[i].size)) {
+            return &regions[i];
+        }
+    }
+
+    return NULL;
+}
+
+static const region_t *region_by_phys(ptr36_t addr)
+{
+    for (size_t i = 0; i < regions_count; i++) {
+        if ((addr >= regions[i].phys) && (addr - regions[i].phys < regions[i].size)) {
+            return &regions[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** Find the symbol containing an address
+ *
+ * Symbols without a size (e.g. assembler labels) extend up to the next
+ * symbol within the same region.
+ *
+ * @param addr   Virtual address.
+ * @param offset Returned offset of the address from the symbol (may be
+ *               NULL).
+ *
+ * @return Name of the symbol or NULL.
+ *
+ */
+const char *symtab_find(uint64_t addr, uint64_t *offset)
+{
+    if (symbols_count == 0) {
+        return NULL;
+    }
+
+    symtab_sort();
+
+    /* Find the last symbol at or below the address */
+    size_t lo = 0;
+    size_t hi = symbols_count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (symbols[mid].addr <= addr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == 0) {
+        return NULL;
+    }
+
+    /* The preferred symbol is the first one at the same address */
+    size_t i = lo - 1;
+    while ((i > 0) && (symbols[i - 1].addr == symbols[i].addr)) {
+        i--;
+    }
+
+    const symbol_t *symbol = &symbols[i];
+
+    if (symbol->size > 0) {
+        if (addr - symbol->addr >= symbol->size) {
+            return NULL;
+        }
+    } else if (regions_count > 0) {
+        const region_t *region = region_by_virt(symbol->addr);
+
+        if ((region == NULL) || (region != region_by_virt(addr))) {
+            return NULL;
+        }
+    }
+
+    if (offset != NULL) {
+        *offset = addr - symbol->addr;
+    }
+
+    return symbol->name;
+}
+
+/** Find the symbol containing a physical address
+ *
+ * @see symtab_find
+ *
+ */
+const char *symtab_find_phys(ptr36_t addr, uint64_t *offset)
+{
+    const region_t *region = region_by_phys(addr);
+
+    if (region == NULL) {
+        return NULL;
+    }
+
+    return symtab_find(region->virt + (addr - region->phys), offset);
+}
+
+/** Get the name of a symbol starting exactly at an address
+ *
+ * @return Name of the symbol or NULL.
+ *
+ */
+const char *symtab_label(uint64_t addr)
+{
+    uint64_t offset;
+    const char *name = symtab_find(addr, &offset);
+
+    return ((name != NULL) && (offset == 0)) ? name : NULL;
+}
+
+/** Get the name of a symbol starting exactly at a physical address */
+const char *symtab_label_phys(ptr36_t addr)
+{
+    uint64_t offset;
+    const char *name = symtab_find_phys(addr, &offset);
+
+    return ((name != NULL) && (offset == 0)) ? name : NULL;
+}
+
+/** Find the address of a symbol by its name
+ *
+ * @return False if there is no such symbol.
+ *
+ */
+bool symtab_lookup(const char *name, uint64_t *addr)
+{
+    ASSERT(name != NULL);
+    ASSERT(addr != NULL);
+
+    for (size_t i = 0; i < symbols_count; i++) {
+        if (strcmp(symbols[i].name, name) == 0) {
+            *addr = symbols[i].addr;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** Find the physical address of a symbol by its name
+ *
+ * @return False if there is no such symbol or it is not
+ *         in a loaded segment.
+ *
+ */
+bool symtab_lookup_phys(const char *name, ptr36_t *addr)
+{
+    uint64_t virt;
+
+    if (!symtab_lookup(name, &virt)) {
+        return false;
+    }
+
+    const region_t *region = region_by_virt(virt);
+
+    if (region == NULL) {
+        return false;
+    }
+
+    *addr = region->phys + (virt - region->virt);
+    return true;
+}
+
+/** Get an address command parameter
+ *
+ * The parameter is either a number or a name of a symbol.
+ * Errors are reported to the user.
+ *
+ * @param parm Parameter token.
+ * @param phys Return the physical address of the symbol.
+ * @param addr Returned address.
+ *
+ * @return False if the symbol is not known.
+ *
+ */
+bool symtab_parm_addr(token_t *parm, bool phys, uint64_t *addr)
+{
+    if (parm_type(parm) == tt_uint) {
+        *addr = parm_uint(parm);
+        return true;
+    }
+
+    const char *name = parm_str(parm);
+    bool found = phys ? symtab_lookup_phys(name, addr) : symtab_lookup(name, addr);
+
+    if (!found) {
+        error("Unknown symbol \"%s\"", name);
+        return false;
+    }
+
+    return true;
+}
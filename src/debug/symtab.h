@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Guest symbol table
+ *
+ */
+
+#ifndef SYMTAB_H_
+#define SYMTAB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../main.h"
+#include "../parser.h"
+
+extern void symtab_add(uint64_t addr, uint64_t size, const char *name);
+extern void symtab_add_region(ptr36_t phys, uint64_t virt, len36_t size);
+extern void symtab_clear(void);
+
+struct memusage;
+extern void symtab_memusage(struct memusage *usage);
+
+extern bool symtab_empty(void);
+extern const char *symtab_find(uint64_t addr, uint64_t *offset);
+extern const char *symtab_find_phys(ptr36_t addr, uint64_t *offset);
+extern const char *symtab_label(uint64_t addr);
+extern const char *symtab_label_phys(ptr36_t addr);
+extern bool symtab_lookup(const char *name, uint64_t *addr);
+extern bool symtab_lookup_phys(const char *name, ptr36_t *addr);
+
+extern bool symtab_parm_addr(token_t *parm, bool phys, uint64_t *addr);
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Instruction cost model
+ *
+ * Without the model every instruction takes one cycle. With the model
+ * enabled, the instructions of the classes below take extra cycles:
+ *
+ *  - multiplications and divisions (latency of the unit),
+ *  - instructions reading the destination register of the immediately
+ *    preceding load (load-use interlock),
+ *  - conditional branches mispredicted by a bimodal predictor
+ *    (a table of two-bit counters indexed by the branch address),
+ *  - atomic memory operations (AMOs, LR/SC, LL/SC),
+ *  - CSR and CP0 accesses (pipeline serialization).
+ *
+ * The extra cycles are spent as stall cycles of the processor, which
+ * are machine cycles as any other, so the cycle counters of the
+ * processor, its timer and the devices counting the machine cycles
+ * all observe them.
+ *
+ * The state of the model (the predictor, the pending stall cycles and
+ * the statistics) is allocated when the model is enabled and released
+ * when it is disabled.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../assert.h"
+#include "../../fault.h"
+#include "../../parser.h"
+#include "../../utils.h"
+#include "cost.h"
+
+/** Names of the instruction classes in the cost command */
+static const char *cost_names[COST_CLASS_COUNT] = {
+    "mul",
+    "div",
+    "loaduse",
+    "mispredict",
+    "amo",
+    "csr"
+};
+
+/** Default extra cycles of a simple in-order pipeline */
+static const unsigned int cost_defaults[COST_CLASS_COUNT] = {
+    4, /* mul */
+    32, /* div */
+    1, /* loaduse */
+    3, /* mispredict */
+    4, /* amo */
+    2 /* csr */
+};
+
+/** Predictor counter value from which branches are predicted taken */
+#define PREDICT_TAKEN 2
+
+/** Maximal predictor counter value */
+#define PREDICT_MAX 3
+
+/** Maximal extra cycles of an instruction class */
+#define COST_MAX_CYCLES 1000000
+
+/** Initialize a disabled cost model with the default costs
+ *
+ */
+void cost_init(cpu_cost_t *cost)
+{
+    ASSERT(cost != NULL);
+
+    memset(cost, 0, sizeof(cpu_cost_t));
+    memcpy(cost->cycles, cost_defaults, sizeof(cost->cycles));
+}
+
+/** Release the state of an enabled cost model
+ *
+ * The pending stall cycles are dropped.
+ *
+ */
+void cost_done(cpu_cost_t *cost)
+{
+    ASSERT(cost != NULL);
+
+    safe_free(cost->model);
+}
+
+/** Enable the cost model
+ *
+ */
+static void cost_enable(cpu_cost_t *cost)
+{
+    ASSERT(cost != NULL);
+
+    if (cost->model != NULL) {
+        return;
+    }
+
+    cost_model_t *model = safe_malloc_t(cost_model_t);
+    memset(model, 0, sizeof(cost_model_t));
+
+    /* Weakly not taken */
+    memset(model->predictor, PREDICT_TAKEN - 1, sizeof(model->predictor));
+
+    cost->model = model;
+}
+
+/** Charge the extra cycles of an instruction class
+ *
+ */
+void cost_charge(cpu_cost_t *cost, cost_class_t cls)
+{
+    ASSERT(cost != NULL);
+    ASSERT(cost->model != NULL);
+    ASSERT(cls < COST_CLASS_COUNT);
+
+    cost->model->events[cls]++;
+    cost->model->stall += cost->cycles[cls];
+}
+
+/** Predict a conditional branch and update the predictor
+ *
+ * @param cost  Cost model.
+ * @param pc    Address of the branch.
+ * @param taken Whether the branch has been taken.
+ *
+ */
+void cost_branch(cpu_cost_t *cost, uint64_t pc, bool taken)
+{
+    ASSERT(cost != NULL);
+    ASSERT(cost->model != NULL);
+
+    /* The lowest bit is zero even with the compressed instructions */
+    uint8_t *counter = &cost->model->predictor[(pc >> 1) % COST_PREDICTOR_SIZE];
+    bool predicted = (*counter >= PREDICT_TAKEN);
+
+    cost->model->branches++;
+
+    if (predicted != taken) {
+        cost_charge(cost, COST_MISPREDICT);
+    }
+
+    if ((taken) && (*counter < PREDICT_MAX)) {
+        (*counter)++;
+    } else if ((!taken) && (*counter > 0)) {
+        (*counter)--;
+    }
+}
+
+/** Print the costs and the statistics of the enabled model
+ *
+ */
+static void cost_print(cpu_cost_t *cost)
+{
+    cost_model_t *model = cost->model;
+
+    if (model == NULL) {
+        printf("Cost model disabled, stall cycles: %" PRIu64 "\n",
+                cost->stalled);
+        printf("[Class     ] [Cycles]\n");
+
+        for (unsigned int i = 0; i < COST_CLASS_COUNT; i++) {
+            printf("%-12s %8u\n", cost_names[i], cost->cycles[i]);
+        }
+
+        return;
+    }
+
+    printf("Cost model enabled, stall cycles: %" PRIu64 ", conditional branches: %" PRIu64 "\n",
+            cost->stalled, model->branches);
+    printf("[Class     ] [Cycles] [Events            ]\n");
+
+    for (unsigned int i = 0; i < COST_CLASS_COUNT; i++) {
+        printf("%-12s %8u %20" PRIu64 "\n", cost_names[i], cost->cycles[i],
+                model->events[i]);
+    }
+}
+
+/** Cost command implementation
+ *
+ * Without parameters the model is printed, "on" and "off" enable
+ * and disable it and a class name with a number sets the extra
+ * cycles of the class (also while the model is disabled).
+ *
+ */
+bool cost_cmd(cpu_cost_t *cost, token_t *parm)
+{
+    ASSERT(cost != NULL);
+
+    if (parm_type(parm) == tt_end) {
+        cost_print(cost);
+        return true;
+    }
+
+    const char *name = parm_str_next(&parm);
+
+    if (strcmp(name, "on") == 0) {
+        cost_enable(cost);
+        return true;
+    }
+
+    if (strcmp(name, "off") == 0) {
+        cost_done(cost);
+        return true;
+    }
+
+    for (unsigned int i = 0; i < COST_CLASS_COUNT; i++) {
+        if (strcmp(name, cost_names[i]) != 0) {
+            continue;
+        }
+
+        if (parm_type(parm) != tt_uint) {
+            error("Number of cycles expected");
+            return false;
+        }
+
+        uint64_t cycles = parm_uint(parm);
+        if (cycles > COST_MAX_CYCLES) {
+            error("Number of cycles out of range (0..%u)", COST_MAX_CYCLES);
+            return false;
+        }
+
+        cost->cycles[i] = (unsigned int) cycles;
+        return true;
+    }
+
+    error("Expected on, off, mul, div, loaduse, mispredict, amo or csr");
+    return false;
+}
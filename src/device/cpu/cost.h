@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Instruction cost model
+ *
+ */
+
+#ifndef COST_H_
+#define COST_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../../parser.h"
+
+/** Number of the branch predictor entries */
+#define COST_PREDICTOR_SIZE 1024
+
+/** Instruction classes with extra cycles */
+typedef enum {
+    COST_MUL, /**< Multiplication */
+    COST_DIV, /**< Division and remainder */
+    COST_LOAD_USE, /**< Use of the result of the previous load */
+    COST_MISPREDICT, /**< Mispredicted conditional branch */
+    COST_AMO, /**< Atomic memory operation */
+    COST_CSR, /**< CSR or CP0 access */
+    COST_CLASS_COUNT
+} cost_class_t;
+
+/** State of an enabled cost model
+ *
+ * Allocated only while the model is enabled, a processor without
+ * the model does not carry the predictor in its structure.
+ *
+ */
+typedef struct {
+    /** Destination register of the previous load (zero if none) */
+    unsigned int load_reg;
+
+    /** Remaining stall cycles */
+    uint64_t stall;
+
+    /** Statistics */
+    uint64_t events[COST_CLASS_COUNT];
+    uint64_t branches;
+
+    /** Bimodal predictor (two-bit saturating counters) */
+    uint8_t predictor[COST_PREDICTOR_SIZE];
+} cost_model_t;
+
+/** Cost model of a processor
+ *
+ * The extra cycles of an instruction are spent as stall cycles
+ * after the instruction, when the processor does not execute
+ * but its cycle counters and timers advance.
+ *
+ * The model pointer is the only field read by a processor step
+ * while the model is disabled.
+ *
+ */
+typedef struct {
+    /** Enabled model (NULL if disabled) */
+    cost_model_t *model;
+
+    /** Spent stall cycles (kept when the model is disabled) */
+    uint64_t stalled;
+
+    /** Extra cycles of the instruction classes */
+    unsigned int cycles[COST_CLASS_COUNT];
+} cpu_cost_t;
+
+extern void cost_init(cpu_cost_t *cost);
+extern void cost_done(cpu_cost_t *cost);
+extern void cost_charge(cpu_cost_t *cost, cost_class_t cls);
+extern void cost_branch(cpu_cost_t *cost, uint64_t pc, bool taken);
+extern bool cost_cmd(cpu_cost_t *cost, token_t *parm);
+
+/** Spend a stall cycle of an enabled model
+ *
+ * @return True if the processor is stalled in this cycle.
+ *
+ */
+static inline bool cost_stalled(cpu_cost_t *cost)
+{
+    if (cost->model->stall == 0) {
+        return false;
+    }
+
+    cost->model->stall--;
+    cost->stalled++;
+    return true;
+}
+
+#endif
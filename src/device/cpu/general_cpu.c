@@ -154,3 +154,38 @@ extern bool cpu_sc_access(general_cpu_t *cpu, ptr36_t addr, int size)
     }
     return cpu->type->sc_access(cpu->data, addr, size);
 }
+
+void cpu_state(general_cpu_t *cpu, cpu_state_t *state)
+{
+    if (cpu == NULL) {
+        cpu = get_fallback_cpu();
+    }
+    cpu->type->state(cpu->data, state);
+}
+
+bool cpu_value(general_cpu_t *cpu, cpu_value_t which, unsigned int index, uint64_t *value)
+{
+    if (cpu == NULL) {
+        cpu = get_fallback_cpu();
+    }
+
+    if (cpu->type->value == NULL) {
+        return false;
+    }
+
+    *value = cpu->type->value(cpu->data, which, index);
+    return true;
+}
+
+bool cpu_inject(general_cpu_t *cpu, cpu_fault_t fault, unsigned int index, uint64_t mask)
+{
+    if (cpu == NULL) {
+        cpu = get_fallback_cpu();
+    }
+
+    if (cpu->type->inject == NULL) {
+        return false;
+    }
+
+    return cpu->type->inject(cpu->data, fault, index, mask);
+}
@@ -13,10 +13,43 @@
 #define GENERAL_CPU_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "../../debug/breakpoint.h"
 #include "../../main.h"
 
+/** Number of general purpose registers in the state summary */
+#define CPU_STATE_REGS 32
+
+/** Summary of the architectural state of a cpu
+ *
+ * The program counter and the general purpose registers are kept
+ * verbatim, the rest of the architectural state (system registers,
+ * TLB, etc.) is represented by a hash.
+ */
+typedef struct {
+    uint64_t pc;
+    uint64_t regs[CPU_STATE_REGS];
+    uint64_t hash;
+} cpu_state_t;
+
+/** Processor values available to breakpoint conditions */
+typedef enum {
+    CPU_VALUE_PC,
+    CPU_VALUE_REG, /**< General purpose register */
+    CPU_VALUE_PRIV, /**< Privilege level in the architecture encoding */
+    CPU_VALUE_ASID, /**< Current address space identifier */
+    CPU_VALUE_IRQ /**< Interrupt line asserted (non-zero) */
+} cpu_value_t;
+
+/** Processor faults for fault injection */
+typedef enum {
+    CPU_FAULT_REG, /**< Flip bits of a general purpose register */
+    CPU_FAULT_SYSREG, /**< Flip bits of a CP0 register or a CSR */
+    CPU_FAULT_TLB, /**< Drop a TLB entry */
+    CPU_FAULT_IRQ /**< Raise an interrupt line */
+} cpu_fault_t;
+
 /** Function type for raising and canceling interrupts */
 typedef void (*interrupt_func_t)(void *, unsigned int);
 /** Function type for inserting breakpoints */
@@ -31,6 +64,12 @@ typedef void (*reg_dump_func_t)(void *);
 typedef void (*set_pc_func_t)(void *, ptr64_t);
 /** Function type for notifying the processor about a write to a memory location, used for implementing SC atomic*/
 typedef bool (*sc_access_func_t)(void *, ptr36_t, int);
+/** Function type for summarizing the architectural state of a cpu */
+typedef void (*state_func_t)(void *, cpu_state_t *);
+/** Function type for reading a processor value */
+typedef uint64_t (*value_func_t)(void *, cpu_value_t, unsigned int);
+/** Function type for injecting a processor fault */
+typedef bool (*inject_func_t)(void *, cpu_fault_t, unsigned int, uint64_t);
 
 /** Cpu method table
  *
@@ -45,6 +84,9 @@ typedef struct {
     reg_dump_func_t reg_dump;
     set_pc_func_t set_pc;
     sc_access_func_t sc_access;
+    state_func_t state;
+    value_func_t value;
+    inject_func_t inject;
 } cpu_ops_t;
 
 /** Structure describinfg cpu methods */
@@ -121,4 +163,34 @@ extern void cpu_set_pc(general_cpu_t *cpu, ptr64_t pc);
  */
 extern bool cpu_sc_access(general_cpu_t *cpu, ptr36_t addr, int size);
 
+/**
+ * @brief Summarizes the architectural state of the cpu
+ *
+ * @param cpu the processor pointer
+ * @param state the state summary to fill in
+ */
+extern void cpu_state(general_cpu_t *cpu, cpu_state_t *state);
+
+/**
+ * @brief Reads a processor value for breakpoint conditions
+ *
+ * @param cpu the processor pointer
+ * @param which the value to read
+ * @param index the register number for CPU_VALUE_REG, the interrupt number for CPU_VALUE_IRQ
+ * @param value the value read
+ * @return whether the processor provides the value
+ */
+extern bool cpu_value(general_cpu_t *cpu, cpu_value_t which, unsigned int index, uint64_t *value);
+
+/**
+ * @brief Injects a processor fault
+ *
+ * @param cpu the processor pointer
+ * @param fault the kind of the fault
+ * @param index the register number, the TLB entry (modulo the TLB size) or the interrupt number
+ * @param mask the bits to flip (ignored for CPU_FAULT_TLB and CPU_FAULT_IRQ)
+ * @return whether the fault was injected
+ */
+extern bool cpu_inject(general_cpu_t *cpu, cpu_fault_t fault, unsigned int index, uint64_t mask);
+
 #endif // GENERAL_CPU_H_
@@ -18,6 +18,10 @@
 #include "../../../debug/breakpoint.h"
 #include "../../../debug/debug.h"
 #include "../../../debug/gdb.h"
+#include "../../../debug/memusage.h"
+#include "../../../debug/profile.h"
+#include "../../../debug/roi.h"
+#include "../../../debug/sample.h"
 #include "../../../endian.h"
 #include "../../../env.h"
 #include "../../../fault.h"
@@ -29,6 +33,7 @@
 #include "../../device.h"
 #include "cpu.h"
 #include "debug.h"
+#include "fpu.h"
 
 /** Register and coprocessor names
  *
@@ -63,7 +68,7 @@ char *r4k_cp0_name[R4K_REG_VARIANTS][R4K_REG_COUNT] = {
             "status", "cause", "epc", "prid",
             "config", "lladdr", "watchlo", "watchhi",
             "xcontext", "res_21", "res_22", "res_23",
-            "res_24", "res_25", "res_26", "res_27",
+            "res_24", "perfcnt", "res_26", "res_27",
             "res_28", "res_29", "errorepc", "res_31" }
 };
 
@@ -228,6 +233,9 @@ static uint64_t sign_extend_32_64(uint32_t val)
 #define CKSEG1_MASK UINT32_C(0xffffffffe0000000)
 #define CKSEG1_BITS UINT32_C(0xffffffffa0000000)
 
+/** Cache algorithm of the uncached accesses (Config.K0) */
+#define CACHE_UNCACHED 2
+
 #define KSSEG_MASK SSEG_MASK
 #define KSSEG_BITS SSEG_BITS
 #define CKSSEG_MASK CSSEG_MASK
@@ -724,6 +732,32 @@ static r4k_exc_t align_test64(r4k_cpu_t *cpu, ptr64_t addr, bool noisy)
     return r4k_excNone;
 }
 
+/** Test whether the address is in the unmapped uncached segment
+ *
+ * The kernel segment 0 is uncached if configured so by Config.K0.
+ *
+ */
+static bool uncached_segment(r4k_cpu_t *cpu, ptr64_t virt)
+{
+    ASSERT(cpu != NULL);
+
+    if (CPU_64BIT_MODE(cpu)) {
+        if ((virt.ptr & CKSEG1_MASK) == CKSEG1_BITS) {
+            return true;
+        }
+
+        return ((virt.ptr & CKSEG0_MASK) == CKSEG0_BITS)
+                && (cp0_config_k0(cpu) == CACHE_UNCACHED);
+    }
+
+    if ((virt.lo & KSEG1_MASK) == KSEG1_BITS) {
+        return true;
+    }
+
+    return ((virt.lo & KSEG0_MASK) == KSEG0_BITS)
+            && (cp0_config_k0(cpu) == CACHE_UNCACHED);
+}
+
 /** Access the virtual memory
  *
  * The operation (read/write) is specified via the wr parameter.
@@ -745,6 +779,19 @@ static r4k_exc_t access_mem(r4k_cpu_t *cpu, acc_mode_t mode, ptr64_t virt,
 
     r4k_exc_t res = r4k_convert_addr(cpu, virt, phys, mode == AM_WRITE, noisy);
 
+    /* Event sources of the performance counters */
+    if ((cpu->perf_on) && (noisy) && (res == r4k_excNone)) {
+        if (mode == AM_WRITE) {
+            cpu->stores++;
+        } else {
+            cpu->loads++;
+        }
+
+        if (uncached_segment(cpu, virt)) {
+            cpu->uncached++;
+        }
+    }
+
     /* Check for watched address */
     if (((cp0_watchlo_r(cpu)) && (mode == AM_READ))
             || ((cp0_watchlo_w(cpu)) && (mode == AM_WRITE))) {
@@ -1060,6 +1107,165 @@ static r4k_exc_t cpu_write_mem64(r4k_cpu_t *cpu, ptr64_t addr, uint64_t value,
     return res;
 }
 
+/** Current value of the event source of a performance counter
+ *
+ */
+static uint64_t perf_source(r4k_cpu_t *cpu, uint32_t control)
+{
+    ASSERT(cpu != NULL);
+
+    unsigned int event = (control & cp0_perfctl_event_mask) >> cp0_perfctl_event_shift;
+
+    switch (event) {
+    case r4k_perf_Cycles:
+        return cpu->k_cycles + cpu->u_cycles + cpu->w_cycles + cpu->cost.stalled;
+    case r4k_perf_Instructions:
+        return cpu->k_cycles + cpu->u_cycles;
+    case r4k_perf_Branches:
+        return cpu->branches;
+    case r4k_perf_Loads:
+        return cpu->loads;
+    case r4k_perf_Stores:
+        return cpu->stores;
+    case r4k_perf_TLBRefills:
+        return cpu->tlb_refill;
+    case r4k_perf_Exceptions: {
+        uint64_t sum = 0;
+        for (unsigned int i = 0; i < R4K_EXC_CODES; i++) {
+            sum += cpu->exceptions[i];
+        }
+
+        return sum;
+    }
+    case r4k_perf_Uncached:
+        return cpu->uncached;
+    default:
+        if (event >= r4k_perf_ExcCode) {
+            return cpu->exceptions[event - r4k_perf_ExcCode];
+        }
+
+        /* Unknown events never happen */
+        return 0;
+    }
+}
+
+/** Current value of a performance counter
+ *
+ */
+static uint32_t perf_count(r4k_cpu_t *cpu, unsigned int i)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(i < R4K_PERF_COUNTERS);
+
+    r4k_perf_t *perf = &cpu->perf[i];
+
+    if ((perf->control & cp0_perfctl_mode_mask) == 0) {
+        return perf->count;
+    }
+
+    return perf->count + (uint32_t) (perf_source(cpu, perf->control) - perf->start);
+}
+
+/** Update the performance counter overflow interrupt
+ *
+ * The interrupt shares the IP7 line with the timer. The event sources
+ * other than the cycles are counted only while a counter is enabled.
+ *
+ */
+static void perf_update(r4k_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    bool on = false;
+    bool ie = false;
+    bool irq = false;
+
+    for (unsigned int i = 0; i < R4K_PERF_COUNTERS; i++) {
+        uint32_t control = cpu->perf[i].control;
+
+        if ((control & cp0_perfctl_mode_mask) != 0) {
+            on = true;
+        }
+
+        if (((control & cp0_perfctl_mode_mask) != 0)
+                && ((control & cp0_perfctl_ie_mask) != 0)) {
+            ie = true;
+
+            if ((perf_count(cpu, i) & cp0_perfcnt_overflow_mask) != 0) {
+                irq = true;
+            }
+        }
+    }
+
+    cpu->perf_on = on;
+    cpu->perf_ie = ie;
+
+    if (irq == cpu->perf_irq) {
+        return;
+    }
+
+    cpu->perf_irq = irq;
+
+    if (irq) {
+        cp0_cause(cpu).val |= 1 << cp0_cause_ip7_shift;
+    } else if (!cpu->timer_irq) {
+        cp0_cause(cpu).val &= ~(1 << cp0_cause_ip7_shift);
+    }
+}
+
+/** Read the PerfCnt register
+ *
+ * Even selects are the control registers, odd selects are the counters.
+ *
+ */
+static uint32_t perf_read(r4k_cpu_t *cpu, unsigned int sel)
+{
+    ASSERT(cpu != NULL);
+
+    unsigned int i = sel >> 1;
+
+    if (i >= R4K_PERF_COUNTERS) {
+        return 0;
+    }
+
+    if ((sel & 1) != 0) {
+        return perf_count(cpu, i);
+    }
+
+    /* The M bit indicates that another counter follows */
+    if (i + 1 < R4K_PERF_COUNTERS) {
+        return cpu->perf[i].control | cp0_perfctl_m_mask;
+    }
+
+    return cpu->perf[i].control;
+}
+
+/** Write the PerfCnt register
+ *
+ */
+static void perf_write(r4k_cpu_t *cpu, unsigned int sel, uint32_t val)
+{
+    ASSERT(cpu != NULL);
+
+    unsigned int i = sel >> 1;
+
+    if (i >= R4K_PERF_COUNTERS) {
+        return;
+    }
+
+    r4k_perf_t *perf = &cpu->perf[i];
+
+    if ((sel & 1) != 0) {
+        perf->count = val;
+    } else {
+        perf->count = perf_count(cpu, i);
+        perf->control = val & cp0_perfctl_write_mask;
+    }
+
+    perf->start = perf_source(cpu, perf->control);
+    perf_update(cpu);
+}
+
 /** Probe TLB entry
  *
  */
@@ -1271,7 +1477,44 @@ static void disassemble_rt_fs(r4k_instr_t instr, string_t *mnemonics,
         string_t *comments)
 {
     string_printf(mnemonics, " %s, %s",
-            r4k_regname[instr.r.rt], r4k_cp1name[instr.r.rs]);
+            r4k_regname[instr.r.rt], r4k_cp1name[instr.r.rd]);
+}
+
+static void disassemble_rt_fcr(r4k_instr_t instr, string_t *mnemonics,
+        string_t *comments)
+{
+    string_printf(mnemonics, " %s, fcr%u",
+            r4k_regname[instr.r.rt], instr.r.rd);
+}
+
+static void disassemble_ft_offset_base(r4k_instr_t instr, string_t *mnemonics,
+        string_t *comments)
+{
+    int64_t offset = (int64_t) sign_extend_16_64(instr.i.imm);
+
+    string_printf(mnemonics, " %s, %" PRId64 "(%s)",
+            r4k_cp1name[instr.i.rt], offset, r4k_regname[instr.i.rs]);
+}
+
+static void disassemble_fd_fs_ft(r4k_instr_t instr, string_t *mnemonics,
+        string_t *comments)
+{
+    string_printf(mnemonics, " %s, %s, %s",
+            r4k_cp1name[instr.r.sa], r4k_cp1name[instr.r.rd], r4k_cp1name[instr.r.rt]);
+}
+
+static void disassemble_fd_fs(r4k_instr_t instr, string_t *mnemonics,
+        string_t *comments)
+{
+    string_printf(mnemonics, " %s, %s",
+            r4k_cp1name[instr.r.sa], r4k_cp1name[instr.r.rd]);
+}
+
+static void disassemble_fs_ft(r4k_instr_t instr, string_t *mnemonics,
+        string_t *comments)
+{
+    string_printf(mnemonics, " %s, %s",
+            r4k_cp1name[instr.r.rd], r4k_cp1name[instr.r.rt]);
 }
 
 static void disassemble_rt_cp2(r4k_instr_t instr, string_t *mnemonics,
@@ -1355,6 +1598,16 @@ static void disassemble_rd(r4k_instr_t instr, string_t *mnemonics,
     string_printf(mnemonics, " %s", r4k_regname[instr.r.rd]);
 }
 
+/** Coprocessor 1 unusable
+ *
+ */
+static r4k_exc_t cop1_unusable(r4k_cpu_t *cpu)
+{
+    cp0_cause(cpu).val &= ~cp0_cause_ce_mask;
+    cp0_cause(cpu).val |= cp0_cause_ce_cu1;
+    return r4k_excCpU;
+}
+
 /** Implementation of instructions of R4000
  *
  * Include those instructions which are supported
@@ -1363,15 +1616,20 @@ static void disassemble_rd(r4k_instr_t instr, string_t *mnemonics,
  */
 
 #include "instr/_reserved.c"
+#include "instr/_unimplemented.c"
 #include "instr/_warning.c"
 #include "instr/_xcrd.c"
 #include "instr/_xhlt.c"
 #include "instr/_xint.c"
 #include "instr/_xrd.c"
+#include "instr/_xroe.c"
+#include "instr/_xroi.c"
 #include "instr/_xtr0.c"
 #include "instr/_xtrc.c"
 #include "instr/_xval.c"
+#include "instr/abs_fmt.c"
 #include "instr/add.c"
+#include "instr/add_fmt.c"
 #include "instr/addi.c"
 #include "instr/addiu.c"
 #include "instr/addu.c"
@@ -1406,11 +1664,18 @@ static void disassemble_rd(r4k_instr_t instr, string_t *mnemonics,
 #include "instr/bne.c"
 #include "instr/bnel.c"
 #include "instr/break.c"
+#include "instr/c_cond_fmt.c"
 #include "instr/cache.c"
+#include "instr/ceil_l_fmt.c"
+#include "instr/ceil_w_fmt.c"
 #include "instr/cfc1.c"
 #include "instr/cfc2.c"
 #include "instr/ctc1.c"
 #include "instr/ctc2.c"
+#include "instr/cvt_d_fmt.c"
+#include "instr/cvt_l_fmt.c"
+#include "instr/cvt_s_fmt.c"
+#include "instr/cvt_w_fmt.c"
 #include "instr/dadd.c"
 #include "instr/daddi.c"
 #include "instr/daddiu.c"
@@ -1418,6 +1683,7 @@ static void disassemble_rd(r4k_instr_t instr, string_t *mnemonics,
 #include "instr/ddiv.c"
 #include "instr/ddivu.c"
 #include "instr/div.c"
+#include "instr/div_fmt.c"
 #include "instr/divu.c"
 #include "instr/dmfc0.c"
 #include "instr/dmfc1.c"
@@ -1437,6 +1703,8 @@ static void disassemble_rd(r4k_instr_t instr, string_t *mnemonics,
 #include "instr/dsub.c"
 #include "instr/dsubu.c"
 #include "instr/eret.c"
+#include "instr/floor_l_fmt.c"
+#include "instr/floor_w_fmt.c"
 #include "instr/j.c"
 #include "instr/jal.c"
 #include "instr/jalr.c"
@@ -1464,15 +1732,20 @@ static void disassemble_rd(r4k_instr_t instr, string_t *mnemonics,
 #include "instr/mfc2.c"
 #include "instr/mfhi.c"
 #include "instr/mflo.c"
+#include "instr/mov_fmt.c"
 #include "instr/mtc0.c"
 #include "instr/mtc1.c"
 #include "instr/mthi.c"
 #include "instr/mtlo.c"
+#include "instr/mul_fmt.c"
 #include "instr/mult.c"
 #include "instr/multu.c"
+#include "instr/neg_fmt.c"
 #include "instr/nor.c"
 #include "instr/or.c"
 #include "instr/ori.c"
+#include "instr/round_l_fmt.c"
+#include "instr/round_w_fmt.c"
 #include "instr/sb.c"
 #include "instr/sc.c"
 #include "instr/scd.c"
@@ -1488,11 +1761,13 @@ static void disassemble_rd(r4k_instr_t instr, string_t *mnemonics,
 #include "instr/slti.c"
 #include "instr/sltiu.c"
 #include "instr/sltu.c"
+#include "instr/sqrt_fmt.c"
 #include "instr/sra.c"
 #include "instr/srav.c"
 #include "instr/srl.c"
 #include "instr/srlv.c"
 #include "instr/sub.c"
+#include "instr/sub_fmt.c"
 #include "instr/subu.c"
 #include "instr/sw.c"
 #include "instr/swc1.c"
@@ -1517,6 +1792,8 @@ static void disassemble_rd(r4k_instr_t instr, string_t *mnemonics,
 #include "instr/tltu.c"
 #include "instr/tne.c"
 #include "instr/tnei.c"
+#include "instr/trunc_l_fmt.c"
+#include "instr/trunc_w_fmt.c"
 #include "instr/xor.c"
 #include "instr/xori.c"
 
@@ -1617,8 +1894,8 @@ static r4k_instr_fnc_t func_map[64] = {
 
     instr_jr,
     instr_jalr,
-    instr__reserved, /* unused */
-    instr__reserved, /* unused */
+    instr__xroi,
+    instr__xroe,
     instr_syscall,
     instr_break,
     instr__xcrd, /* unused */
@@ -1774,12 +2051,12 @@ static r4k_instr_fnc_t cop1_rs_map[32] = {
     instr__reserved, /* unused */
     instr__reserved, /* unused */
 
+    instr__reserved, /* cop1rsS */
+    instr__reserved, /* cop1rsD */
     instr__reserved, /* unused */
     instr__reserved, /* unused */
-    instr__reserved, /* unused */
-    instr__reserved, /* unused */
-    instr__reserved, /* unused */
-    instr__reserved, /* unused */
+    instr__reserved, /* cop1rsW */
+    instr__reserved, /* cop1rsL */
     instr__reserved, /* unused */
     instr__reserved, /* unused */
 
@@ -1907,6 +2184,302 @@ static r4k_instr_fnc_t cop1_rt_map[32] = {
     instr__reserved /* unused */
 };
 
+static r4k_instr_fnc_t cop1_s_func_map[64] = {
+    instr_add_s,
+    instr_sub_s,
+    instr_mul_s,
+    instr_div_s,
+    instr_sqrt_s,
+    instr_abs_s,
+    instr_mov_s,
+    instr_neg_s,
+
+    instr_round_l_s,
+    instr_trunc_l_s,
+    instr_ceil_l_s,
+    instr_floor_l_s,
+    instr_round_w_s,
+    instr_trunc_w_s,
+    instr_ceil_w_s,
+    instr_floor_w_s,
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr_cvt_d_s,
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr_cvt_w_s,
+    instr_cvt_l_s,
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s,
+    instr_c_s
+};
+
+static r4k_instr_fnc_t cop1_d_func_map[64] = {
+    instr_add_d,
+    instr_sub_d,
+    instr_mul_d,
+    instr_div_d,
+    instr_sqrt_d,
+    instr_abs_d,
+    instr_mov_d,
+    instr_neg_d,
+
+    instr_round_l_d,
+    instr_trunc_l_d,
+    instr_ceil_l_d,
+    instr_floor_l_d,
+    instr_round_w_d,
+    instr_trunc_w_d,
+    instr_ceil_w_d,
+    instr_floor_w_d,
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr_cvt_s_d,
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr_cvt_w_d,
+    instr_cvt_l_d,
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d,
+    instr_c_d
+};
+
+static r4k_instr_fnc_t cop1_w_func_map[64] = {
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr_cvt_s_w,
+    instr_cvt_d_w,
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented /* unused */
+};
+
+static r4k_instr_fnc_t cop1_l_func_map[64] = {
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr_cvt_s_l,
+    instr_cvt_d_l,
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented, /* unused */
+    instr__unimplemented /* unused */
+};
+
 static r4k_instr_fnc_t cop2_rt_map[32] = {
     instr_bc2f,
     instr_bc2t,
@@ -2112,8 +2685,8 @@ static mnemonics_fnc_t mnemonics_func_map[64] = {
 
     mnemonics_jr,
     mnemonics_jalr,
-    mnemonics__reserved, /* unused */
-    mnemonics__reserved, /* unused */
+    mnemonics__xroi,
+    mnemonics__xroe,
     mnemonics_syscall,
     mnemonics_break,
     mnemonics__xcrd,
@@ -2269,12 +2842,12 @@ static mnemonics_fnc_t mnemonics_cop1_rs_map[32] = {
     mnemonics__reserved, /* unused */
     mnemonics__reserved, /* unused */
 
+    mnemonics__reserved, /* cop1rsS */
+    mnemonics__reserved, /* cop1rsD */
     mnemonics__reserved, /* unused */
     mnemonics__reserved, /* unused */
-    mnemonics__reserved, /* unused */
-    mnemonics__reserved, /* unused */
-    mnemonics__reserved, /* unused */
-    mnemonics__reserved, /* unused */
+    mnemonics__reserved, /* cop1rsW */
+    mnemonics__reserved, /* cop1rsL */
     mnemonics__reserved, /* unused */
     mnemonics__reserved, /* unused */
 
@@ -2402,6 +2975,302 @@ static mnemonics_fnc_t mnemonics_cop1_rt_map[32] = {
     mnemonics__reserved /* unused */
 };
 
+static mnemonics_fnc_t mnemonics_cop1_s_func_map[64] = {
+    mnemonics_add_s,
+    mnemonics_sub_s,
+    mnemonics_mul_s,
+    mnemonics_div_s,
+    mnemonics_sqrt_s,
+    mnemonics_abs_s,
+    mnemonics_mov_s,
+    mnemonics_neg_s,
+
+    mnemonics_round_l_s,
+    mnemonics_trunc_l_s,
+    mnemonics_ceil_l_s,
+    mnemonics_floor_l_s,
+    mnemonics_round_w_s,
+    mnemonics_trunc_w_s,
+    mnemonics_ceil_w_s,
+    mnemonics_floor_w_s,
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics_cvt_d_s,
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics_cvt_w_s,
+    mnemonics_cvt_l_s,
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s,
+    mnemonics_c_s
+};
+
+static mnemonics_fnc_t mnemonics_cop1_d_func_map[64] = {
+    mnemonics_add_d,
+    mnemonics_sub_d,
+    mnemonics_mul_d,
+    mnemonics_div_d,
+    mnemonics_sqrt_d,
+    mnemonics_abs_d,
+    mnemonics_mov_d,
+    mnemonics_neg_d,
+
+    mnemonics_round_l_d,
+    mnemonics_trunc_l_d,
+    mnemonics_ceil_l_d,
+    mnemonics_floor_l_d,
+    mnemonics_round_w_d,
+    mnemonics_trunc_w_d,
+    mnemonics_ceil_w_d,
+    mnemonics_floor_w_d,
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics_cvt_s_d,
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics_cvt_w_d,
+    mnemonics_cvt_l_d,
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d,
+    mnemonics_c_d
+};
+
+static mnemonics_fnc_t mnemonics_cop1_w_func_map[64] = {
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics_cvt_s_w,
+    mnemonics_cvt_d_w,
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented /* unused */
+};
+
+static mnemonics_fnc_t mnemonics_cop1_l_func_map[64] = {
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics_cvt_s_l,
+    mnemonics_cvt_d_l,
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented, /* unused */
+    mnemonics__unimplemented /* unused */
+};
+
 static mnemonics_fnc_t mnemonics_cop2_rt_map[32] = {
     mnemonics_bc2f,
     mnemonics_bc2t,
@@ -2579,6 +3448,22 @@ mnemonics_fnc_t decode_mnemonics(r4k_instr_t instr)
              */
             fnc = mnemonics_cop1_rt_map[instr.r.rt];
             break;
+        case cop1rsS:
+            /*
+             * COP1 arithmetic opcode decoding
+             * based on the format and the func field.
+             */
+            fnc = mnemonics_cop1_s_func_map[instr.r.func];
+            break;
+        case cop1rsD:
+            fnc = mnemonics_cop1_d_func_map[instr.r.func];
+            break;
+        case cop1rsW:
+            fnc = mnemonics_cop1_w_func_map[instr.r.func];
+            break;
+        case cop1rsL:
+            fnc = mnemonics_cop1_l_func_map[instr.r.func];
+            break;
         default:
             fnc = mnemonics_cop1_rs_map[instr.r.rs];
         }
@@ -2637,6 +3522,7 @@ void r4k_init(r4k_cpu_t *cpu, unsigned int procno)
 
     /* Initially set all members to zero */
     memset(cpu, 0, sizeof(r4k_cpu_t));
+    cost_init(&cpu->cost);
 
     cpu->procno = procno;
     r4k_set_pc(cpu, start_address);
@@ -2808,6 +3694,22 @@ static r4k_instr_fnc_t decode(r4k_instr_t instr)
              */
             fnc = cop1_rt_map[instr.cop.rt];
             break;
+        case cop1rsS:
+            /*
+             * COP1 arithmetic opcode decoding
+             * based on the format and the func field.
+             */
+            fnc = cop1_s_func_map[instr.r.func];
+            break;
+        case cop1rsD:
+            fnc = cop1_d_func_map[instr.r.func];
+            break;
+        case cop1rsW:
+            fnc = cop1_w_func_map[instr.r.func];
+            break;
+        case cop1rsL:
+            fnc = cop1_l_func_map[instr.r.func];
+            break;
         default:
             fnc = cop1_rs_map[instr.cop.rs];
         }
@@ -2853,6 +3755,28 @@ static void cache_item_init(cache_item_t *cache_item)
 
 list_t r4k_instruction_cache = LIST_INITIALIZER;
 
+/** Account the cache of decoded instructions
+ *
+ * The cache is shared by all R4000 processors and it is never
+ * shrunk, a page once executed stays in the cache.
+ *
+ */
+void r4k_cache_memusage(memusage_t *usage)
+{
+    cache_item_t *cache_item;
+    for_each(r4k_instruction_cache, cache_item, cache_item_t)
+    {
+        memusage_add(usage, MEMUSAGE_DECODE_CACHE, sizeof(cache_item_t));
+    }
+}
+
+/** Account the structures of the processor */
+void r4k_memusage(r4k_cpu_t *cpu, memusage_t *usage)
+{
+    memusage_add(usage, MEMUSAGE_TLB, sizeof(cpu->tlb));
+    breakpoint_list_memusage(&cpu->bps, usage);
+}
+
 static bool cache_hit(ptr36_t phys, cache_item_t **cache_item)
 {
     ptr36_t target_page = ALIGN_DOWN(phys, FRAME_SIZE);
@@ -2958,6 +3882,9 @@ static void handle_exception(r4k_cpu_t *cpu, r4k_exc_t res)
     }
 
     ASSERT(res <= r4k_excVCED);
+    if (cpu->perf_on) {
+        cpu->exceptions[res]++;
+    }
 
     /* The standby mode is cancelled by the exception */
     if (cpu->stdby) {
@@ -3022,13 +3949,151 @@ static void handle_exception(r4k_cpu_t *cpu, r4k_exc_t res)
     cp0_status(cpu).val |= cp0_status_exl_mask;
 }
 
+/** Check whether an instruction reads a general purpose register
+ *
+ */
+static bool reads_reg(r4k_instr_t instr, unsigned int reg)
+{
+    switch (instr.i.opcode) {
+    case r4k_opcJ:
+    case r4k_opcJAL:
+    case opcLUI:
+        return false;
+    case r4k_opcSPECIAL:
+    case r4k_opcBEQ:
+    case r4k_opcBNE:
+    case r4k_opcBEQL:
+    case r4k_opcBNEL:
+    case r4k_opcSB:
+    case r4k_opcSH:
+    case r4k_opcSWL:
+    case r4k_opcSW:
+    case r4k_opcSDL:
+    case r4k_opcSDR:
+    case r4k_opcSWR:
+    case r4k_opcSC:
+    case r4k_opcSCD:
+    case r4k_opcSD:
+        return (instr.i.rs == reg) || (instr.i.rt == reg);
+    case r4k_opcCOP0:
+    case r4k_opcCOP1:
+    case r4k_opcCOP2:
+        /* Moves to the coprocessors */
+        return ((instr.r.rs == cop0rsMTC0) || (instr.r.rs == cop0rsDMTC0)
+                       || (instr.r.rs == cop1rsCTC1))
+                && (instr.i.rt == reg);
+    default:
+        return instr.i.rs == reg;
+    }
+}
+
+/** Charge the extra cycles of an executed instruction
+ *
+ * Kept out of line so that the processor step without the cost
+ * model stays as compact as before.
+ *
+ */
+static __attribute__((noinline, cold)) void charge_cost(r4k_cpu_t *cpu, r4k_instr_t instr, r4k_exc_t exc)
+{
+    cpu_cost_t *cost = &cpu->cost;
+
+    if ((exc != r4k_excNone) && (exc != r4k_excJump)) {
+        cost->model->load_reg = 0;
+        return;
+    }
+
+    if ((cost->model->load_reg != 0) && (reads_reg(instr, cost->model->load_reg))) {
+        cost_charge(cost, COST_LOAD_USE);
+    }
+
+    cost->model->load_reg = 0;
+
+    switch (instr.i.opcode) {
+    case r4k_opcSPECIAL:
+        switch (instr.r.func) {
+        case funcMULT:
+        case funcMULTU:
+        case funcDMULT:
+        case funcDMULTU:
+            cost_charge(cost, COST_MUL);
+            break;
+        case funcDIV:
+        case funcDIVU:
+        case funcDDIV:
+        case funcDDIVU:
+            cost_charge(cost, COST_DIV);
+            break;
+        }
+        break;
+    case r4k_opcREGIMM:
+        if ((instr.i.rt <= rtBGEZL)
+                || ((instr.i.rt >= rtBLTZAL) && (instr.i.rt <= rtBGEZALL))) {
+            cost_branch(cost, cpu->pc.ptr, exc == r4k_excJump);
+        }
+        break;
+    case r4k_opcBEQ:
+    case r4k_opcBNE:
+    case r4k_opcBLEZ:
+    case r4k_opcBGTZ:
+    case r4k_opcBEQL:
+    case r4k_opcBNEL:
+    case r4k_opcBLEZL:
+    case r4k_opcBGTZL:
+        cost_branch(cost, cpu->pc.ptr, exc == r4k_excJump);
+        break;
+    case r4k_opcCOP0:
+        if (instr.r.rs == cop0rsBC) {
+            cost_branch(cost, cpu->pc.ptr, exc == r4k_excJump);
+        } else {
+            cost_charge(cost, COST_CSR);
+        }
+        break;
+    case r4k_opcCOP1:
+    case r4k_opcCOP2:
+        if (instr.r.rs == cop1rsBC) {
+            cost_branch(cost, cpu->pc.ptr, exc == r4k_excJump);
+        }
+        break;
+    case r4k_opcLL:
+    case r4k_opcLDD:
+        cost_charge(cost, COST_AMO);
+        cost->model->load_reg = instr.i.rt;
+        break;
+    case r4k_opcSC:
+    case r4k_opcSCD:
+        cost_charge(cost, COST_AMO);
+        break;
+    case r4k_opcLB:
+    case r4k_opcLH:
+    case r4k_opcLWL:
+    case r4k_opcLW:
+    case r4k_opcLBU:
+    case r4k_opcLHU:
+    case r4k_opcLWR:
+    case r4k_opcLWU:
+    case r4k_opcLDL:
+    case r4k_opcLDR:
+    case r4k_opcLD:
+        cost->model->load_reg = instr.i.rt;
+        break;
+    }
+}
+
 /** Execute one CPU instruction
+ *
+ * @param cpu    Processor.
+ * @param costed Whether the cost model is enabled.
  *
  */
-static r4k_exc_t execute(r4k_cpu_t *cpu)
+static r4k_exc_t execute(r4k_cpu_t *cpu, bool costed)
 {
     ASSERT(cpu != NULL);
 
+    /* The trigger address may be given in the 32-bit form */
+    if ((sample_pc_armed) && ((cpu->pc.ptr == sample_pc) || (cpu->pc.ptr == (UINT64_C(0xffffffff00000000) | sample_pc)))) {
+        sample_hit_pc(cpu->procno);
+    }
+
     /* Instruction fetch */
 
     ptr36_t phys;
@@ -3064,9 +4129,17 @@ static r4k_exc_t execute(r4k_cpu_t *cpu)
 
     r4k_instr_t instr = (r4k_instr_t) physmem_read32(cpu->procno, phys, false);
 
+    if (machine_profile) {
+        profile_hit(cpu->procno, cpu->pc.ptr);
+    }
+
     /* Execute instruction */
     r4k_exc_t exc = fnc(cpu, instr);
 
+    if (costed) {
+        charge_cost(cpu, instr, exc);
+    }
+
     if (machine_trace) {
         r4k_idump(cpu, cpu->pc, instr, true);
     }
@@ -3088,6 +4161,10 @@ static r4k_exc_t execute(r4k_cpu_t *cpu)
          */
         exc = r4k_excNone;
         cpu->pc.ptr += 4;
+
+        if (cpu->perf_on) {
+            cpu->branches++;
+        }
     } else {
         /*
          * Advance to the next instruction
@@ -3100,23 +4177,13 @@ static r4k_exc_t execute(r4k_cpu_t *cpu)
     return exc;
 }
 
-/** CPU management
+/** Advance the cycle driven registers by one cycle
  *
  */
-static void manage(r4k_cpu_t *cpu, r4k_exc_t exc, ptr64_t old_pc)
+static void tick(r4k_cpu_t *cpu)
 {
     ASSERT(cpu != NULL);
 
-    /* Test for interrupt request */
-    if ((exc == r4k_excNone) && (!cp0_status_exl(cpu)) && (!cp0_status_erl(cpu)) && (cp0_status_ie(cpu)) && ((cp0_cause(cpu).val & cp0_status(cpu).val) & cp0_cause_ip_mask) != 0) {
-        exc = r4k_excInt;
-    }
-
-    /* Exception control */
-    if (exc != r4k_excNone) {
-        handle_exception(cpu, exc);
-    }
-
     /* Increase counter */
     cp0_count(cpu).val++;
 
@@ -3138,8 +4205,34 @@ static void manage(r4k_cpu_t *cpu, r4k_exc_t exc, ptr64_t old_pc)
     if (cp0_count(cpu).lo == cp0_compare(cpu).lo) {
         /* Generate interrupt request */
         cp0_cause(cpu).val |= 1 << cp0_cause_ip7_shift;
+        cpu->timer_irq = true;
     }
 
+    /* Performance counter overflow */
+    if (cpu->perf_ie) {
+        perf_update(cpu);
+    }
+}
+
+/** CPU management
+ *
+ */
+static void manage(r4k_cpu_t *cpu, r4k_exc_t exc, ptr64_t old_pc)
+{
+    ASSERT(cpu != NULL);
+
+    /* Test for interrupt request */
+    if ((exc == r4k_excNone) && (!cp0_status_exl(cpu)) && (!cp0_status_erl(cpu)) && (cp0_status_ie(cpu)) && ((cp0_cause(cpu).val & cp0_status(cpu).val) & cp0_cause_ip_mask) != 0) {
+        exc = r4k_excInt;
+    }
+
+    /* Exception control */
+    if (exc != r4k_excNone) {
+        handle_exception(cpu, exc);
+    }
+
+    tick(cpu);
+
     /* Branch delay slot control */
     if (cpu->branch > BRANCH_NONE) {
         cpu->branch--;
@@ -3171,19 +4264,65 @@ void r4k_step(r4k_cpu_t *cpu)
 {
     ASSERT(cpu != NULL);
 
+    /*
+     * Stall cycles of the cost model. The instruction has been
+     * executed already, only the cycle driven registers advance.
+     * The model pointer is read once per cycle.
+     */
+    bool costed = (cpu->cost.model != NULL);
+
+    if ((costed) && (cost_stalled(&cpu->cost))) {
+        tick(cpu);
+        return;
+    }
+
     /* Instruction execute */
     r4k_exc_t exc = r4k_excNone;
     ptr64_t old_pc = cpu->pc;
 
     if (!cpu->stdby) {
-        exc = execute(cpu);
+        exc = execute(cpu, costed);
     }
 
     /* Processor management */
     manage(cpu, exc, old_pc);
 
     /* Cycle accounting */
-    account(cpu);
+    if (!machine_fast) {
+        account(cpu);
+    }
+}
+
+/** Reset processor statistics
+ *
+ */
+void r4k_reset_stats(r4k_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    /* Keep the performance counters running */
+    for (unsigned int i = 0; i < R4K_PERF_COUNTERS; i++) {
+        cpu->perf[i].count = perf_count(cpu, i);
+    }
+
+    cpu->k_cycles = 0;
+    cpu->u_cycles = 0;
+    cpu->w_cycles = 0;
+
+    cpu->tlb_refill = 0;
+    cpu->tlb_invalid = 0;
+    cpu->tlb_modified = 0;
+    memset(cpu->intr, 0, sizeof(cpu->intr));
+
+    cpu->branches = 0;
+    cpu->loads = 0;
+    cpu->stores = 0;
+    cpu->uncached = 0;
+    memset(cpu->exceptions, 0, sizeof(cpu->exceptions));
+
+    for (unsigned int i = 0; i < R4K_PERF_COUNTERS; i++) {
+        cpu->perf[i].start = perf_source(cpu, cpu->perf[i].control);
+    }
 }
 
 bool r4k_sc_access(r4k_cpu_t *cpu, ptr36_t addr, int size)
@@ -3199,6 +4338,8 @@ bool r4k_sc_access(r4k_cpu_t *cpu, ptr36_t addr, int size)
 
 void r4k_done(r4k_cpu_t *cpu)
 {
+    cost_done(&cpu->cost);
+
     // Clean whole cache
     while (!is_empty(&r4k_instruction_cache)) {
         cache_item_t *cache_item = (cache_item_t *) (r4k_instruction_cache.head);
@@ -21,6 +21,7 @@
 #include "../../../list.h"
 #include "../../../physmem.h"
 #include "../../../utils.h"
+#include "../cost.h"
 
 #define R4K_REG_COUNT 32
 #define R4K_REG_VARIANTS 3
@@ -75,7 +76,7 @@ typedef enum {
 
     /* 24 */
     cp0_Res5,
-    cp0_Res6,
+    cp0_PerfCnt,
     cp0_ECC,
     cp0_CacheErr,
     cp0_TagLo,
@@ -295,6 +296,28 @@ typedef enum {
 #define cp0_cause_res4(cpu) (((cpu)->cp0[cp0_Cause].val & cp0_cause_res4_mask) >> cp0_cause_res4_shift)
 #define cp0_cause_bd(cpu) (((cpu)->cp0[cp0_Cause].val & cp0_cause_bd_mask) >> cp0_cause_bd_shift)
 
+/** Performance counter control (PerfCtl, selects 0 and 2 of PerfCnt) */
+#define cp0_perfctl_exl_mask UINT32_C(0x00000001)
+#define cp0_perfctl_k_mask UINT32_C(0x00000002)
+#define cp0_perfctl_s_mask UINT32_C(0x00000004)
+#define cp0_perfctl_u_mask UINT32_C(0x00000008)
+#define cp0_perfctl_ie_mask UINT32_C(0x00000010)
+#define cp0_perfctl_event_mask UINT32_C(0x000007e0)
+#define cp0_perfctl_m_mask UINT32_C(0x80000000)
+
+#define cp0_perfctl_event_shift 5
+
+/** Any of the mode bits enables the counter */
+#define cp0_perfctl_mode_mask \
+    (cp0_perfctl_exl_mask | cp0_perfctl_k_mask | cp0_perfctl_s_mask | cp0_perfctl_u_mask)
+
+/** Writable bits of PerfCtl */
+#define cp0_perfctl_write_mask \
+    (cp0_perfctl_mode_mask | cp0_perfctl_ie_mask | cp0_perfctl_event_mask)
+
+/** Overflow bit of PerfCnt */
+#define cp0_perfcnt_overflow_mask UINT32_C(0x80000000)
+
 #define cp0_prid_rev_mask UINT32_C(0x000000ff)
 #define cp0_prid_imp_mask UINT32_C(0x0000ff00)
 #define cp0_prid_res_mask UINT32_C(0xffff0000)
@@ -445,6 +468,66 @@ typedef enum {
 /** cp0 Masks */
 #define cp0_SR_EXLMask UINT32_C(0x00000002)
 
+/** cp1 control registers */
+#define FCR0_IMPL UINT32_C(0x00000500)
+
+#define fcr31_rm_mask UINT32_C(0x00000003)
+#define fcr31_flags_mask UINT32_C(0x0000007c)
+#define fcr31_enables_mask UINT32_C(0x00000f80)
+#define fcr31_cause_mask UINT32_C(0x0003f000)
+#define fcr31_c_mask UINT32_C(0x00800000)
+#define fcr31_fs_mask UINT32_C(0x01000000)
+#define fcr31_mask UINT32_C(0x0183ffff)
+
+#define fcr31_rm_shift 0
+#define fcr31_flags_shift 2
+#define fcr31_enables_shift 7
+#define fcr31_cause_shift 12
+#define fcr31_c_shift 23
+#define fcr31_fs_shift 24
+
+#define fcr31_rm(cpu) (((cpu)->fcr31 & fcr31_rm_mask) >> fcr31_rm_shift)
+#define fcr31_flags(cpu) (((cpu)->fcr31 & fcr31_flags_mask) >> fcr31_flags_shift)
+#define fcr31_enables(cpu) (((cpu)->fcr31 & fcr31_enables_mask) >> fcr31_enables_shift)
+#define fcr31_cause(cpu) (((cpu)->fcr31 & fcr31_cause_mask) >> fcr31_cause_shift)
+#define fcr31_c(cpu) (((cpu)->fcr31 & fcr31_c_mask) >> fcr31_c_shift)
+#define fcr31_fs(cpu) (((cpu)->fcr31 & fcr31_fs_mask) >> fcr31_fs_shift)
+
+/** Floating-point exceptions (bits of the flags, enables and cause fields) */
+#define FPU_EXC_I 0x01 /**< Inexact */
+#define FPU_EXC_U 0x02 /**< Underflow */
+#define FPU_EXC_O 0x04 /**< Overflow */
+#define FPU_EXC_Z 0x08 /**< Division by zero */
+#define FPU_EXC_V 0x10 /**< Invalid operation */
+#define FPU_EXC_E 0x20 /**< Unimplemented operation (cause only) */
+
+/** Rounding modes */
+typedef enum {
+    fpu_rm_RN = 0, /**< To nearest */
+    fpu_rm_RZ = 1, /**< Toward zero */
+    fpu_rm_RP = 2, /**< Toward +infinity */
+    fpu_rm_RM = 3 /**< Toward -infinity */
+} fpu_rm_t;
+
+/** Performance counter events */
+typedef enum {
+    r4k_perf_Cycles = 0,
+    r4k_perf_Instructions = 1,
+    r4k_perf_Branches = 2, /**< Taken branches and jumps */
+    r4k_perf_Loads = 3,
+    r4k_perf_Stores = 4,
+    r4k_perf_TLBRefills = 5,
+    r4k_perf_Exceptions = 6,
+    r4k_perf_Uncached = 7, /**< Loads and stores in the uncached segment */
+    r4k_perf_ExcCode = 32 /**< Exceptions with ExcCode (event - 32) */
+} r4k_perf_event_t;
+
+/** Number of performance counters */
+#define R4K_PERF_COUNTERS 2
+
+/** Number of exception codes */
+#define R4K_EXC_CODES 32
+
 /** Exception types */
 typedef enum {
     r4k_excInt = 0,
@@ -574,6 +657,19 @@ static_assert(sizeof(r4k_instr_t) == 4, "wrong r4k_instr_t size!");
 struct frame;
 struct r4k_cpu;
 
+/** Performance counter
+ *
+ * The counter is evaluated lazily from the statistics of the processor,
+ * only the value of the event source at the time of the last write
+ * is stored.
+ *
+ */
+typedef struct {
+    uint32_t control; /**< PerfCtl register */
+    uint32_t count; /**< PerfCnt value at the last write */
+    uint64_t start; /**< Event source at the last write */
+} r4k_perf_t;
+
 /** Instruction implementation */
 typedef r4k_exc_t (*r4k_instr_fnc_t)(struct r4k_cpu *, r4k_instr_t);
 
@@ -587,6 +683,7 @@ typedef struct r4k_cpu {
     reg64_t regs[R4K_REG_COUNT];
     reg64_t cp0[R4K_REG_COUNT];
     uint64_t fpregs[R4K_REG_COUNT];
+    uint32_t fcr31;
     reg64_t loreg;
     reg64_t hireg;
 
@@ -626,6 +723,22 @@ typedef struct r4k_cpu {
     uint64_t tlb_modified;
     uint64_t intr[INTR_COUNT];
 
+    uint64_t branches;
+    uint64_t loads;
+    uint64_t stores;
+    uint64_t uncached;
+    uint64_t exceptions[R4K_EXC_CODES];
+
+    /* Instruction cost model */
+    cpu_cost_t cost;
+
+    /* Performance counters */
+    r4k_perf_t perf[R4K_PERF_COUNTERS];
+    bool perf_on; /**< A counter is enabled (the event sources are counted) */
+    bool perf_ie; /**< An enabled counter has the overflow interrupt enabled */
+    bool perf_irq; /**< Overflow interrupt asserted */
+    bool timer_irq; /**< Timer interrupt asserted */
+
     /* breakpoints */
     list_t bps;
 } r4k_cpu_t;
@@ -872,7 +985,22 @@ typedef enum {
     /* rs 7 unused */
 
     /* 8 */
-    cop1rsBC = 8
+    cop1rsBC = 8,
+    /* rs 9 unused */
+    /* rs 10 unused */
+    /* rs 11 unused */
+    /* rs 12 unused */
+    /* rs 13 unused */
+    /* rs 14 unused */
+    /* rs 15 unused */
+
+    /* 16 */
+    cop1rsS = 16,
+    cop1rsD = 17,
+    /* rs 18 unused */
+    /* rs 19 unused */
+    cop1rsW = 20,
+    cop1rsL = 21
 } instr_cop1rs_t;
 
 typedef enum {
@@ -959,6 +1087,12 @@ extern void r4k_init(r4k_cpu_t *cpu, unsigned int procno);
 extern void r4k_set_pc(r4k_cpu_t *cpu, ptr64_t value);
 extern void r4k_step(r4k_cpu_t *cpu);
 extern void r4k_done(r4k_cpu_t *cpu);
+extern void r4k_reset_stats(r4k_cpu_t *cpu);
+
+/** Host memory accounting */
+struct memusage;
+extern void r4k_memusage(r4k_cpu_t *cpu, struct memusage *usage);
+extern void r4k_cache_memusage(struct memusage *usage);
 
 /** Addresing function */
 extern r4k_exc_t r4k_convert_addr(r4k_cpu_t *cpu, ptr64_t virt, ptr36_t *phys, bool write,
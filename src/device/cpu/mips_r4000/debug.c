@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include "../../../assert.h"
+#include "../../../debug/symtab.h"
 #include "../../../env.h"
 #include "../../../main.h"
 #include "../../../utils.h"
@@ -115,6 +116,154 @@ void r4k_reg_dump(r4k_cpu_t *cpu)
             cpu->pc.ptr, cpu->loreg.val, cpu->hireg.val);
 }
 
+void r4k_fpu_dump(r4k_cpu_t *cpu)
+{
+    printf("processor %u (fr %u)\n", cpu->procno, (unsigned int) cp0_status_fr(cpu));
+
+    for (unsigned int i = 0; i < R4K_REG_COUNT; i += 4) {
+        printf(" %6s %16" PRIx64 "  %6s %16" PRIx64 "  %6s %16" PRIx64 "  %6s %16" PRIx64 "\n",
+                r4k_cp1name[i], cpu->fpregs[i],
+                r4k_cp1name[i + 1], cpu->fpregs[i + 1],
+                r4k_cp1name[i + 2], cpu->fpregs[i + 2],
+                r4k_cp1name[i + 3], cpu->fpregs[i + 3]);
+    }
+
+    printf(" fcr31 %08" PRIx32 " (rm %u, flags %02x, enables %02x, cause %02x, c %u, fs %u)\n",
+            cpu->fcr31, fcr31_rm(cpu), fcr31_flags(cpu), fcr31_enables(cpu),
+            fcr31_cause(cpu), fcr31_c(cpu), fcr31_fs(cpu));
+}
+
+/** Summarize the architectural state
+ *
+ * The statistics and the debugging copies of the registers
+ * are not part of the architectural state.
+ *
+ */
+void r4k_state(r4k_cpu_t *cpu, cpu_state_t *state)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(state != NULL);
+
+    state->pc = cpu->pc.ptr;
+    for (unsigned int i = 0; i < CPU_STATE_REGS; i++) {
+        state->regs[i] = cpu->regs[i].val;
+    }
+
+    uint64_t hash = hash64(cpu->cp0, sizeof(cpu->cp0), 0);
+    hash = hash64(cpu->fpregs, sizeof(cpu->fpregs), hash);
+
+    uint64_t misc[] = {
+        cpu->loreg.val,
+        cpu->hireg.val,
+        cpu->pc_next.ptr,
+        cpu->branch,
+        cpu->stdby,
+        cpu->llbit,
+        cpu->lladdr,
+        cpu->waddr,
+        cpu->wexcaddr.ptr,
+        cpu->wpending,
+        cpu->fcr31
+    };
+    hash = hash64(misc, sizeof(misc), hash);
+
+    /* TLB entries field by field to skip the padding */
+    for (unsigned int i = 0; i < TLB_ENTRIES; i++) {
+        tlb_entry_t *entry = &cpu->tlb[i];
+        uint64_t fields[] = {
+            entry->mask,
+            entry->vpn2,
+            entry->global,
+            entry->asid,
+            entry->pg[0].pfn,
+            entry->pg[0].cohh,
+            entry->pg[0].dirty,
+            entry->pg[0].valid,
+            entry->pg[1].pfn,
+            entry->pg[1].cohh,
+            entry->pg[1].dirty,
+            entry->pg[1].valid
+        };
+        hash = hash64(fields, sizeof(fields), hash);
+    }
+
+    state->hash = hash;
+}
+
+/** Read a processor value for breakpoint conditions
+ *
+ * The privilege level is the KSU field (0 kernel, 1 supervisor, 2 user),
+ * exception and error levels count as the kernel mode.
+ *
+ */
+uint64_t r4k_value(r4k_cpu_t *cpu, cpu_value_t which, unsigned int index)
+{
+    ASSERT(cpu != NULL);
+
+    switch (which) {
+    case CPU_VALUE_PC:
+        return cpu->pc.ptr;
+    case CPU_VALUE_REG:
+        ASSERT(index < R4K_REG_COUNT);
+        return cpu->regs[index].val;
+    case CPU_VALUE_PRIV:
+        if ((cp0_status_exl(cpu)) || (cp0_status_erl(cpu))) {
+            return 0;
+        }
+        return cp0_status_ksu(cpu);
+    case CPU_VALUE_ASID:
+        return cp0_entryhi_asid(cpu);
+    case CPU_VALUE_IRQ:
+        if (index >= INTR_COUNT) {
+            return 0;
+        }
+        return (cp0_cause(cpu).val >> (cp0_cause_ip0_shift + index)) & 1;
+    }
+
+    return 0;
+}
+
+/** Inject a processor fault
+ *
+ * The system registers are the CP0 registers. A dropped TLB entry
+ * keeps its tag but both its subpages become invalid.
+ *
+ */
+bool r4k_inject(r4k_cpu_t *cpu, cpu_fault_t fault, unsigned int index, uint64_t mask)
+{
+    ASSERT(cpu != NULL);
+
+    switch (fault) {
+    case CPU_FAULT_REG:
+        /* The zero register is hardwired */
+        if ((index == 0) || (index >= R4K_REG_COUNT)) {
+            return false;
+        }
+        cpu->regs[index].val ^= mask;
+        return true;
+    case CPU_FAULT_SYSREG:
+        if (index >= R4K_REG_COUNT) {
+            return false;
+        }
+        cpu->cp0[index].val ^= mask;
+        return true;
+    case CPU_FAULT_TLB: {
+        tlb_entry_t *entry = &cpu->tlb[index % TLB_ENTRIES];
+        entry->pg[0].valid = false;
+        entry->pg[1].valid = false;
+        return true;
+    }
+    case CPU_FAULT_IRQ:
+        if (index >= INTR_COUNT) {
+            return false;
+        }
+        r4k_interrupt_up(cpu, index);
+        return true;
+    }
+
+    return false;
+}
+
 static const char *get_pagemask_name(unsigned int pm)
 {
     unsigned int i;
@@ -339,6 +488,11 @@ void r4k_idump(r4k_cpu_t *cpu, ptr64_t addr, r4k_instr_t instr, bool modregs)
     string_printf(&s_addr, "%#018" PRIx64, addr.ptr);
     idump_common(addr, instr, &s_opc, &s_mnemonics, &s_comments);
 
+    const char *label = symtab_label(addr.ptr);
+    if (label != NULL) {
+        printf("%s:\n", label);
+    }
+
     if (cpu != NULL) {
         printf("%-5s ", s_cpu.str);
     }
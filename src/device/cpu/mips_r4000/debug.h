@@ -6,6 +6,7 @@
 #include <stdlib.h>
 
 #include "../../../utils.h"
+#include "../general_cpu.h"
 #include "cpu.h"
 
 /** Debugging register names */
@@ -18,6 +19,10 @@ extern char **r4k_cp3name;
 extern void r4k_debug_init(void);
 
 extern void r4k_reg_dump(r4k_cpu_t *cpu);
+extern void r4k_fpu_dump(r4k_cpu_t *cpu);
+extern void r4k_state(r4k_cpu_t *cpu, cpu_state_t *state);
+extern uint64_t r4k_value(r4k_cpu_t *cpu, cpu_value_t which, unsigned int index);
+extern bool r4k_inject(r4k_cpu_t *cpu, cpu_fault_t fault, unsigned int index, uint64_t mask);
 extern void r4k_tlb_dump(r4k_cpu_t *cpu);
 extern void r4k_cp0_dump_all(r4k_cpu_t *cpu);
 extern void r4k_cp0_dump(r4k_cpu_t *cpu, unsigned int reg);
@@ -0,0 +1,562 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  MIPS R4000 floating-point unit (coprocessor 1)
+ *
+ * The operations are executed by the host floating-point unit in the
+ * rounding mode of FCR31, the IEEE exceptions are taken from the host
+ * exception flags. The host does not know the NaN encoding of the
+ * R4000 (signaling NaNs have the most significant bit of the fraction
+ * set) and flushing to zero, so the NaN operands are handled here
+ * before the host operation and the results are adjusted afterwards.
+ *
+ * Denormalized results are delivered as computed by the host instead
+ * of raising the Unimplemented Operation exception.
+ *
+ */
+
+#include <fenv.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../../assert.h"
+#include "cpu.h"
+#include "fpu.h"
+
+#define S_SIGN UINT32_C(0x80000000)
+#define S_EXP UINT32_C(0x7f800000)
+#define S_SNAN UINT32_C(0x00400000)
+#define S_DEFAULT_NAN UINT32_C(0x7fbfffff)
+
+#define D_SIGN UINT64_C(0x8000000000000000)
+#define D_EXP UINT64_C(0x7ff0000000000000)
+#define D_SNAN UINT64_C(0x0008000000000000)
+#define D_DEFAULT_NAN UINT64_C(0x7ff7ffffffffffff)
+
+/** Results of invalid conversions to integers */
+#define W_INVALID UINT64_C(0x7fffffff)
+#define L_INVALID UINT64_C(0x7fffffffffffffff)
+
+static const int host_rm[] = {
+    [fpu_rm_RN] = FE_TONEAREST,
+    [fpu_rm_RZ] = FE_TOWARDZERO,
+    [fpu_rm_RP] = FE_UPWARD,
+    [fpu_rm_RM] = FE_DOWNWARD
+};
+
+/** Store the exceptions of the current operation into the cause field */
+void r4k_fpu_set_cause(r4k_cpu_t *cpu, unsigned int cause)
+{
+    cpu->fcr31 = (cpu->fcr31 & ~fcr31_cause_mask)
+            | (cause << fcr31_cause_shift);
+}
+
+/** Prepare the host for an operation
+ *
+ * The host runs in the round to nearest mode,
+ * it is switched only for the other modes.
+ *
+ */
+static inline void host_begin(fpu_rm_t rm)
+{
+    if (rm != fpu_rm_RN) {
+        fesetround(host_rm[rm]);
+    }
+
+    feclearexcept(FE_ALL_EXCEPT);
+}
+
+/** Collect the host exceptions of an operation */
+static inline unsigned int host_end(fpu_rm_t rm)
+{
+    int host = fetestexcept(FE_ALL_EXCEPT);
+
+    if (rm != fpu_rm_RN) {
+        fesetround(FE_TONEAREST);
+    }
+
+    unsigned int exc = 0;
+
+    if ((host & FE_INEXACT) != 0) {
+        exc |= FPU_EXC_I;
+    }
+
+    if ((host & FE_UNDERFLOW) != 0) {
+        exc |= FPU_EXC_U;
+    }
+
+    if ((host & FE_OVERFLOW) != 0) {
+        exc |= FPU_EXC_O;
+    }
+
+    if ((host & FE_DIVBYZERO) != 0) {
+        exc |= FPU_EXC_Z;
+    }
+
+    if ((host & FE_INVALID) != 0) {
+        exc |= FPU_EXC_V;
+    }
+
+    return exc;
+}
+
+static inline float s_float(uint32_t val)
+{
+    float res;
+    memcpy(&res, &val, sizeof(res));
+    return res;
+}
+
+static inline uint32_t s_bits(float val)
+{
+    uint32_t res;
+    memcpy(&res, &val, sizeof(res));
+    return res;
+}
+
+static inline double d_float(uint64_t val)
+{
+    double res;
+    memcpy(&res, &val, sizeof(res));
+    return res;
+}
+
+static inline uint64_t d_bits(double val)
+{
+    uint64_t res;
+    memcpy(&res, &val, sizeof(res));
+    return res;
+}
+
+static inline bool s_is_nan(uint32_t val)
+{
+    return (val & ~S_SIGN) > S_EXP;
+}
+
+static inline bool s_is_snan(uint32_t val)
+{
+    return (s_is_nan(val)) && ((val & S_SNAN) != 0);
+}
+
+static inline bool s_is_denormal(uint32_t val)
+{
+    return ((val & S_EXP) == 0) && ((val & ~S_SIGN) != 0);
+}
+
+static inline bool d_is_nan(uint64_t val)
+{
+    return (val & ~D_SIGN) > D_EXP;
+}
+
+static inline bool d_is_snan(uint64_t val)
+{
+    return (d_is_nan(val)) && ((val & D_SNAN) != 0);
+}
+
+static inline bool d_is_denormal(uint64_t val)
+{
+    return ((val & D_EXP) == 0) && ((val & ~D_SIGN) != 0);
+}
+
+/** Handle NaN operands
+ *
+ * A signaling NaN is an invalid operation delivering the default NaN,
+ * a quiet NaN is propagated to the result.
+ *
+ * @return True if there was a NaN operand and the result is set.
+ *
+ */
+static bool s_nan_operands(r4k_cpu_t *cpu, uint32_t a, uint32_t b,
+        uint32_t *res)
+{
+    if ((!s_is_nan(a)) && (!s_is_nan(b))) {
+        return false;
+    }
+
+    if ((s_is_snan(a)) || (s_is_snan(b))) {
+        r4k_fpu_set_cause(cpu, FPU_EXC_V);
+        *res = S_DEFAULT_NAN;
+    } else {
+        r4k_fpu_set_cause(cpu, 0);
+        *res = s_is_nan(a) ? a : b;
+    }
+
+    return true;
+}
+
+static bool d_nan_operands(r4k_cpu_t *cpu, uint64_t a, uint64_t b,
+        uint64_t *res)
+{
+    if ((!d_is_nan(a)) && (!d_is_nan(b))) {
+        return false;
+    }
+
+    if ((d_is_snan(a)) || (d_is_snan(b))) {
+        r4k_fpu_set_cause(cpu, FPU_EXC_V);
+        *res = D_DEFAULT_NAN;
+    } else {
+        r4k_fpu_set_cause(cpu, 0);
+        *res = d_is_nan(a) ? a : b;
+    }
+
+    return true;
+}
+
+/** Adjust the host result to the R4000 conventions */
+static uint32_t s_result(r4k_cpu_t *cpu, uint32_t res, unsigned int exc)
+{
+    if (s_is_nan(res)) {
+        res = S_DEFAULT_NAN;
+    } else if ((fcr31_fs(cpu)) && (s_is_denormal(res))) {
+        res &= S_SIGN;
+        exc |= FPU_EXC_U | FPU_EXC_I;
+    }
+
+    r4k_fpu_set_cause(cpu, exc);
+    return res;
+}
+
+static uint64_t d_result(r4k_cpu_t *cpu, uint64_t res, unsigned int exc)
+{
+    if (d_is_nan(res)) {
+        res = D_DEFAULT_NAN;
+    } else if ((fcr31_fs(cpu)) && (d_is_denormal(res))) {
+        res &= D_SIGN;
+        exc |= FPU_EXC_U | FPU_EXC_I;
+    }
+
+    r4k_fpu_set_cause(cpu, exc);
+    return res;
+}
+
+/** Single precision arithmetic
+ *
+ * @param op Operation.
+ * @param a  First operand.
+ * @param b  Second operand (zero for the unary operations).
+ *
+ * @return Result (valid only if r4k_fpu_trap does not report
+ *         an exception).
+ *
+ */
+uint32_t r4k_fpu_arith_s(r4k_cpu_t *cpu, fpu_op_t op, uint32_t a, uint32_t b)
+{
+    uint32_t res;
+    if (s_nan_operands(cpu, a, b, &res)) {
+        return res;
+    }
+
+    switch (op) {
+    case fpu_op_abs:
+        r4k_fpu_set_cause(cpu, 0);
+        return a & ~S_SIGN;
+    case fpu_op_neg:
+        r4k_fpu_set_cause(cpu, 0);
+        return a ^ S_SIGN;
+    default:
+        break;
+    }
+
+    fpu_rm_t rm = fcr31_rm(cpu);
+
+    /* Keep the host operation between the flag manipulations */
+    volatile float x = s_float(a);
+    volatile float y = s_float(b);
+    volatile float r = 0;
+
+    host_begin(rm);
+
+    switch (op) {
+    case fpu_op_add:
+        r = x + y;
+        break;
+    case fpu_op_sub:
+        r = x - y;
+        break;
+    case fpu_op_mul:
+        r = x * y;
+        break;
+    case fpu_op_div:
+        r = x / y;
+        break;
+    case fpu_op_sqrt:
+        r = sqrtf(x);
+        break;
+    default:
+        ASSERT(false);
+    }
+
+    unsigned int exc = host_end(rm);
+    return s_result(cpu, s_bits(r), exc);
+}
+
+/** Double precision arithmetic
+ *
+ * @see r4k_fpu_arith_s
+ *
+ */
+uint64_t r4k_fpu_arith_d(r4k_cpu_t *cpu, fpu_op_t op, uint64_t a, uint64_t b)
+{
+    uint64_t res;
+    if (d_nan_operands(cpu, a, b, &res)) {
+        return res;
+    }
+
+    switch (op) {
+    case fpu_op_abs:
+        r4k_fpu_set_cause(cpu, 0);
+        return a & ~D_SIGN;
+    case fpu_op_neg:
+        r4k_fpu_set_cause(cpu, 0);
+        return a ^ D_SIGN;
+    default:
+        break;
+    }
+
+    fpu_rm_t rm = fcr31_rm(cpu);
+
+    volatile double x = d_float(a);
+    volatile double y = d_float(b);
+    volatile double r = 0;
+
+    host_begin(rm);
+
+    switch (op) {
+    case fpu_op_add:
+        r = x + y;
+        break;
+    case fpu_op_sub:
+        r = x - y;
+        break;
+    case fpu_op_mul:
+        r = x * y;
+        break;
+    case fpu_op_div:
+        r = x / y;
+        break;
+    case fpu_op_sqrt:
+        r = sqrt(x);
+        break;
+    default:
+        ASSERT(false);
+    }
+
+    unsigned int exc = host_end(rm);
+    return d_result(cpu, d_bits(r), exc);
+}
+
+/** Compare two single precision values
+ *
+ * @param cond Condition (FPU_COND_* bits).
+ *
+ * @return Value of the condition.
+ *
+ */
+bool r4k_fpu_compare_s(r4k_cpu_t *cpu, uint32_t a, uint32_t b,
+        unsigned int cond)
+{
+    if ((s_is_nan(a)) || (s_is_nan(b))) {
+        bool invalid = (s_is_snan(a)) || (s_is_snan(b))
+                || ((cond & FPU_COND_SIGNAL) != 0);
+
+        r4k_fpu_set_cause(cpu, invalid ? FPU_EXC_V : 0);
+        return (cond & FPU_COND_UN) != 0;
+    }
+
+    r4k_fpu_set_cause(cpu, 0);
+
+    float x = s_float(a);
+    float y = s_float(b);
+
+    return (((cond & FPU_COND_EQ) != 0) && (x == y))
+            || (((cond & FPU_COND_LT) != 0) && (x < y));
+}
+
+/** Compare two double precision values
+ *
+ * @see r4k_fpu_compare_s
+ *
+ */
+bool r4k_fpu_compare_d(r4k_cpu_t *cpu, uint64_t a, uint64_t b,
+        unsigned int cond)
+{
+    if ((d_is_nan(a)) || (d_is_nan(b))) {
+        bool invalid = (d_is_snan(a)) || (d_is_snan(b))
+                || ((cond & FPU_COND_SIGNAL) != 0);
+
+        r4k_fpu_set_cause(cpu, invalid ? FPU_EXC_V : 0);
+        return (cond & FPU_COND_UN) != 0;
+    }
+
+    r4k_fpu_set_cause(cpu, 0);
+
+    double x = d_float(a);
+    double y = d_float(b);
+
+    return (((cond & FPU_COND_EQ) != 0) && (x == y))
+            || (((cond & FPU_COND_LT) != 0) && (x < y));
+}
+
+uint32_t r4k_fpu_cvt_s_d(r4k_cpu_t *cpu, uint64_t a)
+{
+    if (d_is_nan(a)) {
+        r4k_fpu_set_cause(cpu, d_is_snan(a) ? FPU_EXC_V : 0);
+        return S_DEFAULT_NAN;
+    }
+
+    fpu_rm_t rm = fcr31_rm(cpu);
+
+    volatile double x = d_float(a);
+    volatile float r;
+
+    host_begin(rm);
+    r = (float) x;
+    unsigned int exc = host_end(rm);
+
+    return s_result(cpu, s_bits(r), exc);
+}
+
+uint32_t r4k_fpu_cvt_s_w(r4k_cpu_t *cpu, uint32_t a)
+{
+    fpu_rm_t rm = fcr31_rm(cpu);
+
+    volatile int32_t x = (int32_t) a;
+    volatile float r;
+
+    host_begin(rm);
+    r = (float) x;
+    unsigned int exc = host_end(rm);
+
+    return s_result(cpu, s_bits(r), exc);
+}
+
+uint32_t r4k_fpu_cvt_s_l(r4k_cpu_t *cpu, uint64_t a)
+{
+    fpu_rm_t rm = fcr31_rm(cpu);
+
+    volatile int64_t x = (int64_t) a;
+    volatile float r;
+
+    host_begin(rm);
+    r = (float) x;
+    unsigned int exc = host_end(rm);
+
+    return s_result(cpu, s_bits(r), exc);
+}
+
+/** Widening is exact, only the NaNs need attention */
+uint64_t r4k_fpu_cvt_d_s(r4k_cpu_t *cpu, uint32_t a)
+{
+    if (s_is_nan(a)) {
+        r4k_fpu_set_cause(cpu, s_is_snan(a) ? FPU_EXC_V : 0);
+        return D_DEFAULT_NAN;
+    }
+
+    r4k_fpu_set_cause(cpu, 0);
+    return d_bits((double) s_float(a));
+}
+
+uint64_t r4k_fpu_cvt_d_w(r4k_cpu_t *cpu, uint32_t a)
+{
+    r4k_fpu_set_cause(cpu, 0);
+    return d_bits((double) (int32_t) a);
+}
+
+uint64_t r4k_fpu_cvt_d_l(r4k_cpu_t *cpu, uint64_t a)
+{
+    fpu_rm_t rm = fcr31_rm(cpu);
+
+    volatile int64_t x = (int64_t) a;
+    volatile double r;
+
+    host_begin(rm);
+    r = (double) x;
+    unsigned int exc = host_end(rm);
+
+    return d_result(cpu, d_bits(r), exc);
+}
+
+/** Round to an integer
+ *
+ * The rounding is done on the integer part and the (exactly
+ * representable) fraction, so the host rounding mode is not involved.
+ * NaNs, infinities and values out of the range of the result are
+ * invalid and deliver the largest positive integer.
+ *
+ */
+static uint64_t to_int(r4k_cpu_t *cpu, double x, fpu_rm_t rm, bool dword)
+{
+    uint64_t invalid = dword ? L_INVALID : W_INVALID;
+
+    /* NaNs fail both comparisons */
+    if (!((x >= -0x1p63) && (x < 0x1p63))) {
+        r4k_fpu_set_cause(cpu, FPU_EXC_V);
+        return invalid;
+    }
+
+    int64_t val = (int64_t) x;
+    double frac = x - (double) val;
+
+    switch (rm) {
+    case fpu_rm_RN:
+        if ((frac > 0.5) || ((frac == 0.5) && ((val & 1) != 0))) {
+            val++;
+        } else if ((frac < -0.5) || ((frac == -0.5) && ((val & 1) != 0))) {
+            val--;
+        }
+        break;
+    case fpu_rm_RZ:
+        break;
+    case fpu_rm_RP:
+        if (frac > 0) {
+            val++;
+        }
+        break;
+    case fpu_rm_RM:
+        if (frac < 0) {
+            val--;
+        }
+        break;
+    }
+
+    if ((!dword) && ((val < INT32_MIN) || (val > INT32_MAX))) {
+        r4k_fpu_set_cause(cpu, FPU_EXC_V);
+        return invalid;
+    }
+
+    r4k_fpu_set_cause(cpu, (frac != 0) ? FPU_EXC_I : 0);
+    return dword ? (uint64_t) val : (uint32_t) val;
+}
+
+/** Convert a single precision value to an integer
+ *
+ * @param rm    Rounding mode.
+ * @param dword Convert to a 64-bit integer (L) instead of a 32-bit
+ *              one (W).
+ *
+ */
+uint64_t r4k_fpu_to_int_s(r4k_cpu_t *cpu, uint32_t a, fpu_rm_t rm, bool dword)
+{
+    if (s_is_nan(a)) {
+        r4k_fpu_set_cause(cpu, FPU_EXC_V);
+        return dword ? L_INVALID : W_INVALID;
+    }
+
+    return to_int(cpu, (double) s_float(a), rm, dword);
+}
+
+/** Convert a double precision value to an integer
+ *
+ * @see r4k_fpu_to_int_s
+ *
+ */
+uint64_t r4k_fpu_to_int_d(r4k_cpu_t *cpu, uint64_t a, fpu_rm_t rm, bool dword)
+{
+    return to_int(cpu, d_float(a), rm, dword);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  MIPS R4000 floating-point unit (coprocessor 1)
+ *
+ */
+
+#ifndef MIPS_R4000_FPU_H_
+#define MIPS_R4000_FPU_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cpu.h"
+
+/** Floating-point register access
+ *
+ * With Status.FR set there are 32 64-bit registers. Otherwise there
+ * are 32 32-bit registers and the 64-bit values occupy even-odd
+ * pairs (the even register holds the lower word). The 32-bit
+ * registers are always kept in the lower words of fpregs.
+ *
+ */
+
+static inline uint32_t r4k_fpr_get32(r4k_cpu_t *cpu, unsigned int reg)
+{
+    return (uint32_t) cpu->fpregs[reg];
+}
+
+static inline void r4k_fpr_set32(r4k_cpu_t *cpu, unsigned int reg, uint32_t val)
+{
+    cpu->fpregs[reg] = (cpu->fpregs[reg] & UINT64_C(0xffffffff00000000)) | val;
+}
+
+static inline uint64_t r4k_fpr_get64(r4k_cpu_t *cpu, unsigned int reg)
+{
+    if (cp0_status_fr(cpu)) {
+        return cpu->fpregs[reg];
+    }
+
+    reg &= ~1U;
+    return (cpu->fpregs[reg + 1] << 32) | (uint32_t) cpu->fpregs[reg];
+}
+
+static inline void r4k_fpr_set64(r4k_cpu_t *cpu, unsigned int reg, uint64_t val)
+{
+    if (cp0_status_fr(cpu)) {
+        cpu->fpregs[reg] = val;
+        return;
+    }
+
+    reg &= ~1U;
+    r4k_fpr_set32(cpu, reg, (uint32_t) val);
+    r4k_fpr_set32(cpu, reg + 1, (uint32_t) (val >> 32));
+}
+
+/** Finish an arithmetic operation
+ *
+ * The operation has already stored its exceptions into the cause
+ * field. If any of them is enabled (or the operation is unimplemented)
+ * the Floating-Point exception is raised and the result must not be
+ * written. Otherwise the exceptions are accumulated in the flags.
+ *
+ * @return True if the Floating-Point exception should be raised.
+ *
+ */
+static inline bool r4k_fpu_trap(r4k_cpu_t *cpu)
+{
+    uint32_t cause = fcr31_cause(cpu);
+
+    if ((cause & (fcr31_enables(cpu) | FPU_EXC_E)) != 0) {
+        return true;
+    }
+
+    cpu->fcr31 |= cause << fcr31_flags_shift;
+    return false;
+}
+
+/** Bits of the condition of the C.cond.fmt instructions */
+#define FPU_COND_UN 0x01 /**< True if unordered */
+#define FPU_COND_EQ 0x02 /**< True if equal */
+#define FPU_COND_LT 0x04 /**< True if less than */
+#define FPU_COND_SIGNAL 0x08 /**< Invalid operation if unordered */
+
+/** Arithmetic operations */
+typedef enum {
+    fpu_op_add,
+    fpu_op_sub,
+    fpu_op_mul,
+    fpu_op_div,
+    fpu_op_sqrt,
+    fpu_op_abs,
+    fpu_op_neg
+} fpu_op_t;
+
+extern void r4k_fpu_set_cause(r4k_cpu_t *cpu, unsigned int cause);
+
+extern uint32_t r4k_fpu_arith_s(r4k_cpu_t *cpu, fpu_op_t op, uint32_t a,
+        uint32_t b);
+extern uint64_t r4k_fpu_arith_d(r4k_cpu_t *cpu, fpu_op_t op, uint64_t a,
+        uint64_t b);
+
+extern bool r4k_fpu_compare_s(r4k_cpu_t *cpu, uint32_t a, uint32_t b,
+        unsigned int cond);
+extern bool r4k_fpu_compare_d(r4k_cpu_t *cpu, uint64_t a, uint64_t b,
+        unsigned int cond);
+
+extern uint32_t r4k_fpu_cvt_s_d(r4k_cpu_t *cpu, uint64_t a);
+extern uint32_t r4k_fpu_cvt_s_w(r4k_cpu_t *cpu, uint32_t a);
+extern uint32_t r4k_fpu_cvt_s_l(r4k_cpu_t *cpu, uint64_t a);
+extern uint64_t r4k_fpu_cvt_d_s(r4k_cpu_t *cpu, uint32_t a);
+extern uint64_t r4k_fpu_cvt_d_w(r4k_cpu_t *cpu, uint32_t a);
+extern uint64_t r4k_fpu_cvt_d_l(r4k_cpu_t *cpu, uint64_t a);
+
+extern uint64_t r4k_fpu_to_int_s(r4k_cpu_t *cpu, uint32_t a, fpu_rm_t rm,
+        bool dword);
+extern uint64_t r4k_fpu_to_int_d(r4k_cpu_t *cpu, uint64_t a, fpu_rm_t rm,
+        bool dword);
+
+#endif
@@ -0,0 +1,16 @@
+/** Floating-point operation not implemented by the FPU */
+static r4k_exc_t instr__unimplemented(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    r4k_fpu_set_cause(cpu, FPU_EXC_E);
+    return r4k_excFPE;
+}
+
+static void mnemonics__unimplemented(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "(unimplemented)");
+}
@@ -0,0 +1,21 @@
+static r4k_exc_t instr__xroe(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!machine_specific_instructions) {
+        return instr__reserved(cpu, instr);
+    }
+
+    alert("XROE: Region of interest end");
+
+    roi_end(cpu->procno);
+    return r4k_excNone;
+}
+
+static void mnemonics__xroe(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    if (!machine_specific_instructions) {
+        return mnemonics__reserved(addr, instr, mnemonics, comments);
+    }
+
+    string_printf(mnemonics, "_xroe");
+}
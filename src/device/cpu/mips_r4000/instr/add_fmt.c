@@ -0,0 +1,45 @@
+static r4k_exc_t instr_add_s(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint32_t res = r4k_fpu_arith_s(cpu, fpu_op_add,
+            r4k_fpr_get32(cpu, instr.r.rd), r4k_fpr_get32(cpu, instr.r.rt));
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set32(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static r4k_exc_t instr_add_d(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint64_t res = r4k_fpu_arith_d(cpu, fpu_op_add,
+            r4k_fpr_get64(cpu, instr.r.rd), r4k_fpr_get64(cpu, instr.r.rt));
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set64(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static void mnemonics_add_s(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "add.s");
+    disassemble_fd_fs_ft(instr, mnemonics, comments);
+}
+
+static void mnemonics_add_d(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "add.d");
+    disassemble_fd_fs_ft(instr, mnemonics, comments);
+}
@@ -1,16 +1,16 @@
 static r4k_exc_t instr_bc1t(r4k_cpu_t *cpu, r4k_instr_t instr)
 {
-    if (cp0_status_cu1(cpu)) {
-        /* Ignore (always true) */
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    if (fcr31_c(cpu)) {
         cpu->pc_next.ptr += (((int64_t) sign_extend_16_64(instr.i.imm)) << TARGET_SHIFT);
         cpu->branch = BRANCH_COND;
         return r4k_excJump;
     }
 
-    /* Coprocessor unusable */
-    cp0_cause(cpu).val &= ~cp0_cause_ce_mask;
-    cp0_cause(cpu).val |= cp0_cause_ce_cu1;
-    return r4k_excCpU;
+    return r4k_excNone;
 }
 
 static void mnemonics_bc1t(ptr64_t addr, r4k_instr_t instr,
@@ -0,0 +1,61 @@
+/** Names of the conditions of C.cond.fmt */
+static const char *const fpu_cond_name[16] = {
+    "f", "un", "eq", "ueq", "olt", "ult", "ole", "ule",
+    "sf", "ngle", "seq", "ngl", "lt", "nge", "le", "ngt"
+};
+
+static r4k_exc_t instr_c_s(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    bool cond = r4k_fpu_compare_s(cpu, r4k_fpr_get32(cpu, instr.r.rd),
+            r4k_fpr_get32(cpu, instr.r.rt), instr.r.func & 0x0f);
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    if (cond) {
+        cpu->fcr31 |= fcr31_c_mask;
+    } else {
+        cpu->fcr31 &= ~fcr31_c_mask;
+    }
+
+    return r4k_excNone;
+}
+
+static r4k_exc_t instr_c_d(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    bool cond = r4k_fpu_compare_d(cpu, r4k_fpr_get64(cpu, instr.r.rd),
+            r4k_fpr_get64(cpu, instr.r.rt), instr.r.func & 0x0f);
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    if (cond) {
+        cpu->fcr31 |= fcr31_c_mask;
+    } else {
+        cpu->fcr31 &= ~fcr31_c_mask;
+    }
+
+    return r4k_excNone;
+}
+
+static void mnemonics_c_s(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "c.%s.s", fpu_cond_name[instr.r.func & 0x0f]);
+    disassemble_fs_ft(instr, mnemonics, comments);
+}
+
+static void mnemonics_c_d(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "c.%s.d", fpu_cond_name[instr.r.func & 0x0f]);
+    disassemble_fs_ft(instr, mnemonics, comments);
+}
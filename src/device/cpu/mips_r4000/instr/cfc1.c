@@ -1,19 +1,30 @@
 static r4k_exc_t instr_cfc1(r4k_cpu_t *cpu, r4k_instr_t instr)
 {
-    if (cp0_status_cu1(cpu)) {
-        /* Ignored */
-        return r4k_excNone;
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
     }
 
-    /* Coprocessor unusable */
-    cp0_cause(cpu).val &= ~cp0_cause_ce_mask;
-    cp0_cause(cpu).val |= cp0_cause_ce_cu1;
-    return r4k_excCpU;
+    uint32_t val;
+
+    switch (instr.r.rd) {
+    case 0:
+        val = FCR0_IMPL;
+        break;
+    case 31:
+        val = cpu->fcr31;
+        break;
+    default:
+        /* Reserved */
+        val = 0;
+    }
+
+    cpu->regs[instr.r.rt].val = sign_extend_32_64(val);
+    return r4k_excNone;
 }
 
 static void mnemonics_cfc1(ptr64_t addr, r4k_instr_t instr,
         string_t *mnemonics, string_t *comments)
 {
     string_printf(mnemonics, "cfc1");
-    disassemble_rt_rs(instr, mnemonics, comments);
+    disassemble_rt_fcr(instr, mnemonics, comments);
 }
@@ -1,19 +1,27 @@
 static r4k_exc_t instr_ctc1(r4k_cpu_t *cpu, r4k_instr_t instr)
 {
-    if (cp0_status_cu1(cpu)) {
-        /* Ignored */
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    /* Only FCR31 is writable */
+    if (instr.r.rd != 31) {
         return r4k_excNone;
     }
 
-    /* Coprocessor unusable */
-    cp0_cause(cpu).val &= ~cp0_cause_ce_mask;
-    cp0_cause(cpu).val |= cp0_cause_ce_cu1;
-    return r4k_excCpU;
+    cpu->fcr31 = cpu->regs[instr.r.rt].lo & fcr31_mask;
+
+    /* Setting an enabled cause bit raises the exception */
+    if ((fcr31_cause(cpu) & (fcr31_enables(cpu) | FPU_EXC_E)) != 0) {
+        return r4k_excFPE;
+    }
+
+    return r4k_excNone;
 }
 
 static void mnemonics_ctc1(ptr64_t addr, r4k_instr_t instr,
         string_t *mnemonics, string_t *comments)
 {
     string_printf(mnemonics, "ctc1");
-    disassemble_rt_rs(instr, mnemonics, comments);
+    disassemble_rt_fcr(instr, mnemonics, comments);
 }
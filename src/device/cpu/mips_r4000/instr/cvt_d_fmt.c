@@ -0,0 +1,65 @@
+static r4k_exc_t instr_cvt_d_s(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint64_t res = r4k_fpu_cvt_d_s(cpu, r4k_fpr_get32(cpu, instr.r.rd));
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set64(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static r4k_exc_t instr_cvt_d_w(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint64_t res = r4k_fpu_cvt_d_w(cpu, r4k_fpr_get32(cpu, instr.r.rd));
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set64(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static r4k_exc_t instr_cvt_d_l(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint64_t res = r4k_fpu_cvt_d_l(cpu, r4k_fpr_get64(cpu, instr.r.rd));
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set64(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static void mnemonics_cvt_d_s(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "cvt.d.s");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
+
+static void mnemonics_cvt_d_w(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "cvt.d.w");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
+
+static void mnemonics_cvt_d_l(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "cvt.d.l");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
@@ -0,0 +1,45 @@
+static r4k_exc_t instr_cvt_l_s(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint64_t res = r4k_fpu_to_int_s(cpu, r4k_fpr_get32(cpu, instr.r.rd),
+            fcr31_rm(cpu), true);
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set64(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static r4k_exc_t instr_cvt_l_d(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint64_t res = r4k_fpu_to_int_d(cpu, r4k_fpr_get64(cpu, instr.r.rd),
+            fcr31_rm(cpu), true);
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set64(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static void mnemonics_cvt_l_s(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "cvt.l.s");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
+
+static void mnemonics_cvt_l_d(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "cvt.l.d");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
@@ -0,0 +1,65 @@
+static r4k_exc_t instr_cvt_s_d(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint32_t res = r4k_fpu_cvt_s_d(cpu, r4k_fpr_get64(cpu, instr.r.rd));
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set32(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static r4k_exc_t instr_cvt_s_w(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint32_t res = r4k_fpu_cvt_s_w(cpu, r4k_fpr_get32(cpu, instr.r.rd));
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set32(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static r4k_exc_t instr_cvt_s_l(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    uint32_t res = r4k_fpu_cvt_s_l(cpu, r4k_fpr_get64(cpu, instr.r.rd));
+    if (r4k_fpu_trap(cpu)) {
+        return r4k_excFPE;
+    }
+
+    r4k_fpr_set32(cpu, instr.r.sa, res);
+    return r4k_excNone;
+}
+
+static void mnemonics_cvt_s_d(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "cvt.s.d");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
+
+static void mnemonics_cvt_s_w(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "cvt.s.w");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
+
+static void mnemonics_cvt_s_l(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "cvt.s.l");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
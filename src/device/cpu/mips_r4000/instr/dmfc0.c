@@ -2,7 +2,13 @@ static r4k_exc_t instr_dmfc0(r4k_cpu_t *cpu, r4k_instr_t instr)
 {
     if (CPU_64BIT_INSTRUCTION(cpu)) {
         if (CP0_USABLE(cpu)) {
-            cpu->regs[instr.r.rt].val = cpu->cp0[instr.r.rd].val;
+            if (instr.r.rd == cp0_PerfCnt) {
+                /* The select field is used by the performance counters only */
+                cpu->regs[instr.r.rt].val = sign_extend_32_64(perf_read(cpu, instr.val & 0x07U));
+            } else {
+                cpu->regs[instr.r.rt].val = cpu->cp0[instr.r.rd].val;
+            }
+
             return r4k_excNone;
         }
 
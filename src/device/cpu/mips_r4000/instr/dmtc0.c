@@ -60,7 +60,12 @@ static r4k_exc_t instr_dmtc0(r4k_cpu_t *cpu, r4k_instr_t instr)
                 break;
             case cp0_Compare:
                 cp0_compare(cpu).val = reg.lo;
-                cp0_cause(cpu).val &= ~(1 << cp0_cause_ip7_shift);
+                cpu->timer_irq = false;
+
+                /* IP7 is shared with the performance counters */
+                if (!cpu->perf_irq) {
+                    cp0_cause(cpu).val &= ~(1 << cp0_cause_ip7_shift);
+                }
                 break;
             case cp0_Status:
                 cp0_status(cpu).val = reg.val & UINT32_C(0xff77ff1f);
@@ -114,8 +119,9 @@ static r4k_exc_t instr_dmtc0(r4k_cpu_t *cpu, r4k_instr_t instr)
             case cp0_Res5:
                 /* Ignored, reserved */
                 break;
-            case cp0_Res6:
-                /* Ignored, reserved */
+            case cp0_PerfCnt:
+                /* The counters are 32 bits wide */
+                perf_write(cpu, instr.val & 0x07U, reg.lo);
                 break;
             case cp0_ECC:
                 /* Ignored for simulation */
@@ -1,14 +1,15 @@
 static r4k_exc_t instr_dmtc1(r4k_cpu_t *cpu, r4k_instr_t instr)
 {
-    if (cp0_status_cu1(cpu)) {
-        /* Ignored */
+    if (CPU_64BIT_INSTRUCTION(cpu)) {
+        if (!cp0_status_cu1(cpu)) {
+            return cop1_unusable(cpu);
+        }
+
+        r4k_fpr_set64(cpu, instr.r.rd, cpu->regs[instr.r.rt].val);
         return r4k_excNone;
     }
 
-    /* Coprocessor unusable */
-    cp0_cause(cpu).val &= ~cp0_cause_ce_mask;
-    cp0_cause(cpu).val |= cp0_cause_ce_cu1;
-    return r4k_excCpU;
+    return r4k_excRI;
 }
 
 static void mnemonics_dmtc1(ptr64_t addr, r4k_instr_t instr,
@@ -1,19 +1,24 @@
 static r4k_exc_t instr_ldc1(r4k_cpu_t *cpu, r4k_instr_t instr)
 {
-    if (cp0_status_cu1(cpu)) {
-        /* Ignored */
-        return r4k_excNone;
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
     }
 
-    /* Coprocessor unusable */
-    cp0_cause(cpu).val &= ~cp0_cause_ce_mask;
-    cp0_cause(cpu).val |= cp0_cause_ce_cu1;
-    return r4k_excCpU;
+    ptr64_t addr;
+    addr.ptr = cpu->regs[instr.i.rs].val + sign_extend_16_64(instr.i.imm);
+
+    uint64_t val;
+    r4k_exc_t res = cpu_read_mem64(cpu, addr, &val, true);
+    if (res == r4k_excNone) {
+        r4k_fpr_set64(cpu, instr.i.rt, val);
+    }
+
+    return res;
 }
 
 static void mnemonics_ldc1(ptr64_t addr, r4k_instr_t instr,
         string_t *mnemonics, string_t *comments)
 {
     string_printf(mnemonics, "ldc1");
-    disassemble_rt_offset_base(instr, mnemonics, comments);
+    disassemble_ft_offset_base(instr, mnemonics, comments);
 }
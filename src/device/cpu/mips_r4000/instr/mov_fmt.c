@@ -0,0 +1,33 @@
+static r4k_exc_t instr_mov_s(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    r4k_fpr_set32(cpu, instr.r.sa, r4k_fpr_get32(cpu, instr.r.rd));
+    return r4k_excNone;
+}
+
+static r4k_exc_t instr_mov_d(r4k_cpu_t *cpu, r4k_instr_t instr)
+{
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
+    }
+
+    r4k_fpr_set64(cpu, instr.r.sa, r4k_fpr_get64(cpu, instr.r.rd));
+    return r4k_excNone;
+}
+
+static void mnemonics_mov_s(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "mov.s");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
+
+static void mnemonics_mov_d(ptr64_t addr, r4k_instr_t instr,
+        string_t *mnemonics, string_t *comments)
+{
+    string_printf(mnemonics, "mov.d");
+    disassemble_fd_fs(instr, mnemonics, comments);
+}
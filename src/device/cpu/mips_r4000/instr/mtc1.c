@@ -1,14 +1,11 @@
 static r4k_exc_t instr_mtc1(r4k_cpu_t *cpu, r4k_instr_t instr)
 {
-    if (cp0_status_cu1(cpu)) {
-        /* Ignored */
-        return r4k_excNone;
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
     }
 
-    /* Coprocessor unusable */
-    cp0_cause(cpu).val &= ~cp0_cause_ce_mask;
-    cp0_cause(cpu).val |= cp0_cause_ce_cu1;
-    return r4k_excCpU;
+    r4k_fpr_set32(cpu, instr.r.rd, cpu->regs[instr.r.rt].lo);
+    return r4k_excNone;
 }
 
 static void mnemonics_mtc1(ptr64_t addr, r4k_instr_t instr,
@@ -1,19 +1,17 @@
 static r4k_exc_t instr_sdc1(r4k_cpu_t *cpu, r4k_instr_t instr)
 {
-    if (cp0_status_cu1(cpu)) {
-        /* Ignored */
-        return r4k_excNone;
+    if (!cp0_status_cu1(cpu)) {
+        return cop1_unusable(cpu);
     }
 
-    /* Coprocessor unusable */
-    cp0_cause(cpu).val &= ~cp0_cause_ce_mask;
-    cp0_cause(cpu).val |= cp0_cause_ce_cu1;
-    return r4k_excCpU;
+    ptr64_t addr;
+    addr.ptr = cpu->regs[instr.i.rs].val + sign_extend_16_64(instr.i.imm);
+    return cpu_write_mem64(cpu, addr, r4k_fpr_get64(cpu, instr.i.rt), true);
 }
 
 static void mnemonics_sdc1(ptr64_t addr, r4k_instr_t instr,
         string_t *mnemonics, string_t *comments)
 {
     string_printf(mnemonics, "sdc1");
-    disassemble_rt_offset_base(instr, mnemonics, comments);
+    disassemble_ft_offset_base(instr, mnemonics, comments);
 }
@@ -15,9 +15,13 @@
 #include <string.h>
 
 #include "../../../assert.h"
+#include "../../../debug/memusage.h"
+#include "../../../debug/profile.h"
+#include "../../../debug/sample.h"
 #include "../../../list.h"
 #include "../../../main.h"
 #include "../../../physmem.h"
+#include "../../../replay.h"
 #include "../../../utils.h"
 #include "cpu.h"
 #include "csr.h"
@@ -27,16 +31,30 @@
 
 /// Caching of decoded instructions
 
+/**
+ * @brief Decoded instruction
+ *
+ * Compressed instructions are expanded to their base ISA form,
+ * the raw bits are kept for the traces and the exceptions.
+ */
+typedef struct {
+    rv_instr_func_t func; // The handler, NULL if the instruction crosses the page boundary
+    rv_instr_t instr; // The instruction passed to the handler
+    uint32_t raw; // The instruction as in memory (16 bits if compressed)
+} cache_instr_t;
+
 /**
  * @brief Item of a list of pages of cached instructions
+ *
+ * Instructions are 2-byte aligned, there is a slot for every halfword.
  */
 typedef struct {
     item_t item; // The list item
     ptr36_t addr; // The base address of the page
-    rv_instr_func_t instrs[FRAME_SIZE / sizeof(rv_instr_t)]; // Decoded instructions (represented as function pointers)
+    cache_instr_t instrs[FRAME_SIZE / sizeof(uint16_t)]; // Decoded instructions
 } cache_item_t;
 
-#define PHYS2CACHEINSTR(phys) (((phys) & FRAME_MASK) / sizeof(rv_instr_t))
+#define PHYS2CACHEINSTR(phys) (((phys) & FRAME_MASK) / sizeof(uint16_t))
 
 static void cache_item_init(cache_item_t *cache_item)
 {
@@ -47,6 +65,24 @@ static void cache_item_init(cache_item_t *cache_item)
 
 list_t rv_instruction_cache = LIST_INITIALIZER;
 
+/**
+ * @brief Accounts the cache of decoded instructions
+ *
+ * The cache is shared by all RV32IMA processors and it is never
+ * shrunk, a page once executed stays in the cache.
+ */
+void rv_cache_memusage(memusage_t *usage)
+{
+    cache_item_t *cache_item;
+    for_each(rv_instruction_cache, cache_item, cache_item_t)
+    {
+        memusage_add(usage, MEMUSAGE_DECODE_CACHE, sizeof(cache_item_t));
+    }
+}
+
+/** Hook called before exceptions trap (user-mode emulation) */
+rv_trap_hook_t rv_trap_hook = NULL;
+
 /**
  * @brief Looks into cache for the instruction on the given physical address
  * @par phys The physical address to check
@@ -67,15 +103,48 @@ static bool cache_hit(ptr36_t phys, cache_item_t **cache_item)
     return false;
 }
 
+/**
+ * @brief Decodes the instruction given by its raw bits
+ */
+static void instr_decode(uint32_t raw, cache_instr_t *decoded)
+{
+    if (RV_INSTR_IS_COMPRESSED(raw)) {
+        decoded->raw = (uint16_t) raw;
+        decoded->instr = rv_instr_expand((uint16_t) raw);
+    } else {
+        decoded->raw = raw;
+        decoded->instr.val = raw;
+    }
+
+    decoded->func = rv_instr_decode(decoded->instr);
+}
+
 /**
  * @brief Fills the cache_item instrs field with decoded data based on the addr field
+ *
+ * A 32-bit instruction in the last halfword of the page continues
+ * on the next page (which might be mapped elsewhere), it is left
+ * to be decoded on every execution.
  */
 static void cache_item_page_decode(rv_cpu_t *cpu, cache_item_t *cache_item)
 {
-    for (size_t i = 0; i < FRAME_SIZE / sizeof(rv_instr_t); ++i) {
-        ptr36_t addr = cache_item->addr + (i * sizeof(rv_instr_t));
-        rv_instr_t instr_data = (rv_instr_t) physmem_read32(cpu->csr.mhartid, addr, false);
-        cache_item->instrs[i] = rv_instr_decode(instr_data);
+    const size_t count = FRAME_SIZE / sizeof(uint16_t);
+    uint16_t next = physmem_read16(cpu->csr.mhartid, cache_item->addr, false);
+
+    for (size_t i = 0; i < count; ++i) {
+        uint16_t low = next;
+        cache_instr_t *decoded = &cache_item->instrs[i];
+
+        if (i + 1 < count) {
+            ptr36_t addr = cache_item->addr + ((i + 1) * sizeof(uint16_t));
+            next = physmem_read16(cpu->csr.mhartid, addr, false);
+        } else if (!RV_INSTR_IS_COMPRESSED(low)) {
+            decoded->func = NULL;
+            decoded->raw = low;
+            continue;
+        }
+
+        instr_decode(((uint32_t) next << 16) | low, decoded);
     }
 }
 
@@ -126,8 +195,10 @@ static cache_item_t *cache_try_add(rv_cpu_t *cpu, ptr36_t phys)
  * @brief Fethes a decoded instruction from memory
  *
  * Consults the cache first and updates the cache on misses or on invalid memory
+ *
+ * @return Whether the instruction was found in the cache
  */
-static rv_instr_func_t fetch_instr(rv_cpu_t *cpu, ptr36_t phys)
+static bool fetch_instr(rv_cpu_t *cpu, ptr36_t phys, cache_instr_t *decoded)
 {
     cache_item_t *cache_item = NULL;
 
@@ -142,16 +213,54 @@ static rv_instr_func_t fetch_instr(rv_cpu_t *cpu, ptr36_t phys)
             list_push(&rv_instruction_cache, &cache_item->item);
         }
 
-        return cache_item->instrs[PHYS2CACHEINSTR(phys)];
+        *decoded = cache_item->instrs[PHYS2CACHEINSTR(phys)];
+        return true;
     }
 
     cache_item = cache_try_add(cpu, phys);
 
     if (cache_item != NULL) {
-        return cache_item->instrs[PHYS2CACHEINSTR(phys)];
+        *decoded = cache_item->instrs[PHYS2CACHEINSTR(phys)];
+        return true;
     }
+
     alert("Trying to fetch instructions from outside of physical memory");
-    return rv_instr_decode((rv_instr_t) physmem_read32(cpu->csr.mhartid, phys, true));
+    decoded->func = NULL;
+    decoded->raw = physmem_read16(cpu->csr.mhartid, phys, true);
+    return false;
+}
+
+/**
+ * @brief Fetches the instruction PC is pointing to
+ *
+ * Instructions which cross the page boundary (or lie outside of
+ * the physical memory) are decoded on every execution, the second
+ * halfword is translated separately.
+ */
+static rv_exc_t fetch_pc(rv_cpu_t *cpu, ptr36_t phys, cache_instr_t *decoded)
+{
+    if (fetch_instr(cpu, phys, decoded) && (decoded->func != NULL)) {
+        return rv_exc_none;
+    }
+
+    uint32_t raw = decoded->raw;
+
+    if (!RV_INSTR_IS_COMPRESSED(raw)) {
+        ptr36_t phys_high = phys + 2;
+
+        if (IS_ALIGNED(phys_high, FRAME_SIZE)) {
+            rv_exc_t ex = rv_convert_addr(cpu, cpu->pc + 2, &phys_high, false, true, true);
+            if (ex != rv_exc_none) {
+                cpu->csr.tval_next = cpu->pc + 2;
+                return ex;
+            }
+        }
+
+        raw |= (uint32_t) physmem_read16(cpu->csr.mhartid, phys_high, false) << 16;
+    }
+
+    instr_decode(raw, decoded);
+    return rv_exc_none;
 }
 
 static void init_regs(rv_cpu_t *cpu)
@@ -178,8 +287,12 @@ void rv_cpu_init(rv_cpu_t *cpu, unsigned int procno)
 
     rv_init_csr(&cpu->csr, procno);
 
+    rv_instr_decode_init();
+
     rv_tlb_init(&cpu->tlb, DEFAULT_RV_TLB_SIZE);
 
+    cost_init(&cpu->cost);
+
     cpu->priv_mode = rv_mmode;
 }
 
@@ -196,6 +309,7 @@ void rv_cpu_done(rv_cpu_t *cpu)
     }
 
     rv_tlb_done(&cpu->tlb);
+    cost_done(&cpu->cost);
 }
 
 static_assert((sizeof(sv32_pte_t) == 4), "wrong size of sv32_pte_t");
@@ -334,7 +448,8 @@ static rv_exc_t rv_pagewalk(rv_cpu_t *cpu, uint32_t virt, ptr36_t *phys, bool wr
 
         pte_val = uint_from_pte(pte);
 
-        if (noisy) {
+        // The lock-step shadow leaves the page tables to the reference
+        if ((noisy) && (physmem_store_check == NULL)) {
             physmem_write32(cpu->csr.mhartid, pte_addr, pte_val, true);
         }
     }
@@ -491,6 +606,86 @@ static bool try_write_memory_mapped_regs(rv_cpu_t *cpu, uint32_t virt, uint32_t
         return (ex); \
     }
 
+/**
+ * @brief Translates the address of every byte of a misaligned access
+ *
+ * The access spans at most two pages, both of them are translated
+ * before any byte is accessed, so that the access faults as a whole.
+ */
+static rv_exc_t convert_misaligned(rv_cpu_t *cpu, uint32_t virt, unsigned int size, ptr36_t *phys, bool wr, bool noisy)
+{
+    uint32_t second = ALIGN_DOWN(virt + size - 1, FRAME_SIZE);
+    ptr36_t phys_first;
+    ptr36_t phys_second;
+
+    rv_exc_t ex = rv_convert_addr(cpu, virt, &phys_first, wr, false, noisy);
+    if (ex != rv_exc_none) {
+        throw_ex(cpu, virt, ex, noisy);
+    }
+
+    if (second > virt) {
+        // The fault reports the first byte on the second page
+        ex = rv_convert_addr(cpu, second, &phys_second, wr, false, noisy);
+        if (ex != rv_exc_none) {
+            throw_ex(cpu, second, ex, noisy);
+        }
+    }
+
+    for (unsigned int i = 0; i < size; i++) {
+        if ((second > virt) && (virt + i >= second)) {
+            phys[i] = phys_second + (virt + i - second);
+        } else {
+            phys[i] = phys_first + i;
+        }
+    }
+
+    if (noisy) {
+        cpu->misaligned_count++;
+    }
+
+    return rv_exc_none;
+}
+
+/** @brief Reads a misaligned little-endian value byte by byte */
+static rv_exc_t read_misaligned(rv_cpu_t *cpu, uint32_t virt, unsigned int size, uint32_t *value, bool noisy)
+{
+    ptr36_t phys[4];
+
+    rv_exc_t ex = convert_misaligned(cpu, virt, size, phys, false, noisy);
+    if (ex != rv_exc_none) {
+        return ex;
+    }
+
+    uint32_t val = 0;
+    for (unsigned int i = 0; i < size; i++) {
+        val |= (uint32_t) physmem_read8(cpu->csr.mhartid, phys[i], true) << (i * 8);
+    }
+
+    *value = val;
+    return rv_exc_none;
+}
+
+/** @brief Writes a misaligned little-endian value byte by byte */
+static rv_exc_t write_misaligned(rv_cpu_t *cpu, uint32_t virt, unsigned int size, uint32_t value, bool noisy)
+{
+    ptr36_t phys[4];
+
+    rv_exc_t ex = convert_misaligned(cpu, virt, size, phys, true, noisy);
+    if (ex != rv_exc_none) {
+        return ex;
+    }
+
+    for (unsigned int i = 0; i < size; i++) {
+        physmem_write8(cpu->csr.mhartid, phys[i], (uint8_t) (value >> (i * 8)), true);
+    }
+
+    return rv_exc_none;
+}
+
+/** Misaligned data accesses are performed by the hardware */
+#define misaligned_in_hardware(cpu, virt, size, fetch) \
+    ((!IS_ALIGNED((virt), (size))) && ((cpu)->misaligned_access) && (!(fetch)))
+
 /**
  * @brief Reads 32 bits from virtual memory
  *
@@ -510,6 +705,10 @@ rv_exc_t rv_read_mem32(rv_cpu_t *cpu, uint32_t virt, uint32_t *value, bool fetch
         return rv_exc_none;
     }
 
+    if (misaligned_in_hardware(cpu, virt, 4, fetch)) {
+        return read_misaligned(cpu, virt, 4, value, noisy);
+    }
+
     ptr36_t phys;
     rv_exc_t ex = rv_convert_addr(cpu, virt, &phys, false, fetch, noisy);
 
@@ -546,6 +745,15 @@ rv_exc_t rv_read_mem16(rv_cpu_t *cpu, uint32_t virt, uint16_t *value, bool fetch
         return rv_exc_none;
     }
 
+    if (misaligned_in_hardware(cpu, virt, 2, fetch)) {
+        uint32_t val;
+        rv_exc_t ex = read_misaligned(cpu, virt, 2, &val, noisy);
+        if (ex == rv_exc_none) {
+            *value = (uint16_t) val;
+        }
+        return ex;
+    }
+
     ptr36_t phys;
     rv_exc_t ex = rv_convert_addr(cpu, virt, &phys, false, fetch, noisy);
 
@@ -641,6 +849,10 @@ rv_exc_t rv_write_mem16(rv_cpu_t *cpu, uint32_t virt, uint16_t value, bool noisy
         return rv_exc_none;
     }
 
+    if (misaligned_in_hardware(cpu, virt, 2, false)) {
+        return write_misaligned(cpu, virt, 2, value, noisy);
+    }
+
     ptr36_t phys;
     rv_exc_t ex = rv_convert_addr(cpu, virt, &phys, true, false, noisy);
 
@@ -679,6 +891,10 @@ rv_exc_t rv_write_mem32(rv_cpu_t *cpu, uint32_t virt, uint32_t value, bool noisy
         return rv_exc_none;
     }
 
+    if (misaligned_in_hardware(cpu, virt, 4, false)) {
+        return write_misaligned(cpu, virt, 4, value, noisy);
+    }
+
     ptr36_t phys;
     rv_exc_t ex = rv_convert_addr(cpu, virt, &phys, true, false, noisy);
 
@@ -699,6 +915,7 @@ rv_exc_t rv_write_mem32(rv_cpu_t *cpu, uint32_t virt, uint32_t value, bool noisy
     return rv_exc_none;
 }
 
+#undef misaligned_in_hardware
 #undef throw_ex
 
 /**
@@ -708,7 +925,7 @@ rv_exc_t rv_write_mem32(rv_cpu_t *cpu, uint32_t virt, uint32_t value, bool noisy
 void rv_cpu_set_pc(rv_cpu_t *cpu, uint32_t value)
 {
     ASSERT(cpu != NULL);
-    if (!IS_ALIGNED(value, 4)) {
+    if (!IS_ALIGNED(value, RV_IALIGN)) {
         return;
     }
     /* Set both pc and pc_next
@@ -977,7 +1194,7 @@ static void account(rv_cpu_t *cpu, bool instruction_retired)
     }
 
     // mtime cannot be inhibited
-    uint64_t current_tick_time = current_timestamp();
+    uint64_t current_tick_time = replay_timestamp(cpu->csr.mhartid);
     cpu->csr.mtime += (current_tick_time - cpu->csr.last_tick_time);
     cpu->csr.last_tick_time = current_tick_time;
 
@@ -992,11 +1209,92 @@ static void account(rv_cpu_t *cpu, bool instruction_retired)
     manage_timer_interrupts(cpu);
 }
 
+/**
+ * @brief Check whether an instruction (in the base ISA form) reads an integer register
+ */
+static bool reads_reg(rv_instr_t instr, unsigned int reg)
+{
+    switch (instr.r.opcode) {
+    case rv_opcLUI:
+    case rv_opcAUIPC:
+    case rv_opcJAL:
+    case rv_opcMISC_MEM:
+    case rv_opcOP_FP:
+    case rv_opcMADD:
+    case rv_opcMSUB:
+    case rv_opcNMSUB:
+    case rv_opcNMADD:
+        return false;
+    case rv_opcOP:
+    case rv_opcSTORE:
+    case rv_opcBRANCH:
+    case rv_opcAMO:
+        return (instr.r.rs1 == reg) || (instr.r.rs2 == reg);
+    case rv_opcSYSTEM:
+        /* The immediate forms have no source register */
+        return (instr.i.funct3 != rv_funcPRIV) && ((instr.i.funct3 & 0b100) == 0)
+                && (instr.i.rs1 == reg);
+    default:
+        return instr.r.rs1 == reg;
+    }
+}
+
+/**
+ * @brief Charge the extra cycles of an executed instruction to the cost model
+ *
+ * Kept out of line so that the step without the cost model stays compact.
+ */
+static __attribute__((noinline, cold)) void charge_cost(rv_cpu_t *cpu, rv_instr_t instr, rv_exc_t ex, uint32_t length)
+{
+    cpu_cost_t *cost = &cpu->cost;
+
+    if (ex != rv_exc_none) {
+        cost->model->load_reg = 0;
+        return;
+    }
+
+    if ((cost->model->load_reg != 0) && (reads_reg(instr, cost->model->load_reg))) {
+        cost_charge(cost, COST_LOAD_USE);
+    }
+
+    cost->model->load_reg = 0;
+
+    switch (instr.r.opcode) {
+    case rv_opcLOAD:
+        cost->model->load_reg = instr.i.rd;
+        break;
+    case rv_opcOP:
+        if (instr.r.funct7 == 0b0000001) {
+            cost_charge(cost, ((instr.r.funct3 & 0b100) != 0) ? COST_DIV : COST_MUL);
+        }
+        break;
+    case rv_opcAMO:
+        cost_charge(cost, COST_AMO);
+        break;
+    case rv_opcBRANCH:
+        cost_branch(cost, cpu->pc, cpu->pc_next != cpu->pc + length);
+        break;
+    case rv_opcSYSTEM:
+        if (instr.i.funct3 != rv_funcPRIV) {
+            cost_charge(cost, COST_CSR);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
 /**
  * @brief Execute the instruction that PC is pointing to and handle interrupts or exceptions
+ *
+ * @param costed Whether the cost model is enabled
  */
-static rv_exc_t execute(rv_cpu_t *cpu)
+static rv_exc_t execute(rv_cpu_t *cpu, bool costed)
 {
+    if ((sample_pc_armed) && (cpu->pc == sample_pc)) {
+        sample_hit_pc(cpu->csr.mhartid);
+    }
+
     ptr36_t phys;
     rv_exc_t ex = rv_convert_addr(cpu, cpu->pc, &phys, false, true, true);
 
@@ -1008,17 +1306,36 @@ static rv_exc_t execute(rv_cpu_t *cpu)
         return ex;
     }
 
-    rv_instr_func_t instr_func = fetch_instr(cpu, phys);
-    rv_instr_t instr_data = (rv_instr_t) physmem_read32(cpu->csr.mhartid, phys, true);
+    cache_instr_t decoded;
+    ex = fetch_pc(cpu, phys, &decoded);
+
+    if (ex != rv_exc_none) {
+        alert("Fetching from unconvertable address!");
+        if (machine_trace) {
+            rv_idump(cpu, cpu->pc, (rv_instr_t) 0U);
+        }
+        return ex;
+    }
 
     if (machine_trace) {
-        rv_idump(cpu, cpu->pc, instr_data);
+        rv_idump(cpu, cpu->pc, (rv_instr_t) decoded.raw);
     }
 
-    ex = instr_func(cpu, instr_data);
+    if (machine_profile) {
+        profile_hit(cpu->csr.mhartid, cpu->pc);
+    }
+
+    // Control transfer instructions and traps override the sequential pc_next
+    cpu->pc_next = cpu->pc + RV_INSTR_LENGTH(decoded.raw);
+
+    ex = decoded.func(cpu, decoded.instr);
+
+    if (costed) {
+        charge_cost(cpu, decoded.instr, ex, RV_INSTR_LENGTH(decoded.raw));
+    }
 
     if (ex == rv_exc_illegal_instruction) {
-        cpu->csr.tval_next = instr_data.val;
+        cpu->csr.tval_next = decoded.raw;
     }
 
     return ex;
@@ -1031,14 +1348,31 @@ void rv_cpu_step(rv_cpu_t *cpu)
 {
     ASSERT(cpu != NULL);
 
+    /*
+     * Stall cycles of the cost model. The instruction has been
+     * executed already, only the counters and timers advance.
+     * The model pointer is read once per step.
+     */
+    bool costed = (cpu->cost.model != NULL);
+
+    if ((costed) && (cost_stalled(&cpu->cost))) {
+        account(cpu, false);
+        return;
+    }
+
     rv_exc_t ex = rv_exc_none;
     bool instruction_retired = false;
 
     if (!cpu->stdby) {
-        ex = execute(cpu);
+        ex = execute(cpu, costed);
         instruction_retired = (ex == rv_exc_none);
     }
 
+    if ((ex != rv_exc_none) && (rv_trap_hook != NULL) && (rv_trap_hook(cpu, ex))) {
+        ex = rv_exc_none;
+        instruction_retired = true;
+    }
+
     if (ex != rv_exc_none) {
         handle_exception(cpu, ex);
     } else {
@@ -1050,7 +1384,6 @@ void rv_cpu_step(rv_cpu_t *cpu)
 
     if (!cpu->stdby) {
         cpu->pc = cpu->pc_next;
-        cpu->pc_next = cpu->pc + 4;
     }
 
     // x0 is always 0
@@ -17,6 +17,7 @@
 
 #include "../../../main.h"
 #include "csr.h"
+#include "../cost.h"
 #include "instr.h"
 #include "tlb.h"
 
@@ -25,6 +26,9 @@
 #define RV_MTIME_ADDRESS UINT32_C(0xFF000000)
 #define RV_MTIMECMP_ADDRESS UINT32_C(0xFF000008)
 
+/** Instruction address alignment in bytes (IALIGN=16 with the C extension) */
+#define RV_IALIGN 2
+
 #define RV_INTERRUPT_EXC_BITS UINT32_C(0x80000000)
 #define RV_EXCEPTION_EXC_BITS UINT32_C(0)
 #define RV_EXCEPTION_MASK(exc) (1U << ((exc) & ~RV_INTERRUPT_EXC_BITS))
@@ -83,6 +87,9 @@ typedef struct rv_cpu {
     /** Non privileged registers */
     uint32_t regs[RV_REG_COUNT];
 
+    /** Floating-point registers (single-precision values are NaN-boxed) */
+    uint64_t fregs[RV_REG_COUNT];
+
     /** Control and status registers */
     csr_t csr;
 
@@ -104,14 +111,37 @@ typedef struct rv_cpu {
     /** Tells if the processor is executing or waiting */
     bool stdby;
 
+    /** Perform misaligned loads and stores instead of trapping */
+    bool misaligned_access;
+    /** Number of misaligned loads and stores performed */
+    uint64_t misaligned_count;
+
     /** Translation Lookaside Buffer used for caching translated addresses */
     rv_tlb_t tlb;
 
+    /** Instruction cost model */
+    cpu_cost_t cost;
+
 } rv_cpu_t;
 
+/** Trap hook
+ *
+ * If set, the hook is called for every exception before it traps.
+ * When the hook returns true, the exception is considered handled
+ * and the execution continues with the next instruction. Used by
+ * the user-mode emulation.
+ */
+typedef bool (*rv_trap_hook_t)(rv_cpu_t *cpu, rv_exc_t ex);
+
+extern rv_trap_hook_t rv_trap_hook;
+
 /** Basic CPU routines */
 extern void rv_cpu_init(rv_cpu_t *cpu, unsigned int procno);
 extern void rv_cpu_done(rv_cpu_t *cpu);
+
+/** Host memory accounting */
+struct memusage;
+extern void rv_cache_memusage(struct memusage *usage);
 extern void rv_cpu_set_pc(rv_cpu_t *cpu, uint32_t value);
 extern void rv_cpu_step(rv_cpu_t *cpu);
 
@@ -12,11 +12,14 @@
 #include <stdint.h>
 
 #include "../../../assert.h"
+#include "../../../replay.h"
 #include "../../../utils.h"
 #include "cpu.h"
 #include "csr.h"
 #include "tlb.h"
 
+static void csr_table_init(void);
+
 /**
  * Initialize CSRs
  *
@@ -31,39 +34,32 @@ void rv_init_csr(csr_t *csr, unsigned int procno)
     csr->mimpid = RV_IMPLEMENTATION_ID;
     csr->mhartid = procno;
 
-    csr->mtime = current_timestamp();
+    csr->mtime = replay_timestamp(procno);
     csr->last_tick_time = csr->mtime;
 
     csr->asid_len = rv_asid_len;
+
+    csr_table_init();
 }
 
-#define minimal_privilege(priv, cpu) \
-    { \
-        if (cpu->priv_mode < priv) \
-            return rv_exc_illegal_instruction; \
-    }
-#define default_csr_functions(csr_name, priv) \
+#define default_csr_functions(csr_name) \
     static rv_exc_t csr_name##_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target) \
     { \
-        minimal_privilege(priv, cpu); \
         *target = cpu->csr.csr_name; \
         return rv_exc_none; \
     } \
     static rv_exc_t csr_name##_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value) \
     { \
-        minimal_privilege(priv, cpu); \
         cpu->csr.csr_name = value; \
         return rv_exc_none; \
     } \
     static rv_exc_t csr_name##_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value) \
     { \
-        minimal_privilege(priv, cpu); \
         cpu->csr.csr_name |= value; \
         return rv_exc_none; \
     } \
     static rv_exc_t csr_name##_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value) \
     { \
-        minimal_privilege(priv, cpu); \
         cpu->csr.csr_name &= ~value; \
         return rv_exc_none; \
     }
@@ -139,9 +135,6 @@ static rv_exc_t counter_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 static rv_exc_t counter_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
 
-    // only mmode can write to counters
-    minimal_privilege(rv_mmode, cpu);
-
     // global counters are r/o
     if (rv_csr_min_priv_mode(csr) != rv_mmode) {
         return rv_exc_illegal_instruction;
@@ -188,9 +181,6 @@ static rv_exc_t counter_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 static rv_exc_t counter_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
 
-    // only mmode can write to counters
-    minimal_privilege(rv_mmode, cpu);
-
     // global counters are r/o
     if (rv_csr_min_priv_mode(csr) != rv_mmode) {
         return rv_exc_illegal_instruction;
@@ -226,9 +216,6 @@ static rv_exc_t counter_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t counter_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    // only mmode can write to counters
-    minimal_privilege(rv_mmode, cpu);
-
     // global counters are r/o
     if (rv_csr_min_priv_mode(csr) != rv_mmode) {
         return rv_exc_illegal_instruction;
@@ -266,35 +253,30 @@ static rv_exc_t counter_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t mcountinhibit_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mcountinhibit;
     return rv_exc_none;
 }
 
 static rv_exc_t mcountinhibit_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mcountinhibit = value & mcountinhibit_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mcountinhibit_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mcountinhibit |= value & mcountinhibit_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mcountinhibit_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mcountinhibit &= ~(value & mcountinhibit_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t mhpmevent_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     int event = (csr & 0x1F) - 3;
     *target = cpu->csr.hpmevents[event];
     return rv_exc_none;
@@ -302,7 +284,6 @@ static rv_exc_t mhpmevent_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 
 static rv_exc_t mhpmevent_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     int event = (csr & 0x1F) - 3;
 
     if (value < hpm_event_count) {
@@ -313,7 +294,6 @@ static rv_exc_t mhpmevent_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t mhpmevent_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     int event = (csr & 0x1F) - 3;
 
     int val = cpu->csr.hpmevents[event] | value;
@@ -326,7 +306,6 @@ static rv_exc_t mhpmevent_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t mhpmevent_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     int event = (csr & 0x1F) - 3;
 
     int val = cpu->csr.hpmevents[event] & ~value;
@@ -378,17 +357,94 @@ static rv_exc_t pmpaddr_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
     return rv_exc_illegal_instruction;
 }
 
+/** Field of fcsr accessed by the given floating-point CSR */
+static void fcsr_field(csr_num_t csr, uint32_t *mask, unsigned int *shift)
+{
+    switch (csr) {
+    case csr_fflags:
+        *mask = rv_csr_fcsr_fflags_mask;
+        *shift = 0;
+        break;
+    case csr_frm:
+        *mask = rv_csr_fcsr_frm_mask;
+        *shift = rv_csr_fcsr_frm_pos;
+        break;
+    default:
+        *mask = rv_csr_fcsr_mask;
+        *shift = 0;
+        break;
+    }
+}
+
+// The floating-point CSRs are not accessible while the unit is off,
+// writes make the floating-point state dirty
+static rv_exc_t fcsr_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
+{
+    if (rv_csr_sstatus_fs(cpu) == rv_fs_off) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t mask;
+    unsigned int shift;
+    fcsr_field(csr, &mask, &shift);
+
+    *target = (cpu->csr.fcsr & mask) >> shift;
+    return rv_exc_none;
+}
+
+static rv_exc_t fcsr_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
+{
+    if (rv_csr_sstatus_fs(cpu) == rv_fs_off) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t mask;
+    unsigned int shift;
+    fcsr_field(csr, &mask, &shift);
+
+    cpu->csr.fcsr = (cpu->csr.fcsr & ~mask) | ((value << shift) & mask);
+    rv_csr_mstatus_set_fs_dirty(cpu);
+    return rv_exc_none;
+}
+
+static rv_exc_t fcsr_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
+{
+    if (rv_csr_sstatus_fs(cpu) == rv_fs_off) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t mask;
+    unsigned int shift;
+    fcsr_field(csr, &mask, &shift);
+
+    cpu->csr.fcsr |= (value << shift) & mask;
+    rv_csr_mstatus_set_fs_dirty(cpu);
+    return rv_exc_none;
+}
+
+static rv_exc_t fcsr_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
+{
+    if (rv_csr_sstatus_fs(cpu) == rv_fs_off) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t mask;
+    unsigned int shift;
+    fcsr_field(csr, &mask, &shift);
+
+    cpu->csr.fcsr &= ~((value << shift) & mask);
+    rv_csr_mstatus_set_fs_dirty(cpu);
+    return rv_exc_none;
+}
+
 static rv_exc_t sstatus_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
-    *target = cpu->csr.mstatus & rv_csr_sstatus_mask;
+    *target = (cpu->csr.mstatus & rv_csr_sstatus_mask) | rv_csr_sstatus_sd(cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t sstatus_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     // Masked write of low 32 bits
     cpu->csr.mstatus = (cpu->csr.mstatus & 0xFFFFFFFF00000000) | (value & rv_csr_sstatus_mask);
     return rv_exc_none;
@@ -396,7 +452,6 @@ static rv_exc_t sstatus_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t sstatus_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     // Masked write
     cpu->csr.mstatus |= (value & rv_csr_sstatus_mask);
     return rv_exc_none;
@@ -404,7 +459,6 @@ static rv_exc_t sstatus_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t sstatus_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     // Masked write
     cpu->csr.mstatus &= ~(value & rv_csr_sstatus_mask);
     return rv_exc_none;
@@ -412,15 +466,12 @@ static rv_exc_t sstatus_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t sie_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.mie & rv_csr_si_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sie_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     // write only to si bits, preserve rest
     cpu->csr.mie &= ~rv_csr_si_mask;
     cpu->csr.mie |= value & rv_csr_si_mask;
@@ -429,22 +480,18 @@ static rv_exc_t sie_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t sie_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.mie |= value & rv_csr_si_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sie_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.mie &= ~(value & rv_csr_si_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t sip_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
-
     // The SEIP bit is the logical OR of the value in MIP and the status from external interrupt controller
     // Full explanation RISC-V Privileged spec section 3.1.9 Machine Interrupt Registers (mip and mie)
     *target = (cpu->csr.mip & rv_csr_si_mask)
@@ -455,8 +502,6 @@ static rv_exc_t sip_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 
 static rv_exc_t sip_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     // only ssip is writable
     cpu->csr.mip &= ~rv_csr_ssi_mask;
     cpu->csr.mip |= value & rv_csr_ssi_mask;
@@ -465,14 +510,12 @@ static rv_exc_t sip_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t sip_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.mip |= value & rv_csr_ssi_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sip_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.mip &= ~(value & rv_csr_ssi_mask);
     return rv_exc_none;
 }
@@ -481,92 +524,80 @@ static rv_exc_t sip_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t stvec_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.stvec;
     return rv_exc_none;
 }
 
 static rv_exc_t stvec_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.stvec = value & scvec_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t stvec_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.stvec |= value & scvec_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t stvec_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.stvec &= ~(value & scvec_mask);
     return rv_exc_none;
 }
 
-default_csr_functions(scounteren, rv_smode)
+default_csr_functions(scounteren)
 
 #define senvcfg_mask 0x71
 
-        static rv_exc_t senvcfg_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
+static rv_exc_t senvcfg_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.senvcfg;
     return rv_exc_none;
 }
 
 static rv_exc_t senvcfg_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.senvcfg = value & senvcfg_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t senvcfg_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.senvcfg |= value & senvcfg_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t senvcfg_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.senvcfg &= ~(value & senvcfg_mask);
     return rv_exc_none;
 }
 
-default_csr_functions(sscratch, rv_smode)
+default_csr_functions(sscratch)
 
-#define sepc_mask 0xFFFFFFFC
+#define sepc_mask (~(uint32_t) (RV_IALIGN - 1))
 
-        static rv_exc_t sepc_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
+static rv_exc_t sepc_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.sepc;
     return rv_exc_none;
 }
 
 static rv_exc_t sepc_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.sepc = value & sepc_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sepc_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.sepc |= value & sepc_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sepc_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.sepc &= ~(value & sepc_mask);
     return rv_exc_none;
 }
@@ -581,15 +612,12 @@ static bool is_exception_code(uint32_t num)
 
 static rv_exc_t scause_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.scause;
     return rv_exc_none;
 }
 
 static rv_exc_t scause_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     if (is_exception_code(value)) {
         cpu->csr.scause = value;
     } else {
@@ -601,8 +629,6 @@ static rv_exc_t scause_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t scause_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     uint32_t val = value | cpu->csr.scause;
     if (is_exception_code(val)) {
         cpu->csr.scause = val;
@@ -615,8 +641,6 @@ static rv_exc_t scause_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t scause_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     uint32_t val = ~value & cpu->csr.scause;
     if (is_exception_code(val)) {
         cpu->csr.scause = val;
@@ -627,11 +651,10 @@ static rv_exc_t scause_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
     return rv_exc_none;
 }
 
-default_csr_functions(stval, rv_smode)
+default_csr_functions(stval)
 
-        static rv_exc_t satp_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
+static rv_exc_t satp_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     if (rv_csr_mstatus_tvm(cpu)) {
         return rv_exc_illegal_instruction;
     }
@@ -642,7 +665,6 @@ default_csr_functions(stval, rv_smode)
 
 static rv_exc_t satp_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     if (rv_csr_mstatus_tvm(cpu)) {
         return rv_exc_illegal_instruction;
     }
@@ -664,7 +686,6 @@ static rv_exc_t satp_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t satp_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     if (rv_csr_mstatus_tvm(cpu)) {
         return rv_exc_illegal_instruction;
     }
@@ -686,7 +707,6 @@ static rv_exc_t satp_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t satp_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     if (rv_csr_mstatus_tvm(cpu)) {
         return rv_exc_illegal_instruction;
     }
@@ -706,34 +726,30 @@ static rv_exc_t satp_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
     return rv_exc_none;
 }
 
-default_csr_functions(scontext, rv_smode)
+default_csr_functions(scontext)
 
         // Writes to scyclecmp request or unrequest STI (based on the low 32 bits of cycle)
 
-        static rv_exc_t scyclecmp_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
+static rv_exc_t scyclecmp_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.scyclecmp;
     return rv_exc_none;
 }
 
 static rv_exc_t scyclecmp_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.scyclecmp = value;
     cpu->csr.external_STIP = ((uint32_t) cpu->csr.cycle) >= cpu->csr.scyclecmp;
     return rv_exc_none;
 }
 static rv_exc_t scyclecmp_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.scyclecmp |= value;
     cpu->csr.external_STIP = ((uint32_t) cpu->csr.cycle) >= cpu->csr.scyclecmp;
     return rv_exc_none;
 }
 static rv_exc_t scyclecmp_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.scyclecmp &= ~value;
     cpu->csr.external_STIP = ((uint32_t) cpu->csr.cycle) >= cpu->csr.scyclecmp;
     return rv_exc_none;
@@ -741,50 +757,42 @@ static rv_exc_t scyclecmp_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t mvendorid_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mvendorid;
     return rv_exc_none;
 }
 
 static rv_exc_t marchid_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.marchid;
     return rv_exc_none;
 }
 
 static rv_exc_t mimpid_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mimpid;
     return rv_exc_none;
 }
 
 static rv_exc_t mhartid_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mhartid;
     return rv_exc_none;
 }
 
 static rv_exc_t mconfigptr_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mconfigptr;
     return rv_exc_none;
 }
 
 static rv_exc_t mstatus_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
-    *target = (uint32_t) cpu->csr.mstatus;
+    *target = (uint32_t) cpu->csr.mstatus | rv_csr_sstatus_sd(cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mstatus_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     uint64_t val = value & rv_csr_mstatus_mask;
 
     // if the new mpp mode would be rmode (reserved, invalid value), don't modify it
@@ -801,8 +809,6 @@ static rv_exc_t mstatus_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t mstatus_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     value &= rv_csr_mstatus_mask;
 
     uint64_t new_val = ((uint64_t) value) | cpu->csr.mstatus;
@@ -819,8 +825,6 @@ static rv_exc_t mstatus_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t mstatus_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     value &= rv_csr_mstatus_mask;
     // Masked write
     uint64_t new_val = (~(uint64_t) value) & cpu->csr.mstatus;
@@ -837,35 +841,30 @@ static rv_exc_t mstatus_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 // Since MBE and SBE are both R/O zero and other bits re WPRI, whole mstatush is R/O zero
 static rv_exc_t mstatush_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = (uint32_t) (cpu->csr.mstatus >> 32);
     return rv_exc_none;
 }
 
 static rv_exc_t mstatush_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     // writes to mstatush have no effect
     return rv_exc_none;
 }
 
 static rv_exc_t mstatush_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     // writes to mstatush have no effect
     return rv_exc_none;
 }
 
 static rv_exc_t mstatush_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     // writes to mstatush have no effect
     return rv_exc_none;
 }
 
 static rv_exc_t misa_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.misa;
     return rv_exc_none;
 }
@@ -873,19 +872,16 @@ static rv_exc_t misa_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 // misa writes do nothing, we don't allow the change of extensions or MXLEN
 static rv_exc_t misa_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t misa_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t misa_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
@@ -894,35 +890,30 @@ static rv_exc_t misa_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t medeleg_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.medeleg;
     return rv_exc_none;
 }
 
 static rv_exc_t medeleg_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.medeleg = value & medeleg_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t medeleg_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.medeleg |= value & medeleg_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t medeleg_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.medeleg &= ~(value & medeleg_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t mideleg_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mideleg;
     return rv_exc_none;
 }
@@ -930,57 +921,48 @@ static rv_exc_t mideleg_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 // we allow only smode interrupts to be delegatable
 static rv_exc_t mideleg_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mideleg = value & rv_csr_si_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mideleg_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mideleg |= value & rv_csr_si_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mideleg_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mideleg &= ~(value & rv_csr_si_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t mie_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mie;
     return rv_exc_none;
 }
 
 static rv_exc_t mie_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mie = value & rv_csr_mi_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mie_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mie |= value & rv_csr_mi_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mie_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mie &= ~(value & rv_csr_mi_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t mip_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     // The SEIP bit is the logical OR of the value in MIP and the status from external interrupt controller
     // Full explanation RISC-V Privileged spec section 3.1.9 Machine Interrupt Registers (mip and mie)
     *target = cpu->csr.mip
@@ -994,22 +976,18 @@ static rv_exc_t mip_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 
 static rv_exc_t mip_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     cpu->csr.mip = value & mip_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mip_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mip |= value & mip_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mip_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mip &= ~(value & mip_mask);
     return rv_exc_none;
 }
@@ -1018,47 +996,65 @@ static rv_exc_t mip_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t mtvec_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mtvec;
     return rv_exc_none;
 }
 
 static rv_exc_t mtvec_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mtvec = value & mtvec_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mtvec_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mtvec |= value & mtvec_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mtvec_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mtvec &= ~(value & mtvec_mask);
     return rv_exc_none;
 }
 
-default_csr_functions(mcounteren, rv_mmode)
+default_csr_functions(mcounteren)
+
+default_csr_functions(mscratch)
+#define mepc_mask (~(uint32_t) (RV_IALIGN - 1))
+
+static rv_exc_t mepc_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
+{
+    *target = cpu->csr.mepc;
+    return rv_exc_none;
+}
+
+static rv_exc_t mepc_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
+{
+    cpu->csr.mepc = value & mepc_mask;
+    return rv_exc_none;
+}
+
+static rv_exc_t mepc_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
+{
+    cpu->csr.mepc |= value & mepc_mask;
+    return rv_exc_none;
+}
 
-        default_csr_functions(mscratch, rv_mmode)
-                default_csr_functions(mepc, rv_mmode)
+static rv_exc_t mepc_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
+{
+    cpu->csr.mepc &= ~(value & mepc_mask);
+    return rv_exc_none;
+}
 
-                        static rv_exc_t mcause_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
+static rv_exc_t mcause_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mcause;
     return rv_exc_none;
 }
 
 static rv_exc_t mcause_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     if (is_exception_code(value)) {
         cpu->csr.mcause = value;
     } else {
@@ -1069,8 +1065,6 @@ static rv_exc_t mcause_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t mcause_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     uint32_t val = cpu->csr.mcause | value;
 
     if (is_exception_code(val)) {
@@ -1083,7 +1077,6 @@ static rv_exc_t mcause_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t mcause_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     uint32_t val = cpu->csr.mcause & ~value;
 
     if (is_exception_code(val)) {
@@ -1094,9 +1087,9 @@ static rv_exc_t mcause_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
     return rv_exc_none;
 }
 
-default_csr_functions(mtval, rv_mmode)
+default_csr_functions(mtval)
 
-        static rv_exc_t mtinst_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
+static rv_exc_t mtinst_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
     return rv_exc_illegal_instruction;
 }
@@ -1140,28 +1133,24 @@ static rv_exc_t mtval2_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t menvcfg_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = (uint32_t) cpu->csr.menvcfg;
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfg_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.menvcfg = (cpu->csr.menvcfg & 0xFFFFFFFF00000000) | (value & menvcfg_fiom_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfg_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.menvcfg |= (uint64_t) (value & menvcfg_fiom_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfg_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     // Writing to unwritable fields
     cpu->csr.menvcfg &= ~((uint64_t) (value & menvcfg_fiom_mask));
     return rv_exc_none;
@@ -1169,77 +1158,65 @@ static rv_exc_t menvcfg_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 
 static rv_exc_t menvcfgh_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.menvcfg >> 32;
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfgh_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfgh_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfgh_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 // mseccfg(h) do nothing as of now, so they are read-only 0
 static rv_exc_t mseccfg_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mseccfg;
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfg_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfg_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfg_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfgh_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = 0;
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfgh_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfgh_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfgh_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
@@ -1438,362 +1415,212 @@ typedef struct {
     csr_clear_func_t clear; /** Clears the bits on position that has a bit set in the given value (writing only to those bits)*/
 } csr_ops_t;
 
-/** Retrieves the CSR ops for the given csr*/
-static csr_ops_t get_csr_ops(csr_num_t csr)
-{
-    csr_ops_t ops = {
-        .read = invalid_read,
-        .write = invalid_write,
-        .set = invalid_write,
-        .clear = invalid_write
-    };
-
-#define default_case(csr) \
-    case csr_##csr: { \
-        ops.read = csr##_read; \
-        ops.write = csr##_write; \
-        ops.set = csr##_set; \
-        ops.clear = csr##_clear; \
-        break; \
+/** Handlers of the unimplemented CSRs */
+static const csr_ops_t invalid_ops = {
+    .read = invalid_read,
+    .write = invalid_write,
+    .set = invalid_write,
+    .clear = invalid_write
+};
+
+#define csr_ops(csr) \
+    static const csr_ops_t csr##_ops = { \
+        .read = csr##_read, \
+        .write = csr##_write, \
+        .set = csr##_set, \
+        .clear = csr##_clear \
     }
 
-#define read_only_case(csr) \
-    case csr_##csr: { \
-        ops.read = csr##_read; \
-        ops.write = invalid_write; \
-        ops.set = invalid_write; \
-        ops.clear = invalid_write; \
-        break; \
+#define read_only_csr_ops(csr) \
+    static const csr_ops_t csr##_ops = { \
+        .read = csr##_read, \
+        .write = invalid_write, \
+        .set = invalid_write, \
+        .clear = invalid_write \
     }
 
-    switch (csr) {
-    case (csr_cycle):
-    case (csr_time):
-    case (csr_instret):
-    case (csr_hpmcounter3):
-    case (csr_hpmcounter4):
-    case (csr_hpmcounter5):
-    case (csr_hpmcounter6):
-    case (csr_hpmcounter7):
-    case (csr_hpmcounter8):
-    case (csr_hpmcounter9):
-    case (csr_hpmcounter10):
-    case (csr_hpmcounter11):
-    case (csr_hpmcounter12):
-    case (csr_hpmcounter13):
-    case (csr_hpmcounter14):
-    case (csr_hpmcounter15):
-    case (csr_hpmcounter16):
-    case (csr_hpmcounter17):
-    case (csr_hpmcounter18):
-    case (csr_hpmcounter19):
-    case (csr_hpmcounter20):
-    case (csr_hpmcounter21):
-    case (csr_hpmcounter22):
-    case (csr_hpmcounter23):
-    case (csr_hpmcounter24):
-    case (csr_hpmcounter25):
-    case (csr_hpmcounter26):
-    case (csr_hpmcounter27):
-    case (csr_hpmcounter28):
-    case (csr_hpmcounter29):
-    case (csr_hpmcounter30):
-    case (csr_hpmcounter31):
-    case (csr_cycleh):
-    case (csr_timeh):
-    case (csr_instreth):
-    case (csr_hpmcounter3h):
-    case (csr_hpmcounter4h):
-    case (csr_hpmcounter5h):
-    case (csr_hpmcounter6h):
-    case (csr_hpmcounter7h):
-    case (csr_hpmcounter8h):
-    case (csr_hpmcounter9h):
-    case (csr_hpmcounter10h):
-    case (csr_hpmcounter11h):
-    case (csr_hpmcounter12h):
-    case (csr_hpmcounter13h):
-    case (csr_hpmcounter14h):
-    case (csr_hpmcounter15h):
-    case (csr_hpmcounter16h):
-    case (csr_hpmcounter17h):
-    case (csr_hpmcounter18h):
-    case (csr_hpmcounter19h):
-    case (csr_hpmcounter20h):
-    case (csr_hpmcounter21h):
-    case (csr_hpmcounter22h):
-    case (csr_hpmcounter23h):
-    case (csr_hpmcounter24h):
-    case (csr_hpmcounter25h):
-    case (csr_hpmcounter26h):
-    case (csr_hpmcounter27h):
-    case (csr_hpmcounter28h):
-    case (csr_hpmcounter29h):
-    case (csr_hpmcounter30h):
-    case (csr_hpmcounter31h):
-    case (csr_mcycle):
-    case (csr_minstret):
-    case (csr_mhpmcounter3):
-    case (csr_mhpmcounter4):
-    case (csr_mhpmcounter5):
-    case (csr_mhpmcounter6):
-    case (csr_mhpmcounter7):
-    case (csr_mhpmcounter8):
-    case (csr_mhpmcounter9):
-    case (csr_mhpmcounter10):
-    case (csr_mhpmcounter11):
-    case (csr_mhpmcounter12):
-    case (csr_mhpmcounter13):
-    case (csr_mhpmcounter14):
-    case (csr_mhpmcounter15):
-    case (csr_mhpmcounter16):
-    case (csr_mhpmcounter17):
-    case (csr_mhpmcounter18):
-    case (csr_mhpmcounter19):
-    case (csr_mhpmcounter20):
-    case (csr_mhpmcounter21):
-    case (csr_mhpmcounter22):
-    case (csr_mhpmcounter23):
-    case (csr_mhpmcounter24):
-    case (csr_mhpmcounter25):
-    case (csr_mhpmcounter26):
-    case (csr_mhpmcounter27):
-    case (csr_mhpmcounter28):
-    case (csr_mhpmcounter29):
-    case (csr_mhpmcounter30):
-    case (csr_mhpmcounter31):
-    case (csr_mcycleh):
-    case (csr_minstreth):
-    case (csr_mhpmcounter3h):
-    case (csr_mhpmcounter4h):
-    case (csr_mhpmcounter5h):
-    case (csr_mhpmcounter6h):
-    case (csr_mhpmcounter7h):
-    case (csr_mhpmcounter8h):
-    case (csr_mhpmcounter9h):
-    case (csr_mhpmcounter10h):
-    case (csr_mhpmcounter11h):
-    case (csr_mhpmcounter12h):
-    case (csr_mhpmcounter13h):
-    case (csr_mhpmcounter14h):
-    case (csr_mhpmcounter15h):
-    case (csr_mhpmcounter16h):
-    case (csr_mhpmcounter17h):
-    case (csr_mhpmcounter18h):
-    case (csr_mhpmcounter19h):
-    case (csr_mhpmcounter20h):
-    case (csr_mhpmcounter21h):
-    case (csr_mhpmcounter22h):
-    case (csr_mhpmcounter23h):
-    case (csr_mhpmcounter24h):
-    case (csr_mhpmcounter25h):
-    case (csr_mhpmcounter26h):
-    case (csr_mhpmcounter27h):
-    case (csr_mhpmcounter28h):
-    case (csr_mhpmcounter29h):
-    case (csr_mhpmcounter30h):
-    case (csr_mhpmcounter31h): {
-        ops.read = counter_read;
-        ops.write = counter_write;
-        ops.set = counter_set;
-        ops.clear = counter_clear;
-        break;
-    }
+csr_ops(fcsr);
+csr_ops(counter);
+csr_ops(mhpmevent);
+csr_ops(pmpcfg);
+csr_ops(pmpaddr);
+csr_ops(mcountinhibit);
+csr_ops(sstatus);
+csr_ops(sie);
+csr_ops(stvec);
+csr_ops(scounteren);
+csr_ops(senvcfg);
+csr_ops(sscratch);
+csr_ops(sepc);
+csr_ops(scause);
+csr_ops(stval);
+csr_ops(sip);
+csr_ops(satp);
+csr_ops(scontext);
+csr_ops(scyclecmp);
+csr_ops(mstatus);
+csr_ops(misa);
+csr_ops(medeleg);
+csr_ops(mideleg);
+csr_ops(mie);
+csr_ops(mtvec);
+csr_ops(mcounteren);
+csr_ops(mstatush);
+csr_ops(mscratch);
+csr_ops(mepc);
+csr_ops(mcause);
+csr_ops(mtval);
+csr_ops(mip);
+csr_ops(mtinst);
+csr_ops(mtval2);
+csr_ops(menvcfg);
+csr_ops(menvcfgh);
+csr_ops(mseccfg);
+csr_ops(mseccfgh);
+csr_ops(tselect);
+csr_ops(tdata1);
+csr_ops(tdata2);
+csr_ops(tdata3);
+csr_ops(mcontext);
+csr_ops(dcsr);
+csr_ops(dpc);
+csr_ops(dscratch0);
+csr_ops(dscratch1);
+read_only_csr_ops(mvendorid);
+read_only_csr_ops(marchid);
+read_only_csr_ops(mimpid);
+read_only_csr_ops(mhartid);
+read_only_csr_ops(mconfigptr);
+
+#undef csr_ops
+#undef read_only_csr_ops
+
+/** Size of the CSR address space */
+#define CSR_COUNT 4096
+
+/** Entry of the CSR dispatch table */
+typedef struct {
+    const csr_ops_t *ops;
+    /** Lowest privilege mode allowed to access the CSR */
+    uint8_t min_priv;
+    /** Writes raise the illegal instruction exception */
+    bool read_only;
+} csr_entry_t;
+
+/** CSR dispatch table
+ *
+ * Indexed directly by the CSR number. The privilege and read-only
+ * checks encoded in the CSR number are precomputed here and done once
+ * for all handlers, so a CSR access is a single lookup and a call.
+ */
+static csr_entry_t csr_table[CSR_COUNT];
 
-    case (csr_mhpmevent3):
-    case (csr_mhpmevent4):
-    case (csr_mhpmevent5):
-    case (csr_mhpmevent6):
-    case (csr_mhpmevent7):
-    case (csr_mhpmevent8):
-    case (csr_mhpmevent9):
-    case (csr_mhpmevent10):
-    case (csr_mhpmevent11):
-    case (csr_mhpmevent12):
-    case (csr_mhpmevent13):
-    case (csr_mhpmevent14):
-    case (csr_mhpmevent15):
-    case (csr_mhpmevent16):
-    case (csr_mhpmevent17):
-    case (csr_mhpmevent18):
-    case (csr_mhpmevent19):
-    case (csr_mhpmevent20):
-    case (csr_mhpmevent21):
-    case (csr_mhpmevent22):
-    case (csr_mhpmevent23):
-    case (csr_mhpmevent24):
-    case (csr_mhpmevent25):
-    case (csr_mhpmevent26):
-    case (csr_mhpmevent27):
-    case (csr_mhpmevent28):
-    case (csr_mhpmevent29):
-    case (csr_mhpmevent30):
-    case (csr_mhpmevent31): {
-        ops.read = mhpmevent_read;
-        ops.write = mhpmevent_write;
-        ops.set = mhpmevent_set;
-        ops.clear = mhpmevent_clear;
-        break;
+static void csr_table_set_range(csr_num_t first, csr_num_t last, const csr_ops_t *ops)
+{
+    for (unsigned int csr = first; csr <= last; csr++) {
+        csr_table[csr].ops = ops;
     }
+}
 
-    case (csr_pmpcfg0):
-    case (csr_pmpcfg1):
-    case (csr_pmpcfg2):
-    case (csr_pmpcfg3):
-    case (csr_pmpcfg4):
-    case (csr_pmpcfg5):
-    case (csr_pmpcfg6):
-    case (csr_pmpcfg7):
-    case (csr_pmpcfg8):
-    case (csr_pmpcfg9):
-    case (csr_pmpcfg10):
-    case (csr_pmpcfg11):
-    case (csr_pmpcfg12):
-    case (csr_pmpcfg13):
-    case (csr_pmpcfg14):
-    case (csr_pmpcfg15): {
-        ops.read = pmpcfg_read;
-        ops.write = pmpcfg_write;
-        ops.set = pmpcfg_set;
-        ops.clear = pmpcfg_clear;
-        break;
-    }
+/** Fill the CSR dispatch table (once for all processors) */
+static void csr_table_init(void)
+{
+    static bool initialized = false;
 
-    case (csr_pmpaddr0):
-    case (csr_pmpaddr1):
-    case (csr_pmpaddr2):
-    case (csr_pmpaddr3):
-    case (csr_pmpaddr4):
-    case (csr_pmpaddr5):
-    case (csr_pmpaddr6):
-    case (csr_pmpaddr7):
-    case (csr_pmpaddr8):
-    case (csr_pmpaddr9):
-    case (csr_pmpaddr10):
-    case (csr_pmpaddr11):
-    case (csr_pmpaddr12):
-    case (csr_pmpaddr13):
-    case (csr_pmpaddr14):
-    case (csr_pmpaddr15):
-    case (csr_pmpaddr16):
-    case (csr_pmpaddr17):
-    case (csr_pmpaddr18):
-    case (csr_pmpaddr19):
-    case (csr_pmpaddr20):
-    case (csr_pmpaddr21):
-    case (csr_pmpaddr22):
-    case (csr_pmpaddr23):
-    case (csr_pmpaddr24):
-    case (csr_pmpaddr25):
-    case (csr_pmpaddr26):
-    case (csr_pmpaddr27):
-    case (csr_pmpaddr28):
-    case (csr_pmpaddr29):
-    case (csr_pmpaddr30):
-    case (csr_pmpaddr31):
-    case (csr_pmpaddr32):
-    case (csr_pmpaddr33):
-    case (csr_pmpaddr34):
-    case (csr_pmpaddr35):
-    case (csr_pmpaddr36):
-    case (csr_pmpaddr37):
-    case (csr_pmpaddr38):
-    case (csr_pmpaddr39):
-    case (csr_pmpaddr40):
-    case (csr_pmpaddr41):
-    case (csr_pmpaddr42):
-    case (csr_pmpaddr43):
-    case (csr_pmpaddr44):
-    case (csr_pmpaddr45):
-    case (csr_pmpaddr46):
-    case (csr_pmpaddr47):
-    case (csr_pmpaddr48):
-    case (csr_pmpaddr49):
-    case (csr_pmpaddr50):
-    case (csr_pmpaddr51):
-    case (csr_pmpaddr52):
-    case (csr_pmpaddr53):
-    case (csr_pmpaddr54):
-    case (csr_pmpaddr55):
-    case (csr_pmpaddr56):
-    case (csr_pmpaddr57):
-    case (csr_pmpaddr58):
-    case (csr_pmpaddr59):
-    case (csr_pmpaddr60):
-    case (csr_pmpaddr61):
-    case (csr_pmpaddr62):
-    case (csr_pmpaddr63): {
-        ops.read = pmpaddr_read;
-        ops.write = pmpaddr_write;
-        ops.set = pmpaddr_set;
-        ops.clear = pmpaddr_clear;
-        break;
+    if (initialized) {
+        return;
     }
 
-        default_case(mcountinhibit)
-
-                default_case(sstatus)
-
-                        default_case(sie)
-                                default_case(stvec)
-                                        default_case(scounteren)
-
-                                                default_case(senvcfg)
-
-                                                        default_case(sscratch)
-                                                                default_case(sepc)
-                                                                        default_case(scause)
-                                                                                default_case(stval)
-                                                                                        default_case(sip)
-                                                                                                default_case(satp)
-                                                                                                        default_case(scontext)
-                                                                                                                default_case(scyclecmp)
-
-                                                                                                                        read_only_case(mvendorid)
-                                                                                                                                read_only_case(marchid)
-                                                                                                                                        read_only_case(mimpid)
-                                                                                                                                                read_only_case(mhartid)
-                                                                                                                                                        read_only_case(mconfigptr)
-
-                                                                                                                                                                default_case(mstatus)
-
-                                                                                                                                                                        default_case(misa)
-                                                                                                                                                                                default_case(medeleg)
-                                                                                                                                                                                        default_case(mideleg)
-                                                                                                                                                                                                default_case(mie)
-                                                                                                                                                                                                        default_case(mtvec)
-                                                                                                                                                                                                                default_case(mcounteren)
-
-                                                                                                                                                                                                                        default_case(mstatush)
-
-                                                                                                                                                                                                                                default_case(mscratch)
-                                                                                                                                                                                                                                        default_case(mepc)
-                                                                                                                                                                                                                                                default_case(mcause)
-                                                                                                                                                                                                                                                        default_case(mtval)
-                                                                                                                                                                                                                                                                default_case(mip)
-                                                                                                                                                                                                                                                                        default_case(mtinst)
-                                                                                                                                                                                                                                                                                default_case(mtval2)
+    for (unsigned int csr = 0; csr < CSR_COUNT; csr++) {
+        csr_table[csr].ops = &invalid_ops;
+        csr_table[csr].min_priv = rv_csr_min_priv_mode(csr);
+        csr_table[csr].read_only = ((csr >> 10) & 0b11) == 0b11;
+    }
 
-                                                                                                                                                                                                                                                                                        default_case(menvcfg)
-                                                                                                                                                                                                                                                                                                default_case(menvcfgh)
-                                                                                                                                                                                                                                                                                                        default_case(mseccfg)
-                                                                                                                                                                                                                                                                                                                default_case(mseccfgh)
+    csr_table_set_range(csr_fflags, csr_fcsr, &fcsr_ops);
+    csr_table_set_range(csr_cycle, csr_hpmcounter31, &counter_ops);
+    csr_table_set_range(csr_cycleh, csr_hpmcounter31h, &counter_ops);
+    csr_table[csr_mcycle].ops = &counter_ops;
+    csr_table[csr_minstret].ops = &counter_ops;
+    csr_table_set_range(csr_mhpmcounter3, csr_mhpmcounter31, &counter_ops);
+    csr_table[csr_mcycleh].ops = &counter_ops;
+    csr_table[csr_minstreth].ops = &counter_ops;
+    csr_table_set_range(csr_mhpmcounter3h, csr_mhpmcounter31h, &counter_ops);
+
+    csr_table_set_range(csr_mhpmevent3, csr_mhpmevent31, &mhpmevent_ops);
+    csr_table_set_range(csr_pmpcfg0, csr_pmpcfg15, &pmpcfg_ops);
+    csr_table_set_range(csr_pmpaddr0, csr_pmpaddr63, &pmpaddr_ops);
+
+#define csr_entry(csr) \
+    csr_table[csr_##csr].ops = &csr##_ops
+
+    csr_entry(mcountinhibit);
+    csr_entry(sstatus);
+    csr_entry(sie);
+    csr_entry(stvec);
+    csr_entry(scounteren);
+    csr_entry(senvcfg);
+    csr_entry(sscratch);
+    csr_entry(sepc);
+    csr_entry(scause);
+    csr_entry(stval);
+    csr_entry(sip);
+    csr_entry(satp);
+    csr_entry(scontext);
+    csr_entry(scyclecmp);
+    csr_entry(mstatus);
+    csr_entry(misa);
+    csr_entry(medeleg);
+    csr_entry(mideleg);
+    csr_entry(mie);
+    csr_entry(mtvec);
+    csr_entry(mcounteren);
+    csr_entry(mstatush);
+    csr_entry(mscratch);
+    csr_entry(mepc);
+    csr_entry(mcause);
+    csr_entry(mtval);
+    csr_entry(mip);
+    csr_entry(mtinst);
+    csr_entry(mtval2);
+    csr_entry(menvcfg);
+    csr_entry(menvcfgh);
+    csr_entry(mseccfg);
+    csr_entry(mseccfgh);
+    csr_entry(tselect);
+    csr_entry(tdata1);
+    csr_entry(tdata2);
+    csr_entry(tdata3);
+    csr_entry(mcontext);
+    csr_entry(dcsr);
+    csr_entry(dpc);
+    csr_entry(dscratch0);
+    csr_entry(dscratch1);
+    csr_entry(mvendorid);
+    csr_entry(marchid);
+    csr_entry(mimpid);
+    csr_entry(mhartid);
+    csr_entry(mconfigptr);
+
+#undef csr_entry
+
+    initialized = true;
+}
+
+/** Retrieves the CSR ops for the given access
+ *
+ * @param write Whether the access modifies the CSR
+ * @return The CSR ops or NULL if the access is not allowed
+ */
+static inline const csr_ops_t *get_csr_ops(rv_cpu_t *cpu, csr_num_t csr, bool write)
+{
+    const csr_entry_t *entry = &csr_table[csr & (CSR_COUNT - 1)];
 
-                                                                                                                                                                                                                                                                                                                        default_case(tselect)
-                                                                                                                                                                                                                                                                                                                                default_case(tdata1)
-                                                                                                                                                                                                                                                                                                                                        default_case(tdata2)
-                                                                                                                                                                                                                                                                                                                                                default_case(tdata3)
-                                                                                                                                                                                                                                                                                                                                                        default_case(mcontext)
-                                                                                                                                                                                                                                                                                                                                                                default_case(dcsr)
-                                                                                                                                                                                                                                                                                                                                                                        default_case(dpc)
-                                                                                                                                                                                                                                                                                                                                                                                default_case(dscratch0)
-                                                                                                                                                                                                                                                                                                                                                                                        default_case(dscratch1)
+    if ((cpu->priv_mode < entry->min_priv) || (write && entry->read_only)) {
+        return NULL;
     }
 
-    return ops;
-
-#undef default_case
-#undef read_only_case
+    return entry->ops;
 }
 
 /**
@@ -1808,17 +1635,20 @@ static csr_ops_t get_csr_ops(csr_num_t csr)
  */
 rv_exc_t rv_csr_rw(rv_cpu_t *cpu, csr_num_t csr, uint32_t value, uint32_t *read_target, bool read)
 {
+    const csr_ops_t *ops = get_csr_ops(cpu, csr, true);
+    if (ops == NULL) {
+        return rv_exc_illegal_instruction;
+    }
 
-    csr_ops_t ops = get_csr_ops(csr);
     rv_exc_t ex = rv_exc_none;
     uint32_t temp_read_target = 0;
 
     if (read) {
-        ex = ops.read(cpu, csr, &temp_read_target);
+        ex = ops->read(cpu, csr, &temp_read_target);
     }
 
     if (ex == rv_exc_none) {
-        ex = ops.write(cpu, csr, value);
+        ex = ops->write(cpu, csr, value);
     }
 
     if (ex == rv_exc_none) {
@@ -1840,14 +1670,17 @@ rv_exc_t rv_csr_rw(rv_cpu_t *cpu, csr_num_t csr, uint32_t value, uint32_t *read_
  */
 rv_exc_t rv_csr_rs(rv_cpu_t *cpu, csr_num_t csr, uint32_t value, uint32_t *read_target, bool write)
 {
-    csr_ops_t ops = get_csr_ops(csr);
+    const csr_ops_t *ops = get_csr_ops(cpu, csr, write);
+    if (ops == NULL) {
+        return rv_exc_illegal_instruction;
+    }
 
     uint32_t temp_read_target = 0;
 
-    rv_exc_t ex = ops.read(cpu, csr, &temp_read_target);
+    rv_exc_t ex = ops->read(cpu, csr, &temp_read_target);
 
     if (ex == rv_exc_none && write) {
-        ex = ops.set(cpu, csr, value);
+        ex = ops->set(cpu, csr, value);
     }
 
     if (ex == rv_exc_none) {
@@ -1869,13 +1702,16 @@ rv_exc_t rv_csr_rs(rv_cpu_t *cpu, csr_num_t csr, uint32_t value, uint32_t *read_
  */
 rv_exc_t rv_csr_rc(rv_cpu_t *cpu, csr_num_t csr, uint32_t value, uint32_t *read_target, bool write)
 {
+    const csr_ops_t *ops = get_csr_ops(cpu, csr, write);
+    if (ops == NULL) {
+        return rv_exc_illegal_instruction;
+    }
 
-    csr_ops_t ops = get_csr_ops(csr);
     uint32_t temp_read_target = 0;
-    rv_exc_t ex = ops.read(cpu, csr, &temp_read_target);
+    rv_exc_t ex = ops->read(cpu, csr, &temp_read_target);
 
     if (ex == rv_exc_none && write) {
-        ex = ops.clear(cpu, csr, value);
+        ex = ops->clear(cpu, csr, value);
     }
 
     if (ex == rv_exc_none) {
@@ -20,6 +20,14 @@
  */
 typedef enum {
 
+    /************************************
+     * Unprivileged Floating-Point CSRs *
+     ************************************/
+
+    csr_fflags = 0x001, // Floating-Point Accrued Exceptions
+    csr_frm = 0x002, // Floating-Point Dynamic Rounding Mode
+    csr_fcsr = 0x003, // Floating-Point Control and Status Register (frm + fflags)
+
     /********************************
      * Unprivileged Counters/Timers *
      ********************************/
@@ -380,6 +388,9 @@ typedef enum {
  * Structure holding CSR data
  */
 typedef struct {
+    /* Floating-point control and status (frm and fflags) */
+    uint32_t fcsr;
+
     /* Counters/Timers */
     uint64_t cycle;
     uint64_t instret;
@@ -496,7 +507,7 @@ enum rv_priv_mode;
 
 #define RV_32_XLEN_2_BITS 0b01
 
-#define RV_ISA RV_32_MXLEN_BITS | RV_I_EXTENSION_BITS | RV_M_EXTENSION_BITS | RV_A_EXTENSION_BITS | RV_U_IMPLEMENTED_BITS | RV_S_IMPLEMENTED_BITS
+#define RV_ISA RV_32_MXLEN_BITS | RV_I_EXTENSION_BITS | RV_M_EXTENSION_BITS | RV_A_EXTENSION_BITS | RV_F_EXTENSION_BITS | RV_D_EXTENSION_BITS | RV_C_EXTENSION_BITS | RV_U_IMPLEMENTED_BITS | RV_S_IMPLEMENTED_BITS
 
 #define RV_VENDOR_ID 0
 #define RV_ARCH_ID 0
@@ -523,18 +534,22 @@ enum rv_priv_mode;
 #define rv_csr_mstatus_mie(cpu) (bool) ((cpu)->csr.mstatus & rv_csr_mstatus_mie_mask)
 #define rv_csr_mstatus_mpp(cpu) (enum rv_priv_mode)(((cpu)->csr.mstatus & rv_csr_mstatus_mpp_mask) >> 11)
 
+#define rv_csr_sstatus_sd_mask (UINT32_C(1) << 31)
 #define rv_csr_sstatus_mxr_mask (UINT32_C(1) << 19)
 #define rv_csr_sstatus_sum_mask (UINT32_C(1) << 18)
+#define rv_csr_sstatus_fs_mask (UINT32_C(3) << 13)
 #define rv_csr_sstatus_spp_mask (UINT32_C(1) << 8)
 #define rv_csr_sstatus_ube_mask (UINT32_C(1) << 6)
 #define rv_csr_sstatus_spie_mask (UINT32_C(1) << 5)
 #define rv_csr_sstatus_sie_mask (UINT32_C(1) << 1)
 
 #define rv_csr_sstatus_spp_pos 8
+#define rv_csr_sstatus_fs_pos 13
 
 // Doesn't include UBE, because riscv in msim is strictly Little Endian
-// Also does not include SD, XS, FS abd VS, because these are used for extensions that are not implemented
-#define rv_csr_sstatus_mask (rv_csr_sstatus_mxr_mask | rv_csr_sstatus_sum_mask | rv_csr_sstatus_spp_mask | rv_csr_sstatus_spie_mask | rv_csr_sstatus_sie_mask)
+// Also does not include XS and VS, because these are used for extensions that are not implemented
+// SD is not stored, it is computed from FS on reads
+#define rv_csr_sstatus_mask (rv_csr_sstatus_mxr_mask | rv_csr_sstatus_sum_mask | rv_csr_sstatus_fs_mask | rv_csr_sstatus_spp_mask | rv_csr_sstatus_spie_mask | rv_csr_sstatus_sie_mask)
 #define rv_csr_mstatus_mask (rv_csr_sstatus_mask | rv_csr_mstatus_tsr_mask | rv_csr_mstatus_tw_mask | rv_csr_mstatus_tvm_mask | rv_csr_mstatus_mprv_mask | rv_csr_mstatus_mpp_mask | rv_csr_mstatus_mpie_mask | rv_csr_mstatus_mie_mask)
 
 #define rv_csr_sstatus_mxr(cpu) (bool) ((cpu)->csr.mstatus & rv_csr_sstatus_mxr_mask)
@@ -543,6 +558,40 @@ enum rv_priv_mode;
 #define rv_csr_sstatus_sie(cpu) (bool) ((cpu)->csr.mstatus & rv_csr_sstatus_sie_mask)
 #define rv_csr_sstatus_spp(cpu) (enum rv_priv_mode)(((cpu)->csr.mstatus & rv_csr_sstatus_spp_mask) >> (rv_csr_sstatus_spp_pos))
 #define rv_csr_sstatus_ube(cpu) (bool) ((cpu)->csr.mstatus & rv_csr_sstatus_ube_mask)
+#define rv_csr_sstatus_fs(cpu) (rv_fs_t)(((cpu)->csr.mstatus & rv_csr_sstatus_fs_mask) >> (rv_csr_sstatus_fs_pos))
+
+/** States of the floating-point unit in mstatus.FS */
+typedef enum {
+    rv_fs_off = 0b00,
+    rv_fs_initial = 0b01,
+    rv_fs_clean = 0b10,
+    rv_fs_dirty = 0b11
+} rv_fs_t;
+
+/** The SD bit as read from mstatus and sstatus */
+#define rv_csr_sstatus_sd(cpu) ((rv_csr_sstatus_fs(cpu) == rv_fs_dirty) ? rv_csr_sstatus_sd_mask : 0)
+
+/** Mark the floating-point state modified
+ *
+ * Dirty has both FS bits set, so no read-modify-write of the FS field
+ * is needed.
+ */
+#define rv_csr_mstatus_set_fs_dirty(cpu) \
+    ((cpu)->csr.mstatus |= rv_csr_sstatus_fs_mask)
+
+#define rv_csr_fcsr_fflags_mask UINT32_C(0x1F)
+#define rv_csr_fcsr_frm_mask UINT32_C(0xE0)
+#define rv_csr_fcsr_frm_pos 5
+#define rv_csr_fcsr_mask (rv_csr_fcsr_frm_mask | rv_csr_fcsr_fflags_mask)
+
+#define rv_csr_fcsr_frm(cpu) (((cpu)->csr.fcsr & rv_csr_fcsr_frm_mask) >> rv_csr_fcsr_frm_pos)
+
+/** Accrued exception flags in fflags */
+#define rv_fflags_nx UINT32_C(1 << 0) // Inexact
+#define rv_fflags_uf UINT32_C(1 << 1) // Underflow
+#define rv_fflags_of UINT32_C(1 << 2) // Overflow
+#define rv_fflags_dz UINT32_C(1 << 3) // Divide by zero
+#define rv_fflags_nv UINT32_C(1 << 4) // Invalid operation
 
 #define rv_csr_sei_mask (1U << 9)
 #define rv_csr_sti_mask (1U << 5)
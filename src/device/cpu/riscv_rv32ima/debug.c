@@ -9,9 +9,11 @@
  *
  */
 
+#include <inttypes.h>
 #include <string.h>
 
 #include "../../../assert.h"
+#include "../../../debug/symtab.h"
 #include "../../../env.h"
 #include "../../../fault.h"
 #include "../../../physmem.h"
@@ -34,7 +36,22 @@ char *rv_reg_name_table[__rv_regname_type_count][RV_REG_COUNT] = {
             "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6" }
 };
 
+char *rv_freg_name_table[__rv_regname_type_count][RV_REG_COUNT] = {
+    { "f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7",
+            "f8", "f9", "f10", "f11", "f12", "f13", "f14", "f15",
+            "f16", "f17", "f18", "f19", "f20", "f21", "f22", "f23",
+            "f24", "f25", "f26", "f27", "f28", "f29", "f30", "f31" },
+    { "ft0", "ft1", "ft2", "ft3", "ft4", "ft5", "ft6", "ft7",
+            "fs0", "fs1", "fa0", "fa1", "fa2", "fa3", "fa4", "fa5",
+            "fa6", "fa7", "fs2", "fs3", "fs4", "fs5", "fs6", "fs7",
+            "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11" }
+};
+
 char *rv_csr_name_table[0x1000] = {
+    [csr_fflags] = "fflags",
+    [csr_frm] = "frm",
+    [csr_fcsr] = "fcsr",
+
     [csr_cycle] = "cycle",
     [csr_time] = "time",
     [csr_instret] = "instret",
@@ -372,6 +389,7 @@ static const char *counters_command = "counters";
 static const char *all_command = "all";
 
 char **rv_regnames;
+char **rv_fregnames;
 char **rv_csrnames;
 char **rv_excnames;
 char **rv_interruptnames;
@@ -385,6 +403,7 @@ static rv_regname_type_t curr_regname_type = rv_regname_abi;
 void rv_debug_init(void)
 {
     rv_regnames = rv_reg_name_table[curr_regname_type];
+    rv_fregnames = rv_freg_name_table[curr_regname_type];
     rv_csrnames = rv_csr_name_table;
     rv_excnames = exc_name_table;
     rv_interruptnames = interrupt_name_table;
@@ -401,6 +420,7 @@ bool rv_debug_change_regnames(rv_regname_type_t type)
     }
     curr_regname_type = (rv_regname_type_t) type;
     rv_regnames = rv_reg_name_table[curr_regname_type];
+    rv_fregnames = rv_freg_name_table[curr_regname_type];
     return true;
 }
 
@@ -431,11 +451,164 @@ void rv_reg_dump(rv_cpu_t *cpu)
             "Privilege mode", priv_mode);
 }
 
+/**
+ * @brief Dump the content of the floating-point registers to stdout
+ *
+ * Single-precision values are NaN-boxed, so the single-precision
+ * registers show with all ones in the upper word.
+ */
+void rv_fp_dump(rv_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    printf("processor %u\n", cpu->csr.mhartid);
+
+    for (unsigned int i = 0; i < RV_REG_COUNT; i += 2) {
+        printf(" %5s: %016" PRIx64 " %5s: %016" PRIx64 "\n",
+                rv_fregnames[i], cpu->fregs[i],
+                rv_fregnames[i + 1], cpu->fregs[i + 1]);
+    }
+
+    printf(" %5s: %08x %27s: %u\n",
+            "fcsr", cpu->csr.fcsr,
+            "FS", rv_csr_sstatus_fs(cpu));
+}
+
+/**
+ * @brief Summarize the architectural state
+ *
+ * The TLB only caches the page tables, so it is not included.
+ * Neither is the mtime register, which follows the host time.
+ */
+void rv_state(rv_cpu_t *cpu, cpu_state_t *state)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(state != NULL);
+
+    state->pc = cpu->pc;
+    for (unsigned int i = 0; i < CPU_STATE_REGS; i++) {
+        state->regs[i] = cpu->regs[i];
+    }
+
+    /* The CSR structure is zero-initialized, so the padding is stable */
+    csr_t csr;
+    memcpy(&csr, &cpu->csr, sizeof(csr));
+    csr.mtime = 0;
+    csr.last_tick_time = 0;
+
+    uint64_t hash = hash64(&csr, sizeof(csr), 0);
+    hash = hash64(cpu->fregs, sizeof(cpu->fregs), hash);
+
+    uint64_t misc[] = {
+        cpu->pc_next,
+        cpu->priv_mode,
+        cpu->reserved_valid,
+        cpu->reserved_addr,
+        cpu->stdby
+    };
+    state->hash = hash64(misc, sizeof(misc), hash);
+}
+
+/** Interrupt which is raised from the outside of the hart
+ *
+ * The timer interrupts are driven by the hart itself.
+ *
+ */
+static bool rv_raisable_interrupt(unsigned int no)
+{
+    return (no == RV_INTERRUPT_NO(rv_exc_supervisor_software_interrupt))
+            || (no == RV_INTERRUPT_NO(rv_exc_machine_software_interrupt))
+            || (no == RV_INTERRUPT_NO(rv_exc_supervisor_external_interrupt))
+            || (no == RV_INTERRUPT_NO(rv_exc_machine_external_interrupt));
+}
+
+/** Read a processor value for breakpoint conditions */
+uint64_t rv_value(rv_cpu_t *cpu, cpu_value_t which, unsigned int index)
+{
+    ASSERT(cpu != NULL);
+
+    switch (which) {
+    case CPU_VALUE_PC:
+        return cpu->pc;
+    case CPU_VALUE_REG:
+        ASSERT(index < RV_REG_COUNT);
+        return cpu->regs[index];
+    case CPU_VALUE_PRIV:
+        return cpu->priv_mode;
+    case CPU_VALUE_ASID:
+        return rv_csr_satp_asid(cpu);
+    case CPU_VALUE_IRQ:
+        if (!rv_raisable_interrupt(index)) {
+            return 0;
+        }
+        if (index == RV_INTERRUPT_NO(rv_exc_supervisor_external_interrupt)) {
+            return cpu->csr.external_SEIP;
+        }
+        return (cpu->csr.mip & RV_EXCEPTION_MASK(index)) != 0;
+    }
+
+    return 0;
+}
+
+/** Inject a processor fault
+ *
+ * The system registers are the CSRs, they are accessed as from the
+ * machine mode, so the read-only ones cannot be corrupted.
+ *
+ */
+bool rv_inject(rv_cpu_t *cpu, cpu_fault_t fault, unsigned int index, uint64_t mask)
+{
+    ASSERT(cpu != NULL);
+
+    switch (fault) {
+    case CPU_FAULT_REG:
+        /* The zero register is hardwired */
+        if ((index == 0) || (index >= RV_REG_COUNT)) {
+            return false;
+        }
+        cpu->regs[index] ^= mask;
+        return true;
+    case CPU_FAULT_SYSREG: {
+        /* CSR numbers have 12 bits */
+        if (index >= 4096) {
+            return false;
+        }
+
+        rv_priv_mode_t priv_mode = cpu->priv_mode;
+        cpu->priv_mode = rv_mmode;
+
+        uint32_t value;
+        uint32_t old;
+        bool ok = (rv_csr_rs(cpu, index, 0, &value, false) == rv_exc_none)
+                && (rv_csr_rw(cpu, index, value ^ mask, &old, false) == rv_exc_none);
+
+        cpu->priv_mode = priv_mode;
+        return ok;
+    }
+    case CPU_FAULT_TLB:
+        rv_tlb_drop(&cpu->tlb, index);
+        return true;
+    case CPU_FAULT_IRQ:
+        if (!rv_raisable_interrupt(index)) {
+            return false;
+        }
+        rv_interrupt_up(cpu, index);
+        return true;
+    }
+
+    return false;
+}
+
 static void idump_common(uint32_t addr, rv_instr_t instr, string_t *s_opc,
         string_t *s_mnemonics, string_t *s_comments)
 {
-
-    string_printf(s_opc, "%08x", instr.val);
+    if (RV_INSTR_IS_COMPRESSED(instr.val)) {
+        // Compressed instructions are shown in their expanded form
+        string_printf(s_opc, "    %04x", instr.val & 0xffff);
+        instr = rv_instr_expand((uint16_t) instr.val);
+    } else {
+        string_printf(s_opc, "%08x", instr.val);
+    }
 
     rv_mnemonics_func_t mnem_func = rv_decode_mnemonics(instr);
 
@@ -467,7 +640,13 @@ void rv_idump(rv_cpu_t *cpu, uint32_t addr, rv_instr_t instr)
 
     idump_common(addr, instr, &s_opc, &s_mnemonics, &s_comments);
 
+    /* Physical dumps print the labels themselves */
     if (cpu != NULL) {
+        const char *label = symtab_label(addr);
+        if (label != NULL) {
+            printf("%s:\n", label);
+        }
+
         printf("%-5s ", s_cpu.str);
     }
     if (iaddr) {
@@ -505,6 +684,10 @@ void rv_idump_phys(uint32_t addr, rv_instr_t instr)
  */
 void rv_csr_dump_all(rv_cpu_t *cpu)
 {
+    printf("\n");
+    printf("Unprivileged Floating-Point CSRs\n");
+    rv_csr_dump_common(cpu, csr_fcsr);
+    printf("\n");
     rv_csr_dump_mmode(cpu);
     printf("\n");
     rv_csr_dump_smode(cpu);
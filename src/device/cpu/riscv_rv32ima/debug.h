@@ -15,6 +15,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "../general_cpu.h"
 #include "cpu.h"
 #include "csr.h"
 #include "instr.h"
@@ -27,6 +28,7 @@ typedef enum {
 } rv_regname_type_t;
 
 extern char **rv_regnames; /** The currently selected names of registers */
+extern char **rv_fregnames; /** The currently selected names of floating-point registers */
 extern char **rv_csrnames; /** The names of CSRs */
 extern char **rv_excnames; /** The names of exceptions */
 extern char **rv_interruptnames; /** The names of interrupts */
@@ -35,6 +37,10 @@ extern void rv_debug_init(void);
 extern bool rv_debug_change_regnames(rv_regname_type_t type);
 
 extern void rv_reg_dump(rv_cpu_t *cpu);
+extern void rv_fp_dump(rv_cpu_t *cpu);
+extern void rv_state(rv_cpu_t *cpu, cpu_state_t *state);
+extern uint64_t rv_value(rv_cpu_t *cpu, cpu_value_t which, unsigned int index);
+extern bool rv_inject(rv_cpu_t *cpu, cpu_fault_t fault, unsigned int index, uint64_t mask);
 extern void rv_idump(rv_cpu_t *cpu, uint32_t addr, rv_instr_t instr);
 extern void rv_idump_phys(uint32_t addr, rv_instr_t instr);
 extern void rv_csr_dump_all(rv_cpu_t *cpu);
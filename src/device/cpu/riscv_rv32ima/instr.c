@@ -7,8 +7,14 @@
  *
  *  RISC-V Instruction decoding
  *
+ *  The decoder is generated from the instruction specification in
+ *  instr.def.
+ *
  */
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include "../../../assert.h"
@@ -17,6 +23,7 @@
 #include "instr.h"
 #include "instructions/computations.h"
 #include "instructions/control_transfer.h"
+#include "instructions/fp_ops.h"
 #include "instructions/mem_ops.h"
 #include "instructions/system.h"
 
@@ -25,309 +32,425 @@ rv_exc_t rv_illegal_instr(rv_cpu_t *cpu, rv_instr_t instr)
     return machine_undefined ? rv_exc_none : rv_exc_illegal_instruction;
 }
 
-static rv_instr_func_t decode_LOAD(rv_instr_t instr)
-{
-    ASSERT(instr.i.opcode == rv_opcLOAD);
-    switch (instr.i.funct3) {
-    case rv_func_LB:
-        return rv_lb_instr;
-    case rv_func_LH:
-        return rv_lh_instr;
-    case rv_func_LW:
-        return rv_lw_instr;
-    case rv_func_LBU:
-        return rv_lbu_instr;
-    case rv_func_LHU:
-        return rv_lhu_instr;
-    default:
-        return rv_illegal_instr;
-    }
-}
+/** Instruction specification */
+typedef struct {
+    rv_instr_func_t func;
+    uint32_t mask;
+    uint32_t match;
+    bool machine_specific;
+} instr_spec_t;
+
+static const instr_spec_t instr_spec[rv_instr_count] = {
+#define RV_INSTR(name, func, mask, match, machine_specific) \
+    [rv_instr_##name] = { rv_##func##_instr, mask, match, machine_specific },
+#include "instr.def"
+#undef RV_INSTR
+};
+
+/** Bits of the instruction word indexing the decoding table */
+#define DECODE_KEY_MASK UINT32_C(0x0000707f)
+
+/** Decoding table index of the opcode and funct3 fields */
+#define DECODE_INDEX(val) ((((val) & 0x7f) << 3) | (((val) >> 12) & 0x7))
+
+#define DECODE_SLOTS (1 << 10)
+
+/** There are 8 funct3 values an instruction can span */
+#define DECODE_POOL_SIZE (rv_instr_count * 8)
+
+/** Decoding table entry for one opcode and funct3 combination
+ *
+ * If a single instruction is identified by these fields alone, it is
+ * stored directly. Otherwise the candidates are matched against the
+ * remaining bits of the instruction word.
+ */
+typedef struct {
+    rv_instr_id_t id;
+    rv_instr_func_t func;
+    const rv_instr_id_t *candidates;
+    unsigned int count;
+} decode_slot_t;
 
-static rv_instr_func_t decode_MISC_MEM(rv_instr_t instr)
+static decode_slot_t decode_table[DECODE_SLOTS];
+static rv_instr_id_t decode_pool[DECODE_POOL_SIZE];
+
+/** Build the decoding table from the instruction specification */
+void rv_instr_decode_init(void)
 {
-    ASSERT(instr.r.opcode == rv_opcMISC_MEM);
-    if (instr.i.funct3 == 0) {
-        return rv_fence_instr;
+    static bool initialized = false;
+
+    if (initialized) {
+        return;
     }
-    return rv_illegal_instr;
-}
 
-static rv_instr_func_t decode_OP_IMM(rv_instr_t instr)
-{
-    ASSERT(instr.i.opcode == rv_opcOP_IMM);
-
-    switch (instr.i.funct3) {
-    case rv_func_ADDI:
-        return rv_addi_instr;
-    case rv_func_SLTI:
-        return rv_slti_instr;
-    case rv_func_SLTIU:
-        return rv_sltiu_instr;
-    case rv_func_XORI:
-        return rv_xori_instr;
-    case rv_func_ORI:
-        return rv_ori_instr;
-    case rv_func_ANDI:
-        return rv_andi_instr;
-    case rv_func_SLLI: {
-        if (instr.i.imm >> 5 == 0) {
-            return rv_slli_instr;
-        } else {
-            return rv_illegal_instr;
+    size_t used = 0;
+
+    for (unsigned int index = 0; index < DECODE_SLOTS; index++) {
+        uint32_t key = ((index >> 3) & 0x7f) | ((index & 0x7) << 12);
+        decode_slot_t *slot = &decode_table[index];
+
+        slot->id = rv_instr_count;
+        slot->func = NULL;
+        slot->candidates = &decode_pool[used];
+        slot->count = 0;
+
+        for (unsigned int id = 0; id < rv_instr_count; id++) {
+            const instr_spec_t *spec = &instr_spec[id];
+            ASSERT((spec->mask & 0x7f) == 0x7f);
+            ASSERT((spec->match & ~spec->mask) == 0);
+
+            if ((key & spec->mask & DECODE_KEY_MASK) == (spec->match & DECODE_KEY_MASK)) {
+                ASSERT(used < DECODE_POOL_SIZE);
+                decode_pool[used++] = id;
+                slot->count++;
+            }
         }
-    }
-    case rv_func_SRI: {
-        switch (instr.i.imm >> 5) {
-        case rv_SRAI:
-            return rv_srai_instr;
-        case rv_SRLI:
-            return rv_srli_instr;
-        default:
-            return rv_illegal_instr;
+
+        if (slot->count == 1) {
+            const instr_spec_t *spec = &instr_spec[slot->candidates[0]];
+
+            if (((spec->mask & ~DECODE_KEY_MASK) == 0) && (!spec->machine_specific)) {
+                slot->id = slot->candidates[0];
+                slot->func = spec->func;
+            }
         }
     }
-    default:
-        return rv_illegal_instr;
-    }
-}
 
-static rv_instr_func_t decode_AUIPC(rv_instr_t instr)
-{
-    ASSERT(instr.r.opcode == rv_opcAUIPC);
-    return rv_auipc_instr;
+    initialized = true;
 }
 
-static rv_instr_func_t decode_STORE(rv_instr_t instr)
+/** Identify the instruction
+ *
+ * @return The instruction or rv_instr_count if it is not valid
+ */
+rv_instr_id_t rv_instr_identify(rv_instr_t instr)
 {
-    ASSERT(instr.s.opcode == rv_opcSTORE);
-    switch (instr.s.funct3) {
-    case rv_func_SB:
-        return rv_sb_instr;
-    case rv_func_SH:
-        return rv_sh_instr;
-    case rv_func_SW:
-        return rv_sw_instr;
-    default:
-        return rv_illegal_instr;
+    const decode_slot_t *slot = &decode_table[DECODE_INDEX(instr.val)];
+
+    if (slot->func != NULL) {
+        return slot->id;
+    }
+
+    for (unsigned int i = 0; i < slot->count; i++) {
+        rv_instr_id_t id = slot->candidates[i];
+        const instr_spec_t *spec = &instr_spec[id];
+
+        if ((instr.val & spec->mask) == spec->match) {
+            if ((spec->machine_specific) && (!machine_specific_instructions)) {
+                return rv_instr_count;
+            }
+
+            return id;
+        }
     }
+
+    return rv_instr_count;
 }
 
-static rv_instr_func_t decode_AMO(rv_instr_t instr)
+rv_instr_func_t rv_instr_decode(rv_instr_t instr)
 {
-    ASSERT(instr.r.opcode == rv_opcAMO);
+    const decode_slot_t *slot = &decode_table[DECODE_INDEX(instr.val)];
 
-    // only 32 bit width is supported
-    if (instr.r.funct3 != RV_AMO_32_WLEN) {
-        return rv_illegal_instr;
+    if (slot->func != NULL) {
+        return slot->func;
     }
 
-    switch (RV_AMO_FUNCT(instr)) {
-    case rv_funcLR:
-        return instr.r.rs2 == 0 ? rv_lr_instr : rv_illegal_instr;
-    case rv_funcSC:
-        return rv_sc_instr;
-    case rv_funcAMOSWAP:
-        return rv_amoswap_instr;
-    case rv_funcAMOADD:
-        return rv_amoadd_instr;
-    case rv_funcAMOXOR:
-        return rv_amoxor_instr;
-    case rv_funcAMOAND:
-        return rv_amoand_instr;
-    case rv_funcAMOOR:
-        return rv_amoor_instr;
-    case rv_funcAMOMIN:
-        return rv_amomin_instr;
-    case rv_funcAMOMAX:
-        return rv_amomax_instr;
-    case rv_funcAMOMINU:
-        return rv_amominu_instr;
-    case rv_funcAMOMAXU:
-        return rv_amomaxu_instr;
-    default:
+    rv_instr_id_t id = rv_instr_identify(instr);
+
+    if (id == rv_instr_count) {
         return rv_illegal_instr;
     }
+
+    return instr_spec[id].func;
 }
 
-static rv_instr_func_t decode_OP(rv_instr_t instr)
+/*
+ * Expansion of the compressed instructions
+ *
+ * Each instruction of the C extension is an alias of a base ISA
+ * instruction, the compressed instructions are therefore expanded
+ * at decode time and executed by the handlers of their base forms.
+ */
+
+/** Bits hi to lo of the compressed instruction */
+#define CBITS(cinstr, hi, lo) (((uint32_t) (cinstr) >> (lo)) & ((UINT32_C(1) << ((hi) - (lo) + 1)) - 1))
+
+/** Registers x8 to x15 encoded in the 3-bit fields */
+#define CREG(cinstr, lo) (CBITS(cinstr, (lo) + 2, lo) + 8)
+
+static uint32_t sign_extend(uint32_t val, unsigned int bits)
 {
-    ASSERT(instr.r.opcode == rv_opcOP);
-    uint32_t funct = RV_R_FUNCT(instr);
-    switch (funct) {
-    case rv_func_ADD:
-        return rv_add_instr;
-    case rv_func_SUB:
-        return rv_sub_instr;
-    case rv_func_SLL:
-        return rv_sll_instr;
-    case rv_func_SLT:
-        return rv_slt_instr;
-    case rv_func_SLTU:
-        return rv_sltu_instr;
-    case rv_func_XOR:
-        return rv_xor_instr;
-    case rv_func_SRL:
-        return rv_srl_instr;
-    case rv_func_SRA:
-        return rv_sra_instr;
-    case rv_func_OR:
-        return rv_or_instr;
-    case rv_func_AND:
-        return rv_and_instr;
-    // M extension
-    case rv_func_MUL:
-        return rv_mul_instr;
-    case rv_func_MULH:
-        return rv_mulh_instr;
-    case rv_func_MULHSU:
-        return rv_mulhsu_instr;
-    case rv_func_MULHU:
-        return rv_mulhu_instr;
-    case rv_func_DIV:
-        return rv_div_instr;
-    case rv_func_DIVU:
-        return rv_divu_instr;
-    case rv_func_REM:
-        return rv_rem_instr;
-    case rv_func_REMU:
-        return rv_remu_instr;
-    default:
-        return rv_illegal_instr;
-    }
+    return (uint32_t) ((int32_t) (val << (32 - bits)) >> (32 - bits));
 }
 
-static rv_instr_func_t decode_LUI(rv_instr_t instr)
+static rv_instr_t encode_r(rv_opcode_t opcode, uint32_t funct, unsigned int rd,
+        unsigned int rs1, unsigned int rs2)
 {
-    ASSERT(instr.r.opcode == rv_opcLUI);
-    return rv_lui_instr;
+    rv_instr_t instr = { .r = {
+                                 .opcode = opcode,
+                                 .rd = rd,
+                                 .funct3 = funct & 0x7,
+                                 .rs1 = rs1,
+                                 .rs2 = rs2,
+                                 .funct7 = funct >> 3 } };
+    return instr;
 }
 
-static rv_instr_func_t decode_BRANCH(rv_instr_t instr)
+static rv_instr_t encode_i(rv_opcode_t opcode, unsigned int funct3,
+        unsigned int rd, unsigned int rs1, uint32_t imm)
 {
-    ASSERT(instr.b.opcode == rv_opcBRANCH);
-    switch (instr.b.funct3) {
-    case rv_func_BEQ:
-        return rv_beq_instr;
-    case rv_func_BNE:
-        return rv_bne_instr;
-    case rv_func_BLT:
-        return rv_blt_instr;
-    case rv_func_BLTU:
-        return rv_bltu_instr;
-    case rv_func_BGE:
-        return rv_bge_instr;
-    case rv_func_BGEU:
-        return rv_bgeu_instr;
-    default:
-        return rv_illegal_instr;
-    }
+    rv_instr_t instr = { .val = (imm << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode };
+    return instr;
 }
 
-static rv_instr_func_t decode_JALR(rv_instr_t instr)
+static rv_instr_t encode_s(rv_opcode_t opcode, unsigned int funct3,
+        unsigned int rs1, unsigned int rs2, uint32_t imm)
 {
-    ASSERT(instr.i.opcode == rv_opcJALR);
+    rv_instr_t instr = { .val = (CBITS(imm, 11, 5) << 25) | (rs2 << 20) | (rs1 << 15)
+                                | (funct3 << 12) | (CBITS(imm, 4, 0) << 7) | opcode };
+    return instr;
+}
 
-    if (instr.i.funct3 != 0) {
-        return rv_illegal_instr;
-    }
-    return rv_jalr_instr;
+static rv_instr_t encode_b(unsigned int funct3, unsigned int rs1,
+        unsigned int rs2, uint32_t imm)
+{
+    rv_instr_t instr = { .val = (CBITS(imm, 12, 12) << 31) | (CBITS(imm, 10, 5) << 25)
+                                | (rs2 << 20) | (rs1 << 15) | (funct3 << 12)
+                                | (CBITS(imm, 4, 1) << 8) | (CBITS(imm, 11, 11) << 7)
+                                | rv_opcBRANCH };
+    return instr;
 }
 
-static rv_instr_func_t decode_JAL(rv_instr_t instr)
+static rv_instr_t encode_u(rv_opcode_t opcode, unsigned int rd, uint32_t imm)
 {
-    ASSERT(instr.r.opcode == rv_opcJAL);
-    return rv_jal_instr;
+    rv_instr_t instr = { .val = (imm & UINT32_C(0xfffff000)) | (rd << 7) | opcode };
+    return instr;
 }
 
-static rv_instr_func_t decode_PRIV(rv_instr_t instr)
+static rv_instr_t encode_j(unsigned int rd, uint32_t imm)
 {
-    ASSERT(instr.i.opcode == rv_opcSYSTEM);
-    ASSERT(instr.i.funct3 == rv_funcPRIV);
+    rv_instr_t instr = { .val = (CBITS(imm, 20, 20) << 31) | (CBITS(imm, 10, 1) << 21)
+                                | (CBITS(imm, 11, 11) << 20) | (CBITS(imm, 19, 12) << 12)
+                                | (rd << 7) | rv_opcJAL };
+    return instr;
+}
 
-    if (instr.r.funct7 == rv_privSFENCEVMA_FUNCT7) {
-        return rv_sfence_instr;
-    }
+/** Illegal instruction (all zeros are not a valid base ISA instruction) */
+static const rv_instr_t illegal_instr = { .val = 0 };
+
+/** Quadrant 0: stack-pointer based addition and register based loads and stores */
+static rv_instr_t expand_q0(uint16_t c)
+{
+    unsigned int rs1 = CREG(c, 7);
+    unsigned int rd_rs2 = CREG(c, 2);
+
+    /* Offsets of the word and double-word accesses */
+    uint32_t offset_w = (CBITS(c, 12, 10) << 3) | (CBITS(c, 6, 6) << 2) | (CBITS(c, 5, 5) << 6);
+    uint32_t offset_d = (CBITS(c, 12, 10) << 3) | (CBITS(c, 6, 5) << 6);
 
-    switch (instr.i.imm & 0xFFF) {
-    case rv_privEBREAK:
-        return rv_break_instr;
-    case rv_privEHALT:
-        return machine_specific_instructions ? rv_halt_instr : rv_illegal_instr;
-    case rv_privEDUMP:
-        return machine_specific_instructions ? rv_dump_instr : rv_illegal_instr;
-    case rv_privETRACES:
-        return machine_specific_instructions ? rv_trace_set_instr : rv_illegal_instr;
-    case rv_privETRACER:
-        return machine_specific_instructions ? rv_trace_reset_instr : rv_illegal_instr;
-    case rv_privECSRD:
-        return machine_specific_instructions ? rv_csr_rd_instr : rv_illegal_instr;
-    case rv_privECALL:
-        return rv_call_instr;
-    case rv_privSRET:
-        return rv_sret_instr;
-    case rv_privMRET:
-        return rv_mret_instr;
-    case rv_privWFI:
-        return rv_wfi_instr;
+    switch (CBITS(c, 15, 13)) {
+    case 0b000: {
+        /* C.ADDI4SPN (the zero immediate is reserved) */
+        uint32_t imm = (CBITS(c, 12, 11) << 4) | (CBITS(c, 10, 7) << 6)
+                | (CBITS(c, 6, 6) << 2) | (CBITS(c, 5, 5) << 3);
+        if (imm == 0) {
+            return illegal_instr;
+        }
+        return encode_i(rv_opcOP_IMM, rv_func_ADDI, rd_rs2, 2, imm);
+    }
+    case 0b001:
+        /* C.FLD */
+        return encode_i(rv_opcLOAD_FP, 0b011, rd_rs2, rs1, offset_d);
+    case 0b010:
+        /* C.LW */
+        return encode_i(rv_opcLOAD, rv_func_LW, rd_rs2, rs1, offset_w);
+    case 0b011:
+        /* C.FLW */
+        return encode_i(rv_opcLOAD_FP, 0b010, rd_rs2, rs1, offset_w);
+    case 0b101:
+        /* C.FSD */
+        return encode_s(rv_opcSTORE_FP, 0b011, rs1, rd_rs2, offset_d);
+    case 0b110:
+        /* C.SW */
+        return encode_s(rv_opcSTORE, rv_func_SW, rs1, rd_rs2, offset_w);
+    case 0b111:
+        /* C.FSW */
+        return encode_s(rv_opcSTORE_FP, 0b010, rs1, rd_rs2, offset_w);
     default:
-        return rv_illegal_instr;
+        return illegal_instr;
     }
 }
 
-static rv_instr_func_t decode_SYSTEM(rv_instr_t instr)
+/** Quadrant 1: immediate operations, register operations and control transfers */
+static rv_instr_t expand_q1(uint16_t c)
 {
-    ASSERT(instr.i.opcode == rv_opcSYSTEM);
-    switch (instr.i.funct3) {
-    case rv_funcPRIV:
-        return decode_PRIV(instr);
-    case rv_funcCSRRW:
-        return rv_csrrw_instr;
-    case rv_funcCSRRS:
-        return rv_csrrs_instr;
-    case rv_funcCSRRC:
-        return rv_csrrc_instr;
-    case rv_funcCSRRWI:
-        return rv_csrrwi_instr;
-    case rv_funcCSRRSI:
-        return rv_csrrsi_instr;
-    case rv_funcCSRRCI:
-        return rv_csrrci_instr;
+    unsigned int rd = CBITS(c, 11, 7);
+    unsigned int rd_short = CREG(c, 7);
+    unsigned int rs2_short = CREG(c, 2);
+
+    uint32_t imm = sign_extend((CBITS(c, 12, 12) << 5) | CBITS(c, 6, 2), 6);
+
+    uint32_t jump_offset = sign_extend((CBITS(c, 12, 12) << 11) | (CBITS(c, 11, 11) << 4)
+                    | (CBITS(c, 10, 9) << 8) | (CBITS(c, 8, 8) << 10)
+                    | (CBITS(c, 7, 7) << 6) | (CBITS(c, 6, 6) << 7)
+                    | (CBITS(c, 5, 3) << 1) | (CBITS(c, 2, 2) << 5),
+            12);
+
+    uint32_t branch_offset = sign_extend((CBITS(c, 12, 12) << 8) | (CBITS(c, 11, 10) << 3)
+                    | (CBITS(c, 6, 5) << 6) | (CBITS(c, 4, 3) << 1)
+                    | (CBITS(c, 2, 2) << 5),
+            9);
+
+    switch (CBITS(c, 15, 13)) {
+    case 0b000:
+        /* C.ADDI (C.NOP for x0) */
+        return encode_i(rv_opcOP_IMM, rv_func_ADDI, rd, rd, imm);
+    case 0b001:
+        /* C.JAL */
+        return encode_j(1, jump_offset);
+    case 0b010:
+        /* C.LI */
+        return encode_i(rv_opcOP_IMM, rv_func_ADDI, rd, 0, imm);
+    case 0b011:
+        if (rd == 2) {
+            /* C.ADDI16SP (the zero immediate is reserved) */
+            uint32_t sp_imm = sign_extend((CBITS(c, 12, 12) << 9) | (CBITS(c, 6, 6) << 4)
+                            | (CBITS(c, 5, 5) << 6) | (CBITS(c, 4, 3) << 7)
+                            | (CBITS(c, 2, 2) << 5),
+                    10);
+            if (sp_imm == 0) {
+                return illegal_instr;
+            }
+            return encode_i(rv_opcOP_IMM, rv_func_ADDI, 2, 2, sp_imm);
+        }
+
+        /* C.LUI (the zero immediate is reserved) */
+        if (imm == 0) {
+            return illegal_instr;
+        }
+        return encode_u(rv_opcLUI, rd, imm << 12);
+    case 0b100:
+        switch (CBITS(c, 11, 10)) {
+        case 0b00:
+        case 0b01: {
+            /* C.SRLI and C.SRAI (shift amounts above 31 are reserved on RV32) */
+            if (CBITS(c, 12, 12) != 0) {
+                return illegal_instr;
+            }
+            uint32_t type = (CBITS(c, 11, 10) == 0b01) ? rv_SRAI : rv_SRLI;
+            return encode_i(rv_opcOP_IMM, rv_func_SRI, rd_short, rd_short,
+                    (type << 5) | CBITS(c, 6, 2));
+        }
+        case 0b10:
+            /* C.ANDI */
+            return encode_i(rv_opcOP_IMM, rv_func_ANDI, rd_short, rd_short, imm);
+        default:
+            break;
+        }
+
+        /* C.SUBW and C.ADDW are RV64 only */
+        if (CBITS(c, 12, 12) != 0) {
+            return illegal_instr;
+        }
+
+        static const rv_op_func_t funcs[] = { rv_func_SUB, rv_func_XOR, rv_func_OR, rv_func_AND };
+        return encode_r(rv_opcOP, funcs[CBITS(c, 6, 5)], rd_short, rd_short, rs2_short);
+    case 0b101:
+        /* C.J */
+        return encode_j(0, jump_offset);
+    case 0b110:
+        /* C.BEQZ */
+        return encode_b(rv_func_BEQ, rd_short, 0, branch_offset);
     default:
-        return rv_illegal_instr;
+        /* C.BNEZ */
+        return encode_b(rv_func_BNE, rd_short, 0, branch_offset);
     }
 }
 
-rv_instr_func_t rv_instr_decode(rv_instr_t instr)
+/** Quadrant 2: stack-pointer based loads and stores, register moves and indirect jumps */
+static rv_instr_t expand_q2(uint16_t c)
 {
-    // opcode is at the same spot in all encodings, so any can be chosen
-    switch (instr.r.opcode) {
-    case rv_opcLOAD:
-        return decode_LOAD(instr);
-    case rv_opcMISC_MEM:
-        return decode_MISC_MEM(instr);
-    case rv_opcOP_IMM:
-        return decode_OP_IMM(instr);
-    case rv_opcAUIPC:
-        return decode_AUIPC(instr);
-    case rv_opcSTORE:
-        return decode_STORE(instr);
-    case rv_opcAMO:
-        return decode_AMO(instr);
-    case rv_opcOP:
-        return decode_OP(instr);
-    case rv_opcLUI:
-        return decode_LUI(instr);
-    case rv_opcBRANCH:
-        return decode_BRANCH(instr);
-    case rv_opcJALR:
-        return decode_JALR(instr);
-    case rv_opcJAL:
-        return decode_JAL(instr);
-    case rv_opcSYSTEM:
-        return decode_SYSTEM(instr);
-    default: {
-        return rv_illegal_instr;
+    unsigned int rd = CBITS(c, 11, 7);
+    unsigned int rs2 = CBITS(c, 6, 2);
+
+    /* Offsets of the stack-pointer based accesses */
+    uint32_t load_offset_w = (CBITS(c, 12, 12) << 5) | (CBITS(c, 6, 4) << 2) | (CBITS(c, 3, 2) << 6);
+    uint32_t load_offset_d = (CBITS(c, 12, 12) << 5) | (CBITS(c, 6, 5) << 3) | (CBITS(c, 4, 2) << 6);
+    uint32_t store_offset_w = (CBITS(c, 12, 9) << 2) | (CBITS(c, 8, 7) << 6);
+    uint32_t store_offset_d = (CBITS(c, 12, 10) << 3) | (CBITS(c, 9, 7) << 6);
+
+    switch (CBITS(c, 15, 13)) {
+    case 0b000:
+        /* C.SLLI (shift amounts above 31 are reserved on RV32) */
+        if (CBITS(c, 12, 12) != 0) {
+            return illegal_instr;
+        }
+        return encode_i(rv_opcOP_IMM, rv_func_SLLI, rd, rd, CBITS(c, 6, 2));
+    case 0b001:
+        /* C.FLDSP */
+        return encode_i(rv_opcLOAD_FP, 0b011, rd, 2, load_offset_d);
+    case 0b010:
+        /* C.LWSP (x0 destination is reserved) */
+        if (rd == 0) {
+            return illegal_instr;
+        }
+        return encode_i(rv_opcLOAD, rv_func_LW, rd, 2, load_offset_w);
+    case 0b011:
+        /* C.FLWSP */
+        return encode_i(rv_opcLOAD_FP, 0b010, rd, 2, load_offset_w);
+    case 0b100:
+        if (CBITS(c, 12, 12) == 0) {
+            if (rs2 != 0) {
+                /* C.MV */
+                return encode_r(rv_opcOP, rv_func_ADD, rd, 0, rs2);
+            }
+
+            /* C.JR (x0 source is reserved) */
+            if (rd == 0) {
+                return illegal_instr;
+            }
+            return encode_i(rv_opcJALR, 0, 0, rd, 0);
+        }
+
+        if (rs2 != 0) {
+            /* C.ADD */
+            return encode_r(rv_opcOP, rv_func_ADD, rd, rd, rs2);
+        }
+
+        if (rd == 0) {
+            /* C.EBREAK */
+            return encode_i(rv_opcSYSTEM, rv_funcPRIV, 0, 0, rv_privEBREAK);
+        }
+
+        /* C.JALR */
+        return encode_i(rv_opcJALR, 0, 1, rd, 0);
+    case 0b101:
+        /* C.FSDSP */
+        return encode_s(rv_opcSTORE_FP, 0b011, 2, rs2, store_offset_d);
+    case 0b110:
+        /* C.SWSP */
+        return encode_s(rv_opcSTORE, rv_func_SW, 2, rs2, store_offset_w);
+    default:
+        /* C.FSWSP */
+        return encode_s(rv_opcSTORE_FP, 0b010, 2, rs2, store_offset_w);
     }
+}
+
+/** Expand a compressed instruction to its base ISA form
+ *
+ * @return The equivalent 32-bit instruction or an invalid instruction
+ *         (all zeros) if the encoding is reserved or not supported.
+ */
+rv_instr_t rv_instr_expand(uint16_t cinstr)
+{
+    switch (cinstr & 0x3) {
+    case 0b00:
+        return expand_q0(cinstr);
+    case 0b01:
+        return expand_q1(cinstr);
+    case 0b10:
+        return expand_q2(cinstr);
+    default:
+        return illegal_instr;
     }
 }
@@ -75,25 +75,30 @@ static_assert(sizeof(rv_instr_t) == 4, "rv_instr_t has wrong size");
 #define RV_J_IMM(instr) (uint32_t) ((((int32_t) instr.j.imm20) << 20) | (instr.j.imm19_12 << 12) | (instr.j.imm11 << 11) | (instr.j.imm10_1 << 1))
 #define RV_B_IMM(instr) (uint32_t) ((((int32_t) instr.b.imm12) << 12) | (instr.b.imm11 << 11) | (instr.b.imm10_5 << 5) | (instr.b.imm4_1 << 1))
 #define RV_AMO_FUNCT(instr) (instr.r.funct7 >> 2)
+#define RV_R4_RS3(instr) (unsigned int) (instr.r.funct7 >> 2)
+
+/** Instructions of the C extension have the lowest two bits other than 0b11 */
+#define RV_INSTR_IS_COMPRESSED(val) (((val) & 0x3) != 0x3)
+#define RV_INSTR_LENGTH(val) (RV_INSTR_IS_COMPRESSED(val) ? 2 : 4)
 
 /** Opcodes*/
 typedef enum {
     rv_opcLOAD = 0b0000011,
-    rv_opcLOAD_FP = 0b0000111, // not supported
+    rv_opcLOAD_FP = 0b0000111,
     rv_opcMISC_MEM = 0b0001111,
     rv_opcOP_IMM = 0b0010011,
     rv_opcAUIPC = 0b0010111,
     rv_opcSTORE = 0b0100011,
-    rv_opcSTORE_FP = 0b0100111, // not supported
+    rv_opcSTORE_FP = 0b0100111,
     rv_opcAMO = 0b0101111,
     rv_opcOP = 0b0110011,
     rv_opcLUI = 0b0110111,
     rv_opcOP_32 = 0b0111011, // not supported
-    rv_opcMADD = 0b1000011, // not supported
-    rv_opcMSUB = 0b1000111, // not supported
-    rv_opcNMSUB = 0b1001011, // not supported
-    rv_opcNMADD = 0b1001111, // not supported
-    rv_opcOP_FP = 0b1010011, // not supported
+    rv_opcMADD = 0b1000011,
+    rv_opcMSUB = 0b1000111,
+    rv_opcNMSUB = 0b1001011,
+    rv_opcNMADD = 0b1001111,
+    rv_opcOP_FP = 0b1010011,
     rv_opcBRANCH = 0b1100011,
     rv_opcJALR = 0b1100111,
     rv_opcJAL = 0b1101111,
@@ -170,6 +175,16 @@ typedef enum {
     rv_func_SW = 0b010
 } rv_store_func_t;
 
+/** Rounding modes of the floating-point instructions (rm field and frm) */
+typedef enum {
+    rv_rmRNE = 0b000, // to nearest, ties to even
+    rv_rmRTZ = 0b001, // towards zero
+    rv_rmRDN = 0b010, // down (towards -infinity)
+    rv_rmRUP = 0b011, // up (towards +infinity)
+    rv_rmRMM = 0b100, // to nearest, ties to max magnitude
+    rv_rmDYN = 0b111 // dynamic (frm)
+} rv_rm_t;
+
 /** Funct values for SYSTEM instructions */
 typedef enum {
     rv_funcPRIV = 0b000,
@@ -191,6 +206,8 @@ typedef enum {
     rv_privETRACES = 0b100011000010,
     rv_privETRACER = 0b100011000011,
     rv_privECSRD = 0b100011000100,
+    rv_privEROIB = 0b100011000101,
+    rv_privEROIE = 0b100011000110,
     rv_privSRET = 0b000100000010,
     rv_privMRET = 0b001100000010,
     rv_privWFI = 0b000100000101
@@ -225,7 +242,18 @@ struct rv_cpu;
 
 typedef enum rv_exc (*rv_instr_func_t)(struct rv_cpu *, rv_instr_t);
 
+/** Instructions of the specification in instr.def */
+typedef enum {
+#define RV_INSTR(name, func, mask, match, machine_specific) rv_instr_##name,
+#include "instr.def"
+#undef RV_INSTR
+    rv_instr_count
+} rv_instr_id_t;
+
+extern void rv_instr_decode_init(void);
+extern rv_instr_id_t rv_instr_identify(rv_instr_t instr);
 extern rv_instr_func_t rv_instr_decode(rv_instr_t instr);
+extern rv_instr_t rv_instr_expand(uint16_t cinstr);
 
 extern enum rv_exc rv_illegal_instr(struct rv_cpu *cpu, rv_instr_t instr);
 
@@ -21,12 +21,13 @@ rv_exc_t rv_jal_instr(rv_cpu_t *cpu, rv_instr_t instr)
     // jump target is relative to the address of the instruction eg. pc
     uint32_t target = cpu->pc + RV_J_IMM(instr);
 
-    if (!IS_ALIGNED(target, 4)) {
+    if (!IS_ALIGNED(target, RV_IALIGN)) {
         cpu->csr.tval_next = target;
         return rv_exc_instruction_address_misaligned;
     }
 
-    cpu->regs[instr.j.rd] = cpu->pc + 4;
+    // pc_next points to the following (possibly compressed) instruction
+    cpu->regs[instr.j.rd] = cpu->pc_next;
 
     cpu->pc_next = target;
     return rv_exc_none;
@@ -42,12 +43,13 @@ rv_exc_t rv_jalr_instr(rv_cpu_t *cpu, rv_instr_t instr)
     // lowest bit set to 0, as described in the specification
     target &= ~1;
 
-    if (!IS_ALIGNED(target, 4)) {
+    if (!IS_ALIGNED(target, RV_IALIGN)) {
         cpu->csr.tval_next = target;
         return rv_exc_instruction_address_misaligned;
     }
 
-    cpu->regs[instr.j.rd] = cpu->pc + 4;
+    // pc_next points to the following (possibly compressed) instruction
+    cpu->regs[instr.j.rd] = cpu->pc_next;
 
     cpu->pc_next = target;
     return rv_exc_none;
@@ -65,7 +67,7 @@ rv_exc_t rv_beq_instr(rv_cpu_t *cpu, rv_instr_t instr)
     uint32_t rhs = cpu->regs[instr.b.rs2];
 
     if (lhs == rhs) {
-        if (!IS_ALIGNED(target, 4)) {
+        if (!IS_ALIGNED(target, RV_IALIGN)) {
             cpu->csr.tval_next = target;
             return rv_exc_instruction_address_misaligned;
         }
@@ -88,7 +90,7 @@ rv_exc_t rv_bne_instr(rv_cpu_t *cpu, rv_instr_t instr)
     uint32_t rhs = cpu->regs[instr.b.rs2];
 
     if (lhs != rhs) {
-        if (!IS_ALIGNED(target, 4)) {
+        if (!IS_ALIGNED(target, RV_IALIGN)) {
             cpu->csr.tval_next = target;
             return rv_exc_instruction_address_misaligned;
         }
@@ -111,7 +113,7 @@ rv_exc_t rv_blt_instr(rv_cpu_t *cpu, rv_instr_t instr)
     int32_t rhs = (int32_t) cpu->regs[instr.b.rs2];
 
     if (lhs < rhs) {
-        if (!IS_ALIGNED(target, 4)) {
+        if (!IS_ALIGNED(target, RV_IALIGN)) {
             cpu->csr.tval_next = target;
             return rv_exc_instruction_address_misaligned;
         }
@@ -134,7 +136,7 @@ rv_exc_t rv_bltu_instr(rv_cpu_t *cpu, rv_instr_t instr)
 
     if (lhs < rhs) {
 
-        if (!IS_ALIGNED(target, 4)) {
+        if (!IS_ALIGNED(target, RV_IALIGN)) {
             cpu->csr.tval_next = target;
             return rv_exc_instruction_address_misaligned;
         }
@@ -156,7 +158,7 @@ rv_exc_t rv_bge_instr(rv_cpu_t *cpu, rv_instr_t instr)
     int32_t rhs = (int32_t) cpu->regs[instr.b.rs2];
 
     if (lhs >= rhs) {
-        if (!IS_ALIGNED(target, 4)) {
+        if (!IS_ALIGNED(target, RV_IALIGN)) {
             cpu->csr.tval_next = target;
             return rv_exc_instruction_address_misaligned;
         }
@@ -178,7 +180,7 @@ rv_exc_t rv_bgeu_instr(rv_cpu_t *cpu, rv_instr_t instr)
     uint32_t rhs = cpu->regs[instr.b.rs2];
 
     if (lhs >= rhs) {
-        if (!IS_ALIGNED(target, 4)) {
+        if (!IS_ALIGNED(target, RV_IALIGN)) {
             cpu->csr.tval_next = target;
             return rv_exc_instruction_address_misaligned;
         }
@@ -0,0 +1,1341 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ * RISC-V floating-point instructions (F and D extensions)
+ *
+ * The arithmetic is executed by the host floating-point unit in the
+ * rounding mode of the instruction and the accrued exceptions are
+ * taken from the host exception flags. The host has no mode rounding
+ * ties away from zero, so RMM rounds ties to even in the arithmetic
+ * (the conversions to integers round ties away from zero correctly).
+ *
+ * Every NaN result is replaced with the canonical NaN. Single-precision
+ * values are NaN-boxed in the 64-bit registers, a single-precision
+ * operand which is not properly NaN-boxed reads as the canonical NaN.
+ *
+ * All instructions raise the illegal instruction exception while
+ * mstatus.FS is Off. Every write of a floating-point register or of
+ * fcsr sets FS to Dirty, so the operating system only needs to save
+ * the floating-point state of the harts that have used it.
+ *
+ */
+
+#include <fenv.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../../../../assert.h"
+#include "../../../../physmem.h"
+#include "../../../../utils.h"
+#include "../virt_mem.h"
+#include "fp_ops.h"
+
+#define S_SIGN UINT32_C(0x80000000)
+#define S_EXP UINT32_C(0x7F800000)
+#define S_QUIET UINT32_C(0x00400000)
+#define S_CANONICAL_NAN UINT32_C(0x7FC00000)
+
+#define D_SIGN UINT64_C(0x8000000000000000)
+#define D_EXP UINT64_C(0x7FF0000000000000)
+#define D_QUIET UINT64_C(0x0008000000000000)
+#define D_CANONICAL_NAN UINT64_C(0x7FF8000000000000)
+
+/** Upper bits of a NaN-boxed single-precision value */
+#define NAN_BOX UINT64_C(0xFFFFFFFF00000000)
+
+/** Classes of fclass (bit numbers of the result) */
+#define CLASS_NEG_INF 0
+#define CLASS_NEG_NORMAL 1
+#define CLASS_NEG_SUBNORMAL 2
+#define CLASS_NEG_ZERO 3
+#define CLASS_POS_ZERO 4
+#define CLASS_POS_SUBNORMAL 5
+#define CLASS_POS_NORMAL 6
+#define CLASS_POS_INF 7
+#define CLASS_SNAN 8
+#define CLASS_QNAN 9
+
+/** Arithmetic operations */
+typedef enum {
+    fp_op_add,
+    fp_op_sub,
+    fp_op_mul,
+    fp_op_div,
+    fp_op_sqrt,
+    fp_op_madd,
+    fp_op_msub,
+    fp_op_nmsub,
+    fp_op_nmadd
+} fp_op_t;
+
+/** Comparisons */
+typedef enum {
+    fp_cmp_eq,
+    fp_cmp_lt,
+    fp_cmp_le
+} fp_cmp_t;
+
+/** Sign injections */
+typedef enum {
+    fp_sgnj,
+    fp_sgnjn,
+    fp_sgnjx
+} fp_sgnj_t;
+
+static const int host_rm[] = {
+    [rv_rmRNE] = FE_TONEAREST,
+    [rv_rmRTZ] = FE_TOWARDZERO,
+    [rv_rmRDN] = FE_DOWNWARD,
+    [rv_rmRUP] = FE_UPWARD,
+    [rv_rmRMM] = FE_TONEAREST
+};
+
+/***********
+ * Helpers *
+ ***********/
+
+static inline bool fp_off(rv_cpu_t *cpu)
+{
+    return rv_csr_sstatus_fs(cpu) == rv_fs_off;
+}
+
+/** Resolve the rounding mode of the instruction
+ *
+ * @return False if the rounding mode is reserved.
+ *
+ */
+static inline bool get_rm(rv_cpu_t *cpu, rv_instr_t instr, rv_rm_t *rm)
+{
+    unsigned int mode = instr.r.funct3;
+
+    if (mode == rv_rmDYN) {
+        mode = rv_csr_fcsr_frm(cpu);
+    }
+
+    if (mode > rv_rmRMM) {
+        return false;
+    }
+
+    *rm = (rv_rm_t) mode;
+    return true;
+}
+
+/** Prepare the host for an operation
+ *
+ * The host runs in the round to nearest mode,
+ * it is switched only for the other modes.
+ *
+ */
+static inline void host_begin(rv_rm_t rm)
+{
+    if (host_rm[rm] != FE_TONEAREST) {
+        fesetround(host_rm[rm]);
+    }
+
+    feclearexcept(FE_ALL_EXCEPT);
+}
+
+/** Collect the host exceptions of an operation as fflags */
+static inline uint32_t host_end(rv_rm_t rm)
+{
+    int host = fetestexcept(FE_ALL_EXCEPT);
+
+    if (host_rm[rm] != FE_TONEAREST) {
+        fesetround(FE_TONEAREST);
+    }
+
+    uint32_t flags = 0;
+
+    if ((host & FE_INEXACT) != 0) {
+        flags |= rv_fflags_nx;
+    }
+
+    if ((host & FE_UNDERFLOW) != 0) {
+        flags |= rv_fflags_uf;
+    }
+
+    if ((host & FE_OVERFLOW) != 0) {
+        flags |= rv_fflags_of;
+    }
+
+    if ((host & FE_DIVBYZERO) != 0) {
+        flags |= rv_fflags_dz;
+    }
+
+    if ((host & FE_INVALID) != 0) {
+        flags |= rv_fflags_nv;
+    }
+
+    return flags;
+}
+
+static inline void accrue(rv_cpu_t *cpu, uint32_t flags)
+{
+    if (flags != 0) {
+        cpu->csr.fcsr |= flags;
+        rv_csr_mstatus_set_fs_dirty(cpu);
+    }
+}
+
+static inline float s_float(uint32_t val)
+{
+    float res;
+    memcpy(&res, &val, sizeof(res));
+    return res;
+}
+
+static inline uint32_t s_bits(float val)
+{
+    uint32_t res;
+    memcpy(&res, &val, sizeof(res));
+    return res;
+}
+
+static inline double d_float(uint64_t val)
+{
+    double res;
+    memcpy(&res, &val, sizeof(res));
+    return res;
+}
+
+static inline uint64_t d_bits(double val)
+{
+    uint64_t res;
+    memcpy(&res, &val, sizeof(res));
+    return res;
+}
+
+static inline bool s_is_nan(uint32_t val)
+{
+    return (val & ~S_SIGN) > S_EXP;
+}
+
+static inline bool s_is_snan(uint32_t val)
+{
+    return (s_is_nan(val)) && ((val & S_QUIET) == 0);
+}
+
+static inline bool d_is_nan(uint64_t val)
+{
+    return (val & ~D_SIGN) > D_EXP;
+}
+
+static inline bool d_is_snan(uint64_t val)
+{
+    return (d_is_nan(val)) && ((val & D_QUIET) == 0);
+}
+
+/** Read a single-precision operand (unboxed values are the canonical NaN) */
+static inline uint32_t get_s(rv_cpu_t *cpu, unsigned int reg)
+{
+    uint64_t val = cpu->fregs[reg];
+
+    if ((val & NAN_BOX) != NAN_BOX) {
+        return S_CANONICAL_NAN;
+    }
+
+    return (uint32_t) val;
+}
+
+static inline void set_s(rv_cpu_t *cpu, unsigned int reg, uint32_t val)
+{
+    cpu->fregs[reg] = NAN_BOX | val;
+    rv_csr_mstatus_set_fs_dirty(cpu);
+}
+
+static inline uint64_t get_d(rv_cpu_t *cpu, unsigned int reg)
+{
+    return cpu->fregs[reg];
+}
+
+static inline void set_d(rv_cpu_t *cpu, unsigned int reg, uint64_t val)
+{
+    cpu->fregs[reg] = val;
+    rv_csr_mstatus_set_fs_dirty(cpu);
+}
+
+/** Invalid multiplication of zero and infinity in a fused operation
+ *
+ * The host may not signal it when the addend is a quiet NaN.
+ *
+ */
+static inline bool fma_invalid(double a, double b)
+{
+    return ((isinf(a)) && (b == 0)) || ((a == 0) && (isinf(b)));
+}
+
+/**************
+ * Arithmetic *
+ **************/
+
+static rv_exc_t arith_s(rv_cpu_t *cpu, rv_instr_t instr, fp_op_t op)
+{
+    rv_rm_t rm;
+
+    if ((fp_off(cpu)) || (!get_rm(cpu, instr, &rm))) {
+        return rv_exc_illegal_instruction;
+    }
+
+    /* Volatile keeps the operation between the flag accesses */
+    volatile float a = s_float(get_s(cpu, instr.r.rs1));
+    volatile float b = s_float(get_s(cpu, instr.r.rs2));
+    volatile float c = 0;
+    volatile float res = 0;
+    uint32_t flags = 0;
+
+    if (op >= fp_op_madd) {
+        c = s_float(get_s(cpu, RV_R4_RS3(instr)));
+        if (fma_invalid(a, b)) {
+            flags |= rv_fflags_nv;
+        }
+    }
+
+    host_begin(rm);
+
+    switch (op) {
+    case fp_op_add:
+        res = a + b;
+        break;
+    case fp_op_sub:
+        res = a - b;
+        break;
+    case fp_op_mul:
+        res = a * b;
+        break;
+    case fp_op_div:
+        res = a / b;
+        break;
+    case fp_op_sqrt:
+        res = sqrtf(a);
+        break;
+    case fp_op_madd:
+        res = fmaf(a, b, c);
+        break;
+    case fp_op_msub:
+        res = fmaf(a, b, -c);
+        break;
+    case fp_op_nmsub:
+        res = fmaf(-a, b, c);
+        break;
+    case fp_op_nmadd:
+        res = fmaf(-a, b, -c);
+        break;
+    }
+
+    flags |= host_end(rm);
+
+    uint32_t bits = s_bits(res);
+    if (s_is_nan(bits)) {
+        bits = S_CANONICAL_NAN;
+    }
+
+    accrue(cpu, flags);
+    set_s(cpu, instr.r.rd, bits);
+    return rv_exc_none;
+}
+
+static rv_exc_t arith_d(rv_cpu_t *cpu, rv_instr_t instr, fp_op_t op)
+{
+    rv_rm_t rm;
+
+    if ((fp_off(cpu)) || (!get_rm(cpu, instr, &rm))) {
+        return rv_exc_illegal_instruction;
+    }
+
+    volatile double a = d_float(get_d(cpu, instr.r.rs1));
+    volatile double b = d_float(get_d(cpu, instr.r.rs2));
+    volatile double c = 0;
+    volatile double res = 0;
+    uint32_t flags = 0;
+
+    if (op >= fp_op_madd) {
+        c = d_float(get_d(cpu, RV_R4_RS3(instr)));
+        if (fma_invalid(a, b)) {
+            flags |= rv_fflags_nv;
+        }
+    }
+
+    host_begin(rm);
+
+    switch (op) {
+    case fp_op_add:
+        res = a + b;
+        break;
+    case fp_op_sub:
+        res = a - b;
+        break;
+    case fp_op_mul:
+        res = a * b;
+        break;
+    case fp_op_div:
+        res = a / b;
+        break;
+    case fp_op_sqrt:
+        res = sqrt(a);
+        break;
+    case fp_op_madd:
+        res = fma(a, b, c);
+        break;
+    case fp_op_msub:
+        res = fma(a, b, -c);
+        break;
+    case fp_op_nmsub:
+        res = fma(-a, b, c);
+        break;
+    case fp_op_nmadd:
+        res = fma(-a, b, -c);
+        break;
+    }
+
+    flags |= host_end(rm);
+
+    uint64_t bits = d_bits(res);
+    if (d_is_nan(bits)) {
+        bits = D_CANONICAL_NAN;
+    }
+
+    accrue(cpu, flags);
+    set_d(cpu, instr.r.rd, bits);
+    return rv_exc_none;
+}
+
+/******************
+ * Sign injection *
+ ******************/
+
+static rv_exc_t sgnj_s(rv_cpu_t *cpu, rv_instr_t instr, fp_sgnj_t kind)
+{
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t a = get_s(cpu, instr.r.rs1);
+    uint32_t b = get_s(cpu, instr.r.rs2);
+    uint32_t sign = b & S_SIGN;
+
+    if (kind == fp_sgnjn) {
+        sign ^= S_SIGN;
+    } else if (kind == fp_sgnjx) {
+        sign ^= a & S_SIGN;
+    }
+
+    set_s(cpu, instr.r.rd, (a & ~S_SIGN) | sign);
+    return rv_exc_none;
+}
+
+static rv_exc_t sgnj_d(rv_cpu_t *cpu, rv_instr_t instr, fp_sgnj_t kind)
+{
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint64_t a = get_d(cpu, instr.r.rs1);
+    uint64_t b = get_d(cpu, instr.r.rs2);
+    uint64_t sign = b & D_SIGN;
+
+    if (kind == fp_sgnjn) {
+        sign ^= D_SIGN;
+    } else if (kind == fp_sgnjx) {
+        sign ^= a & D_SIGN;
+    }
+
+    set_d(cpu, instr.r.rd, (a & ~D_SIGN) | sign);
+    return rv_exc_none;
+}
+
+/***********
+ * Min/max *
+ ***********/
+
+/*
+ * A NaN operand is ignored (the result is the canonical NaN only if both
+ * operands are NaNs), only signaling NaNs are invalid. Negative zero is
+ * smaller than positive zero.
+ */
+
+static rv_exc_t min_max_s(rv_cpu_t *cpu, rv_instr_t instr, bool max)
+{
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t a = get_s(cpu, instr.r.rs1);
+    uint32_t b = get_s(cpu, instr.r.rs2);
+    uint32_t res;
+
+    if ((s_is_snan(a)) || (s_is_snan(b))) {
+        accrue(cpu, rv_fflags_nv);
+    }
+
+    if ((s_is_nan(a)) && (s_is_nan(b))) {
+        res = S_CANONICAL_NAN;
+    } else if (s_is_nan(a)) {
+        res = b;
+    } else if (s_is_nan(b)) {
+        res = a;
+    } else if (((a | b) & ~S_SIGN) == 0) {
+        res = max ? (a & b) : (a | b);
+    } else {
+        bool less = s_float(a) < s_float(b);
+        res = (less != max) ? a : b;
+    }
+
+    set_s(cpu, instr.r.rd, res);
+    return rv_exc_none;
+}
+
+static rv_exc_t min_max_d(rv_cpu_t *cpu, rv_instr_t instr, bool max)
+{
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint64_t a = get_d(cpu, instr.r.rs1);
+    uint64_t b = get_d(cpu, instr.r.rs2);
+    uint64_t res;
+
+    if ((d_is_snan(a)) || (d_is_snan(b))) {
+        accrue(cpu, rv_fflags_nv);
+    }
+
+    if ((d_is_nan(a)) && (d_is_nan(b))) {
+        res = D_CANONICAL_NAN;
+    } else if (d_is_nan(a)) {
+        res = b;
+    } else if (d_is_nan(b)) {
+        res = a;
+    } else if (((a | b) & ~D_SIGN) == 0) {
+        res = max ? (a & b) : (a | b);
+    } else {
+        bool less = d_float(a) < d_float(b);
+        res = (less != max) ? a : b;
+    }
+
+    set_d(cpu, instr.r.rd, res);
+    return rv_exc_none;
+}
+
+/***************
+ * Comparisons *
+ ***************/
+
+/*
+ * The result is 0 if any operand is a NaN. FEQ is a quiet comparison
+ * (only signaling NaNs are invalid), FLT and FLE are signaling
+ * comparisons (all NaNs are invalid).
+ */
+
+static rv_exc_t compare_s(rv_cpu_t *cpu, rv_instr_t instr, fp_cmp_t cmp)
+{
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t a = get_s(cpu, instr.r.rs1);
+    uint32_t b = get_s(cpu, instr.r.rs2);
+
+    if ((s_is_nan(a)) || (s_is_nan(b))) {
+        if ((cmp != fp_cmp_eq) || (s_is_snan(a)) || (s_is_snan(b))) {
+            accrue(cpu, rv_fflags_nv);
+        }
+
+        cpu->regs[instr.r.rd] = 0;
+        return rv_exc_none;
+    }
+
+    float fa = s_float(a);
+    float fb = s_float(b);
+    bool res = (cmp == fp_cmp_eq) ? (fa == fb) : ((cmp == fp_cmp_lt) ? (fa < fb) : (fa <= fb));
+
+    cpu->regs[instr.r.rd] = res ? 1 : 0;
+    return rv_exc_none;
+}
+
+static rv_exc_t compare_d(rv_cpu_t *cpu, rv_instr_t instr, fp_cmp_t cmp)
+{
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint64_t a = get_d(cpu, instr.r.rs1);
+    uint64_t b = get_d(cpu, instr.r.rs2);
+
+    if ((d_is_nan(a)) || (d_is_nan(b))) {
+        if ((cmp != fp_cmp_eq) || (d_is_snan(a)) || (d_is_snan(b))) {
+            accrue(cpu, rv_fflags_nv);
+        }
+
+        cpu->regs[instr.r.rd] = 0;
+        return rv_exc_none;
+    }
+
+    double fa = d_float(a);
+    double fb = d_float(b);
+    bool res = (cmp == fp_cmp_eq) ? (fa == fb) : ((cmp == fp_cmp_lt) ? (fa < fb) : (fa <= fb));
+
+    cpu->regs[instr.r.rd] = res ? 1 : 0;
+    return rv_exc_none;
+}
+
+/******************
+ * Classification *
+ ******************/
+
+static uint32_t classify(bool sign, bool exp_zero, bool exp_max, bool frac_zero, bool quiet)
+{
+    unsigned int class;
+
+    if (exp_max) {
+        if (frac_zero) {
+            class = sign ? CLASS_NEG_INF : CLASS_POS_INF;
+        } else {
+            class = quiet ? CLASS_QNAN : CLASS_SNAN;
+        }
+    } else if (exp_zero) {
+        if (frac_zero) {
+            class = sign ? CLASS_NEG_ZERO : CLASS_POS_ZERO;
+        } else {
+            class = sign ? CLASS_NEG_SUBNORMAL : CLASS_POS_SUBNORMAL;
+        }
+    } else {
+        class = sign ? CLASS_NEG_NORMAL : CLASS_POS_NORMAL;
+    }
+
+    return UINT32_C(1) << class;
+}
+
+/***************************
+ * Conversions to integers *
+ ***************************/
+
+/** Convert to a 32-bit integer
+ *
+ * Both precisions are converted from double, which holds every
+ * single-precision value exactly. Out of range values and NaNs are
+ * invalid and the result saturates (NaNs convert to the largest
+ * integer).
+ *
+ */
+static uint32_t to_int(rv_cpu_t *cpu, double val, rv_rm_t rm, bool is_signed)
+{
+    if (isnan(val)) {
+        accrue(cpu, rv_fflags_nv);
+        return is_signed ? INT32_MAX : UINT32_MAX;
+    }
+
+    double rounded;
+
+    switch (rm) {
+    case rv_rmRTZ:
+        rounded = trunc(val);
+        break;
+    case rv_rmRDN:
+        rounded = floor(val);
+        break;
+    case rv_rmRUP:
+        rounded = ceil(val);
+        break;
+    case rv_rmRMM:
+        rounded = round(val);
+        break;
+    default:
+        rounded = nearbyint(val);
+        break;
+    }
+
+    if (is_signed) {
+        if (rounded < (double) INT32_MIN) {
+            accrue(cpu, rv_fflags_nv);
+            return (uint32_t) INT32_MIN;
+        }
+
+        if (rounded > (double) INT32_MAX) {
+            accrue(cpu, rv_fflags_nv);
+            return INT32_MAX;
+        }
+    } else {
+        if (rounded < 0) {
+            accrue(cpu, rv_fflags_nv);
+            return 0;
+        }
+
+        if (rounded > (double) UINT32_MAX) {
+            accrue(cpu, rv_fflags_nv);
+            return UINT32_MAX;
+        }
+    }
+
+    if (rounded != val) {
+        accrue(cpu, rv_fflags_nx);
+    }
+
+    return is_signed ? (uint32_t) (int32_t) rounded : (uint32_t) rounded;
+}
+
+static rv_exc_t fcvt_w(rv_cpu_t *cpu, rv_instr_t instr, double val, bool is_signed)
+{
+    rv_rm_t rm;
+
+    if (!get_rm(cpu, instr, &rm)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    cpu->regs[instr.r.rd] = to_int(cpu, val, rm, is_signed);
+    return rv_exc_none;
+}
+
+/*****************************
+ * Conversions from integers *
+ *****************************/
+
+static rv_exc_t fcvt_s_w(rv_cpu_t *cpu, rv_instr_t instr, bool is_signed)
+{
+    rv_rm_t rm;
+
+    if ((fp_off(cpu)) || (!get_rm(cpu, instr, &rm))) {
+        return rv_exc_illegal_instruction;
+    }
+
+    volatile uint32_t val = cpu->regs[instr.r.rs1];
+    volatile float res;
+
+    host_begin(rm);
+
+    if (is_signed) {
+        res = (float) (int32_t) val;
+    } else {
+        res = (float) val;
+    }
+
+    accrue(cpu, host_end(rm));
+    set_s(cpu, instr.r.rd, s_bits(res));
+    return rv_exc_none;
+}
+
+static rv_exc_t fcvt_d_w(rv_cpu_t *cpu, rv_instr_t instr, bool is_signed)
+{
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    /* Exact, the rounding mode is ignored */
+    uint32_t val = cpu->regs[instr.r.rs1];
+    double res = is_signed ? (double) (int32_t) val : (double) val;
+
+    set_d(cpu, instr.r.rd, d_bits(res));
+    return rv_exc_none;
+}
+
+/********************
+ * Loads and stores *
+ ********************/
+
+rv_exc_t rv_flw_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.i.opcode == rv_opcLOAD_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t virt = cpu->regs[instr.i.rs1] + (int32_t) instr.i.imm;
+
+    if ((!IS_ALIGNED(virt, 4)) && (!cpu->misaligned_access)) {
+        cpu->csr.tval_next = virt;
+        return rv_exc_load_address_misaligned;
+    }
+
+    uint32_t val;
+
+    rv_exc_t ex = rv_read_mem32(cpu, virt, &val, false, true);
+
+    if (ex != rv_exc_none) {
+        return ex;
+    }
+
+    set_s(cpu, instr.i.rd, val);
+
+    return rv_exc_none;
+}
+
+rv_exc_t rv_fld_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.i.opcode == rv_opcLOAD_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t virt = cpu->regs[instr.i.rs1] + (int32_t) instr.i.imm;
+
+    if ((!IS_ALIGNED(virt, 8)) && (!cpu->misaligned_access)) {
+        cpu->csr.tval_next = virt;
+        return rv_exc_load_address_misaligned;
+    }
+
+    // Performed as two 32-bit reads, the register is written
+    // only when both succeed
+    uint32_t lo;
+    uint32_t hi;
+
+    rv_exc_t ex = rv_read_mem32(cpu, virt, &lo, false, true);
+
+    if (ex == rv_exc_none) {
+        ex = rv_read_mem32(cpu, virt + 4, &hi, false, true);
+    }
+
+    if (ex != rv_exc_none) {
+        return ex;
+    }
+
+    set_d(cpu, instr.i.rd, ((uint64_t) hi << 32) | lo);
+
+    return rv_exc_none;
+}
+
+rv_exc_t rv_fsw_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.s.opcode == rv_opcSTORE_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t virt = cpu->regs[instr.s.rs1] + RV_S_IMM(instr);
+
+    // The lower bits are stored regardless of the NaN-boxing
+    return rv_write_mem32(cpu, virt, (uint32_t) cpu->fregs[instr.s.rs2], true);
+}
+
+rv_exc_t rv_fsd_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.s.opcode == rv_opcSTORE_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t virt = cpu->regs[instr.s.rs1] + RV_S_IMM(instr);
+
+    if ((!IS_ALIGNED(virt, 8)) && (!cpu->misaligned_access)) {
+        cpu->csr.tval_next = virt;
+        return rv_exc_store_amo_address_misaligned;
+    }
+
+    // A misaligned store may cross a page between the two words, both
+    // pages are translated first so that the store faults as a whole
+    uint32_t second = ALIGN_DOWN(virt + 7, FRAME_SIZE);
+
+    if (second > virt) {
+        ptr36_t phys;
+        rv_exc_t ex = rv_convert_addr(cpu, virt, &phys, true, false, true);
+
+        if (ex != rv_exc_none) {
+            cpu->csr.tval_next = virt;
+            return ex;
+        }
+
+        ex = rv_convert_addr(cpu, second, &phys, true, false, true);
+
+        if (ex != rv_exc_none) {
+            cpu->csr.tval_next = second;
+            return ex;
+        }
+    }
+
+    uint64_t val = cpu->fregs[instr.s.rs2];
+
+    rv_exc_t ex = rv_write_mem32(cpu, virt, (uint32_t) val, true);
+
+    if (ex != rv_exc_none) {
+        return ex;
+    }
+
+    return rv_write_mem32(cpu, virt + 4, (uint32_t) (val >> 32), true);
+}
+
+/***************
+ * F extension *
+ ***************/
+
+rv_exc_t rv_fmadd_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcMADD);
+
+    return arith_s(cpu, instr, fp_op_madd);
+}
+
+rv_exc_t rv_fmsub_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcMSUB);
+
+    return arith_s(cpu, instr, fp_op_msub);
+}
+
+rv_exc_t rv_fnmsub_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcNMSUB);
+
+    return arith_s(cpu, instr, fp_op_nmsub);
+}
+
+rv_exc_t rv_fnmadd_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcNMADD);
+
+    return arith_s(cpu, instr, fp_op_nmadd);
+}
+
+rv_exc_t rv_fadd_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_s(cpu, instr, fp_op_add);
+}
+
+rv_exc_t rv_fsub_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_s(cpu, instr, fp_op_sub);
+}
+
+rv_exc_t rv_fmul_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_s(cpu, instr, fp_op_mul);
+}
+
+rv_exc_t rv_fdiv_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_s(cpu, instr, fp_op_div);
+}
+
+rv_exc_t rv_fsqrt_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_s(cpu, instr, fp_op_sqrt);
+}
+
+rv_exc_t rv_fsgnj_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return sgnj_s(cpu, instr, fp_sgnj);
+}
+
+rv_exc_t rv_fsgnjn_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return sgnj_s(cpu, instr, fp_sgnjn);
+}
+
+rv_exc_t rv_fsgnjx_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return sgnj_s(cpu, instr, fp_sgnjx);
+}
+
+rv_exc_t rv_fmin_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return min_max_s(cpu, instr, false);
+}
+
+rv_exc_t rv_fmax_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return min_max_s(cpu, instr, true);
+}
+
+rv_exc_t rv_fcvt_w_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    return fcvt_w(cpu, instr, s_float(get_s(cpu, instr.r.rs1)), true);
+}
+
+rv_exc_t rv_fcvt_wu_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    return fcvt_w(cpu, instr, s_float(get_s(cpu, instr.r.rs1)), false);
+}
+
+rv_exc_t rv_fcvt_s_w_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return fcvt_s_w(cpu, instr, true);
+}
+
+rv_exc_t rv_fcvt_s_wu_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return fcvt_s_w(cpu, instr, false);
+}
+
+rv_exc_t rv_fmv_x_w_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    // The bits are moved as they are, regardless of the NaN-boxing
+    cpu->regs[instr.r.rd] = (uint32_t) cpu->fregs[instr.r.rs1];
+    return rv_exc_none;
+}
+
+rv_exc_t rv_fmv_w_x_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    set_s(cpu, instr.r.rd, cpu->regs[instr.r.rs1]);
+    return rv_exc_none;
+}
+
+rv_exc_t rv_feq_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return compare_s(cpu, instr, fp_cmp_eq);
+}
+
+rv_exc_t rv_flt_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return compare_s(cpu, instr, fp_cmp_lt);
+}
+
+rv_exc_t rv_fle_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return compare_s(cpu, instr, fp_cmp_le);
+}
+
+rv_exc_t rv_fclass_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint32_t val = get_s(cpu, instr.r.rs1);
+
+    cpu->regs[instr.r.rd] = classify((val & S_SIGN) != 0,
+            (val & S_EXP) == 0, (val & S_EXP) == S_EXP,
+            (val & ~(S_SIGN | S_EXP)) == 0, (val & S_QUIET) != 0);
+    return rv_exc_none;
+}
+
+/***************
+ * D extension *
+ ***************/
+
+rv_exc_t rv_fmadd_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcMADD);
+
+    return arith_d(cpu, instr, fp_op_madd);
+}
+
+rv_exc_t rv_fmsub_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcMSUB);
+
+    return arith_d(cpu, instr, fp_op_msub);
+}
+
+rv_exc_t rv_fnmsub_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcNMSUB);
+
+    return arith_d(cpu, instr, fp_op_nmsub);
+}
+
+rv_exc_t rv_fnmadd_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcNMADD);
+
+    return arith_d(cpu, instr, fp_op_nmadd);
+}
+
+rv_exc_t rv_fadd_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_d(cpu, instr, fp_op_add);
+}
+
+rv_exc_t rv_fsub_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_d(cpu, instr, fp_op_sub);
+}
+
+rv_exc_t rv_fmul_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_d(cpu, instr, fp_op_mul);
+}
+
+rv_exc_t rv_fdiv_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_d(cpu, instr, fp_op_div);
+}
+
+rv_exc_t rv_fsqrt_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return arith_d(cpu, instr, fp_op_sqrt);
+}
+
+rv_exc_t rv_fsgnj_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return sgnj_d(cpu, instr, fp_sgnj);
+}
+
+rv_exc_t rv_fsgnjn_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return sgnj_d(cpu, instr, fp_sgnjn);
+}
+
+rv_exc_t rv_fsgnjx_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return sgnj_d(cpu, instr, fp_sgnjx);
+}
+
+rv_exc_t rv_fmin_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return min_max_d(cpu, instr, false);
+}
+
+rv_exc_t rv_fmax_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return min_max_d(cpu, instr, true);
+}
+
+rv_exc_t rv_fcvt_w_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    return fcvt_w(cpu, instr, d_float(get_d(cpu, instr.r.rs1)), true);
+}
+
+rv_exc_t rv_fcvt_wu_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    return fcvt_w(cpu, instr, d_float(get_d(cpu, instr.r.rs1)), false);
+}
+
+rv_exc_t rv_fcvt_d_w_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return fcvt_d_w(cpu, instr, true);
+}
+
+rv_exc_t rv_fcvt_d_wu_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return fcvt_d_w(cpu, instr, false);
+}
+
+rv_exc_t rv_fcvt_s_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    rv_rm_t rm;
+
+    if ((fp_off(cpu)) || (!get_rm(cpu, instr, &rm))) {
+        return rv_exc_illegal_instruction;
+    }
+
+    volatile double val = d_float(get_d(cpu, instr.r.rs1));
+    volatile float res;
+
+    host_begin(rm);
+    res = (float) val;
+    uint32_t flags = host_end(rm);
+
+    uint32_t bits = s_bits(res);
+    if (s_is_nan(bits)) {
+        bits = S_CANONICAL_NAN;
+    }
+
+    accrue(cpu, flags);
+    set_s(cpu, instr.r.rd, bits);
+    return rv_exc_none;
+}
+
+rv_exc_t rv_fcvt_d_s_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    /* Exact, only a signaling NaN is invalid */
+    uint32_t val = get_s(cpu, instr.r.rs1);
+    uint64_t bits;
+
+    if (s_is_nan(val)) {
+        if (s_is_snan(val)) {
+            accrue(cpu, rv_fflags_nv);
+        }
+
+        bits = D_CANONICAL_NAN;
+    } else {
+        bits = d_bits((double) s_float(val));
+    }
+
+    set_d(cpu, instr.r.rd, bits);
+    return rv_exc_none;
+}
+
+rv_exc_t rv_feq_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return compare_d(cpu, instr, fp_cmp_eq);
+}
+
+rv_exc_t rv_flt_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return compare_d(cpu, instr, fp_cmp_lt);
+}
+
+rv_exc_t rv_fle_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    return compare_d(cpu, instr, fp_cmp_le);
+}
+
+rv_exc_t rv_fclass_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.r.opcode == rv_opcOP_FP);
+
+    if (fp_off(cpu)) {
+        return rv_exc_illegal_instruction;
+    }
+
+    uint64_t val = get_d(cpu, instr.r.rs1);
+
+    cpu->regs[instr.r.rd] = classify((val & D_SIGN) != 0,
+            (val & D_EXP) == 0, (val & D_EXP) == D_EXP,
+            (val & ~(D_SIGN | D_EXP)) == 0, (val & D_QUIET) != 0);
+    return rv_exc_none;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ * RISC-V floating-point instructions (F and D extensions)
+ *
+ */
+
+#ifndef RISCV_RV32IMA_INSTR_FP_OPS_H_
+#define RISCV_RV32IMA_INSTR_FP_OPS_H_
+
+#include "../cpu.h"
+#include "../instr.h"
+
+/* Loads and stores */
+
+extern rv_exc_t rv_flw_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fld_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsw_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsd_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+/* F extension */
+
+extern rv_exc_t rv_fmadd_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmsub_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fnmsub_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fnmadd_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+extern rv_exc_t rv_fadd_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsub_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmul_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fdiv_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsqrt_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+extern rv_exc_t rv_fsgnj_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsgnjn_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsgnjx_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmin_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmax_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+extern rv_exc_t rv_fcvt_w_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fcvt_wu_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fcvt_s_w_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fcvt_s_wu_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmv_x_w_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmv_w_x_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+extern rv_exc_t rv_feq_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_flt_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fle_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fclass_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+/* D extension */
+
+extern rv_exc_t rv_fmadd_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmsub_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fnmsub_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fnmadd_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+extern rv_exc_t rv_fadd_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsub_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmul_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fdiv_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsqrt_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+extern rv_exc_t rv_fsgnj_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsgnjn_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fsgnjx_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmin_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fmax_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+extern rv_exc_t rv_fcvt_w_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fcvt_wu_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fcvt_d_w_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fcvt_d_wu_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fcvt_s_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fcvt_d_s_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+extern rv_exc_t rv_feq_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_flt_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fle_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_fclass_d_instr(rv_cpu_t *cpu, rv_instr_t instr);
+
+#endif // RISCV_RV32IMA_INSTR_FP_OPS_H_
@@ -66,7 +66,7 @@ rv_exc_t rv_lw_instr(rv_cpu_t *cpu, rv_instr_t instr)
 
     uint32_t virt = cpu->regs[instr.i.rs1] + (int32_t) instr.i.imm;
 
-    if (!IS_ALIGNED(virt, 4)) {
+    if ((!IS_ALIGNED(virt, 4)) && (!cpu->misaligned_access)) {
         cpu->csr.tval_next = virt;
         return rv_exc_load_address_misaligned;
     }
@@ -111,7 +111,7 @@ rv_exc_t rv_lhu_instr(rv_cpu_t *cpu, rv_instr_t instr)
 
     uint32_t virt = cpu->regs[instr.i.rs1] + (int32_t) instr.i.imm;
 
-    if (!IS_ALIGNED(virt, 2)) {
+    if ((!IS_ALIGNED(virt, 2)) && (!cpu->misaligned_access)) {
         cpu->csr.tval_next = virt;
         return rv_exc_load_address_misaligned;
     }
@@ -176,6 +176,15 @@ rv_exc_t rv_lr_instr(rv_cpu_t *cpu, rv_instr_t instr)
 
     uint32_t virt = cpu->regs[instr.r.rs1];
 
+    // Reservations of misaligned addresses are not supported,
+    // even if the misaligned loads are performed by the hardware
+    if (!IS_ALIGNED(virt, 4)) {
+        sc_unregister(cpu->csr.mhartid);
+        cpu->reserved_valid = false;
+        cpu->csr.tval_next = virt;
+        return rv_exc_load_address_misaligned;
+    }
+
     uint32_t val;
     rv_exc_t ex = rv_read_mem32(cpu, virt, &val, false, true);
 
@@ -186,15 +195,6 @@ rv_exc_t rv_lr_instr(rv_cpu_t *cpu, rv_instr_t instr)
         return ex;
     }
 
-    // The missalignment should be caught in rv_read_mem32
-    // Bit if we would choose to allow missaligned accesses in the future,
-    // this would break, so this is here just for safety
-    if (!IS_ALIGNED(virt, 4)) {
-        sc_unregister(cpu->csr.mhartid);
-        cpu->reserved_valid = false;
-        return rv_exc_load_address_misaligned;
-    }
-
     // store the read value
     cpu->regs[instr.r.rd] = val;
 
@@ -242,6 +242,7 @@ rv_exc_t rv_sc_instr(rv_cpu_t *cpu, rv_instr_t instr)
 
     if (!IS_ALIGNED(virt, 4)) {
         cpu->regs[instr.r.rd] = 1;
+        cpu->csr.tval_next = virt;
         return rv_exc_store_amo_address_misaligned;
     }
 
@@ -12,6 +12,7 @@
 #include <stdint.h>
 
 #include "../../../../assert.h"
+#include "../../../../debug/roi.h"
 #include "../../../../input.h"
 #include "../../../../main.h"
 #include "../csr.h"
@@ -88,6 +89,24 @@ extern rv_exc_t rv_csr_rd_instr(rv_cpu_t *cpu, rv_instr_t instr)
     return rv_exc_none;
 }
 
+extern rv_exc_t rv_roi_begin_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.i.opcode == rv_opcSYSTEM);
+    alert("EROIB: Region of interest begin");
+    roi_begin(cpu->csr.mhartid);
+    return rv_exc_none;
+}
+
+extern rv_exc_t rv_roi_end_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.i.opcode == rv_opcSYSTEM);
+    alert("EROIE: Region of interest end");
+    roi_end(cpu->csr.mhartid);
+    return rv_exc_none;
+}
+
 rv_exc_t rv_call_instr(rv_cpu_t *cpu, rv_instr_t instr)
 {
     switch (cpu->priv_mode) {
@@ -21,6 +21,8 @@ extern rv_exc_t rv_dump_instr(rv_cpu_t *cpu, rv_instr_t instr);
 extern rv_exc_t rv_trace_set_instr(rv_cpu_t *cpu, rv_instr_t instr);
 extern rv_exc_t rv_trace_reset_instr(rv_cpu_t *cpu, rv_instr_t instr);
 extern rv_exc_t rv_csr_rd_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_roi_begin_instr(rv_cpu_t *cpu, rv_instr_t instr);
+extern rv_exc_t rv_roi_end_instr(rv_cpu_t *cpu, rv_instr_t instr);
 
 extern rv_exc_t rv_call_instr(rv_cpu_t *cpu, rv_instr_t instr);
 
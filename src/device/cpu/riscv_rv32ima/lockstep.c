@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V lock-step differential execution
+ *
+ * A hart in the lock-step mode is accompanied by a shadow copy which
+ * is executed by a second execution engine. After every instruction
+ * of the reference hart the shadow executes the same instruction and
+ * the architectural states of both are compared. The first mismatch
+ * is reported together with the last few executed instructions and
+ * the simulation enters the interactive mode.
+ *
+ * The shadow is executed either by the interpreter of the hart (which
+ * checks that the execution is repeatable) or by the RV32 build of the
+ * generic core. The state of the generic core is mapped to the shadow
+ * copy after every instruction, so both engines are compared the same
+ * way. The generic core implements neither the F, D and C extensions
+ * nor the misaligned accesses, using them is reported as a mismatch.
+ *
+ * Both engines share the physical memory. The loads of the shadow read
+ * the memory, but its stores are not performed: each of them is compared
+ * with the memory content written by the same store of the reference,
+ * a store of a different value or to a different address is reported
+ * as a mismatch. Instructions with side effects (atomics, accesses to
+ * device registers and MSIM-specific instructions) are executed by the
+ * reference engine only and the shadow is then synchronized with the
+ * reference.
+ *
+ * The TLB of the shadow is flushed on every synchronization, so a guest
+ * which changes a mapping without SFENCE.VMA may see the mismatch of the
+ * stale translation of the reference reported.
+ *
+ * The shadow sees the same interrupts as the reference. The host time
+ * which drives mtime is read by both engines separately, so a guest
+ * depending on the timer should be run with --replay to avoid
+ * spurious mismatches.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../../assert.h"
+#include "../../../debug/sample.h"
+#include "../../../fault.h"
+#include "../../../main.h"
+#include "../../../physmem.h"
+#include "../../../utils.h"
+#include "../general_cpu.h"
+#include "../riscv_rv_ima/rv_ima.h"
+#include "cpu.h"
+#include "debug.h"
+#include "instr.h"
+#include "lockstep.h"
+#include "tlb.h"
+
+/** Number of instructions kept for the mismatch report */
+#define LOCKSTEP_TRACE_LENGTH 8
+
+typedef struct {
+    uint32_t pc;
+    rv_instr_t instr;
+} trace_entry_t;
+
+typedef struct {
+    /** Shadow copy of the hart */
+    rv_cpu_t shadow;
+    rv_lockstep_engine_t engine;
+
+    /** Cost model state of the shadow (if the model is enabled) */
+    cost_model_t shadow_cost;
+
+    /** Shadow hart of the generic core (the generic engine only) */
+    struct rv32_cpu *generic;
+
+    /** Last executed instructions (circular buffer) */
+    trace_entry_t trace[LOCKSTEP_TRACE_LENGTH];
+    unsigned int trace_next;
+
+    /** The reference has not executed any instruction yet */
+    bool fresh;
+
+    /** Stores of the shadow compared with the memory */
+    physmem_store_check_t stores;
+
+    /** Statistics */
+    uint64_t checked;
+    uint64_t synced;
+    uint64_t mismatches;
+} rv_lockstep_t;
+
+/** Number of harts running in the lock-step mode */
+unsigned int rv_lockstep_count = 0;
+
+static rv_lockstep_t *lockstep[MAX_CPUS];
+
+static rv_lockstep_t *get_lockstep(rv_cpu_t *cpu)
+{
+    ASSERT(cpu->csr.mhartid < MAX_CPUS);
+    return lockstep[cpu->csr.mhartid];
+}
+
+/** Copy the reference state to the shadow
+ *
+ * The TLB is just a cache of the page tables, the shadow keeps its own.
+ * The shadow also stalls on its own copy of the cost model state.
+ *
+ */
+static void lockstep_sync(rv_lockstep_t *ls, rv_cpu_t *cpu)
+{
+    rv_tlb_t tlb = ls->shadow.tlb;
+    memcpy(&ls->shadow, cpu, sizeof(rv_cpu_t));
+    ls->shadow.tlb = tlb;
+
+    if (cpu->cost.model != NULL) {
+        ls->shadow_cost = *cpu->cost.model;
+        ls->shadow.cost.model = &ls->shadow_cost;
+    }
+
+    rv_tlb_flush(&ls->shadow.tlb);
+
+    if (ls->generic != NULL) {
+        rv32_tlb_flush(ls->generic);
+    }
+}
+
+#define EXPORT_ARRAY(type, name, count) \
+    memcpy(state->csr.name, cpu->csr.name, sizeof(state->csr.name));
+#define EXPORT_SCALAR(type, name) \
+    state->csr.name = cpu->csr.name;
+#define IMPORT_ARRAY(type, name, count) \
+    memcpy(cpu->csr.name, state->csr.name, sizeof(cpu->csr.name));
+#define IMPORT_SCALAR(type, name) \
+    cpu->csr.name = state->csr.name;
+
+/** Map the shadow copy to the state of the generic core */
+static void export_state(rv_cpu_t *cpu, rv32_state_t *state)
+{
+    memcpy(state->regs, cpu->regs, sizeof(state->regs));
+    state->pc = cpu->pc;
+    state->priv_mode = cpu->priv_mode;
+    state->reserved_valid = cpu->reserved_valid;
+    state->reserved_addr = cpu->reserved_addr;
+    state->stdby = cpu->stdby;
+
+    RV32_STATE_CSRS(EXPORT_ARRAY, EXPORT_SCALAR)
+}
+
+/** Map the state of the generic core to the shadow copy
+ *
+ * The floating-point state is not touched, the generic core
+ * does not implement it.
+ *
+ */
+static void import_state(rv_cpu_t *cpu, const rv32_state_t *state)
+{
+    memcpy(cpu->regs, state->regs, sizeof(cpu->regs));
+    cpu->pc = state->pc;
+    cpu->priv_mode = (rv_priv_mode_t) state->priv_mode;
+    cpu->reserved_valid = state->reserved_valid;
+    cpu->reserved_addr = state->reserved_addr;
+    cpu->stdby = state->stdby;
+
+    RV32_STATE_CSRS(IMPORT_ARRAY, IMPORT_SCALAR)
+}
+
+#undef EXPORT_ARRAY
+#undef EXPORT_SCALAR
+#undef IMPORT_ARRAY
+#undef IMPORT_SCALAR
+
+/** Execute one instruction of the shadow by the generic core */
+static void generic_step(rv_lockstep_t *ls, rv_cpu_t *cpu)
+{
+    rv32_state_t state;
+
+    export_state(&ls->shadow, &state);
+    rv32_cpu_set_state(ls->generic, &state);
+    rv32_cpu_step(ls->generic);
+    rv32_cpu_get_state(ls->generic, &state);
+    import_state(&ls->shadow, &state);
+
+    /* The address of the next instruction is not architectural */
+    ls->shadow.pc_next = cpu->pc_next;
+}
+
+/** Start the lock-step mode of the hart
+ *
+ * @param cpu    Reference hart.
+ * @param engine Execution engine of the shadow.
+ *
+ */
+void rv_lockstep_enable(rv_cpu_t *cpu, rv_lockstep_engine_t engine)
+{
+    ASSERT(cpu != NULL);
+
+    rv_lockstep_t *ls = get_lockstep(cpu);
+    if (ls != NULL) {
+        if (ls->engine == engine) {
+            return;
+        }
+
+        rv_lockstep_disable(cpu);
+    }
+
+    ls = safe_malloc_t(rv_lockstep_t);
+    memset(ls, 0, sizeof(rv_lockstep_t));
+
+    rv_tlb_init(&ls->shadow.tlb, DEFAULT_RV_TLB_SIZE);
+    ls->engine = engine;
+
+    if (engine == RV_LOCKSTEP_GENERIC) {
+        ls->generic = rv32_cpu_create(cpu->csr.mhartid);
+    }
+
+    lockstep_sync(ls, cpu);
+    ls->fresh = true;
+
+    lockstep[cpu->csr.mhartid] = ls;
+    rv_lockstep_count++;
+}
+
+/** Stop the lock-step mode of the hart */
+void rv_lockstep_disable(rv_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    rv_lockstep_t *ls = get_lockstep(cpu);
+    if (ls == NULL) {
+        return;
+    }
+
+    if (ls->generic != NULL) {
+        rv32_cpu_destroy(ls->generic);
+    }
+
+    rv_tlb_done(&ls->shadow.tlb);
+    safe_free(ls);
+
+    lockstep[cpu->csr.mhartid] = NULL;
+    rv_lockstep_count--;
+}
+
+bool rv_lockstep_enabled(rv_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    return get_lockstep(cpu) != NULL;
+}
+
+/** Print the lock-step statistics of the hart */
+void rv_lockstep_info(rv_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    rv_lockstep_t *ls = get_lockstep(cpu);
+    if (ls == NULL) {
+        printf("Lock-step mode disabled\n");
+        return;
+    }
+
+    printf("Engine: %s\n",
+            (ls->engine == RV_LOCKSTEP_GENERIC) ? "generic" : "interp");
+    printf("Checked: %" PRIu64 " instructions, synchronized: %" PRIu64
+           ", mismatches: %" PRIu64 "\n",
+            ls->checked, ls->synced, ls->mismatches);
+}
+
+/** Check whether the instruction can be safely executed twice */
+static bool is_repeatable(rv_instr_t instr)
+{
+    if (RV_INSTR_IS_COMPRESSED(instr.val)) {
+        instr = rv_instr_expand((uint16_t) instr.val);
+    }
+
+    if (instr.r.opcode == rv_opcAMO) {
+        return false;
+    }
+
+    if ((instr.i.opcode == rv_opcSYSTEM) && (instr.i.funct3 == rv_funcPRIV)) {
+        uint32_t imm = RV_I_UNSIGNED_IMM(instr);
+
+        /* EBREAK and the MSIM-specific instructions */
+        if ((imm == rv_privEBREAK) || ((imm & 0xfc0) == (rv_privEHALT & 0xfc0))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** Execute the shadow without the instrumentation of the simulator */
+static void shadow_step(rv_lockstep_t *ls, rv_cpu_t *cpu)
+{
+    bool trace = machine_trace;
+    bool profile = machine_profile;
+    bool pc_armed = sample_pc_armed;
+
+    machine_trace = false;
+    machine_profile = false;
+    sample_pc_armed = false;
+    physmem_breakpoints_muted = true;
+
+    memset(&ls->stores, 0, sizeof(ls->stores));
+    physmem_store_check = &ls->stores;
+
+    if (ls->engine == RV_LOCKSTEP_GENERIC) {
+        generic_step(ls, cpu);
+    } else {
+        rv_cpu_step(&ls->shadow);
+    }
+
+    machine_trace = trace;
+    machine_profile = profile;
+    sample_pc_armed = pc_armed;
+    physmem_breakpoints_muted = false;
+    physmem_store_check = NULL;
+}
+
+static void report_mismatch(rv_lockstep_t *ls, rv_cpu_t *cpu,
+        cpu_state_t *ref, cpu_state_t *shadow)
+{
+    alert("Lock-step: cpu%u diverged after %" PRIu64 " instructions",
+            cpu->csr.mhartid, ls->checked);
+
+    printf("Last instructions:\n");
+    for (unsigned int i = 0; i < LOCKSTEP_TRACE_LENGTH; i++) {
+        trace_entry_t *entry = &ls->trace[(ls->trace_next + i) % LOCKSTEP_TRACE_LENGTH];
+        if (entry->instr.val != 0) {
+            rv_idump_phys(entry->pc, entry->instr);
+        }
+    }
+
+    physmem_store_check_t *stores = &ls->stores;
+
+    if ((stores->mismatches != 0) && (stores->device)) {
+        printf("store: %#" PRIx64 " (%u bytes) to the device at %#011" PRIx64 " (shadow)\n",
+                stores->value, stores->size, stores->addr);
+    } else if (stores->mismatches != 0) {
+        printf("store at %#011" PRIx64 ": %#" PRIx64 " (memory) vs. %#" PRIx64 " (shadow, %u bytes)\n",
+                stores->addr, stores->memory, stores->value, stores->size);
+    }
+
+    if (ref->pc != shadow->pc) {
+        printf("pc: %#010" PRIx64 " (reference) vs. %#010" PRIx64 " (shadow)\n",
+                ref->pc, shadow->pc);
+        return;
+    }
+
+    for (unsigned int i = 0; i < RV_REG_COUNT; i++) {
+        if (ref->regs[i] != shadow->regs[i]) {
+            printf("%s: %#010" PRIx64 " (reference) vs. %#010" PRIx64 " (shadow)\n",
+                    rv_regnames[i], ref->regs[i], shadow->regs[i]);
+        }
+    }
+
+    if (ref->hash != shadow->hash) {
+        printf("Other architectural state (CSRs, floating-point registers, privilege mode, etc.) differs\n");
+    }
+}
+
+/** Execute one step of the hart in the lock-step mode */
+void rv_lockstep_step(rv_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    rv_lockstep_t *ls = get_lockstep(cpu);
+    if (ls == NULL) {
+        rv_cpu_step(cpu);
+        return;
+    }
+
+    /*
+     * The cost model has been enabled or disabled meanwhile, or the
+     * configuration has changed the state after enabling the lock-step
+     * mode (e.g. the entry point set by the elf load command).
+     */
+    if ((ls->fresh)
+            || ((cpu->cost.model == NULL) != (ls->shadow.cost.model == NULL))) {
+        lockstep_sync(ls, cpu);
+        ls->fresh = false;
+    }
+
+    /* Inputs from the devices */
+    ls->shadow.csr.mip = cpu->csr.mip;
+    ls->shadow.csr.external_SEIP = cpu->csr.external_SEIP;
+    ls->shadow.csr.external_STIP = cpu->csr.external_STIP;
+
+    /* Instruction to be executed (for the trace) */
+    rv_instr_t instr = { .val = 0 };
+    bool fetched = cpu->stdby;
+    ptr36_t phys;
+
+    if ((!cpu->stdby)
+            && (rv_convert_addr(cpu, cpu->pc, &phys, false, true, false) == rv_exc_none)) {
+        instr.val = physmem_read16(cpu->csr.mhartid, phys, false);
+        fetched = true;
+
+        /* The second halfword might lie on another page */
+        if (!RV_INSTR_IS_COMPRESSED(instr.val)) {
+            fetched = (rv_convert_addr(cpu, cpu->pc + 2, &phys, false, true, false) == rv_exc_none);
+            if (fetched) {
+                instr.val |= (uint32_t) physmem_read16(cpu->csr.mhartid, phys, false) << 16;
+            }
+        }
+    }
+
+    ls->trace[ls->trace_next].pc = cpu->pc;
+    ls->trace[ls->trace_next].instr = instr;
+    ls->trace_next = (ls->trace_next + 1) % LOCKSTEP_TRACE_LENGTH;
+
+    uint64_t device_accesses = physmem_device_accesses;
+    rv_cpu_step(cpu);
+
+    /*
+     * Instructions with side effects and failed fetches
+     * (which are reported by the reference already).
+     */
+    if ((!fetched) || (!is_repeatable(instr))
+            || (physmem_device_accesses != device_accesses)) {
+        lockstep_sync(ls, cpu);
+        ls->synced++;
+        return;
+    }
+
+    shadow_step(ls, cpu);
+    ls->checked++;
+
+    /*
+     * The reservation of the shadow is not invalidated by stores
+     * since the shadow is not registered for the store-conditional
+     * control (LR/SC themselves are not repeated).
+     */
+    ls->shadow.reserved_valid = cpu->reserved_valid;
+
+    cpu_state_t ref;
+    cpu_state_t shadow;
+    rv_state(cpu, &ref);
+    rv_state(&ls->shadow, &shadow);
+
+    if ((memcmp(&ref, &shadow, sizeof(cpu_state_t)) != 0)
+            || (ls->stores.mismatches != 0)) {
+        ls->mismatches++;
+        report_mismatch(ls, cpu, &ref, &shadow);
+        machine_interactive = true;
+
+        /* Continue from the reference state */
+        lockstep_sync(ls, cpu);
+    }
+}
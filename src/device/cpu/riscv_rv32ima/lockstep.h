@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V lock-step differential execution
+ *
+ */
+
+#ifndef RISCV_RV32IMA_LOCKSTEP_H_
+#define RISCV_RV32IMA_LOCKSTEP_H_
+
+#include <stdbool.h>
+
+#include "cpu.h"
+
+/** Execution engines of the shadow hart */
+typedef enum {
+    RV_LOCKSTEP_INTERP, /**< The interpreter of the hart */
+    RV_LOCKSTEP_GENERIC /**< RV32 build of the generic core */
+} rv_lockstep_engine_t;
+
+/** Number of harts running in the lock-step mode */
+extern unsigned int rv_lockstep_count;
+
+extern void rv_lockstep_enable(rv_cpu_t *cpu, rv_lockstep_engine_t engine);
+extern void rv_lockstep_disable(rv_cpu_t *cpu);
+extern bool rv_lockstep_enabled(rv_cpu_t *cpu);
+extern void rv_lockstep_info(rv_cpu_t *cpu);
+
+extern void rv_lockstep_step(rv_cpu_t *cpu);
+
+#endif // RISCV_RV32IMA_LOCKSTEP_H_
@@ -19,134 +19,28 @@
 #include "instr.h"
 #include "instructions/computations.h"
 #include "instructions/control_transfer.h"
+#include "instructions/fp_ops.h"
 #include "instructions/mem_ops.h"
 #include "instructions/system.h"
 #include "mnemonics.h"
 
+/** Disassembly functions of the instructions in instr.def */
+static const rv_mnemonics_func_t mnemonics[rv_instr_count] = {
+#define RV_INSTR(name, func, mask, match, machine_specific) \
+    [rv_instr_##name] = rv_##name##_mnemonics,
+#include "instr.def"
+#undef RV_INSTR
+};
+
 extern rv_mnemonics_func_t rv_decode_mnemonics(rv_instr_t instr)
 {
-    // is this dirty?
-    rv_instr_func_t instr_func = rv_instr_decode(instr);
-
-    // very dirty indeed, but only one decode is needed
-
-#define IF_SAME_DECODE(expected_instr) \
-    if (instr_func == rv_##expected_instr##_instr) \
-    return rv_##expected_instr##_mnemonics
-
-    IF_SAME_DECODE(lui);
-    IF_SAME_DECODE(auipc);
-
-    IF_SAME_DECODE(jal);
-    IF_SAME_DECODE(jalr);
-    IF_SAME_DECODE(beq);
-    IF_SAME_DECODE(bne);
-    IF_SAME_DECODE(blt);
-    IF_SAME_DECODE(bge);
-    IF_SAME_DECODE(bltu);
-    IF_SAME_DECODE(bgeu);
-
-    IF_SAME_DECODE(lb);
-    IF_SAME_DECODE(lh);
-    IF_SAME_DECODE(lw);
-    IF_SAME_DECODE(lbu);
-    IF_SAME_DECODE(lhu);
-
-    IF_SAME_DECODE(sb);
-    IF_SAME_DECODE(sh);
-    IF_SAME_DECODE(sw);
-
-    IF_SAME_DECODE(addi);
-    IF_SAME_DECODE(slti);
-    IF_SAME_DECODE(sltiu);
-    IF_SAME_DECODE(xori);
-    IF_SAME_DECODE(ori);
-    IF_SAME_DECODE(andi);
-    IF_SAME_DECODE(slli);
-    IF_SAME_DECODE(srli);
-    IF_SAME_DECODE(srai);
-
-    IF_SAME_DECODE(add);
-    IF_SAME_DECODE(sub);
-    IF_SAME_DECODE(sll);
-    IF_SAME_DECODE(slt);
-    IF_SAME_DECODE(sltu);
-    IF_SAME_DECODE(xor);
-    IF_SAME_DECODE(or);
-    IF_SAME_DECODE(and);
-    IF_SAME_DECODE(srl);
-    IF_SAME_DECODE(sra);
-
-    IF_SAME_DECODE(fence);
-
-    // SYSTEM
-
-    if (instr_func == rv_break_instr) {
-        return rv_ebreak_mnemonics;
-    }
-
-    if (instr_func == rv_halt_instr) {
-        return rv_ehalt_mnemonics;
-    }
-
-    if (instr_func == rv_dump_instr) {
-        return rv_edump_mnemonics;
-    }
-
-    if (instr_func == rv_trace_set_instr) {
-        return rv_trace_set_mnemonics;
-    }
-
-    if (instr_func == rv_trace_reset_instr) {
-        return rv_trace_reset_mnemonics;
-    }
+    rv_instr_id_t id = rv_instr_identify(instr);
 
-    if (instr_func == rv_csr_rd_instr) {
-        return rv_csr_rd_mnemonics;
+    if (id == rv_instr_count) {
+        return undefined_mnemonics;
     }
 
-    if (instr_func == rv_call_instr) {
-        return rv_ecall_mnemonics;
-    }
-
-    IF_SAME_DECODE(sret);
-    IF_SAME_DECODE(mret);
-    IF_SAME_DECODE(wfi);
-    IF_SAME_DECODE(sfence);
-
-    IF_SAME_DECODE(csrrw);
-    IF_SAME_DECODE(csrrs);
-    IF_SAME_DECODE(csrrc);
-    IF_SAME_DECODE(csrrwi);
-    IF_SAME_DECODE(csrrsi);
-    IF_SAME_DECODE(csrrci);
-
-    // M-extension
-
-    IF_SAME_DECODE(mul);
-    IF_SAME_DECODE(mulh);
-    IF_SAME_DECODE(mulhsu);
-    IF_SAME_DECODE(mulhu);
-    IF_SAME_DECODE(div);
-    IF_SAME_DECODE(divu);
-    IF_SAME_DECODE(rem);
-    IF_SAME_DECODE(remu);
-
-    // A-extension
-
-    IF_SAME_DECODE(lr);
-    IF_SAME_DECODE(sc);
-    IF_SAME_DECODE(amoswap);
-    IF_SAME_DECODE(amoadd);
-    IF_SAME_DECODE(amoxor);
-    IF_SAME_DECODE(amoor);
-    IF_SAME_DECODE(amoand);
-    IF_SAME_DECODE(amomin);
-    IF_SAME_DECODE(amomax);
-    IF_SAME_DECODE(amominu);
-    IF_SAME_DECODE(amomaxu);
-
-    return undefined_mnemonics;
+    return mnemonics[id];
 }
 
 /***********
@@ -290,6 +184,71 @@ static void amo_instr_mnemonics(rv_instr_t instr, string_t *s_mnemonics)
     string_printf(s_mnemonics, " %s, %s, (%s)", rv_regnames[instr.r.rd], rv_regnames[instr.r.rs2], rv_regnames[instr.r.rs1]);
 }
 
+static const char *const rm_names[8] = {
+    [rv_rmRNE] = "rne",
+    [rv_rmRTZ] = "rtz",
+    [rv_rmRDN] = "rdn",
+    [rv_rmRUP] = "rup",
+    [rv_rmRMM] = "rmm",
+    [5] = "inv5",
+    [6] = "inv6",
+    [rv_rmDYN] = "dyn"
+};
+
+/** Print the rounding mode unless it is the dynamic one */
+static void fp_rm_mnemonics(rv_instr_t instr, string_t *s_mnemonics)
+{
+    if (instr.r.funct3 != rv_rmDYN) {
+        string_printf(s_mnemonics, ", %s", rm_names[instr.r.funct3]);
+    }
+}
+
+static void fp_load_instr_mnemonics(rv_instr_t instr, string_t *s_mnemonics)
+{
+    string_printf(s_mnemonics, " %s, ", rv_fregnames[instr.i.rd]);
+    dissasemble_target(instr.i.rs1, instr.i.imm, s_mnemonics);
+}
+
+static void fp_store_instr_mnemonics(rv_instr_t instr, string_t *s_mnemonics)
+{
+    string_printf(s_mnemonics, " %s, ", rv_fregnames[instr.s.rs2]);
+    dissasemble_target(instr.s.rs1, RV_S_IMM(instr), s_mnemonics);
+}
+
+static void fp_r4_instr_mnemonics(rv_instr_t instr, string_t *s_mnemonics)
+{
+    string_printf(s_mnemonics, " %s, %s, %s, %s",
+            rv_fregnames[instr.r.rd],
+            rv_fregnames[instr.r.rs1],
+            rv_fregnames[instr.r.rs2],
+            rv_fregnames[RV_R4_RS3(instr)]);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+
+/** Floating-point operands and result */
+static void fp_r_instr_mnemonics(rv_instr_t instr, string_t *s_mnemonics)
+{
+    string_printf(s_mnemonics, " %s, %s, %s",
+            rv_fregnames[instr.r.rd],
+            rv_fregnames[instr.r.rs1],
+            rv_fregnames[instr.r.rs2]);
+}
+
+/** Integer result of floating-point operands */
+static void fp_cmp_instr_mnemonics(rv_instr_t instr, string_t *s_mnemonics)
+{
+    string_printf(s_mnemonics, " %s, %s, %s",
+            rv_regnames[instr.r.rd],
+            rv_fregnames[instr.r.rs1],
+            rv_fregnames[instr.r.rs2]);
+}
+
+/** Unary operation, the register names select the register files */
+static void fp_unary_instr_mnemonics(rv_instr_t instr, string_t *s_mnemonics, char **rd_names, char **rs1_names)
+{
+    string_printf(s_mnemonics, " %s, %s", rd_names[instr.r.rd], rs1_names[instr.r.rs1]);
+}
+
 static void csr_reg_instr_mnemonics(rv_instr_t instr, string_t *s_mnemonics)
 {
     string_printf(s_mnemonics, " %s, %s, %s", rv_regnames[instr.i.rd], rv_csrnames[RV_I_UNSIGNED_IMM(instr)], rv_regnames[instr.i.rs1]);
@@ -587,6 +546,14 @@ void rv_csr_rd_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics,
 {
     string_printf(s_mnemonics, "ecsrd %s", rv_regnames[instr.i.rd]);
 }
+void rv_roi_begin_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "eroib");
+}
+void rv_roi_end_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "eroie");
+}
 
 extern void rv_sret_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
 {
@@ -783,6 +750,284 @@ extern void rv_amomaxu_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mn
     amo_instr_mnemonics(instr, s_mnemonics);
 }
 
+extern void rv_flw_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "flw");
+    fp_load_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fld_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fld");
+    fp_load_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsw_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsw");
+    fp_store_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsd_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsd");
+    fp_store_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmadd_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmadd.s");
+    fp_r4_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmsub_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmsub.s");
+    fp_r4_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fnmsub_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fnmsub.s");
+    fp_r4_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fnmadd_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fnmadd.s");
+    fp_r4_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fadd_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fadd.s");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsub_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsub.s");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmul_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmul.s");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fdiv_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fdiv.s");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsqrt_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsqrt.s");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_fregnames, rv_fregnames);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsgnj_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsgnj.s");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsgnjn_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsgnjn.s");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsgnjx_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsgnjx.s");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmin_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmin.s");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmax_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmax.s");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_feq_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "feq.s");
+    fp_cmp_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_flt_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "flt.s");
+    fp_cmp_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fle_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fle.s");
+    fp_cmp_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fclass_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fclass.s");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_regnames, rv_fregnames);
+}
+extern void rv_fcvt_w_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.w.s");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_regnames, rv_fregnames);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fcvt_wu_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.wu.s");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_regnames, rv_fregnames);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmadd_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmadd.d");
+    fp_r4_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmsub_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmsub.d");
+    fp_r4_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fnmsub_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fnmsub.d");
+    fp_r4_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fnmadd_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fnmadd.d");
+    fp_r4_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fadd_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fadd.d");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsub_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsub.d");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmul_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmul.d");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fdiv_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fdiv.d");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsqrt_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsqrt.d");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_fregnames, rv_fregnames);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsgnj_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsgnj.d");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsgnjn_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsgnjn.d");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fsgnjx_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fsgnjx.d");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmin_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmin.d");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fmax_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmax.d");
+    fp_r_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_feq_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "feq.d");
+    fp_cmp_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_flt_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "flt.d");
+    fp_cmp_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fle_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fle.d");
+    fp_cmp_instr_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fclass_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fclass.d");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_regnames, rv_fregnames);
+}
+extern void rv_fcvt_w_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.w.d");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_regnames, rv_fregnames);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fcvt_wu_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.wu.d");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_regnames, rv_fregnames);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fcvt_s_w_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.s.w");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_fregnames, rv_regnames);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fcvt_s_wu_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.s.wu");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_fregnames, rv_regnames);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fcvt_d_w_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.d.w");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_fregnames, rv_regnames);
+}
+extern void rv_fcvt_d_wu_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.d.wu");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_fregnames, rv_regnames);
+}
+extern void rv_fcvt_s_d_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.s.d");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_fregnames, rv_fregnames);
+    fp_rm_mnemonics(instr, s_mnemonics);
+}
+extern void rv_fcvt_d_s_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fcvt.d.s");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_fregnames, rv_fregnames);
+}
+extern void rv_fmv_x_w_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmv.x.w");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_regnames, rv_fregnames);
+}
+extern void rv_fmv_w_x_mnemonics(uint32_t addr, rv_instr_t instr, string_t *s_mnemonics, string_t *s_comments)
+{
+    string_printf(s_mnemonics, "fmv.w.x");
+    fp_unary_instr_mnemonics(instr, s_mnemonics, rv_fregnames, rv_regnames);
+}
+
 #define default_print_function(csr_name) \
     static void print_##csr_name(rv_cpu_t *cpu, string_t *mnemonics, string_t *comments) \
     { \
@@ -854,11 +1099,26 @@ static void print_hpm_event(rv_cpu_t *cpu, int hpm, string_t *mnemonics, string_
 
 #define bit_string(b) (b ? "1" : "0")
 
+static void print_fcsr(rv_cpu_t *cpu, string_t *mnemonics, string_t *comments)
+{
+    uint32_t fcsr = cpu->csr.fcsr;
+
+    string_printf(mnemonics, "%s 0x%08x", "fcsr", fcsr);
+
+    string_printf(comments, "frm %s, NV %s, DZ %s, OF %s, UF %s, NX %s",
+            rm_names[rv_csr_fcsr_frm(cpu)],
+            bit_string(fcsr & rv_fflags_nv),
+            bit_string(fcsr & rv_fflags_dz),
+            bit_string(fcsr & rv_fflags_of),
+            bit_string(fcsr & rv_fflags_uf),
+            bit_string(fcsr & rv_fflags_nx));
+}
+
 static void print_sstatus(rv_cpu_t *cpu, string_t *mnemonics, string_t *comments)
 {
     uint32_t sstatus = cpu->csr.mstatus & rv_csr_sstatus_mask;
 
-    bool sd = cpu->csr.mstatus & 0x80000000;
+    bool sd = rv_csr_sstatus_sd(cpu);
     bool mxr = rv_csr_sstatus_mxr(cpu);
     bool sum = rv_csr_sstatus_sum(cpu);
     int xs = (cpu->csr.mstatus & 0x18000) >> 15;
@@ -891,7 +1151,7 @@ static void print_mstatus(rv_cpu_t *cpu, string_t *mnemonics, string_t *comments
     bool mbe = (cpu->csr.mstatus >> 32) & rv_csr_mstatush_mbe_mask;
     bool sbe = (cpu->csr.mstatus >> 32) & rv_csr_mstatush_sbe_mask;
 
-    bool sd = cpu->csr.mstatus & 0x80000000;
+    bool sd = rv_csr_sstatus_sd(cpu);
     bool tsr = rv_csr_mstatus_tsr(cpu);
     bool tw = rv_csr_mstatus_tw(cpu);
     bool tvm = rv_csr_mstatus_tvm(cpu);
@@ -1254,7 +1514,11 @@ default_print_function(mvendorid)
         break;
 
     switch (csr) {
-    case csr_cycleh:
+    case csr_fflags:
+    case csr_frm:
+    default_case(fcsr)
+
+            case csr_cycleh:
     case csr_mcycle:
     case csr_mcycleh:
     default_case(cycle)
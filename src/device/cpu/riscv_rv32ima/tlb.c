@@ -1,6 +1,7 @@
 #include <string.h>
 
 #include "../../../assert.h"
+#include "../../../debug/memusage.h"
 #include "../../../utils.h"
 #include "tlb.h"
 
@@ -136,6 +137,16 @@ extern void rv_tlb_remove_mapping(rv_tlb_t *tlb, unsigned asid, uint32_t virt)
     }
 }
 
+// Invalidates the entry with the given index (modulo the TLB size)
+extern void rv_tlb_drop(rv_tlb_t *tlb, size_t index)
+{
+    rv_tlb_entry_t *entry = &tlb->entries[index % tlb->size];
+
+    if (is_entry_valid(tlb, entry)) {
+        invalidate_tlb_entry(tlb, entry);
+    }
+}
+
 /** TLB flushes */
 
 // Invalidates all entries
@@ -245,6 +256,11 @@ extern void rv_tlb_done(rv_tlb_t *tlb)
     safe_free(tlb->entries);
 }
 
+extern void rv_tlb_memusage(rv_tlb_t *tlb, memusage_t *usage)
+{
+    memusage_add(usage, MEMUSAGE_TLB, tlb->size * sizeof(rv_tlb_entry_t));
+}
+
 extern bool rv_tlb_resize(rv_tlb_t *tlb, size_t size)
 {
     safe_free(tlb->entries);
@@ -37,6 +37,7 @@ extern bool rv_tlb_get_mapping(rv_tlb_t *tlb, unsigned asid, uint32_t virt, sv32
 
 /** Removes the first mapping that matches the given address and is global or has the right ASID */
 extern void rv_tlb_remove_mapping(rv_tlb_t *tlb, unsigned asid, uint32_t virt);
+extern void rv_tlb_drop(rv_tlb_t *tlb, size_t index);
 
 /** TLB flushes */
 extern void rv_tlb_flush(rv_tlb_t *tlb);
@@ -56,4 +57,8 @@ extern bool rv_tlb_resize(rv_tlb_t *tlb, size_t size);
 
 extern void rv_tlb_dump(rv_tlb_t *tlb);
 
+/** Accounts the host memory of the TLB */
+struct memusage;
+extern void rv_tlb_memusage(rv_tlb_t *tlb, struct memusage *usage);
+
 #endif // RISCV_RV32IMA_TLB_H_
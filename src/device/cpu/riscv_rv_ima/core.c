@@ -0,0 +1,1294 @@
+/*
+ * Copyright (c) 2022 Jan Papesch
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V RV32IMA/RV64IMA processor core
+ *
+ * This file is not compiled on its own, it is included by rv32ima.c
+ * and rv64ima.c which define XLEN. The CSRs and the instructions are
+ * included as well, so the whole core is a single translation unit
+ * and the instructions can be inlined into the execution loop.
+ *
+ * Sv32 is used for the address translation in the RV32 build and
+ * Sv39 in the RV64 build.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../../assert.h"
+#include "../../../debug/memusage.h"
+#include "../../../debug/profile.h"
+#include "../../../debug/sample.h"
+#include "../../../fault.h"
+#include "../../../main.h"
+#include "../../../physmem.h"
+#include "../../../replay.h"
+#include "../../../utils.h"
+#include "cpu.h"
+#include "rv_ima.h"
+
+/*
+ * The instructions expect the following functions to be declared
+ * without a storage class, the static declarations here give them
+ * internal linkage, so the two builds of the core do not clash.
+ */
+static rv_exc_t rv_read_mem8(rv_cpu_t *cpu, virt_t virt, uint8_t *value, bool noisy);
+static rv_exc_t rv_read_mem16(rv_cpu_t *cpu, virt_t virt, uint16_t *value, bool fetch, bool noisy);
+static rv_exc_t rv_read_mem32(rv_cpu_t *cpu, virt_t virt, uint32_t *value, bool fetch, bool noisy);
+static rv_exc_t rv_read_mem64(rv_cpu_t *cpu, virt_t virt, uint64_t *value, bool fetch, bool noisy);
+static rv_exc_t rv_write_mem8(rv_cpu_t *cpu, virt_t virt, uint8_t value, bool noisy);
+static rv_exc_t rv_write_mem16(rv_cpu_t *cpu, virt_t virt, uint16_t value, bool noisy);
+static rv_exc_t rv_write_mem32(rv_cpu_t *cpu, virt_t virt, uint32_t value, bool noisy);
+static rv_exc_t rv_write_mem64(rv_cpu_t *cpu, virt_t virt, uint64_t value, bool noisy);
+static rv_exc_t rv_convert_addr(rv_cpu_t *cpu, virt_t virt, ptr36_t *phys, bool wr, bool fetch, bool noisy);
+static void rv_tlb_flush_by_asid(rv_cpu_t *cpu, unsigned int asid, bool global);
+static void rv_tlb_flush_by_addr(rv_cpu_t *cpu, unsigned int asid, virt_t virt, bool global);
+static void rv_reg_dump(rv_cpu_t *cpu);
+static void rv_interrupt_up(rv_cpu_t *cpu, unsigned int no);
+
+#include "csr.c"
+#include "instructions/computations.c"
+#include "instructions/control_transfer.c"
+#include "instructions/mem_ops.c"
+#include "instructions/system.c"
+#include "instr.c"
+
+/*
+ * Virtual memory
+ */
+
+#define RV_PAGE_WIDTH 12
+
+#if XLEN == 64
+/* Sv39 */
+#define RV_PT_LEVELS 3
+#define RV_PTE_SIZE 8
+#define RV_VPN_WIDTH 9
+#define RV_VIRT_WIDTH 39
+#define RV_PTE_PPN_MASK UINT64_C(0x003FFFFFFFFFFC00)
+#define RV_PTE_RESERVED_MASK UINT64_C(0xFFC0000000000000)
+#else
+/* Sv32 */
+#define RV_PT_LEVELS 2
+#define RV_PTE_SIZE 4
+#define RV_VPN_WIDTH 10
+#define RV_PTE_PPN_MASK UINT64_C(0xFFFFFC00)
+#define RV_PTE_RESERVED_MASK UINT64_C(0)
+#endif
+
+#define RV_PTE_V (1 << 0)
+#define RV_PTE_R (1 << 1)
+#define RV_PTE_W (1 << 2)
+#define RV_PTE_X (1 << 3)
+#define RV_PTE_U (1 << 4)
+#define RV_PTE_G (1 << 5)
+#define RV_PTE_A (1 << 6)
+#define RV_PTE_D (1 << 7)
+
+#define pte_ppn_phys(pte) ((ptr36_t) (((pte) & RV_PTE_PPN_MASK) >> 10) << RV_PAGE_WIDTH)
+#define pte_is_valid(pte) (((pte) & RV_PTE_V) && !(((pte) & RV_PTE_W) && !((pte) & RV_PTE_R)))
+#define pte_is_leaf(pte) ((pte) & (RV_PTE_R | RV_PTE_X))
+
+/** Size of the page mapped by a leaf PTE on the given level */
+#define level_page_size(level) (UINT64_C(1) << (RV_PAGE_WIDTH + (level) * RV_VPN_WIDTH))
+
+#define virt_vpn(virt, level) \
+    (((virt) >> (RV_PAGE_WIDTH + (level) * RV_VPN_WIDTH)) & ((1 << RV_VPN_WIDTH) - 1))
+
+#define page_fault_exception (fetch ? rv_exc_instruction_page_fault : (wr ? rv_exc_store_amo_page_fault : rv_exc_load_page_fault))
+
+static inline rv_priv_mode_t effective_priv(rv_cpu_t *cpu)
+{
+    return rv_csr_mstatus_mprv(cpu) ? rv_csr_mstatus_mpp(cpu) : cpu->priv_mode;
+}
+
+/**
+ * @brief Tests, whether a given memory access is allowed on the page specified by the pte
+ */
+static bool is_access_allowed(rv_cpu_t *cpu, uint64_t pte, bool wr, bool fetch)
+{
+    if (wr && !(pte & RV_PTE_W)) {
+        return false;
+    }
+
+    if (fetch && !(pte & RV_PTE_X)) {
+        return false;
+    }
+
+    // Page is executable and I can read from executable pages
+    bool rx = rv_csr_sstatus_mxr(cpu) && (pte & RV_PTE_X);
+
+    if (!wr && !fetch && !(pte & RV_PTE_R) && !rx) {
+        return false;
+    }
+
+    switch (effective_priv(cpu)) {
+    case rv_smode:
+        if ((pte & RV_PTE_U) && (fetch || !rv_csr_sstatus_sum(cpu))) {
+            return false;
+        }
+        break;
+    case rv_umode:
+        if (!(pte & RV_PTE_U)) {
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+static inline bool pte_access_dirty_update_needed(uint64_t pte, bool wr)
+{
+    return !(pte & RV_PTE_A) || (wr && !(pte & RV_PTE_D));
+}
+
+/**
+ * @brief Constructs the physical address from the virtual address and the leaf PTE on the given level
+ */
+static inline ptr36_t make_phys(virt_t virt, uint64_t pte, unsigned int level)
+{
+    uint64_t offset_mask = level_page_size(level) - 1;
+    return (pte_ppn_phys(pte) & ~offset_mask) | (virt & offset_mask);
+}
+
+#define tlb_set(virt) (((virt) >> RV_PAGE_WIDTH) & (RV_TLB_SETS - 1))
+
+/** @brief Finds the valid TLB entry of the accessed page for the current ASID */
+static inline rv_tlb_entry_t *tlb_lookup(rv_cpu_t *cpu, virt_t virt)
+{
+    unsigned int set = tlb_set(virt);
+    uint64_t vpn = virt >> RV_PAGE_WIDTH;
+    unsigned int asid = rv_csr_satp_asid(cpu);
+
+    for (unsigned int way = 0; way < RV_TLB_WAYS; way++) {
+        rv_tlb_entry_t *entry = &cpu->tlb[set][way];
+
+        if ((entry->valid) && (entry->vpn == vpn)
+                && ((entry->global) || (entry->asid == asid))) {
+            cpu->tlb_mru[set] = way;
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief Chooses the TLB entry to be replaced by a new translation */
+static rv_tlb_entry_t *tlb_victim(rv_cpu_t *cpu, virt_t virt)
+{
+    unsigned int set = tlb_set(virt);
+    uint64_t vpn = virt >> RV_PAGE_WIDTH;
+    unsigned int victim = (cpu->tlb_mru[set] + 1) % RV_TLB_WAYS;
+
+    for (unsigned int way = 0; way < RV_TLB_WAYS; way++) {
+        rv_tlb_entry_t *entry = &cpu->tlb[set][way];
+
+        // Stale translation of the same page
+        if ((entry->valid) && (entry->vpn == vpn)) {
+            victim = way;
+            break;
+        }
+
+        if (!entry->valid) {
+            victim = way;
+        }
+    }
+
+    cpu->tlb_mru[set] = victim;
+    return &cpu->tlb[set][victim];
+}
+
+static void rv_tlb_flush_by_asid(rv_cpu_t *cpu, unsigned int asid, bool global)
+{
+    for (unsigned int set = 0; set < RV_TLB_SETS; set++) {
+        for (unsigned int way = 0; way < RV_TLB_WAYS; way++) {
+            rv_tlb_entry_t *entry = &cpu->tlb[set][way];
+            if ((global) || ((entry->asid == asid) && (!entry->global))) {
+                entry->valid = false;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Removes the translations of the page containing the address
+ *
+ * The superpages are cached for every accessed 4 KiB page, so all
+ * entries are checked.
+ */
+static void rv_tlb_flush_by_addr(rv_cpu_t *cpu, unsigned int asid, virt_t virt, bool global)
+{
+    for (unsigned int set = 0; set < RV_TLB_SETS; set++) {
+        for (unsigned int way = 0; way < RV_TLB_WAYS; way++) {
+            rv_tlb_entry_t *entry = &cpu->tlb[set][way];
+            uint64_t page_mask = ~(level_page_size(entry->level) - 1);
+
+            bool match = ((entry->vpn << RV_PAGE_WIDTH) & page_mask) == (virt & page_mask);
+
+            if ((match) && ((global) || ((entry->asid == asid) && (!entry->global)))) {
+                entry->valid = false;
+            }
+        }
+    }
+}
+
+static uint64_t read_pte(rv_cpu_t *cpu, ptr36_t addr, bool noisy)
+{
+#if XLEN == 64
+    return physmem_read64(cpu->csr.mhartid, addr, noisy);
+#else
+    return physmem_read32(cpu->csr.mhartid, addr, noisy);
+#endif
+}
+
+static void write_pte(rv_cpu_t *cpu, ptr36_t addr, uint64_t pte)
+{
+#if XLEN == 64
+    physmem_write64(cpu->csr.mhartid, addr, pte, true);
+#else
+    physmem_write32(cpu->csr.mhartid, addr, (uint32_t) pte, true);
+#endif
+}
+
+/**
+ * @brief Translates the virtual address by walking the pagetable, sets the Accessed and Dirty bits and populates the TLB
+ */
+static rv_exc_t rv_pagewalk(rv_cpu_t *cpu, virt_t virt, ptr36_t *phys, bool wr, bool fetch, bool noisy)
+{
+    ptr36_t table = (ptr36_t) rv_csr_satp_ppn(cpu) << RV_PAGE_WIDTH;
+    bool global = false;
+
+    for (int level = RV_PT_LEVELS - 1; level >= 0; level--) {
+        // PMP or PMA check goes here if implemented
+        ptr36_t pte_addr = table + virt_vpn(virt, level) * RV_PTE_SIZE;
+        uint64_t pte = read_pte(cpu, pte_addr, noisy);
+
+        if ((!pte_is_valid(pte)) || ((pte & RV_PTE_RESERVED_MASK) != 0)) {
+            return page_fault_exception;
+        }
+
+        // Global non-leaf PTE implies that the translation is global
+        global |= (pte & RV_PTE_G) != 0;
+
+        if (!pte_is_leaf(pte)) {
+            table = pte_ppn_phys(pte);
+            continue;
+        }
+
+        // Misaligned superpage
+        if ((pte_ppn_phys(pte) & (level_page_size(level) - 1)) != 0) {
+            return page_fault_exception;
+        }
+
+        if (!is_access_allowed(cpu, pte, wr, fetch)) {
+            return page_fault_exception;
+        }
+
+        if (pte_access_dirty_update_needed(pte, wr)) {
+            pte |= RV_PTE_A | (wr ? RV_PTE_D : 0);
+
+            // The lock-step shadow leaves the page tables to the reference
+            if ((noisy) && (physmem_store_check == NULL)) {
+                write_pte(cpu, pte_addr, pte);
+            }
+        }
+
+        *phys = make_phys(virt, pte, level);
+
+        if (noisy) {
+            rv_tlb_entry_t *entry = tlb_victim(cpu, virt);
+            entry->vpn = virt >> RV_PAGE_WIDTH;
+            entry->pte = pte;
+            entry->level = level;
+            entry->asid = rv_csr_satp_asid(cpu);
+            entry->global = global;
+            entry->valid = true;
+        }
+
+        return rv_exc_none;
+    }
+
+    // Non-leaf PTE on the last level
+    return page_fault_exception;
+}
+
+/**
+ * @brief Converts the address from virtual memory space to physical memory space
+ *
+ * @param cpu The CPU, from the point of which, is the translation made
+ * @param virt The virtual address to be converted
+ * @param phys Pointer to where the physical address will be stored
+ * @param wr Is the conversion made for a write operation
+ * @param fetch Is the conversion made for an instruction fetch
+ * @param noisy Shall this function change the processor and global state
+ * @return rv_exc_t The exception code of this operation
+ */
+static rv_exc_t rv_convert_addr(rv_cpu_t *cpu, virt_t virt, ptr36_t *phys, bool wr, bool fetch, bool noisy)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(phys != NULL);
+    ASSERT(!(wr && fetch));
+
+    bool translate = (effective_priv(cpu) <= rv_smode) && (!rv_csr_satp_is_bare(cpu)) && !(cpu->priv_mode == rv_mmode && fetch);
+
+    if (!translate) {
+        *phys = virt;
+        return rv_exc_none;
+    }
+
+#if XLEN == 64
+    // The upper bits have to be copies of the most significant bit
+    if (((int64_t) (virt << (64 - RV_VIRT_WIDTH)) >> (64 - RV_VIRT_WIDTH)) != (int64_t) virt) {
+        return page_fault_exception;
+    }
+#endif
+
+    // First try the TLB
+    rv_tlb_entry_t *entry = tlb_lookup(cpu, virt);
+
+    if (entry != NULL) {
+        if (!is_access_allowed(cpu, entry->pte, wr, fetch)) {
+            return page_fault_exception;
+        }
+
+        // If the A and D bits of the PTE do not need to be updated, we can use the cached result
+        if (!pte_access_dirty_update_needed(entry->pte, wr)) {
+            *phys = make_phys(virt, entry->pte, entry->level);
+            return rv_exc_none;
+        }
+    }
+
+    // If the TLB lookup failed or if the AD bits need to be updated, perform the full pagewalk
+    return rv_pagewalk(cpu, virt, phys, wr, fetch, noisy);
+}
+
+#undef page_fault_exception
+
+/*
+ * Memory access
+ */
+
+static void handle_mtip(rv_cpu_t *cpu)
+{
+    if (cpu->csr.mtime >= cpu->csr.mtimecmp) {
+        // Set MTIP
+        cpu->csr.mip |= rv_csr_mti_mask;
+    } else {
+        // Clear MTIP
+        cpu->csr.mip &= ~rv_csr_mti_mask;
+    }
+}
+
+/** @brief Finds the memory mapped register located on the given address */
+static inline uint64_t *memory_mapped_reg(rv_cpu_t *cpu, virt_t virt, unsigned int width)
+{
+    if (!IS_ALIGNED(virt, width / 8)) {
+        return NULL;
+    }
+
+    if ((cpu->priv_mode < rv_mmode) || rv_csr_mstatus_mprv(cpu)) {
+        return NULL;
+    }
+
+    if (ALIGN_DOWN(virt, 8) == RV_MTIME_ADDRESS) {
+        return &cpu->csr.mtime;
+    }
+
+    if (ALIGN_DOWN(virt, 8) == RV_MTIMECMP_ADDRESS) {
+        return &cpu->csr.mtimecmp;
+    }
+
+    return NULL;
+}
+
+#define throw_ex(cpu, virt, ex, noisy) \
+    { \
+        if (noisy) { \
+            (cpu)->csr.tval_next = (virt); \
+        } \
+        return (ex); \
+    }
+
+/**
+ * @brief Reads from virtual memory
+ *
+ * @param cpu The cpu which makes the read
+ * @param virt The virtual address of the read target
+ * @param value The pointer where will the read value be stored on success
+ * @param width The width of the read in bits
+ * @param fetch If the read is instruction fetch or data read
+ * @param noisy Shall this operation change the global and cpu state
+ * @return rv_exc_t The exception code
+ */
+static ALWAYS_INLINE rv_exc_t read_mem(rv_cpu_t *cpu, virt_t virt, uint64_t *value, unsigned int width, bool fetch, bool noisy)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(value != NULL);
+
+    uint64_t *reg = memory_mapped_reg(cpu, virt, width);
+
+    if (reg != NULL) {
+        unsigned int offset = (virt & 0x7) * 8;
+        *value = (width == 64) ? *reg : EXTRACT_BITS(*reg, offset, offset + width);
+        return rv_exc_none;
+    }
+
+    ptr36_t phys;
+    rv_exc_t ex = rv_convert_addr(cpu, virt, &phys, false, fetch, noisy);
+
+    // Address translation exceptions have priority to alignment exceptions
+    if (ex != rv_exc_none) {
+        throw_ex(cpu, virt, ex, noisy);
+    }
+
+    if (!IS_ALIGNED(virt, width / 8)) {
+        throw_ex(cpu, virt, fetch ? rv_exc_instruction_address_misaligned : rv_exc_load_address_misaligned, noisy);
+    }
+
+    unsigned int procno = cpu->csr.mhartid;
+
+    switch (width) {
+    case 8:
+        *value = physmem_read8(procno, phys, true);
+        break;
+    case 16:
+        *value = physmem_read16(procno, phys, true);
+        break;
+    case 32:
+        *value = physmem_read32(procno, phys, true);
+        break;
+    default:
+        *value = physmem_read64(procno, phys, true);
+        break;
+    }
+
+    return rv_exc_none;
+}
+
+/**
+ * @brief Writes to virtual memory
+ *
+ * @param cpu The cpu which makes the write
+ * @param virt The virtual address
+ * @param value The value to be written
+ * @param width The width of the write in bits
+ * @param noisy Shall this operation change the global and cpu state
+ * @return rv_exc_t The exception code
+ */
+static ALWAYS_INLINE rv_exc_t write_mem(rv_cpu_t *cpu, virt_t virt, uint64_t value, unsigned int width, bool noisy)
+{
+    ASSERT(cpu != NULL);
+
+    uint64_t *reg = memory_mapped_reg(cpu, virt, width);
+
+    if (reg != NULL) {
+        unsigned int offset = (virt & 0x7) * 8;
+        *reg = (width == 64) ? value : WRITE_BITS(*reg, value, offset, offset + width);
+        handle_mtip(cpu);
+        return rv_exc_none;
+    }
+
+    ptr36_t phys;
+    rv_exc_t ex = rv_convert_addr(cpu, virt, &phys, true, false, noisy);
+
+    // Address translation exceptions have priority to alignment exceptions
+    if (ex != rv_exc_none) {
+        throw_ex(cpu, virt, ex, noisy);
+    }
+
+    if (!IS_ALIGNED(virt, width / 8)) {
+        throw_ex(cpu, virt, rv_exc_store_amo_address_misaligned, noisy);
+    }
+
+    unsigned int procno = cpu->csr.mhartid;
+
+    // Writes to invalid memory are ignored
+    switch (width) {
+    case 8:
+        physmem_write8(procno, phys, value, true);
+        break;
+    case 16:
+        physmem_write16(procno, phys, value, true);
+        break;
+    case 32:
+        physmem_write32(procno, phys, value, true);
+        break;
+    default:
+        physmem_write64(procno, phys, value, true);
+        break;
+    }
+
+    return rv_exc_none;
+}
+
+#undef throw_ex
+
+static rv_exc_t rv_read_mem8(rv_cpu_t *cpu, virt_t virt, uint8_t *value, bool noisy)
+{
+    uint64_t val = 0;
+    rv_exc_t ex = read_mem(cpu, virt, &val, 8, false, noisy);
+    *value = val;
+    return ex;
+}
+
+static rv_exc_t rv_read_mem16(rv_cpu_t *cpu, virt_t virt, uint16_t *value, bool fetch, bool noisy)
+{
+    uint64_t val = 0;
+    rv_exc_t ex = read_mem(cpu, virt, &val, 16, fetch, noisy);
+    *value = val;
+    return ex;
+}
+
+static rv_exc_t rv_read_mem32(rv_cpu_t *cpu, virt_t virt, uint32_t *value, bool fetch, bool noisy)
+{
+    uint64_t val = 0;
+    rv_exc_t ex = read_mem(cpu, virt, &val, 32, fetch, noisy);
+    *value = val;
+    return ex;
+}
+
+static rv_exc_t rv_read_mem64(rv_cpu_t *cpu, virt_t virt, uint64_t *value, bool fetch, bool noisy)
+{
+    return read_mem(cpu, virt, value, 64, fetch, noisy);
+}
+
+static rv_exc_t rv_write_mem8(rv_cpu_t *cpu, virt_t virt, uint8_t value, bool noisy)
+{
+    return write_mem(cpu, virt, value, 8, noisy);
+}
+
+static rv_exc_t rv_write_mem16(rv_cpu_t *cpu, virt_t virt, uint16_t value, bool noisy)
+{
+    return write_mem(cpu, virt, value, 16, noisy);
+}
+
+static rv_exc_t rv_write_mem32(rv_cpu_t *cpu, virt_t virt, uint32_t value, bool noisy)
+{
+    return write_mem(cpu, virt, value, 32, noisy);
+}
+
+static rv_exc_t rv_write_mem64(rv_cpu_t *cpu, virt_t virt, uint64_t value, bool noisy)
+{
+    return write_mem(cpu, virt, value, 64, noisy);
+}
+
+/*
+ * Decoding of instructions
+ *
+ * The decoding depends on the instruction word only, so the decoded
+ * instructions are cached by the instruction word rather than by the
+ * address. No invalidation is needed when the memory is rewritten.
+ */
+
+#define RV_DECODE_CACHE_SIZE 4096
+
+typedef struct {
+    uint32_t instr;
+    rv_instr_func_t func;
+} decode_cache_entry_t;
+
+static decode_cache_entry_t decode_cache[RV_DECODE_CACHE_SIZE];
+
+static ALWAYS_INLINE rv_instr_func_t decode_cached(rv_instr_t instr)
+{
+    decode_cache_entry_t *entry = &decode_cache[(instr.val * UINT32_C(0x9E3779B1)) >> 20];
+
+    if ((entry->instr != instr.val) || (entry->func == NULL)) {
+        entry->instr = instr.val;
+        entry->func = rv_instr_decode(instr);
+    }
+
+    return entry->func;
+}
+
+/*
+ * Debugging
+ */
+
+static void rv_idump(rv_cpu_t *cpu, uxlen_t addr, rv_instr_t instr)
+{
+    printf("cpu%-2u %#0*" PRIx64 " %08" PRIx32 "\n", (unsigned int) cpu->csr.mhartid,
+            XLEN / 4 + 2, (uint64_t) addr, instr.val);
+}
+
+static const char *const rv_abi_regnames[RV_REG_COUNT] = {
+    "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+    "s0/fp", "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+    "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7",
+    "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"
+};
+
+static void rv_reg_dump(rv_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    printf("processor %u\n", (unsigned int) cpu->csr.mhartid);
+
+    for (unsigned int i = 0; i < RV_REG_COUNT; i += 4) {
+        printf(" %5s: %*" PRIx64 " %5s: %*" PRIx64 " %5s: %*" PRIx64 " %5s: %*" PRIx64 "\n",
+                rv_abi_regnames[i], XLEN / 4, (uint64_t) cpu->regs[i],
+                rv_abi_regnames[i + 1], XLEN / 4, (uint64_t) cpu->regs[i + 1],
+                rv_abi_regnames[i + 2], XLEN / 4, (uint64_t) cpu->regs[i + 2],
+                rv_abi_regnames[i + 3], XLEN / 4, (uint64_t) cpu->regs[i + 3]);
+    }
+
+    const char *priv_mode = cpu->priv_mode == rv_mmode ? "M"
+            : cpu->priv_mode == rv_smode               ? "S"
+            : cpu->priv_mode == rv_umode               ? "U"
+                                                       : "ERROR";
+
+    printf(" %5s: %0*" PRIx64 " %*s: %s\n",
+            "pc", XLEN / 4, (uint64_t) cpu->pc,
+            XLEN + 12, "Privilege mode", priv_mode);
+}
+
+static void rv_state(rv_cpu_t *cpu, cpu_state_t *state)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(state != NULL);
+
+    state->pc = cpu->pc;
+    for (unsigned int i = 0; i < CPU_STATE_REGS; i++) {
+        state->regs[i] = cpu->regs[i];
+    }
+
+    /* The CSR structure is zero-initialized, so the padding is stable */
+    rv_csr_t csr;
+    memcpy(&csr, &cpu->csr, sizeof(csr));
+    csr.mtime = 0;
+    csr.last_tick_time = 0;
+
+    uint64_t hash = hash64(&csr, sizeof(csr), 0);
+
+    uint64_t misc[] = {
+        cpu->pc_next,
+        cpu->priv_mode,
+        cpu->reserved_valid,
+        cpu->reserved_addr,
+        cpu->stdby
+    };
+    state->hash = hash64(misc, sizeof(misc), hash);
+}
+
+/** Interrupt which is raised from the outside of the hart
+ *
+ * The timer interrupts are driven by the hart itself.
+ *
+ */
+static bool rv_raisable_interrupt(unsigned int no)
+{
+    return (no == RV_INTERRUPT_NO(rv_exc_supervisor_software_interrupt))
+            || (no == RV_INTERRUPT_NO(rv_exc_machine_software_interrupt))
+            || (no == RV_INTERRUPT_NO(rv_exc_supervisor_external_interrupt))
+            || (no == RV_INTERRUPT_NO(rv_exc_machine_external_interrupt));
+}
+
+static uint64_t rv_value(rv_cpu_t *cpu, cpu_value_t which, unsigned int index)
+{
+    ASSERT(cpu != NULL);
+
+    switch (which) {
+    case CPU_VALUE_PC:
+        return cpu->pc;
+    case CPU_VALUE_REG:
+        ASSERT(index < RV_REG_COUNT);
+        return cpu->regs[index];
+    case CPU_VALUE_PRIV:
+        return cpu->priv_mode;
+    case CPU_VALUE_ASID:
+        return rv_csr_satp_asid(cpu);
+    case CPU_VALUE_IRQ:
+        if (!rv_raisable_interrupt(index)) {
+            return 0;
+        }
+        if (index == RV_INTERRUPT_NO(rv_exc_supervisor_external_interrupt)) {
+            return cpu->csr.external_SEIP;
+        }
+        return (cpu->csr.mip & RV_EXCEPTION_MASK(index)) != 0;
+    }
+
+    return 0;
+}
+
+/** Inject a processor fault
+ *
+ * The system registers are the CSRs, they are accessed as from the
+ * machine mode, so the read-only ones cannot be corrupted.
+ *
+ */
+static bool rv_inject(rv_cpu_t *cpu, cpu_fault_t fault, unsigned int index, uint64_t mask)
+{
+    ASSERT(cpu != NULL);
+
+    switch (fault) {
+    case CPU_FAULT_REG:
+        /* The zero register is hardwired */
+        if ((index == 0) || (index >= RV_REG_COUNT)) {
+            return false;
+        }
+        cpu->regs[index] ^= mask;
+        return true;
+    case CPU_FAULT_SYSREG: {
+        if (index >= CSR_COUNT) {
+            return false;
+        }
+
+        rv_priv_mode_t priv_mode = cpu->priv_mode;
+        cpu->priv_mode = rv_mmode;
+
+        uxlen_t value;
+        uxlen_t old;
+        bool ok = (rv_csr_rs(cpu, index, 0, &value, false) == rv_exc_none)
+                && (rv_csr_rw(cpu, index, value ^ mask, &old, false) == rv_exc_none);
+
+        cpu->priv_mode = priv_mode;
+        return ok;
+    }
+    case CPU_FAULT_TLB: {
+        unsigned int entry = index % (RV_TLB_SETS * RV_TLB_WAYS);
+        cpu->tlb[entry / RV_TLB_WAYS][entry % RV_TLB_WAYS].valid = false;
+        return true;
+    }
+    case CPU_FAULT_IRQ:
+        if (!rv_raisable_interrupt(index)) {
+            return false;
+        }
+        rv_interrupt_up(cpu, index);
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * Traps
+ */
+
+/**
+ * @brief Trap to M mode
+ *
+ * @param ex The exception/interrupt that caused the trap
+ */
+static void m_trap(rv_cpu_t *cpu, rv_exc_t ex)
+{
+    ASSERT(ex != rv_exc_none);
+
+    bool is_interrupt = ex & RV_INTERRUPT_EXC_BITS;
+    cpu->stdby = false;
+
+    cpu->csr.mepc = is_interrupt ? cpu->pc_next : cpu->pc;
+    cpu->csr.mcause = ex;
+    cpu->csr.mtval = cpu->csr.tval_next;
+
+    // MPIE = MIE
+    if (rv_csr_mstatus_mie(cpu)) {
+        cpu->csr.mstatus |= rv_csr_mstatus_mpie_mask;
+    } else {
+        cpu->csr.mstatus &= ~rv_csr_mstatus_mpie_mask;
+    }
+
+    // MIE = 0
+    cpu->csr.mstatus &= ~rv_csr_mstatus_mie_mask;
+
+    // MPP = cpu->priv_mode
+    cpu->csr.mstatus &= ~rv_csr_mstatus_mpp_mask;
+    cpu->csr.mstatus |= ((uint64_t) cpu->priv_mode << rv_csr_mstatus_mpp_pos) & rv_csr_mstatus_mpp_mask;
+
+    cpu->priv_mode = rv_mmode;
+
+    uxlen_t mode = cpu->csr.mtvec & rv_csr_mtvec_mode_mask;
+    uxlen_t base = cpu->csr.mtvec & ~rv_csr_mtvec_mode_mask;
+
+    if ((mode == rv_csr_mtvec_mode_vectored) && (is_interrupt)) {
+        cpu->pc_next = base + 4 * RV_INTERRUPT_NO(ex);
+    } else {
+        cpu->pc_next = base;
+    }
+}
+
+/**
+ * @brief Trap to S mode
+ *
+ * @param ex The exception/interrupt that caused the trap
+ */
+static void s_trap(rv_cpu_t *cpu, rv_exc_t ex)
+{
+    ASSERT(ex != rv_exc_none);
+
+    bool is_interrupt = ex & RV_INTERRUPT_EXC_BITS;
+    cpu->stdby = false;
+
+    cpu->csr.sepc = is_interrupt ? cpu->pc_next : cpu->pc;
+    cpu->csr.scause = ex;
+    cpu->csr.stval = cpu->csr.tval_next;
+
+    // SPIE = SIE
+    if (rv_csr_sstatus_sie(cpu)) {
+        cpu->csr.mstatus |= rv_csr_sstatus_spie_mask;
+    } else {
+        cpu->csr.mstatus &= ~rv_csr_sstatus_spie_mask;
+    }
+
+    // SIE = 0
+    cpu->csr.mstatus &= ~rv_csr_sstatus_sie_mask;
+
+    // SPP = cpu->priv_mode
+    cpu->csr.mstatus &= ~rv_csr_sstatus_spp_mask;
+    cpu->csr.mstatus |= ((uint64_t) cpu->priv_mode << rv_csr_sstatus_spp_pos) & rv_csr_sstatus_spp_mask;
+
+    cpu->priv_mode = rv_smode;
+
+    uxlen_t mode = cpu->csr.stvec & rv_csr_mtvec_mode_mask;
+    uxlen_t base = cpu->csr.stvec & ~rv_csr_mtvec_mode_mask;
+
+    if ((mode == rv_csr_mtvec_mode_vectored) && (is_interrupt)) {
+        cpu->pc_next = base + 4 * RV_INTERRUPT_NO(ex);
+    } else {
+        cpu->pc_next = base;
+    }
+}
+
+/**
+ * @brief Causes an exception trap to the proper privilege level
+ */
+static void handle_exception(rv_cpu_t *cpu, rv_exc_t ex)
+{
+    ASSERT(!(ex & RV_INTERRUPT_EXC_BITS));
+
+    bool delegated = cpu->csr.medeleg & RV_EXCEPTION_MASK(ex);
+
+    if (delegated && cpu->priv_mode != rv_mmode) {
+        s_trap(cpu, ex);
+    } else {
+        m_trap(cpu, ex);
+    }
+}
+
+/**
+ * @brief Traps if an interrupt is pending and is enabled
+ *
+ * Respects the proper interrupt priorities
+ */
+static void try_handle_interrupt(rv_cpu_t *cpu)
+{
+    // Effective mip includes the external SEIP and STIP
+    // Full explanation RISC-V Privileged spec section 3.1.9 Machine Interrupt Registers (mip and mie)
+    uxlen_t mip = cpu->csr.mip
+            | (cpu->csr.external_SEIP ? rv_csr_sei_mask : 0)
+            | (cpu->csr.external_STIP ? rv_csr_sti_mask : 0);
+
+    // no interrupt pending
+    if (mip == 0) {
+        return;
+    }
+
+// PRIORITY: MEI, MSI, MTI, SEI, SSI, STI
+#define trap_if_set(cpu, mask, interrupt, trap_func) \
+    if (mask & RV_EXCEPTION_MASK(interrupt)) { \
+        trap_func(cpu, interrupt); \
+        return; \
+    }
+
+    // TRAP to M-mode
+    // ((priv_mode == M && MIE) || (priv_mode < M)) && MIP[i] && MIE[i] && !MIDELEG[i]
+
+    bool can_trap_to_M = (cpu->priv_mode == rv_mmode && rv_csr_mstatus_mie(cpu)) || (cpu->priv_mode < rv_mmode);
+
+    if (can_trap_to_M) {
+        uxlen_t m_mode_active_interrupt_mask = mip & cpu->csr.mie & ~cpu->csr.mideleg;
+
+        trap_if_set(cpu, m_mode_active_interrupt_mask, rv_exc_machine_external_interrupt, m_trap);
+        trap_if_set(cpu, m_mode_active_interrupt_mask, rv_exc_machine_software_interrupt, m_trap);
+        trap_if_set(cpu, m_mode_active_interrupt_mask, rv_exc_machine_timer_interrupt, m_trap);
+        trap_if_set(cpu, m_mode_active_interrupt_mask, rv_exc_supervisor_external_interrupt, m_trap);
+        trap_if_set(cpu, m_mode_active_interrupt_mask, rv_exc_supervisor_software_interrupt, m_trap);
+        trap_if_set(cpu, m_mode_active_interrupt_mask, rv_exc_supervisor_timer_interrupt, m_trap);
+    }
+
+    // TRAP to S-mode
+    // ((priv_mode == S && SIE) || (priv_mode < S)) && SIP[i] && SIE[i]
+
+    bool can_trap_to_S = (cpu->priv_mode == rv_smode && rv_csr_sstatus_sie(cpu)) || (cpu->priv_mode < rv_smode);
+
+    if (can_trap_to_S) {
+        // mask to only account S mode interrupts
+        uxlen_t s_mode_active_interrupt_mask = mip & cpu->csr.mie & rv_csr_si_mask;
+
+        trap_if_set(cpu, s_mode_active_interrupt_mask, rv_exc_supervisor_external_interrupt, s_trap);
+        trap_if_set(cpu, s_mode_active_interrupt_mask, rv_exc_supervisor_software_interrupt, s_trap);
+        trap_if_set(cpu, s_mode_active_interrupt_mask, rv_exc_supervisor_timer_interrupt, s_trap);
+    }
+
+#undef trap_if_set
+}
+
+/*
+ * Execution
+ */
+
+/**
+ * @brief Increases the HPM counters based in the event specifying CSRs
+ */
+static void account_hpm(rv_cpu_t *cpu, int i)
+{
+    ASSERT((i >= 0 && i < 29));
+
+    if (cpu->csr.mcountinhibit & (1 << (i + 3))) {
+        return;
+    }
+
+    switch (cpu->csr.hpmevents[i]) {
+    case hpm_u_cycles:
+        cpu->csr.hpmcounters[i] += (cpu->priv_mode == rv_umode);
+        break;
+    case hpm_s_cycles:
+        cpu->csr.hpmcounters[i] += (cpu->priv_mode == rv_smode);
+        break;
+    case hpm_m_cycles:
+        cpu->csr.hpmcounters[i] += (cpu->priv_mode == rv_mmode);
+        break;
+    case hpm_w_cycles:
+        cpu->csr.hpmcounters[i] += cpu->stdby;
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Increase the counter CSRs and raise timer interrupts if desired
+ */
+static void account(rv_cpu_t *cpu, bool instruction_retired)
+{
+    if (!(cpu->csr.mcountinhibit & 0b001)) {
+        cpu->csr.cycle++;
+    }
+
+    // mtime cannot be inhibited
+    uint64_t current_tick_time = replay_timestamp(cpu->csr.mhartid);
+    cpu->csr.mtime += (current_tick_time - cpu->csr.last_tick_time);
+    cpu->csr.last_tick_time = current_tick_time;
+
+    if (!(cpu->csr.mcountinhibit & 0b100) && instruction_retired) {
+        cpu->csr.instret++;
+    }
+
+    for (int i = 0; i < 29; ++i) {
+        account_hpm(cpu, i);
+    }
+
+    // raise or clear scyclecmp ESTIP
+    cpu->csr.external_STIP = ((uxlen_t) cpu->csr.cycle) >= cpu->csr.scyclecmp;
+
+    // raise or clear mtimecmp MTIP
+    handle_mtip(cpu);
+}
+
+/**
+ * @brief Execute the instruction that PC is pointing to
+ */
+static rv_exc_t execute(rv_cpu_t *cpu)
+{
+    if ((sample_pc_armed) && (cpu->pc == sample_pc)) {
+        sample_hit_pc(cpu->csr.mhartid);
+    }
+
+    ptr36_t phys;
+    rv_exc_t ex = rv_convert_addr(cpu, cpu->pc, &phys, false, true, true);
+
+    if (ex != rv_exc_none) {
+        alert("Fetching from unconvertable address!");
+        cpu->csr.tval_next = cpu->pc;
+        return ex;
+    }
+
+    rv_instr_t instr = { .val = physmem_read32(cpu->csr.mhartid, phys, true) };
+
+    if (machine_trace) {
+        rv_idump(cpu, cpu->pc, instr);
+    }
+
+    if (machine_profile) {
+        profile_hit(cpu->csr.mhartid, cpu->pc);
+    }
+
+    ex = decode_cached(instr)(cpu, instr);
+
+    if (ex == rv_exc_illegal_instruction) {
+        cpu->csr.tval_next = instr.val;
+    }
+
+    return ex;
+}
+
+/*
+ * Public interface
+ */
+
+/**
+ * @brief Create and initialize a processor
+ */
+rv_cpu_t *RV_XLEN_NAME(cpu_create)(unsigned int procno)
+{
+    rv_cpu_t *cpu = safe_malloc_t(rv_cpu_t);
+
+    // expects that default value for any variable is 0
+    memset(cpu, 0, sizeof(rv_cpu_t));
+
+    cpu->pc = RV_START_ADDRESS;
+    cpu->pc_next = RV_START_ADDRESS + 4;
+    cpu->priv_mode = rv_mmode;
+
+    rv_init_csr(&cpu->csr, procno);
+
+    return cpu;
+}
+
+void RV_XLEN_NAME(cpu_destroy)(rv_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    safe_free(cpu);
+}
+
+/**
+ * @brief Simulate one step of the CPU
+ */
+void RV_XLEN_NAME(cpu_step)(rv_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    rv_exc_t ex = rv_exc_none;
+    bool instruction_retired = false;
+
+    if (!cpu->stdby) {
+        ex = execute(cpu);
+        instruction_retired = (ex == rv_exc_none);
+    }
+
+    if (ex != rv_exc_none) {
+        handle_exception(cpu, ex);
+    } else {
+        // If any interrupts are pending, handle them
+        try_handle_interrupt(cpu);
+    }
+
+    account(cpu, instruction_retired);
+
+    if (!cpu->stdby) {
+        cpu->pc = cpu->pc_next;
+        cpu->pc_next = cpu->pc + 4;
+    }
+
+    // x0 is always 0
+    cpu->regs[0] = 0;
+    cpu->csr.tval_next = 0;
+}
+
+#if XLEN == 32
+
+#define GET_ARRAY(type, name, count) \
+    memcpy(state->csr.name, cpu->csr.name, sizeof(state->csr.name));
+#define GET_SCALAR(type, name) \
+    state->csr.name = cpu->csr.name;
+#define SET_ARRAY(type, name, count) \
+    memcpy(cpu->csr.name, state->csr.name, sizeof(cpu->csr.name));
+#define SET_SCALAR(type, name) \
+    cpu->csr.name = state->csr.name;
+
+/**
+ * @brief Exports the architectural state of the processor
+ */
+void rv32_cpu_get_state(rv_cpu_t *cpu, rv32_state_t *state)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(state != NULL);
+
+    memcpy(state->regs, cpu->regs, sizeof(state->regs));
+    state->pc = cpu->pc;
+    state->priv_mode = cpu->priv_mode;
+    state->reserved_valid = cpu->reserved_valid;
+    state->reserved_addr = cpu->reserved_addr;
+    state->stdby = cpu->stdby;
+
+    RV32_STATE_CSRS(GET_ARRAY, GET_SCALAR)
+}
+
+/**
+ * @brief Imports the architectural state of the processor
+ *
+ * The TLB is kept, flush it if the page tables might differ.
+ */
+void rv32_cpu_set_state(rv_cpu_t *cpu, const rv32_state_t *state)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(state != NULL);
+
+    memcpy(cpu->regs, state->regs, sizeof(cpu->regs));
+    cpu->pc = state->pc;
+    cpu->pc_next = state->pc + 4;
+    cpu->priv_mode = (rv_priv_mode_t) state->priv_mode;
+    cpu->reserved_valid = state->reserved_valid;
+    cpu->reserved_addr = state->reserved_addr;
+    cpu->stdby = state->stdby;
+
+    RV32_STATE_CSRS(SET_ARRAY, SET_SCALAR)
+}
+
+#undef GET_ARRAY
+#undef GET_SCALAR
+#undef SET_ARRAY
+#undef SET_SCALAR
+
+#endif
+
+void RV_XLEN_NAME(reg_dump)(rv_cpu_t *cpu)
+{
+    rv_reg_dump(cpu);
+}
+
+void RV_XLEN_NAME(memusage)(rv_cpu_t *cpu, memusage_t *usage)
+{
+    ASSERT(cpu != NULL);
+
+    memusage_add(usage, MEMUSAGE_TLB, sizeof(cpu->tlb));
+}
+
+/**
+ * @brief Accounts the decoded instruction cache of this build
+ *
+ * The cache is shared by all processors of the same XLEN, only the
+ * touched pages of it are resident.
+ */
+void RV_XLEN_NAME(cache_memusage)(memusage_t *usage)
+{
+    memusage_add_mapped(usage, MEMUSAGE_DECODE_CACHE, decode_cache,
+            sizeof(decode_cache));
+}
+
+void RV_XLEN_NAME(tlb_flush)(rv_cpu_t *cpu)
+{
+    ASSERT(cpu != NULL);
+
+    rv_tlb_flush_by_asid(cpu, 0, true);
+}
+
+/* Interrupts
+ * Devices should raise a Machine/Supervisor External Interrupt,
+ * but interprocessor interrupts should be Machine/Supervisor Software Interrupts.
+ * So we use the argument `no` to differentiate based on the exception code (see `rv_exc_t` definiton)
+ */
+
+/**
+ * @brief Raises the interrupt of the given number
+ *
+ * @param no The interrupt number (1 = SSI, 3 = MSI, 5 = STI, 7 = MTI, 9 = SEI, 11 = MEI)
+ */
+static void rv_interrupt_up(rv_cpu_t *cpu, unsigned int no)
+{
+    ASSERT(cpu != NULL);
+
+    // Edge case, where we don't want to set SEIP, because SEIP is writable from M mode
+    if (no == RV_INTERRUPT_NO(rv_exc_supervisor_external_interrupt)) {
+        cpu->csr.external_SEIP = true;
+        return;
+    }
+
+    // default to MEI if no is invalid
+    if (no != RV_INTERRUPT_NO(rv_exc_machine_software_interrupt) && no != RV_INTERRUPT_NO(rv_exc_supervisor_software_interrupt) && no != RV_INTERRUPT_NO(rv_exc_machine_external_interrupt)) {
+        no = RV_INTERRUPT_NO(rv_exc_machine_external_interrupt);
+    }
+
+    cpu->csr.mip |= RV_EXCEPTION_MASK(no);
+}
+
+/**
+ * @brief Clears the interrupt of the given number
+ *
+ * @param no The interrupt number (1 = SSI, 3 = MSI, 5 = STI, 7 = MTI, 9 = SEI, 11 = MEI)
+ */
+static void rv_interrupt_down(rv_cpu_t *cpu, unsigned int no)
+{
+    ASSERT(cpu != NULL);
+
+    // Edge case, where we don't want to clear SEIP, because SEIP is writable from M mode
+    if (no == RV_INTERRUPT_NO(rv_exc_supervisor_external_interrupt)) {
+        cpu->csr.external_SEIP = false;
+        return;
+    }
+
+    // default to MEI if no is invalid
+    if (no != RV_INTERRUPT_NO(rv_exc_machine_software_interrupt) && no != RV_INTERRUPT_NO(rv_exc_supervisor_software_interrupt) && no != RV_INTERRUPT_NO(rv_exc_machine_external_interrupt)) {
+        no = RV_INTERRUPT_NO(rv_exc_machine_external_interrupt);
+    }
+
+    cpu->csr.mip &= ~RV_EXCEPTION_MASK(no);
+}
+
+static bool rv_convert_addr_wrapper(rv_cpu_t *cpu, ptr64_t virt, ptr36_t *phys, bool write)
+{
+    return rv_convert_addr(cpu, (virt_t) virt.ptr, phys, write, false, false) == rv_exc_none;
+}
+
+static void rv_set_pc(rv_cpu_t *cpu, ptr64_t addr)
+{
+    ASSERT(cpu != NULL);
+
+    uxlen_t value = (uxlen_t) addr.ptr;
+
+    if (!IS_ALIGNED(value, 4)) {
+        return;
+    }
+
+    /* Set both pc and pc_next, so that the new instruction
+     * does not jump back to where the processor was
+     */
+    cpu->pc = value;
+    cpu->pc_next = value + 4;
+}
+
+/**
+ * @brief Notify the CPU that an adress has been written to
+ *
+ * Used for implementing the LR/SC atomics
+ *
+ * @returns Whether we hit the LR reserved address
+ */
+static bool rv_sc_access(rv_cpu_t *cpu, ptr36_t phys, int size)
+{
+    ASSERT(cpu != NULL);
+
+    // The size of the reservation is XLEN bits, we check whether the write overlaps
+    bool hit = AREAS_OVERLAP(cpu->reserved_addr, XLEN / 8, phys, size);
+
+    if (hit) {
+        cpu->reserved_valid = false;
+    }
+
+    return hit;
+}
+
+const cpu_ops_t RV_XLEN_NAME(cpu_ops) = {
+    .interrupt_up = (interrupt_func_t) rv_interrupt_up,
+    .interrupt_down = (interrupt_func_t) rv_interrupt_down,
+
+    .convert_addr = (convert_addr_func_t) rv_convert_addr_wrapper,
+    .reg_dump = (reg_dump_func_t) rv_reg_dump,
+
+    .set_pc = (set_pc_func_t) rv_set_pc,
+    .sc_access = (sc_access_func_t) rv_sc_access,
+    .state = (state_func_t) rv_state,
+    .value = (value_func_t) rv_value,
+    .inject = (inject_func_t) rv_inject
+};
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V RV32IMA/RV64IMA processor core
+ *
+ * The core is compiled once for every supported XLEN (see rv32ima.c
+ * and rv64ima.c), so the width of the registers is known at compile
+ * time and the RV32 build does not pay for the 64-bit support. The
+ * exported symbols of the builds are prefixed by rv32_ and rv64_.
+ *
+ */
+
+#ifndef RISCV_RV_CPU_H_
+#define RISCV_RV_CPU_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../../../main.h"
+#include "csr.h"
+#include "exception.h"
+#include "instr.h"
+#include "types.h"
+
+#if XLEN == 64
+#define RV_XLEN_NAME(name) rv64_##name
+#else
+#define RV_XLEN_NAME(name) rv32_##name
+#endif
+
+#define RV_REG_COUNT 32
+
+/** Number of TLB sets (has to be a power of two) */
+#define RV_TLB_SETS 128
+#define RV_TLB_WAYS 2
+
+/** TLB entry
+ *
+ * The TLB is two-way set associative and indexed by the 4 KiB virtual
+ * page number. Translations of superpages are cached for the 4 KiB
+ * pages which have actually been accessed.
+ */
+typedef struct {
+    /** Virtual page number of the accessed 4 KiB page */
+    uint64_t vpn;
+
+    /** Leaf PTE of the translation */
+    uint64_t pte;
+
+    /** Level of the leaf PTE (0 for 4 KiB pages) */
+    unsigned int level;
+
+    unsigned int asid;
+    bool global;
+    bool valid;
+} rv_tlb_entry_t;
+
+/** Main processor structure */
+struct RV_XLEN_NAME(cpu) {
+    /** Non privileged registers */
+    uxlen_t regs[RV_REG_COUNT];
+
+    /** Control and status registers */
+    rv_csr_t csr;
+
+    /** Program counter */
+    uxlen_t pc;
+
+    /** The next value of PC
+     *  Used for implementing jumps, branches and traps
+     */
+    uxlen_t pc_next;
+
+    /** Current privilege mode */
+    rv_priv_mode_t priv_mode;
+
+    // LR and SC
+    bool reserved_valid; /** Is the current LR reservation valid */
+    ptr36_t reserved_addr; /** physical address of the last LR */
+
+    /** Tells if the processor is executing or waiting */
+    bool stdby;
+
+    /** Translation Lookaside Buffer */
+    rv_tlb_entry_t tlb[RV_TLB_SETS][RV_TLB_WAYS];
+
+    /** Most recently used way of every TLB set */
+    uint8_t tlb_mru[RV_TLB_SETS];
+};
+
+#endif // RISCV_RV_CPU_H_
@@ -22,6 +22,8 @@ typedef rv_exc_t (*csr_write_func_t)(rv_cpu_t *, csr_num_t csr, uxlen_t);
 typedef rv_exc_t (*csr_set_func_t)(rv_cpu_t *, csr_num_t csr, uxlen_t);
 typedef rv_exc_t (*csr_clear_func_t)(rv_cpu_t *, csr_num_t csr, uxlen_t);
 
+static void csr_table_init(void);
+
 /**
  * Initialize CSRs
  *
@@ -39,6 +41,8 @@ static void rv_init_csr(rv_csr_t *csr, unsigned int procno)
     csr->last_tick_time = csr->mtime;
 
     csr->asid_len = rv_asid_len;
+
+    csr_table_init();
 }
 
 /**
@@ -59,33 +63,24 @@ typedef struct {
     csr_clear_func_t clear; /** Clears the bits on position that has a bit set in the given value (writing only to those bits)*/
 } csr_ops_t;
 
-#define minimal_privilege(priv, cpu) \
-    { \
-        if (cpu->priv_mode < priv) \
-            return rv_exc_illegal_instruction; \
-    }
-#define default_csr_functions(csr_name, priv) \
+#define default_csr_functions(csr_name) \
     static rv_exc_t csr_name##_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target) \
     { \
-        minimal_privilege(priv, cpu); \
         *target = cpu->csr.csr_name; \
         return rv_exc_none; \
     } \
     static rv_exc_t csr_name##_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value) \
     { \
-        minimal_privilege(priv, cpu); \
         cpu->csr.csr_name = value; \
         return rv_exc_none; \
     } \
     static rv_exc_t csr_name##_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value) \
     { \
-        minimal_privilege(priv, cpu); \
         cpu->csr.csr_name |= value; \
         return rv_exc_none; \
     } \
     static rv_exc_t csr_name##_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value) \
     { \
-        minimal_privilege(priv, cpu); \
         cpu->csr.csr_name &= ~value; \
         return rv_exc_none; \
     }
@@ -161,9 +156,6 @@ static rv_exc_t counter_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 static rv_exc_t counter_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
 
-    // only mmode can write to counters
-    minimal_privilege(rv_mmode, cpu);
-
     // global counters are r/o
     if (rv_csr_min_priv_mode(csr) != rv_mmode) {
         return rv_exc_illegal_instruction;
@@ -210,9 +202,6 @@ static rv_exc_t counter_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 static rv_exc_t counter_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
 
-    // only mmode can write to counters
-    minimal_privilege(rv_mmode, cpu);
-
     // global counters are r/o
     if (rv_csr_min_priv_mode(csr) != rv_mmode) {
         return rv_exc_illegal_instruction;
@@ -248,9 +237,6 @@ static rv_exc_t counter_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t counter_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    // only mmode can write to counters
-    minimal_privilege(rv_mmode, cpu);
-
     // global counters are r/o
     if (rv_csr_min_priv_mode(csr) != rv_mmode) {
         return rv_exc_illegal_instruction;
@@ -288,35 +274,30 @@ static rv_exc_t counter_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t mcountinhibit_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mcountinhibit;
     return rv_exc_none;
 }
 
 static rv_exc_t mcountinhibit_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mcountinhibit = value & mcountinhibit_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mcountinhibit_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mcountinhibit |= value & mcountinhibit_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mcountinhibit_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mcountinhibit &= ~(value & mcountinhibit_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t mhpmevent_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     int event = (csr & 0x1F) - 3;
     *target = cpu->csr.hpmevents[event];
     return rv_exc_none;
@@ -324,7 +305,6 @@ static rv_exc_t mhpmevent_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 
 static rv_exc_t mhpmevent_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     int event = (csr & 0x1F) - 3;
 
     if (value < hpm_event_count) {
@@ -335,7 +315,6 @@ static rv_exc_t mhpmevent_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t mhpmevent_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     int event = (csr & 0x1F) - 3;
 
     int val = cpu->csr.hpmevents[event] | value;
@@ -348,7 +327,6 @@ static rv_exc_t mhpmevent_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t mhpmevent_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     int event = (csr & 0x1F) - 3;
 
     int val = cpu->csr.hpmevents[event] & ~value;
@@ -402,15 +380,12 @@ static rv_exc_t pmpaddr_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t sstatus_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.mstatus & rv_csr_sstatus_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sstatus_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     // Masked write of low 32 bits
     // TODO: Reconsider this masking
     cpu->csr.mstatus = (cpu->csr.mstatus & 0xFFFFFFFF00000000) | (value & rv_csr_sstatus_mask);
@@ -419,7 +394,6 @@ static rv_exc_t sstatus_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t sstatus_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     // Masked write
     cpu->csr.mstatus |= (value & rv_csr_sstatus_mask);
     return rv_exc_none;
@@ -427,7 +401,6 @@ static rv_exc_t sstatus_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t sstatus_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     // Masked write
     cpu->csr.mstatus &= ~(value & rv_csr_sstatus_mask);
     return rv_exc_none;
@@ -435,15 +408,12 @@ static rv_exc_t sstatus_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t sie_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.mie & rv_csr_si_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sie_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     // write only to si bits, preserve rest
     cpu->csr.mie &= ~rv_csr_si_mask;
     cpu->csr.mie |= value & rv_csr_si_mask;
@@ -452,22 +422,18 @@ static rv_exc_t sie_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t sie_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.mie |= value & rv_csr_si_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sie_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.mie &= ~(value & rv_csr_si_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t sip_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
-
     // The SEIP bit is the logical OR of the value in MIP and the status from external interrupt controller
     // Full explanation RISC-V Privileged spec section 3.1.9 Machine Interrupt Registers (mip and mie)
     *target = (cpu->csr.mip & rv_csr_si_mask)
@@ -478,8 +444,6 @@ static rv_exc_t sip_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 
 static rv_exc_t sip_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     // only ssip is writable
     cpu->csr.mip &= ~rv_csr_ssi_mask;
     cpu->csr.mip |= value & rv_csr_ssi_mask;
@@ -488,14 +452,12 @@ static rv_exc_t sip_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t sip_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.mip |= value & rv_csr_ssi_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sip_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.mip &= ~(value & rv_csr_ssi_mask);
     return rv_exc_none;
 }
@@ -504,65 +466,57 @@ static rv_exc_t sip_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t stvec_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.stvec;
     return rv_exc_none;
 }
 
 static rv_exc_t stvec_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.stvec = value & scvec_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t stvec_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.stvec |= value & scvec_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t stvec_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.stvec &= ~(value & scvec_mask);
     return rv_exc_none;
 }
 
-default_csr_functions(scounteren, rv_smode)
+default_csr_functions(scounteren)
 
 #define senvcfg_mask 0x71
 
-        static rv_exc_t senvcfg_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
+static rv_exc_t senvcfg_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.senvcfg;
     return rv_exc_none;
 }
 
 static rv_exc_t senvcfg_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.senvcfg = value & senvcfg_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t senvcfg_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.senvcfg |= value & senvcfg_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t senvcfg_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.senvcfg &= ~(value & senvcfg_mask);
     return rv_exc_none;
 }
 
-default_csr_functions(sscratch, rv_smode)
+default_csr_functions(sscratch)
 
 #if XLEN == 32
 #define sepc_mask 0xFFFFFFFC
@@ -570,30 +524,26 @@ default_csr_functions(sscratch, rv_smode)
 #define sepc_mask 0xFFFFFFFFFFFFFFFC
 #endif
 
-        static rv_exc_t sepc_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
+static rv_exc_t sepc_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.sepc;
     return rv_exc_none;
 }
 
 static rv_exc_t sepc_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.sepc = value & sepc_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sepc_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.sepc |= value & sepc_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t sepc_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.sepc &= ~(value & sepc_mask);
     return rv_exc_none;
 }
@@ -608,15 +558,12 @@ static bool is_exception_code(uxlen_t num)
 
 static rv_exc_t scause_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.scause;
     return rv_exc_none;
 }
 
 static rv_exc_t scause_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     if (is_exception_code(value)) {
         cpu->csr.scause = value;
     } else {
@@ -628,8 +575,6 @@ static rv_exc_t scause_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t scause_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     uxlen_t val = value | cpu->csr.scause;
     if (is_exception_code(val)) {
         cpu->csr.scause = val;
@@ -642,8 +587,6 @@ static rv_exc_t scause_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t scause_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
-
     uxlen_t val = ~value & cpu->csr.scause;
     if (is_exception_code(val)) {
         cpu->csr.scause = val;
@@ -654,11 +597,10 @@ static rv_exc_t scause_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
     return rv_exc_none;
 }
 
-default_csr_functions(stval, rv_smode)
+default_csr_functions(stval)
 
-        static rv_exc_t satp_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
+static rv_exc_t satp_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     if (rv_csr_mstatus_tvm(cpu)) {
         return rv_exc_illegal_instruction;
     }
@@ -669,7 +611,6 @@ default_csr_functions(stval, rv_smode)
 
 static rv_exc_t satp_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     if (rv_csr_mstatus_tvm(cpu)) {
         return rv_exc_illegal_instruction;
     }
@@ -691,7 +632,6 @@ static rv_exc_t satp_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t satp_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     if (rv_csr_mstatus_tvm(cpu)) {
         return rv_exc_illegal_instruction;
     }
@@ -713,7 +653,6 @@ static rv_exc_t satp_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t satp_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     if (rv_csr_mstatus_tvm(cpu)) {
         return rv_exc_illegal_instruction;
     }
@@ -733,34 +672,30 @@ static rv_exc_t satp_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
     return rv_exc_none;
 }
 
-default_csr_functions(scontext, rv_smode)
+default_csr_functions(scontext)
 
         // Writes to scyclecmp request or unrequest STI (based on the low 32 bits of cycle)
 
-        static rv_exc_t scyclecmp_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
+static rv_exc_t scyclecmp_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_smode, cpu);
     *target = cpu->csr.scyclecmp;
     return rv_exc_none;
 }
 
 static rv_exc_t scyclecmp_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.scyclecmp = value;
     cpu->csr.external_STIP = ((uxlen_t) cpu->csr.cycle) >= cpu->csr.scyclecmp;
     return rv_exc_none;
 }
 static rv_exc_t scyclecmp_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.scyclecmp |= value;
     cpu->csr.external_STIP = ((uxlen_t) cpu->csr.cycle) >= cpu->csr.scyclecmp;
     return rv_exc_none;
 }
 static rv_exc_t scyclecmp_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_smode, cpu);
     cpu->csr.scyclecmp &= ~value;
     cpu->csr.external_STIP = ((uxlen_t) cpu->csr.cycle) >= cpu->csr.scyclecmp;
     return rv_exc_none;
@@ -768,50 +703,42 @@ static rv_exc_t scyclecmp_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t mvendorid_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mvendorid;
     return rv_exc_none;
 }
 
 static rv_exc_t marchid_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.marchid;
     return rv_exc_none;
 }
 
 static rv_exc_t mimpid_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mimpid;
     return rv_exc_none;
 }
 
 static rv_exc_t mhartid_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mhartid;
     return rv_exc_none;
 }
 
 static rv_exc_t mconfigptr_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mconfigptr;
     return rv_exc_none;
 }
 
 static rv_exc_t mstatus_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = (uxlen_t) cpu->csr.mstatus;
     return rv_exc_none;
 }
 
 static rv_exc_t mstatus_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     uint64_t val = value & rv_csr_mstatus_mask;
 
     // if the new mpp mode would be rmode (reserved, invalid value), don't modify it
@@ -828,8 +755,6 @@ static rv_exc_t mstatus_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t mstatus_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     value &= rv_csr_mstatus_mask;
 
     uint64_t new_val = ((uint64_t) value) | cpu->csr.mstatus;
@@ -846,8 +771,6 @@ static rv_exc_t mstatus_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t mstatus_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     value &= rv_csr_mstatus_mask;
     // Masked write
     uint64_t new_val = (~(uint64_t) value) & cpu->csr.mstatus;
@@ -864,35 +787,30 @@ static rv_exc_t mstatus_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 // Since MBE and SBE are both R/O zero and other bits re WPRI, whole mstatush is R/O zero
 static rv_exc_t mstatush_read(rv_cpu_t *cpu, csr_num_t csr, uint32_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = (uint32_t) (cpu->csr.mstatus >> 32);
     return rv_exc_none;
 }
 
 static rv_exc_t mstatush_write(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     // writes to mstatush have no effect
     return rv_exc_none;
 }
 
 static rv_exc_t mstatush_set(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     // writes to mstatush have no effect
     return rv_exc_none;
 }
 
 static rv_exc_t mstatush_clear(rv_cpu_t *cpu, csr_num_t csr, uint32_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     // writes to mstatush have no effect
     return rv_exc_none;
 }
 
 static rv_exc_t misa_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.misa;
     return rv_exc_none;
 }
@@ -900,19 +818,16 @@ static rv_exc_t misa_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 // misa writes do nothing, we don't allow the change of extensions or MXLEN
 static rv_exc_t misa_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t misa_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t misa_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
@@ -921,35 +836,30 @@ static rv_exc_t misa_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t medeleg_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.medeleg;
     return rv_exc_none;
 }
 
 static rv_exc_t medeleg_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.medeleg = value & medeleg_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t medeleg_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.medeleg |= value & medeleg_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t medeleg_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.medeleg &= ~(value & medeleg_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t mideleg_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mideleg;
     return rv_exc_none;
 }
@@ -957,57 +867,48 @@ static rv_exc_t mideleg_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 // we allow only smode interrupts to be delegatable
 static rv_exc_t mideleg_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mideleg = value & rv_csr_si_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mideleg_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mideleg |= value & rv_csr_si_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mideleg_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mideleg &= ~(value & rv_csr_si_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t mie_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mie;
     return rv_exc_none;
 }
 
 static rv_exc_t mie_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mie = value & rv_csr_mi_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mie_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mie |= value & rv_csr_mi_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mie_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mie &= ~(value & rv_csr_mi_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t mip_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     // The SEIP bit is the logical OR of the value in MIP and the status from external interrupt controller
     // Full explanation RISC-V Privileged spec section 3.1.9 Machine Interrupt Registers (mip and mie)
     *target = cpu->csr.mip
@@ -1021,22 +922,18 @@ static rv_exc_t mip_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 
 static rv_exc_t mip_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     cpu->csr.mip = value & mip_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mip_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mip |= value & mip_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mip_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mip &= ~(value & mip_mask);
     return rv_exc_none;
 }
@@ -1045,47 +942,41 @@ static rv_exc_t mip_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t mtvec_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mtvec;
     return rv_exc_none;
 }
 
 static rv_exc_t mtvec_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mtvec = value & mtvec_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mtvec_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mtvec |= value & mtvec_mask;
     return rv_exc_none;
 }
 
 static rv_exc_t mtvec_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.mtvec &= ~(value & mtvec_mask);
     return rv_exc_none;
 }
 
-default_csr_functions(mcounteren, rv_mmode)
+default_csr_functions(mcounteren)
 
-        default_csr_functions(mscratch, rv_mmode)
-                default_csr_functions(mepc, rv_mmode)
+default_csr_functions(mscratch)
+default_csr_functions(mepc)
 
-                        static rv_exc_t mcause_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
+static rv_exc_t mcause_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mcause;
     return rv_exc_none;
 }
 
 static rv_exc_t mcause_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     if (is_exception_code(value)) {
         cpu->csr.mcause = value;
     } else {
@@ -1096,8 +987,6 @@ static rv_exc_t mcause_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t mcause_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
-
     uxlen_t val = cpu->csr.mcause | value;
 
     if (is_exception_code(val)) {
@@ -1110,7 +999,6 @@ static rv_exc_t mcause_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t mcause_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     uxlen_t val = cpu->csr.mcause & ~value;
 
     if (is_exception_code(val)) {
@@ -1121,9 +1009,9 @@ static rv_exc_t mcause_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
     return rv_exc_none;
 }
 
-default_csr_functions(mtval, rv_mmode)
+default_csr_functions(mtval)
 
-        static rv_exc_t mtinst_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
+static rv_exc_t mtinst_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
     return rv_exc_illegal_instruction;
 }
@@ -1167,14 +1055,12 @@ static rv_exc_t mtval2_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t menvcfg_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = (uxlen_t) cpu->csr.menvcfg;
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfg_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     // TODO: Reconsider this masking
     cpu->csr.menvcfg = (cpu->csr.menvcfg & 0xFFFFFFFF00000000) | (value & menvcfg_fiom_mask);
     return rv_exc_none;
@@ -1182,14 +1068,12 @@ static rv_exc_t menvcfg_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t menvcfg_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     cpu->csr.menvcfg |= (uint64_t) (value & menvcfg_fiom_mask);
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfg_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     // Writing to unwritable fields
     cpu->csr.menvcfg &= ~((uint64_t) (value & menvcfg_fiom_mask));
     return rv_exc_none;
@@ -1197,77 +1081,65 @@ static rv_exc_t menvcfg_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 
 static rv_exc_t menvcfgh_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.menvcfg >> 32;
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfgh_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfgh_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t menvcfgh_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 // mseccfg(h) do nothing as of now, so they are read-only 0
 static rv_exc_t mseccfg_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = cpu->csr.mseccfg;
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfg_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfg_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfg_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfgh_read(rv_cpu_t *cpu, csr_num_t csr, uxlen_t *target)
 {
-    minimal_privilege(rv_mmode, cpu);
     *target = 0;
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfgh_write(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfgh_set(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
 static rv_exc_t mseccfgh_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
 {
-    minimal_privilege(rv_mmode, cpu);
     return rv_exc_none;
 }
 
@@ -1451,368 +1323,214 @@ static rv_exc_t dscratch1_clear(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value)
     return rv_exc_illegal_instruction;
 }
 
-/** Retrieves the CSR ops for the given csr*/
-static csr_ops_t get_csr_ops(csr_num_t csr)
-{
-    csr_ops_t ops = {
-        .read = invalid_read,
-        .write = invalid_write,
-        .set = invalid_write,
-        .clear = invalid_write
-    };
-
-#define default_case(csr) \
-    case csr_##csr: { \
-        ops.read = csr##_read; \
-        ops.write = csr##_write; \
-        ops.set = csr##_set; \
-        ops.clear = csr##_clear; \
-        break; \
+/** Handlers of the unimplemented CSRs */
+static const csr_ops_t invalid_ops = {
+    .read = invalid_read,
+    .write = invalid_write,
+    .set = invalid_write,
+    .clear = invalid_write
+};
+
+#define csr_ops(csr) \
+    static const csr_ops_t csr##_ops = { \
+        .read = csr##_read, \
+        .write = csr##_write, \
+        .set = csr##_set, \
+        .clear = csr##_clear \
     }
 
-#define read_only_case(csr) \
-    case csr_##csr: { \
-        ops.read = csr##_read; \
-        ops.write = invalid_write; \
-        ops.set = invalid_write; \
-        ops.clear = invalid_write; \
-        break; \
+#define read_only_csr_ops(csr) \
+    static const csr_ops_t csr##_ops = { \
+        .read = csr##_read, \
+        .write = invalid_write, \
+        .set = invalid_write, \
+        .clear = invalid_write \
     }
 
-    switch (csr) {
-    case (csr_cycle):
-    case (csr_time):
-    case (csr_instret):
-    case (csr_hpmcounter3):
-    case (csr_hpmcounter4):
-    case (csr_hpmcounter5):
-    case (csr_hpmcounter6):
-    case (csr_hpmcounter7):
-    case (csr_hpmcounter8):
-    case (csr_hpmcounter9):
-    case (csr_hpmcounter10):
-    case (csr_hpmcounter11):
-    case (csr_hpmcounter12):
-    case (csr_hpmcounter13):
-    case (csr_hpmcounter14):
-    case (csr_hpmcounter15):
-    case (csr_hpmcounter16):
-    case (csr_hpmcounter17):
-    case (csr_hpmcounter18):
-    case (csr_hpmcounter19):
-    case (csr_hpmcounter20):
-    case (csr_hpmcounter21):
-    case (csr_hpmcounter22):
-    case (csr_hpmcounter23):
-    case (csr_hpmcounter24):
-    case (csr_hpmcounter25):
-    case (csr_hpmcounter26):
-    case (csr_hpmcounter27):
-    case (csr_hpmcounter28):
-    case (csr_hpmcounter29):
-    case (csr_hpmcounter30):
-    case (csr_hpmcounter31):
-    case (csr_cycleh):
-    case (csr_timeh):
-    case (csr_instreth):
-    case (csr_hpmcounter3h):
-    case (csr_hpmcounter4h):
-    case (csr_hpmcounter5h):
-    case (csr_hpmcounter6h):
-    case (csr_hpmcounter7h):
-    case (csr_hpmcounter8h):
-    case (csr_hpmcounter9h):
-    case (csr_hpmcounter10h):
-    case (csr_hpmcounter11h):
-    case (csr_hpmcounter12h):
-    case (csr_hpmcounter13h):
-    case (csr_hpmcounter14h):
-    case (csr_hpmcounter15h):
-    case (csr_hpmcounter16h):
-    case (csr_hpmcounter17h):
-    case (csr_hpmcounter18h):
-    case (csr_hpmcounter19h):
-    case (csr_hpmcounter20h):
-    case (csr_hpmcounter21h):
-    case (csr_hpmcounter22h):
-    case (csr_hpmcounter23h):
-    case (csr_hpmcounter24h):
-    case (csr_hpmcounter25h):
-    case (csr_hpmcounter26h):
-    case (csr_hpmcounter27h):
-    case (csr_hpmcounter28h):
-    case (csr_hpmcounter29h):
-    case (csr_hpmcounter30h):
-    case (csr_hpmcounter31h):
-    case (csr_mcycle):
-    case (csr_minstret):
-    case (csr_mhpmcounter3):
-    case (csr_mhpmcounter4):
-    case (csr_mhpmcounter5):
-    case (csr_mhpmcounter6):
-    case (csr_mhpmcounter7):
-    case (csr_mhpmcounter8):
-    case (csr_mhpmcounter9):
-    case (csr_mhpmcounter10):
-    case (csr_mhpmcounter11):
-    case (csr_mhpmcounter12):
-    case (csr_mhpmcounter13):
-    case (csr_mhpmcounter14):
-    case (csr_mhpmcounter15):
-    case (csr_mhpmcounter16):
-    case (csr_mhpmcounter17):
-    case (csr_mhpmcounter18):
-    case (csr_mhpmcounter19):
-    case (csr_mhpmcounter20):
-    case (csr_mhpmcounter21):
-    case (csr_mhpmcounter22):
-    case (csr_mhpmcounter23):
-    case (csr_mhpmcounter24):
-    case (csr_mhpmcounter25):
-    case (csr_mhpmcounter26):
-    case (csr_mhpmcounter27):
-    case (csr_mhpmcounter28):
-    case (csr_mhpmcounter29):
-    case (csr_mhpmcounter30):
-    case (csr_mhpmcounter31):
-    case (csr_mcycleh):
-    case (csr_minstreth):
-    case (csr_mhpmcounter3h):
-    case (csr_mhpmcounter4h):
-    case (csr_mhpmcounter5h):
-    case (csr_mhpmcounter6h):
-    case (csr_mhpmcounter7h):
-    case (csr_mhpmcounter8h):
-    case (csr_mhpmcounter9h):
-    case (csr_mhpmcounter10h):
-    case (csr_mhpmcounter11h):
-    case (csr_mhpmcounter12h):
-    case (csr_mhpmcounter13h):
-    case (csr_mhpmcounter14h):
-    case (csr_mhpmcounter15h):
-    case (csr_mhpmcounter16h):
-    case (csr_mhpmcounter17h):
-    case (csr_mhpmcounter18h):
-    case (csr_mhpmcounter19h):
-    case (csr_mhpmcounter20h):
-    case (csr_mhpmcounter21h):
-    case (csr_mhpmcounter22h):
-    case (csr_mhpmcounter23h):
-    case (csr_mhpmcounter24h):
-    case (csr_mhpmcounter25h):
-    case (csr_mhpmcounter26h):
-    case (csr_mhpmcounter27h):
-    case (csr_mhpmcounter28h):
-    case (csr_mhpmcounter29h):
-    case (csr_mhpmcounter30h):
-    case (csr_mhpmcounter31h): {
-        ops.read = counter_read;
-        ops.write = counter_write;
-        ops.set = counter_set;
-        ops.clear = counter_clear;
-        break;
-    }
+csr_ops(counter);
+csr_ops(mhpmevent);
+csr_ops(pmpcfg);
+csr_ops(pmpaddr);
+csr_ops(mcountinhibit);
+csr_ops(sstatus);
+csr_ops(sie);
+csr_ops(stvec);
+csr_ops(scounteren);
+csr_ops(senvcfg);
+csr_ops(sscratch);
+csr_ops(sepc);
+csr_ops(scause);
+csr_ops(stval);
+csr_ops(sip);
+csr_ops(satp);
+csr_ops(scontext);
+csr_ops(scyclecmp);
+csr_ops(mstatus);
+#if XLEN == 32
+csr_ops(mstatush);
+#endif
+csr_ops(misa);
+csr_ops(medeleg);
+csr_ops(mideleg);
+csr_ops(mie);
+csr_ops(mtvec);
+csr_ops(mcounteren);
+csr_ops(mscratch);
+csr_ops(mepc);
+csr_ops(mcause);
+csr_ops(mtval);
+csr_ops(mip);
+csr_ops(mtinst);
+csr_ops(mtval2);
+csr_ops(menvcfg);
+csr_ops(menvcfgh);
+csr_ops(mseccfg);
+csr_ops(mseccfgh);
+csr_ops(tselect);
+csr_ops(tdata1);
+csr_ops(tdata2);
+csr_ops(tdata3);
+csr_ops(mcontext);
+csr_ops(dcsr);
+csr_ops(dpc);
+csr_ops(dscratch0);
+csr_ops(dscratch1);
+read_only_csr_ops(mvendorid);
+read_only_csr_ops(marchid);
+read_only_csr_ops(mimpid);
+read_only_csr_ops(mhartid);
+read_only_csr_ops(mconfigptr);
+
+#undef csr_ops
+#undef read_only_csr_ops
+
+/** Size of the CSR address space */
+#define CSR_COUNT 4096
+
+/** Entry of the CSR dispatch table */
+typedef struct {
+    const csr_ops_t *ops;
+    /** Lowest privilege mode allowed to access the CSR */
+    uint8_t min_priv;
+    /** Writes raise the illegal instruction exception */
+    bool read_only;
+} csr_entry_t;
+
+/** CSR dispatch table
+ *
+ * Indexed directly by the CSR number. The privilege and read-only
+ * checks encoded in the CSR number are precomputed here and done once
+ * for all handlers, so a CSR access is a single lookup and a call.
+ */
+static csr_entry_t csr_table[CSR_COUNT];
 
-    case (csr_mhpmevent3):
-    case (csr_mhpmevent4):
-    case (csr_mhpmevent5):
-    case (csr_mhpmevent6):
-    case (csr_mhpmevent7):
-    case (csr_mhpmevent8):
-    case (csr_mhpmevent9):
-    case (csr_mhpmevent10):
-    case (csr_mhpmevent11):
-    case (csr_mhpmevent12):
-    case (csr_mhpmevent13):
-    case (csr_mhpmevent14):
-    case (csr_mhpmevent15):
-    case (csr_mhpmevent16):
-    case (csr_mhpmevent17):
-    case (csr_mhpmevent18):
-    case (csr_mhpmevent19):
-    case (csr_mhpmevent20):
-    case (csr_mhpmevent21):
-    case (csr_mhpmevent22):
-    case (csr_mhpmevent23):
-    case (csr_mhpmevent24):
-    case (csr_mhpmevent25):
-    case (csr_mhpmevent26):
-    case (csr_mhpmevent27):
-    case (csr_mhpmevent28):
-    case (csr_mhpmevent29):
-    case (csr_mhpmevent30):
-    case (csr_mhpmevent31): {
-        ops.read = mhpmevent_read;
-        ops.write = mhpmevent_write;
-        ops.set = mhpmevent_set;
-        ops.clear = mhpmevent_clear;
-        break;
+static void csr_table_set_range(csr_num_t first, csr_num_t last, const csr_ops_t *ops)
+{
+    for (unsigned int csr = first; csr <= last; csr++) {
+        csr_table[csr].ops = ops;
     }
+}
 
-    case (csr_pmpcfg0):
-    case (csr_pmpcfg1):
-    case (csr_pmpcfg2):
-    case (csr_pmpcfg3):
-    case (csr_pmpcfg4):
-    case (csr_pmpcfg5):
-    case (csr_pmpcfg6):
-    case (csr_pmpcfg7):
-    case (csr_pmpcfg8):
-    case (csr_pmpcfg9):
-    case (csr_pmpcfg10):
-    case (csr_pmpcfg11):
-    case (csr_pmpcfg12):
-    case (csr_pmpcfg13):
-    case (csr_pmpcfg14):
-    case (csr_pmpcfg15): {
-        ops.read = pmpcfg_read;
-        ops.write = pmpcfg_write;
-        ops.set = pmpcfg_set;
-        ops.clear = pmpcfg_clear;
-        break;
-    }
+/** Fill the CSR dispatch table (once for all processors) */
+static void csr_table_init(void)
+{
+    static bool initialized = false;
 
-    case (csr_pmpaddr0):
-    case (csr_pmpaddr1):
-    case (csr_pmpaddr2):
-    case (csr_pmpaddr3):
-    case (csr_pmpaddr4):
-    case (csr_pmpaddr5):
-    case (csr_pmpaddr6):
-    case (csr_pmpaddr7):
-    case (csr_pmpaddr8):
-    case (csr_pmpaddr9):
-    case (csr_pmpaddr10):
-    case (csr_pmpaddr11):
-    case (csr_pmpaddr12):
-    case (csr_pmpaddr13):
-    case (csr_pmpaddr14):
-    case (csr_pmpaddr15):
-    case (csr_pmpaddr16):
-    case (csr_pmpaddr17):
-    case (csr_pmpaddr18):
-    case (csr_pmpaddr19):
-    case (csr_pmpaddr20):
-    case (csr_pmpaddr21):
-    case (csr_pmpaddr22):
-    case (csr_pmpaddr23):
-    case (csr_pmpaddr24):
-    case (csr_pmpaddr25):
-    case (csr_pmpaddr26):
-    case (csr_pmpaddr27):
-    case (csr_pmpaddr28):
-    case (csr_pmpaddr29):
-    case (csr_pmpaddr30):
-    case (csr_pmpaddr31):
-    case (csr_pmpaddr32):
-    case (csr_pmpaddr33):
-    case (csr_pmpaddr34):
-    case (csr_pmpaddr35):
-    case (csr_pmpaddr36):
-    case (csr_pmpaddr37):
-    case (csr_pmpaddr38):
-    case (csr_pmpaddr39):
-    case (csr_pmpaddr40):
-    case (csr_pmpaddr41):
-    case (csr_pmpaddr42):
-    case (csr_pmpaddr43):
-    case (csr_pmpaddr44):
-    case (csr_pmpaddr45):
-    case (csr_pmpaddr46):
-    case (csr_pmpaddr47):
-    case (csr_pmpaddr48):
-    case (csr_pmpaddr49):
-    case (csr_pmpaddr50):
-    case (csr_pmpaddr51):
-    case (csr_pmpaddr52):
-    case (csr_pmpaddr53):
-    case (csr_pmpaddr54):
-    case (csr_pmpaddr55):
-    case (csr_pmpaddr56):
-    case (csr_pmpaddr57):
-    case (csr_pmpaddr58):
-    case (csr_pmpaddr59):
-    case (csr_pmpaddr60):
-    case (csr_pmpaddr61):
-    case (csr_pmpaddr62):
-    case (csr_pmpaddr63): {
-        ops.read = pmpaddr_read;
-        ops.write = pmpaddr_write;
-        ops.set = pmpaddr_set;
-        ops.clear = pmpaddr_clear;
-        break;
+    if (initialized) {
+        return;
     }
 
-        // clang-format off
-
-    default_case(mcountinhibit)
-
-    default_case(sstatus)
-
-    default_case(sie)
-    default_case(stvec)
-    default_case(scounteren)
-
-    default_case(senvcfg)
-
-    default_case(sscratch)
-    default_case(sepc)
-    default_case(scause)
-    default_case(stval)
-    default_case(sip)
-    default_case(satp)
-    default_case(scontext)
-    default_case(scyclecmp)
-
-    read_only_case(mvendorid)
-    read_only_case(marchid)
-    read_only_case(mimpid)
-    read_only_case(mhartid)
-    read_only_case(mconfigptr)
-
-    default_case(mstatus)
-    #if XLEN == 32
-    default_case(mstatush)
-    #endif
-
-
-    default_case(misa)
-    default_case(medeleg)
-    default_case(mideleg)
-    default_case(mie)
-    default_case(mtvec)
-    default_case(mcounteren)
-
-    default_case(mscratch)
-    default_case(mepc)
-    default_case(mcause)
-    default_case(mtval)
-    default_case(mip)
-    default_case(mtinst)
-    default_case(mtval2)
-
-    default_case(menvcfg)
-    default_case(menvcfgh)
-    default_case(mseccfg)
-    default_case(mseccfgh)
-
-    default_case(tselect)
-    default_case(tdata1)
-    default_case(tdata2)
-    default_case(tdata3)
-    default_case(mcontext)
-    default_case(dcsr)
-    default_case(dpc)
-    default_case(dscratch0)
-    default_case(dscratch1)
-
-        // clang-format on
+    for (unsigned int csr = 0; csr < CSR_COUNT; csr++) {
+        csr_table[csr].ops = &invalid_ops;
+        csr_table[csr].min_priv = rv_csr_min_priv_mode(csr);
+        csr_table[csr].read_only = ((csr >> 10) & 0b11) == 0b11;
     }
 
-    return ops;
+    csr_table_set_range(csr_cycle, csr_hpmcounter31, &counter_ops);
+    csr_table_set_range(csr_cycleh, csr_hpmcounter31h, &counter_ops);
+    csr_table[csr_mcycle].ops = &counter_ops;
+    csr_table[csr_minstret].ops = &counter_ops;
+    csr_table_set_range(csr_mhpmcounter3, csr_mhpmcounter31, &counter_ops);
+    csr_table[csr_mcycleh].ops = &counter_ops;
+    csr_table[csr_minstreth].ops = &counter_ops;
+    csr_table_set_range(csr_mhpmcounter3h, csr_mhpmcounter31h, &counter_ops);
+
+    csr_table_set_range(csr_mhpmevent3, csr_mhpmevent31, &mhpmevent_ops);
+    csr_table_set_range(csr_pmpcfg0, csr_pmpcfg15, &pmpcfg_ops);
+    csr_table_set_range(csr_pmpaddr0, csr_pmpaddr63, &pmpaddr_ops);
+
+#define csr_entry(csr) \
+    csr_table[csr_##csr].ops = &csr##_ops
+
+    csr_entry(mcountinhibit);
+    csr_entry(sstatus);
+    csr_entry(sie);
+    csr_entry(stvec);
+    csr_entry(scounteren);
+    csr_entry(senvcfg);
+    csr_entry(sscratch);
+    csr_entry(sepc);
+    csr_entry(scause);
+    csr_entry(stval);
+    csr_entry(sip);
+    csr_entry(satp);
+    csr_entry(scontext);
+    csr_entry(scyclecmp);
+    csr_entry(mstatus);
+#if XLEN == 32
+    csr_entry(mstatush);
+#endif
+    csr_entry(misa);
+    csr_entry(medeleg);
+    csr_entry(mideleg);
+    csr_entry(mie);
+    csr_entry(mtvec);
+    csr_entry(mcounteren);
+    csr_entry(mscratch);
+    csr_entry(mepc);
+    csr_entry(mcause);
+    csr_entry(mtval);
+    csr_entry(mip);
+    csr_entry(mtinst);
+    csr_entry(mtval2);
+    csr_entry(menvcfg);
+    csr_entry(menvcfgh);
+    csr_entry(mseccfg);
+    csr_entry(mseccfgh);
+    csr_entry(tselect);
+    csr_entry(tdata1);
+    csr_entry(tdata2);
+    csr_entry(tdata3);
+    csr_entry(mcontext);
+    csr_entry(dcsr);
+    csr_entry(dpc);
+    csr_entry(dscratch0);
+    csr_entry(dscratch1);
+    csr_entry(mvendorid);
+    csr_entry(marchid);
+    csr_entry(mimpid);
+    csr_entry(mhartid);
+    csr_entry(mconfigptr);
+
+#undef csr_entry
+
+    initialized = true;
+}
+
+/** Retrieves the CSR ops for the given access
+ *
+ * @param write Whether the access modifies the CSR
+ * @return The CSR ops or NULL if the access is not allowed
+ */
+static inline const csr_ops_t *get_csr_ops(rv_cpu_t *cpu, csr_num_t csr, bool write)
+{
+    const csr_entry_t *entry = &csr_table[csr & (CSR_COUNT - 1)];
 
-#undef default_case
-#undef read_only_case
+    if ((cpu->priv_mode < entry->min_priv) || (write && entry->read_only)) {
+        return NULL;
+    }
+
+    return entry->ops;
 }
 
 /**
@@ -1827,16 +1545,20 @@ static csr_ops_t get_csr_ops(csr_num_t csr)
  */
 static rv_exc_t rv_csr_rw(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value, uxlen_t *read_target, bool read)
 {
-    csr_ops_t ops = get_csr_ops(csr);
+    const csr_ops_t *ops = get_csr_ops(cpu, csr, true);
+    if (ops == NULL) {
+        return rv_exc_illegal_instruction;
+    }
+
     rv_exc_t ex = rv_exc_none;
     uxlen_t temp_read_target = 0;
 
     if (read) {
-        ex = ops.read(cpu, csr, &temp_read_target);
+        ex = ops->read(cpu, csr, &temp_read_target);
     }
 
     if (ex == rv_exc_none) {
-        ex = ops.write(cpu, csr, value);
+        ex = ops->write(cpu, csr, value);
     }
 
     if (ex == rv_exc_none) {
@@ -1858,14 +1580,17 @@ static rv_exc_t rv_csr_rw(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value, uxlen_t *
  */
 static rv_exc_t rv_csr_rs(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value, uxlen_t *read_target, bool write)
 {
-    csr_ops_t ops = get_csr_ops(csr);
+    const csr_ops_t *ops = get_csr_ops(cpu, csr, write);
+    if (ops == NULL) {
+        return rv_exc_illegal_instruction;
+    }
 
     uxlen_t temp_read_target = 0;
 
-    rv_exc_t ex = ops.read(cpu, csr, &temp_read_target);
+    rv_exc_t ex = ops->read(cpu, csr, &temp_read_target);
 
     if (ex == rv_exc_none && write) {
-        ex = ops.set(cpu, csr, value);
+        ex = ops->set(cpu, csr, value);
     }
 
     if (ex == rv_exc_none) {
@@ -1887,13 +1612,16 @@ static rv_exc_t rv_csr_rs(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value, uxlen_t *
  */
 static rv_exc_t rv_csr_rc(rv_cpu_t *cpu, csr_num_t csr, uxlen_t value, uxlen_t *read_target, bool write)
 {
+    const csr_ops_t *ops = get_csr_ops(cpu, csr, write);
+    if (ops == NULL) {
+        return rv_exc_illegal_instruction;
+    }
 
-    csr_ops_t ops = get_csr_ops(csr);
     uxlen_t temp_read_target = 0;
-    rv_exc_t ex = ops.read(cpu, csr, &temp_read_target);
+    rv_exc_t ex = ops->read(cpu, csr, &temp_read_target);
 
     if (ex == rv_exc_none && write) {
-        ex = ops.clear(cpu, csr, value);
+        ex = ops->clear(cpu, csr, value);
     }
 
     if (ex == rv_exc_none) {
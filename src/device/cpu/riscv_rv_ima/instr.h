@@ -200,6 +200,8 @@ typedef enum {
     rv_privETRACES = 0b100011000010,
     rv_privETRACER = 0b100011000011,
     rv_privECSRD = 0b100011000100,
+    rv_privEROIB = 0b100011000101,
+    rv_privEROIE = 0b100011000110,
     rv_privSRET = 0b000100000010,
     rv_privMRET = 0b001100000010,
     rv_privWFI = 0b000100000101
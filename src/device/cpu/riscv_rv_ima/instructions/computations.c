@@ -358,9 +358,9 @@ static rv_exc_t rv_slli_instr(rv_cpu_t *cpu, rv_instr_t instr)
     ASSERT(cpu != NULL);
     ASSERT(instr.i.opcode == rv_opcOP_IMM);
 
-    uint32_t imm = instr.i.imm & 0x3F;
+    uint32_t imm = instr.i.imm & shift_instr_mask(XLEN);
 
-    uint64_t val = cpu->regs[instr.i.rs1] << imm;
+    uxlen_t val = cpu->regs[instr.i.rs1] << imm;
 
     cpu->regs[instr.i.rd] = val;
 
@@ -388,9 +388,9 @@ static rv_exc_t rv_srli_instr(rv_cpu_t *cpu, rv_instr_t instr)
     ASSERT(cpu != NULL);
     ASSERT(instr.i.opcode == rv_opcOP_IMM);
 
-    uint32_t imm = instr.i.imm & 0x3F;
+    uint32_t imm = instr.i.imm & shift_instr_mask(XLEN);
 
-    uint64_t val = cpu->regs[instr.i.rs1] >> imm;
+    uxlen_t val = cpu->regs[instr.i.rs1] >> imm;
 
     cpu->regs[instr.i.rd] = val;
 
@@ -418,11 +418,11 @@ static rv_exc_t rv_srai_instr(rv_cpu_t *cpu, rv_instr_t instr)
     ASSERT(cpu != NULL);
     ASSERT(instr.i.opcode == rv_opcOP_IMM);
 
-    uint32_t imm = instr.i.imm & 0x3F;
+    uint32_t imm = instr.i.imm & shift_instr_mask(XLEN);
 
-    int64_t val = (int64_t) cpu->regs[instr.i.rs1] >> imm;
+    xlen_t val = (xlen_t) cpu->regs[instr.i.rs1] >> imm;
 
-    cpu->regs[instr.i.rd] = (uint64_t) val;
+    cpu->regs[instr.i.rd] = (uxlen_t) val;
 
     return rv_exc_none;
 }
@@ -1069,7 +1069,7 @@ static rv_exc_t rv_amominu_w_instr(rv_cpu_t *cpu, rv_instr_t instr)
     rv_exc_t ex = rv_read_mem32(cpu, virt, &val, false, true);
     ASSERT(ex == rv_exc_none);
 
-    cpu->regs[instr.r.rd] = zero_extend_32_to_xlen(val, XLEN);
+    cpu->regs[instr.r.rd] = sign_extend_32_to_xlen(val, XLEN);
     uint32_t rs2 = (uint32_t) cpu->regs[instr.r.rs2];
     val = rs2 < val ? rs2 : val;
 
@@ -1113,7 +1113,7 @@ static rv_exc_t rv_amomaxu_w_instr(rv_cpu_t *cpu, rv_instr_t instr)
     rv_exc_t ex = rv_read_mem32(cpu, virt, &val, false, true);
     ASSERT(ex == rv_exc_none);
 
-    cpu->regs[instr.r.rd] = zero_extend_32_to_xlen(val, XLEN);
+    cpu->regs[instr.r.rd] = sign_extend_32_to_xlen(val, XLEN);
     uint32_t rs2 = (uint32_t) cpu->regs[instr.r.rs2];
     val = rs2 > val ? rs2 : val;
 
@@ -1145,3 +1145,8 @@ static rv_exc_t rv_amomaxu_d_instr(rv_cpu_t *cpu, rv_instr_t instr)
     ASSERT(ex == rv_exc_none);
     return ex;
 }
+
+#undef throw_ex
+#undef throw_if_wrong_privilege
+#undef throw_if_misaligned_word
+#undef throw_if_misaligned_dword
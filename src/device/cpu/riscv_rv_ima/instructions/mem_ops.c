@@ -291,7 +291,7 @@ static rv_exc_t rv_lr_w_instr(rv_cpu_t *cpu, rv_instr_t instr)
     }
 
     // store the read value
-    cpu->regs[instr.r.rd] = zero_extend_32_to_xlen(val, XLEN);
+    cpu->regs[instr.r.rd] = sign_extend_32_to_xlen(val, XLEN);
 
     // we track physical addresses, so convert
     // this should not fail
@@ -15,6 +15,7 @@
 #include <stdint.h>
 
 #include "../../../../assert.h"
+#include "../../../../debug/roi.h"
 #include "../../../../fault.h"
 #include "../../../../input.h"
 #include "../csr.h"
@@ -30,6 +31,9 @@ rv_exc_t rv_write_mem16(rv_cpu_t *cpu, virt_t virt, uint16_t value, bool noisy);
 rv_exc_t rv_write_mem32(rv_cpu_t *cpu, virt_t virt, uint32_t value, bool noisy);
 rv_exc_t rv_write_mem64(rv_cpu_t *cpu, virt_t virt, uint64_t value, bool noisy);
 rv_exc_t rv_convert_addr(rv_cpu_t *cpu, virt_t virt, ptr36_t *phys, bool wr, bool fetch, bool noisy);
+void rv_tlb_flush_by_asid(rv_cpu_t *cpu, unsigned int asid, bool global);
+void rv_tlb_flush_by_addr(rv_cpu_t *cpu, unsigned int asid, virt_t virt, bool global);
+void rv_reg_dump(rv_cpu_t *cpu);
 
 static rv_exc_t rv_break_instr(rv_cpu_t *cpu, rv_instr_t instr)
 {
@@ -58,6 +62,15 @@ static rv_exc_t rv_halt_instr(rv_cpu_t *cpu, rv_instr_t instr)
     return rv_exc_none;
 }
 
+static rv_exc_t rv_dump_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.i.opcode == rv_opcSYSTEM);
+    alert("EDUMP: Dumping general registers");
+    rv_reg_dump(cpu);
+    return rv_exc_none;
+}
+
 static rv_exc_t rv_trace_set_instr(rv_cpu_t *cpu, rv_instr_t instr)
 {
     ASSERT(cpu != NULL);
@@ -76,6 +89,24 @@ static rv_exc_t rv_trace_reset_instr(rv_cpu_t *cpu, rv_instr_t instr)
     return rv_exc_none;
 }
 
+static rv_exc_t rv_roi_begin_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.i.opcode == rv_opcSYSTEM);
+    alert("EROIB: Region of interest begin");
+    roi_begin(cpu->csr.mhartid);
+    return rv_exc_none;
+}
+
+static rv_exc_t rv_roi_end_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    ASSERT(cpu != NULL);
+    ASSERT(instr.i.opcode == rv_opcSYSTEM);
+    alert("EROIE: Region of interest end");
+    roi_end(cpu->csr.mhartid);
+    return rv_exc_none;
+}
+
 static rv_exc_t rv_call_instr(rv_cpu_t *cpu, rv_instr_t instr)
 {
     switch (cpu->priv_mode) {
@@ -187,6 +218,25 @@ static rv_exc_t rv_wfi_instr(rv_cpu_t *cpu, rv_instr_t instr)
     return rv_exc_none;
 }
 
+static rv_exc_t rv_sfence_instr(rv_cpu_t *cpu, rv_instr_t instr)
+{
+    if (rv_csr_mstatus_tvm(cpu) || cpu->priv_mode < rv_smode) {
+        return rv_exc_illegal_instruction;
+    }
+
+    // rs1 == x0 flushes all addresses, rs2 == x0 flushes all address spaces
+    bool all_asids = instr.r.rs2 == 0;
+    unsigned int asid = cpu->regs[instr.r.rs2] & rv_asid_mask;
+
+    if (instr.r.rs1 == 0) {
+        rv_tlb_flush_by_asid(cpu, asid, all_asids);
+    } else {
+        rv_tlb_flush_by_addr(cpu, asid, cpu->regs[instr.r.rs1], all_asids);
+    }
+
+    return rv_exc_none;
+}
+
 // Note: csrrw reads with rd = x0 shall not read the CSR and shall not have any side-efects based on the read
 //       similarly, csrrs and csrrc writes with rs1 = x0 (or uimm = 0) shall not write anything
 
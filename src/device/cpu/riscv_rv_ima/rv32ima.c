@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V RV32IMA processor
+ *
+ */
+
+#define XLEN 32
+
+#include "core.c"
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V RV64IMA processor
+ *
+ */
+
+#define XLEN 64
+
+#include "core.c"
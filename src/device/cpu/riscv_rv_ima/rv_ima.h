@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V RV32IMA/RV64IMA processor core interface
+ *
+ * The interface does not depend on XLEN, so the devices can use both
+ * specialized builds of the core at once. The processor structures
+ * are opaque outside of the core.
+ *
+ */
+
+#ifndef RISCV_RV_IMA_H_
+#define RISCV_RV_IMA_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../general_cpu.h"
+
+struct rv32_cpu;
+struct rv64_cpu;
+struct memusage;
+
+/** CSR state of an RV32 hart (array fields and scalar fields) */
+#define RV32_STATE_CSRS(array, scalar) \
+    array(uint64_t, hpmcounters, 29) \
+    array(uint32_t, hpmevents, 29) \
+    array(uint8_t, pmpcfgs, 64) \
+    array(uint32_t, pmpaddrs, 64) \
+    scalar(uint64_t, cycle) \
+    scalar(uint64_t, instret) \
+    scalar(uint32_t, misa) \
+    scalar(uint32_t, mvendorid) \
+    scalar(uint32_t, marchid) \
+    scalar(uint32_t, mimpid) \
+    scalar(uint32_t, mhartid) \
+    scalar(uint32_t, mconfigptr) \
+    scalar(uint64_t, mstatus) \
+    scalar(uint32_t, mtvec) \
+    scalar(uint32_t, medeleg) \
+    scalar(uint32_t, mideleg) \
+    scalar(uint32_t, mip) \
+    scalar(uint32_t, mie) \
+    scalar(uint32_t, mscratch) \
+    scalar(uint32_t, mepc) \
+    scalar(uint32_t, mcause) \
+    scalar(uint32_t, mtval) \
+    scalar(uint32_t, mcounteren) \
+    scalar(uint32_t, mcountinhibit) \
+    scalar(uint64_t, menvcfg) \
+    scalar(uint32_t, mseccfg) \
+    scalar(uint32_t, mcontext) \
+    scalar(uint32_t, stvec) \
+    scalar(uint32_t, scounteren) \
+    scalar(uint32_t, sscratch) \
+    scalar(uint32_t, sepc) \
+    scalar(uint32_t, scause) \
+    scalar(uint32_t, stval) \
+    scalar(uint32_t, senvcfg) \
+    scalar(uint32_t, satp) \
+    scalar(uint32_t, scontext) \
+    scalar(uint32_t, tval_next) \
+    scalar(bool, external_SEIP) \
+    scalar(uint64_t, mtime) \
+    scalar(uint64_t, last_tick_time) \
+    scalar(uint64_t, mtimecmp) \
+    scalar(uint32_t, scyclecmp) \
+    scalar(bool, external_STIP) \
+    scalar(unsigned int, asid_len)
+
+#define RV32_STATE_ARRAY(type, name, count) type name[count];
+#define RV32_STATE_SCALAR(type, name) type name;
+
+/** Architectural state of an RV32 hart
+ *
+ * Used to exchange the state between the RV32 build of the core
+ * and the rv32ima processor (the lock-step shadow), the layouts of
+ * their processor structures differ.
+ */
+typedef struct {
+    uint32_t regs[32];
+    uint32_t pc;
+    unsigned int priv_mode;
+
+    bool reserved_valid;
+    ptr36_t reserved_addr;
+    bool stdby;
+
+    struct {
+        RV32_STATE_CSRS(RV32_STATE_ARRAY, RV32_STATE_SCALAR)
+    } csr;
+} rv32_state_t;
+
+/** RV32IMA build of the core */
+extern const cpu_ops_t rv32_cpu_ops;
+
+extern struct rv32_cpu *rv32_cpu_create(unsigned int procno);
+extern void rv32_cpu_destroy(struct rv32_cpu *cpu);
+extern void rv32_cpu_step(struct rv32_cpu *cpu);
+extern void rv32_cpu_get_state(struct rv32_cpu *cpu, rv32_state_t *state);
+extern void rv32_cpu_set_state(struct rv32_cpu *cpu, const rv32_state_t *state);
+extern void rv32_reg_dump(struct rv32_cpu *cpu);
+extern void rv32_tlb_flush(struct rv32_cpu *cpu);
+extern void rv32_memusage(struct rv32_cpu *cpu, struct memusage *usage);
+extern void rv32_cache_memusage(struct memusage *usage);
+
+/** RV64IMA build of the core */
+extern const cpu_ops_t rv64_cpu_ops;
+
+extern struct rv64_cpu *rv64_cpu_create(unsigned int procno);
+extern void rv64_cpu_destroy(struct rv64_cpu *cpu);
+extern void rv64_cpu_step(struct rv64_cpu *cpu);
+extern void rv64_reg_dump(struct rv64_cpu *cpu);
+extern void rv64_tlb_flush(struct rv64_cpu *cpu);
+extern void rv64_memusage(struct rv64_cpu *cpu, struct memusage *usage);
+extern void rv64_cache_memusage(struct memusage *usage);
+
+#endif // RISCV_RV_IMA_H_
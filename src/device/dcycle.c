@@ -69,6 +69,8 @@ static bool dcycle_init(token_t *parm, device_t *dev)
     data->addr = addr;
     data->cycle = 0;
 
+    dev_map_region(dev, addr, REGISTER_LIMIT);
+
     return true;
 }
 
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include "../arch/mmap.h"
+#include "../debug/memusage.h"
 #include "../fault.h"
 #include "../main.h"
 #include "../physmem.h"
@@ -86,6 +87,7 @@ typedef struct {
     size_t secno; /**< Sector number */
     size_t cnt; /**< Word counter */
     bool ig; /**< Interrupt pending flag */
+    bool fail_next; /**< Fail the next command (fault injection) */
 
     /* Statistics */
     uint64_t intrcount; /**< Number of interrupts */
@@ -176,11 +178,14 @@ static bool ddisk_init(token_t *parm, device_t *dev)
     data->secno = 0;
     data->cnt = 0;
     data->ig = false;
+    data->fail_next = false;
     data->intrcount = 0;
     data->cmds_read = 0;
     data->cmds_write = 0;
     data->disk_type = DISKT_NONE;
 
+    dev_map_region(dev, addr, REGISTER_LIMIT);
+
     return true;
 }
 
@@ -548,6 +553,22 @@ static void ddisk_done(device_t *dev)
     safe_free(dev->data);
 }
 
+/** Account the disk image
+ *
+ * @param dev   Device pointer
+ * @param usage Accounted memory
+ *
+ */
+static void ddisk_memusage(device_t *dev, memusage_t *usage)
+{
+    disk_data_s *data = (disk_data_s *) dev->data;
+
+    if (data->disk_type != DISKT_NONE) {
+        memusage_add_mapped(usage, MEMUSAGE_DEVICE_IMAGES, data->img,
+                data->size);
+    }
+}
+
 /** Read command implementation
  *
  * @param dev  Device pointer
@@ -666,6 +687,17 @@ static void ddisk_write32(unsigned int procno, device_t *dev, ptr36_t addr,
             return;
         }
 
+        /* Injected failure */
+        if ((data->fail_next) && (data->disk_command & (COMMAND_READ | COMMAND_WRITE))) {
+            data->fail_next = false;
+            data->disk_status = STATUS_INT | STATUS_ERROR;
+            cpu_interrupt_up(NULL, data->intno);
+            data->ig = true;
+            data->intrcount++;
+            data->cmds_error++;
+            return;
+        }
+
         /* Read command */
         if (data->disk_command & COMMAND_READ) {
             /* Reading in progress */
@@ -732,6 +764,53 @@ static void ddisk_step(device_t *dev)
     }
 }
 
+/** Make the next read or write command of a disk fail
+ *
+ * @param dev Device pointer
+ *
+ * @return False if the device is not an initialized disk
+ *
+ */
+bool ddisk_inject_error(device_t *dev)
+{
+    if (dev->type != &ddisk) {
+        return false;
+    }
+
+    disk_data_s *data = (disk_data_s *) dev->data;
+    if (data->disk_type == DISKT_NONE) {
+        return false;
+    }
+
+    data->fail_next = true;
+    return true;
+}
+
+/** Corrupt a byte of a disk image
+ *
+ * @param dev    Device pointer
+ * @param offset Offset of the byte in the image
+ * @param mask   Bits to flip
+ *
+ * @return False if the device is not an initialized disk
+ *         or the offset is out of the image
+ *
+ */
+bool ddisk_inject_corruption(device_t *dev, uint64_t offset, uint8_t mask)
+{
+    if (dev->type != &ddisk) {
+        return false;
+    }
+
+    disk_data_s *data = (disk_data_s *) dev->data;
+    if ((data->disk_type == DISKT_NONE) || (offset >= data->size)) {
+        return false;
+    }
+
+    ((uint8_t *) data->img)[offset] ^= mask;
+    return true;
+}
+
 cmd_t ddisk_cmds[] = {
     { "init",
             (fcmd_t) ddisk_init,
@@ -813,6 +892,7 @@ device_type_t ddisk = {
 
     /* Functions */
     .done = ddisk_done,
+    .memusage = ddisk_memusage,
     .step = ddisk_step,
     .read32 = ddisk_read32,
     .write32 = ddisk_write32,
@@ -16,4 +16,7 @@
 
 extern device_type_t ddisk;
 
+extern bool ddisk_inject_error(device_t *dev);
+extern bool ddisk_inject_corruption(device_t *dev, uint64_t offset, uint8_t mask);
+
 #endif
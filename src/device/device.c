@@ -27,21 +27,24 @@
 #include "ddisk.h"
 #include "device.h"
 #include "dkeyboard.h"
+#include "dlink.h"
 #include "dnomem.h"
 #include "dorder.h"
 #include "dprinter.h"
 #include "dr4kcpu.h"
+#include "drv64cpu.h"
 #include "drvcpu.h"
 #include "dtime.h"
 #include "mem.h"
 
 /** Count of device types */
-#define DEVICE_TYPE_COUNT 11
+#define DEVICE_TYPE_COUNT 13
 
 /* Implemented peripheral list */
 const device_type_t *device_types[DEVICE_TYPE_COUNT] = {
     &dr4kcpu,
     &drvcpu,
+    &drv64cpu,
     &dcycle,
     &drwm,
     &drom,
@@ -50,12 +53,43 @@ const device_type_t *device_types[DEVICE_TYPE_COUNT] = {
     &dkeyboard,
     &dnomem,
     &ddisk,
-    &dtime
+    &dtime,
+    &dlink
 };
 
 /* List of all devices */
 list_t device_list = LIST_INITIALIZER;
 
+/** Range of the physical addresses handled by the same devices */
+typedef struct {
+    ptr36_t start;
+    uint64_t end;
+
+    /** Index of the NULL-terminated device list in decoder_devices */
+    size_t first;
+} decoder_range_t;
+
+/** Address decoder of the device registers
+ *
+ * The physical address space is split into ranges where the same
+ * devices respond, so a device access calls only the devices whose
+ * register block contains the address (and the devices without a
+ * registered block). The decoder is rebuilt lazily after the device
+ * list or a register block changes.
+ *
+ */
+static bool decoder_valid = false;
+static decoder_range_t *decoder_ranges = NULL;
+static size_t decoder_range_count = 0;
+static device_t **decoder_devices = NULL;
+
+/** Devices for the addresses outside of all ranges */
+static size_t decoder_outside = 0;
+
+/** Any device implements the writes (the result of devmem writes) */
+static bool decoder_write32 = false;
+static bool decoder_write64 = false;
+
 /** Search for device type and allocates device structure
  *
  * @param type_string Exact name of device type.
@@ -99,6 +133,8 @@ device_t *alloc_device(const char *type_string, const char *device_name)
     dev->type = device_type;
     dev->name = safe_strdup(device_name);
     dev->data = NULL;
+    dev->region_addr = 0;
+    dev->region_size = 0;
     item_init(&dev->item);
 
     return dev;
@@ -117,6 +153,7 @@ void free_device(device_t *dev)
 void add_device(device_t *dev)
 {
     list_append(&device_list, &dev->item);
+    decoder_valid = false;
 }
 
 /** Test device according to the given filter condition.
@@ -306,6 +343,181 @@ device_t *dev_by_name(const char *searched_name)
 void dev_remove(device_t *device)
 {
     list_remove(&device_list, &device->item);
+    decoder_valid = false;
+}
+
+/** Register the block of physical addresses handled by a device
+ *
+ * Devices without a registered block are called for every access
+ * which does not hit the physical memory.
+ *
+ * @param dev  Device.
+ * @param addr Start of the register block.
+ * @param size Size of the register block.
+ *
+ */
+void dev_map_region(device_t *dev, ptr36_t addr, uint64_t size)
+{
+    ASSERT(dev != NULL);
+
+    dev->region_addr = addr;
+    dev->region_size = size;
+    decoder_valid = false;
+}
+
+static bool dev_has_memory_ops(const device_t *dev)
+{
+    return (dev->type->read32 != NULL) || (dev->type->read64 != NULL)
+            || (dev->type->write32 != NULL) || (dev->type->write64 != NULL);
+}
+
+static int boundary_compare(const void *a, const void *b)
+{
+    uint64_t ba = *((const uint64_t *) a);
+    uint64_t bb = *((const uint64_t *) b);
+
+    if (ba == bb) {
+        return 0;
+    }
+
+    return (ba > bb) ? 1 : -1;
+}
+
+/** Append the devices handling the given range to the decoder
+ *
+ * @return Index of the NULL-terminated list.
+ *
+ */
+static size_t decoder_add_devices(uint64_t start, uint64_t end, size_t *count)
+{
+    size_t first = *count;
+
+    device_t *dev = NULL;
+    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
+        if (!dev_has_memory_ops(dev)) {
+            continue;
+        }
+
+        bool hit = (dev->region_size == 0)
+                || ((start < dev->region_addr + dev->region_size)
+                        && (end > dev->region_addr));
+
+        if (hit) {
+            decoder_devices[(*count)++] = dev;
+        }
+    }
+
+    decoder_devices[(*count)++] = NULL;
+    return first;
+}
+
+static void decoder_build(void)
+{
+    safe_free(decoder_ranges);
+    safe_free(decoder_devices);
+
+    size_t devices = 0;
+    decoder_write32 = false;
+    decoder_write64 = false;
+
+    device_t *dev = NULL;
+    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
+        devices++;
+        decoder_write32 = decoder_write32 || (dev->type->write32 != NULL);
+        decoder_write64 = decoder_write64 || (dev->type->write64 != NULL);
+    }
+
+    /* Boundaries of the register blocks */
+    uint64_t *boundaries = safe_malloc(2 * (devices + 1) * sizeof(uint64_t));
+    size_t count = 0;
+
+    dev = NULL;
+    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
+        if ((dev_has_memory_ops(dev)) && (dev->region_size > 0)) {
+            boundaries[count++] = dev->region_addr;
+            boundaries[count++] = dev->region_addr + dev->region_size;
+        }
+    }
+
+    qsort(boundaries, count, sizeof(uint64_t), boundary_compare);
+
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++) {
+        if ((unique == 0) || (boundaries[unique - 1] != boundaries[i])) {
+            boundaries[unique++] = boundaries[i];
+        }
+    }
+
+    decoder_range_count = (unique > 0) ? unique - 1 : 0;
+    decoder_ranges = safe_malloc((decoder_range_count + 1) * sizeof(decoder_range_t));
+    decoder_devices = safe_malloc((decoder_range_count + 1) * (devices + 1) * sizeof(device_t *));
+
+    size_t used = 0;
+    decoder_outside = decoder_add_devices(0, 0, &used);
+
+    for (size_t i = 0; i < decoder_range_count; i++) {
+        decoder_ranges[i].start = boundaries[i];
+        decoder_ranges[i].end = boundaries[i + 1];
+        decoder_ranges[i].first = decoder_add_devices(boundaries[i],
+                boundaries[i + 1], &used);
+    }
+
+    safe_free(boundaries);
+    decoder_valid = true;
+}
+
+/** Find the devices handling a physical address
+ *
+ * @param addr Physical address.
+ *
+ * @return NULL-terminated list of the devices.
+ *
+ */
+device_t *const *dev_decode(ptr36_t addr)
+{
+    if (!decoder_valid) {
+        decoder_build();
+    }
+
+    size_t low = 0;
+    size_t high = decoder_range_count;
+
+    /* The last range starting at or below the address */
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+
+        if (decoder_ranges[mid].start <= addr) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if ((low > 0) && (addr < decoder_ranges[low - 1].end)) {
+        return &decoder_devices[decoder_ranges[low - 1].first];
+    }
+
+    return &decoder_devices[decoder_outside];
+}
+
+/** Any device implements 32-bit writes */
+bool dev_any_write32(void)
+{
+    if (!decoder_valid) {
+        decoder_build();
+    }
+
+    return decoder_write32;
+}
+
+/** Any device implements 64-bit writes */
+bool dev_any_write64(void)
+{
+    if (!decoder_valid) {
+        decoder_build();
+    }
+
+    return decoder_write64;
 }
 
 /** Generic help generation
@@ -18,6 +18,7 @@
 #include "../parser.h"
 
 struct device;
+struct memusage;
 
 /** Structure describing device methods.
  *
@@ -51,6 +52,9 @@ typedef struct {
     void (*write64)(unsigned int procno, struct device *dev, ptr36_t addr,
             uint64_t val);
 
+    /** Account the host memory used by the device. */
+    void (*memusage)(struct device *dev, struct memusage *usage);
+
     /**
      * An array of commands supported by the device.
      * The last command should be the LAST_CMS macro.
@@ -71,6 +75,10 @@ typedef struct device {
                      Must be unique. */
     void *data; /**< Device specific pointer where
                      internal data are stored. */
+
+    ptr36_t region_addr; /**< Start of the register block. */
+    uint64_t region_size; /**< Size of the register block, zero if the
+                               device handles any physical address. */
 } device_t;
 
 typedef enum {
@@ -109,6 +117,11 @@ extern size_t dev_count_by_partial_name(const char *prefix_name,
 
 extern bool dev_next(device_t **dev, device_filter_t filter);
 
+extern void dev_map_region(device_t *dev, ptr36_t addr, uint64_t size);
+extern device_t *const *dev_decode(ptr36_t addr);
+extern bool dev_any_write32(void);
+extern bool dev_any_write64(void);
+
 /*
  * General utilities
  */
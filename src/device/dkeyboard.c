@@ -20,6 +20,7 @@
 #include "../assert.h"
 #include "../env.h"
 #include "../fault.h"
+#include "../replay.h"
 #include "../text.h"
 #include "../utils.h"
 #include "cpu/general_cpu.h"
@@ -108,6 +109,8 @@ static bool dkeyboard_init(token_t *parm, device_t *dev)
     data->keycount = 0;
     data->overrun = 0;
 
+    dev_map_region(dev, addr, REGISTER_LIMIT);
+
     return true;
 }
 
@@ -215,7 +218,7 @@ static void keyboard_step4k(device_t *dev)
 {
     char c;
 
-    if (stdin_poll(&c)) {
+    if (replay_stdin_poll(&c)) {
         gen_key(dev, c);
     }
 }
@@ -0,0 +1,862 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Inter-instance link
+ *
+ * The link connects two simulator processes on the same host through
+ * a shared file mapping (e.g. a file in /dev/shm). The mapping holds
+ * one ring of packets for each direction. Every ring has a single
+ * producer and a single consumer, the head and tail counters are
+ * updated with atomic operations only and no locks are needed.
+ *
+ * The guest sends and receives packets by DMA. The interrupt is
+ * asserted when a packet can be received.
+ *
+ * Without synchronization the packets are delivered as soon as the
+ * peer process writes them and the timing depends on the host. With
+ * the conservative synchronization both instances meet at a barrier
+ * every quantum of simulated cycles. A packet sent in a quantum is
+ * delivered at the beginning of the next quantum of the receiver and
+ * the free space of the ring is also observed as of the end of the
+ * previous quantum, which makes the multi-node runs deterministic.
+ *
+ * The packets are not part of the replay log, an unsynchronized link
+ * therefore transfers packets only when non-determinism is enabled
+ * and the run is neither recorded nor replayed.
+ *
+ */
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "../arch/mmap.h"
+#include "../debug/memusage.h"
+#include "../fault.h"
+#include "../main.h"
+#include "../physmem.h"
+#include "../replay.h"
+#include "../text.h"
+#include "../utils.h"
+#include "cpu/general_cpu.h"
+#include "device.h"
+#include "dlink.h"
+
+/** \{ \name Register offsets */
+#define REGISTER_ADDR_LO 0 /**< DMA address (bits 0 .. 31) */
+#define REGISTER_ADDR_HI 4 /**< DMA address (bits 32 .. 35) */
+#define REGISTER_LENGTH 8 /**< Packet length */
+#define REGISTER_STATUS 12 /**< Status */
+#define REGISTER_COMMAND 12 /**< Command */
+#define REGISTER_MTU 16 /**< Maximal packet length */
+#define REGISTER_LIMIT 20 /**< Size of register block */
+/* \} */
+
+/** \{ \name Status flags */
+#define STATUS_RX 0x01 /**< A packet can be received */
+#define STATUS_TX_FULL 0x02 /**< No packet can be sent */
+#define STATUS_INT 0x04 /**< Interrupt pending */
+#define STATUS_ERROR 0x08 /**< The last command failed */
+/* \} */
+
+/** \{ \name Command flags */
+#define COMMAND_SEND 0x01 /**< Send a packet */
+#define COMMAND_RECV 0x02 /**< Receive a packet */
+#define COMMAND_INT_ACK 0x04 /**< Interrupt acknowledge */
+#define COMMAND_MASK 0x07 /**< Command mask */
+/* \} */
+
+/** \{ \name Shared mapping layout */
+#define LINK_MAGIC UINT32_C(0x4b4e4c4d) /**< "MLNK" */
+#define LINK_VERSION 1
+#define LINK_SLOTS 64 /**< Packets in each ring */
+#define LINK_MTU 1536 /**< Maximal packet length */
+/* \} */
+
+/** Number of polls before sleeping at the barrier */
+#define LINK_SPIN 1000
+
+/** Sleep between the polls at the barrier */
+#define LINK_SLEEP_NSEC 50000
+
+/** Polls before reporting that the peer is slow (about a second) */
+#define LINK_SLOW_POLLS 20000
+
+/** States of the sides of the link */
+enum link_state_e {
+    LINK_FREE, /**< Nobody has attached the side */
+    LINK_ATTACHED, /**< A simulator is using the side */
+    LINK_DETACHED /**< The simulator has finished */
+};
+
+/** Packet in the ring */
+typedef struct {
+    uint64_t quantum; /**< Quantum the packet was sent in */
+    uint32_t length; /**< Packet length */
+    uint32_t reserved;
+    uint8_t data[LINK_MTU]; /**< Packet data */
+} link_slot_t;
+
+/** Ring of one direction
+ *
+ * The head and tail are free-running counters of the sent and
+ * the received packets.
+ *
+ */
+typedef struct {
+    uint32_t head; /**< Written by the producer */
+    uint32_t tail; /**< Written by the consumer */
+    uint32_t tail_sync[2]; /**< Tail at the end of the even and odd quanta */
+    link_slot_t slots[LINK_SLOTS];
+} link_ring_t;
+
+/** Shared state of the link (zero is a valid initial state) */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t quantum; /**< Synchronization quantum agreed by the sides */
+    uint32_t state[2]; /**< State of each side */
+    uint64_t reached[2]; /**< Quantum reached by each side */
+    link_ring_t rings[2]; /**< Ring i is produced by side i */
+} link_shared_t;
+
+/** Link instance data structure */
+typedef struct {
+    /* Configuration */
+    ptr36_t addr; /**< Register block address */
+    unsigned int intno; /**< Interrupt number */
+    char *path; /**< Shared file */
+    link_shared_t *shared; /**< Shared mapping (NULL if not attached) */
+    unsigned int side; /**< Side of the link (0 or 1) */
+    uint64_t quantum; /**< Synchronization quantum (0 if disabled) */
+    uint64_t current; /**< Current quantum */
+    bool refused; /**< Unsynchronized operation has been refused */
+
+    /* Registers */
+    ptr36_t dma_ptr; /**< DMA pointer */
+    uint32_t length; /**< Packet length */
+    bool error; /**< The last command failed */
+    bool ig; /**< Interrupt pending flag */
+
+    /* Statistics */
+    uint64_t intrcount; /**< Number of interrupts */
+    uint64_t sent; /**< Number of sent packets */
+    uint64_t received; /**< Number of received packets */
+    uint64_t errors; /**< Number of failed commands */
+    uint64_t barriers; /**< Number of barriers */
+    uint64_t waits; /**< Number of barriers waiting for the peer */
+} link_data_t;
+
+/** Ring of the packets sent to the peer */
+static link_ring_t *link_tx(link_data_t *data)
+{
+    return &data->shared->rings[data->side];
+}
+
+/** Ring of the packets received from the peer */
+static link_ring_t *link_rx(link_data_t *data)
+{
+    return &data->shared->rings[1 - data->side];
+}
+
+/** Check whether a packet can be received
+ *
+ * With synchronization only the packets sent in the previous quanta
+ * are visible.
+ *
+ */
+static bool link_rx_ready(link_data_t *data)
+{
+    link_ring_t *ring = link_rx(data);
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    if (head == ring->tail) {
+        return false;
+    }
+
+    if (data->quantum == 0) {
+        return true;
+    }
+
+    return ring->slots[ring->tail % LINK_SLOTS].quantum < data->current;
+}
+
+/** Check whether the ring to the peer is full
+ *
+ * With synchronization the consumer position is taken from the end
+ * of the previous quantum.
+ *
+ */
+static bool link_tx_full(link_data_t *data)
+{
+    link_ring_t *ring = link_tx(data);
+    uint32_t tail;
+
+    if (data->quantum == 0) {
+        tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    } else {
+        tail = __atomic_load_n(&ring->tail_sync[(data->current - 1) & 1],
+                __ATOMIC_ACQUIRE);
+    }
+
+    return (ring->head - tail) >= LINK_SLOTS;
+}
+
+/** Check whether the link transfers packets
+ *
+ * Without synchronization the packet timing depends on the host
+ * scheduling, which is allowed only in the non-deterministic mode.
+ *
+ */
+static bool link_active(link_data_t *data)
+{
+    if (data->shared == NULL) {
+        return false;
+    }
+
+    if (data->quantum != 0) {
+        return true;
+    }
+
+    return (machine_nondet) && (replay_mode == REPLAY_MODE_NONE);
+}
+
+static uint32_t link_status(link_data_t *data)
+{
+    if (!link_active(data)) {
+        return 0;
+    }
+
+    uint32_t status = 0;
+
+    if (link_rx_ready(data)) {
+        status |= STATUS_RX;
+    }
+
+    if (link_tx_full(data)) {
+        status |= STATUS_TX_FULL;
+    }
+
+    if (data->ig) {
+        status |= STATUS_INT;
+    }
+
+    if (data->error) {
+        status |= STATUS_ERROR;
+    }
+
+    return status;
+}
+
+/** Copy a packet from the guest memory to the ring */
+static bool link_send(link_data_t *data)
+{
+    if ((data->length > LINK_MTU) || (link_tx_full(data))) {
+        return false;
+    }
+
+    link_ring_t *ring = link_tx(data);
+    link_slot_t *slot = &ring->slots[ring->head % LINK_SLOTS];
+
+    for (uint32_t i = 0; i < data->length; i++) {
+        slot->data[i] = physmem_read8(-1, data->dma_ptr + i, true);
+    }
+
+    slot->length = data->length;
+    slot->quantum = data->current;
+
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+    data->sent++;
+
+    return true;
+}
+
+/** Copy a packet from the ring to the guest memory */
+static bool link_receive(link_data_t *data)
+{
+    if (!link_rx_ready(data)) {
+        return false;
+    }
+
+    link_ring_t *ring = link_rx(data);
+    link_slot_t *slot = &ring->slots[ring->tail % LINK_SLOTS];
+
+    for (uint32_t i = 0; i < slot->length; i++) {
+        physmem_write8(-1, data->dma_ptr + i, slot->data[i], true);
+    }
+
+    data->length = slot->length;
+
+    __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+    data->received++;
+
+    return true;
+}
+
+/** Assert the interrupt if a packet can be received */
+static void link_update_interrupt(link_data_t *data)
+{
+    if ((!data->ig) && (link_rx_ready(data))) {
+        data->ig = true;
+        data->intrcount++;
+        cpu_interrupt_up(NULL, data->intno);
+    }
+}
+
+/** Check whether the peer has reached the given quantum */
+static bool link_peer_reached(link_data_t *data, uint64_t quantum)
+{
+    unsigned int peer = 1 - data->side;
+    uint32_t state = __atomic_load_n(&data->shared->state[peer], __ATOMIC_SEQ_CST);
+
+    if (state == LINK_DETACHED) {
+        return true;
+    }
+
+    return (state == LINK_ATTACHED)
+            && (__atomic_load_n(&data->shared->reached[peer], __ATOMIC_SEQ_CST) >= quantum);
+}
+
+/** Synchronize with the peer at the beginning of a quantum
+ *
+ * The consumer position is published for the deterministic free
+ * space checks of the peer, then the simulation waits until the
+ * peer finishes the previous quantum as well.
+ *
+ */
+static void link_barrier(device_t *dev, uint64_t quantum)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+    link_ring_t *ring = link_rx(data);
+
+    __atomic_store_n(&ring->tail_sync[(quantum - 1) & 1], ring->tail,
+            __ATOMIC_RELEASE);
+    __atomic_store_n(&data->shared->reached[data->side], quantum,
+            __ATOMIC_SEQ_CST);
+
+    data->current = quantum;
+    data->barriers++;
+
+    if (link_peer_reached(data, quantum)) {
+        return;
+    }
+
+    data->waits++;
+
+    struct timespec delay = { 0, LINK_SLEEP_NSEC };
+    uint64_t polls = 0;
+
+    while (!link_peer_reached(data, quantum)) {
+        polls++;
+
+        if (polls == LINK_SLOW_POLLS) {
+            alert("Link %s: waiting for the peer", dev->name);
+        }
+
+        if (polls > LINK_SPIN) {
+            nanosleep(&delay, NULL);
+        }
+    }
+}
+
+/** Detach from the shared mapping
+ *
+ * The side which detaches last clears the shared state so that the
+ * file can be used by the next run.
+ *
+ */
+static void link_detach(link_data_t *data)
+{
+    if (data->shared == NULL) {
+        return;
+    }
+
+    unsigned int peer = 1 - data->side;
+
+    __atomic_store_n(&data->shared->state[data->side], LINK_DETACHED,
+            __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&data->shared->state[peer], __ATOMIC_SEQ_CST) != LINK_ATTACHED) {
+        memset(data->shared, 0, sizeof(link_shared_t));
+    }
+
+    try_munmap(data->shared, sizeof(link_shared_t));
+    data->shared = NULL;
+}
+
+/** Init command implementation
+ *
+ * @param parm Command-line parameters
+ * @param dev  Device instance structure
+ *
+ * @return True if successful
+ *
+ */
+static bool dlink_init(token_t *parm, device_t *dev)
+{
+    parm_next(&parm);
+    uint64_t _addr = parm_uint_next(&parm);
+    uint64_t _intno = parm_uint_next(&parm);
+
+    if (!phys_range(_addr)) {
+        error("Physical memory address out of range");
+        return false;
+    }
+
+    if (!phys_range(_addr + (uint64_t) REGISTER_LIMIT)) {
+        error("Invalid address, registers would exceed the physical "
+              "memory range");
+        return false;
+    }
+
+    ptr36_t addr = _addr;
+
+    if (!ptr36_dword_aligned(addr)) {
+        error("Physical memory address must be 8-byte aligned");
+        return false;
+    }
+
+    if (_intno > MAX_INTRS) {
+        error("%s", txt_intnum_range);
+        return false;
+    }
+
+    /* Allocate structure */
+    link_data_t *data = safe_malloc_t(link_data_t);
+    memset(data, 0, sizeof(link_data_t));
+    dev->data = data;
+
+    data->addr = addr;
+    data->intno = _intno;
+    data->path = NULL;
+    data->shared = NULL;
+
+    dev_map_region(dev, addr, REGISTER_LIMIT);
+
+    return true;
+}
+
+/** Info command implementation
+ *
+ * @param parm Command-line parameters
+ * @param dev  Device instance structure
+ *
+ * @return True (always successful)
+ *
+ */
+static bool dlink_info(token_t *parm, device_t *dev)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+
+    printf("[address  ] [int] [side] [quantum           ] [status] [file]\n");
+
+    if (data->shared == NULL) {
+        printf("%#011" PRIx64 " %-5u %-6s %-20s %-8s %s\n",
+                data->addr, data->intno, "-", "-", "-", "(not attached)");
+        return true;
+    }
+
+    printf("%#011" PRIx64 " %-5u %-6u %-20" PRIu64 " %#-8x %s\n",
+            data->addr, data->intno, data->side, data->quantum,
+            link_status(data), data->path);
+
+    return true;
+}
+
+/** Stat command implementation
+ *
+ * @param parm Command-line parameters
+ * @param dev  Device instance structure
+ *
+ * @return True (always successful)
+ *
+ */
+static bool dlink_stat(token_t *parm, device_t *dev)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+
+    printf("[interrupts        ] [sent              ] [received          ] [errors            ]\n");
+    printf("%20" PRIu64 " %20" PRIu64 " %20" PRIu64 " %20" PRIu64 "\n",
+            data->intrcount, data->sent, data->received, data->errors);
+    printf("[barriers          ] [waits             ]\n");
+    printf("%20" PRIu64 " %20" PRIu64 "\n", data->barriers, data->waits);
+
+    return true;
+}
+
+/** Attach command implementation
+ *
+ * Map the shared file (it is created if it does not exist)
+ * and take one side of the link.
+ *
+ * @param parm Command-line parameters
+ * @param dev  Device instance structure
+ *
+ * @return True if successful
+ *
+ */
+static bool dlink_attach(token_t *parm, device_t *dev)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+    const char *const path = parm_str_next(&parm);
+    uint64_t side = parm_uint(parm);
+
+    if (side > 1) {
+        error("Side must be 0 or 1");
+        return false;
+    }
+
+    if (data->shared != NULL) {
+        error("Link already attached");
+        return false;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT, 0666);
+    if (fd == -1) {
+        io_error(path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        io_error(path);
+        close(fd);
+        return false;
+    }
+
+    if ((st.st_size == 0) && (ftruncate(fd, sizeof(link_shared_t)) != 0)) {
+        io_error(path);
+        close(fd);
+        return false;
+    }
+
+    if ((st.st_size != 0) && ((size_t) st.st_size != sizeof(link_shared_t))) {
+        error("File is not a link of a compatible version");
+        close(fd);
+        return false;
+    }
+
+    void *ptr = mmap(0, sizeof(link_shared_t), PROT_READ | PROT_WRITE,
+            MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (ptr == MAP_FAILED) {
+        io_error(path);
+        error("%s", txt_file_map_fail);
+        return false;
+    }
+
+    link_shared_t *shared = (link_shared_t *) ptr;
+
+    /* The first side initializes the header */
+    uint32_t magic = 0;
+    __atomic_compare_exchange_n(&shared->magic, &magic, LINK_MAGIC, false,
+            __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&shared->version, LINK_VERSION, __ATOMIC_SEQ_CST);
+
+    if ((magic != 0) && (magic != LINK_MAGIC)) {
+        error("File is not a link of a compatible version");
+        try_munmap(ptr, sizeof(link_shared_t));
+        return false;
+    }
+
+    uint32_t state = LINK_FREE;
+    if (!__atomic_compare_exchange_n(&shared->state[side], &state,
+                LINK_ATTACHED, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        error("Side %" PRIu64 " of the link is already used "
+              "(remove the file if it is left from a previous run)",
+                side);
+        try_munmap(ptr, sizeof(link_shared_t));
+        return false;
+    }
+
+    if (data->path != NULL) {
+        safe_free(data->path);
+    }
+
+    data->path = safe_strdup(path);
+    data->shared = shared;
+    data->side = side;
+
+    return true;
+}
+
+/** Sync command implementation
+ *
+ * Enable the conservative synchronization with the peer.
+ *
+ * @param parm Command-line parameters
+ * @param dev  Device instance structure
+ *
+ * @return True if successful
+ *
+ */
+static bool dlink_sync(token_t *parm, device_t *dev)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+    uint64_t quantum = parm_uint(parm);
+
+    if (data->shared == NULL) {
+        error("Link not attached");
+        return false;
+    }
+
+    if ((quantum == 0) || ((quantum % 4096) != 0)) {
+        error("Quantum must be a non-zero multiple of 4096 cycles");
+        return false;
+    }
+
+    if (data->quantum != 0) {
+        error("Synchronization already enabled");
+        return false;
+    }
+
+    /* Both sides have to agree on the quantum */
+    uint64_t agreed = 0;
+    if ((!__atomic_compare_exchange_n(&data->shared->quantum, &agreed,
+                quantum, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            && (agreed != quantum)) {
+        error("Quantum differs from the quantum of the peer (%" PRIu64 ")",
+                agreed);
+        return false;
+    }
+
+    data->quantum = quantum;
+    data->current = machine_steps / quantum;
+    __atomic_store_n(&data->shared->reached[data->side], data->current,
+            __ATOMIC_SEQ_CST);
+
+    return true;
+}
+
+/** Dispose link
+ *
+ * @param dev Device pointer
+ *
+ */
+static void dlink_done(device_t *dev)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+
+    link_detach(data);
+
+    if (data->path != NULL) {
+        safe_free(data->path);
+    }
+
+    safe_free(dev->data);
+}
+
+/** Account the shared mapping
+ *
+ * @param dev   Device pointer
+ * @param usage Accounted memory
+ *
+ */
+static void dlink_memusage(device_t *dev, memusage_t *usage)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+
+    if (data->shared != NULL) {
+        memusage_add_mapped(usage, MEMUSAGE_DEVICE_IMAGES, data->shared,
+                sizeof(link_shared_t));
+    }
+}
+
+/** Read command implementation
+ *
+ * @param dev  Device pointer
+ * @param addr Address of the read operation
+ * @param val  Read (returned) value
+ *
+ */
+static void dlink_read32(unsigned int procno, device_t *dev, ptr36_t addr,
+        uint32_t *val)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+
+    switch (addr - data->addr) {
+    case REGISTER_ADDR_LO:
+        *val = (uint32_t) (data->dma_ptr & UINT32_C(0xffffffff));
+        break;
+    case REGISTER_ADDR_HI:
+        *val = (uint32_t) (data->dma_ptr >> 32);
+        break;
+    case REGISTER_LENGTH:
+        *val = data->length;
+        break;
+    case REGISTER_STATUS:
+        *val = link_status(data);
+        break;
+    case REGISTER_MTU:
+        *val = LINK_MTU;
+        break;
+    }
+}
+
+/** Write command implementation
+ *
+ * @param dev  Device pointer
+ * @param addr Address of the write operation
+ * @param val  Value to write
+ *
+ */
+static void dlink_write32(unsigned int procno, device_t *dev, ptr36_t addr,
+        uint32_t val)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+
+    switch (addr - data->addr) {
+    case REGISTER_ADDR_LO:
+        data->dma_ptr &= ~((ptr36_t) UINT32_C(0xffffffff));
+        data->dma_ptr |= val;
+        break;
+    case REGISTER_ADDR_HI:
+        data->dma_ptr &= (ptr36_t) UINT32_C(0xffffffff);
+        data->dma_ptr |= ((ptr36_t) val) << 32;
+        break;
+    case REGISTER_LENGTH:
+        data->length = val;
+        break;
+    case REGISTER_COMMAND:
+        val &= COMMAND_MASK;
+
+        if (val & COMMAND_INT_ACK) {
+            data->ig = false;
+            cpu_interrupt_down(NULL, data->intno);
+        }
+
+        if ((val & (COMMAND_SEND | COMMAND_RECV)) == 0) {
+            break;
+        }
+
+        data->error = (!link_active(data))
+                || ((val & COMMAND_SEND) && (!link_send(data)))
+                || ((val & COMMAND_RECV) && (!link_receive(data)));
+
+        if (data->error) {
+            data->errors++;
+        }
+
+        break;
+    }
+}
+
+/** Synchronize and check for the received packets
+ *
+ * @param dev Device pointer
+ *
+ */
+static void dlink_step4k(device_t *dev)
+{
+    link_data_t *data = (link_data_t *) dev->data;
+
+    if (data->shared == NULL) {
+        return;
+    }
+
+    if (!link_active(data)) {
+        if (!data->refused) {
+            alert("Link %s: not synchronized, packets are not transferred "
+                  "(use the sync command or the -n option)",
+                    dev->name);
+            data->refused = true;
+        }
+
+        return;
+    }
+
+    if (data->quantum != 0) {
+        if ((machine_steps % data->quantum) != 0) {
+            return;
+        }
+
+        link_barrier(dev, machine_steps / data->quantum);
+    }
+
+    link_update_interrupt(data);
+}
+
+cmd_t dlink_cmds[] = {
+    { "init",
+            (fcmd_t) dlink_init,
+            DEFAULT,
+            DEFAULT,
+            "Initialization",
+            "Initialization",
+            REQ STR "name/link name" NEXT
+                    REQ INT "addr/register block address" NEXT
+                            REQ INT "intno/interrupt number within 0..6" END },
+    { "help",
+            (fcmd_t) dev_generic_help,
+            DEFAULT,
+            DEFAULT,
+            "Display help",
+            "Display help",
+            OPT STR "cmd/command name" END },
+    { "info",
+            (fcmd_t) dlink_info,
+            DEFAULT,
+            DEFAULT,
+            "Configuration information",
+            "Configuration information",
+            NOCMD },
+    { "stat",
+            (fcmd_t) dlink_stat,
+            DEFAULT,
+            DEFAULT,
+            "Statistics",
+            "Statistics",
+            NOCMD },
+    { "attach",
+            (fcmd_t) dlink_attach,
+            DEFAULT,
+            DEFAULT,
+            "Attach to the link shared through the file specified",
+            "Attach to the link shared through the file specified "
+            "(the file is created if it does not exist)",
+            REQ STR "fname/file name" NEXT
+                    REQ INT "side/side of the link (0 or 1)" END },
+    { "sync",
+            (fcmd_t) dlink_sync,
+            DEFAULT,
+            DEFAULT,
+            "Synchronize with the peer every quantum of cycles",
+            "Synchronize with the peer every quantum of cycles "
+            "(a multiple of 4096), both sides have to use the same quantum",
+            REQ INT "quantum/synchronization quantum" END },
+    LAST_CMD
+};
+
+/**< Dlink object structure */
+device_type_t dlink = {
+    /* Unsynchronized operation requires -n (see link_active) */
+    .nondet = false,
+
+    /* Type name and description */
+    .name = "dlink",
+    .brief = "Inter-instance link",
+    .full = "Packet link between two simulator instances through "
+            "a shared file mapping",
+
+    /* Functions */
+    .done = dlink_done,
+    .memusage = dlink_memusage,
+    .step4k = dlink_step4k,
+    .read32 = dlink_read32,
+    .write32 = dlink_write32,
+
+    /* Commands */
+    .cmds = dlink_cmds
+};
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Inter-instance link
+ *
+ */
+
+#ifndef DLINK_H_
+#define DLINK_H_
+
+#include "device.h"
+
+extern device_type_t dlink;
+
+#endif
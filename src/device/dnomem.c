@@ -110,6 +110,8 @@ static bool dnomem_init(token_t *parm, device_t *dev)
     data->mode = &access_mode_warn;
     data->register_dump = false;
 
+    dev_map_region(dev, start_addr, size);
+
     return true;
 }
 
@@ -119,6 +119,8 @@ static bool dorder_init(token_t *parm, device_t *dev)
     data->intno = _intno;
     data->cmds = 0;
 
+    dev_map_region(dev, addr, REGISTER_LIMIT);
+
     return true;
 }
 
@@ -72,6 +72,8 @@ static bool dprinter_init(token_t *parm, device_t *dev)
     data->fname = NULL;
     data->count = 0;
 
+    dev_map_region(dev, addr, REGISTER_LIMIT);
+
     return true;
 }
 
@@ -16,9 +16,12 @@
 
 #include "../debug/breakpoint.h"
 #include "../debug/debug.h"
+#include "../debug/memusage.h"
+#include "../debug/symtab.h"
 #include "../fault.h"
 #include "../main.h"
 #include "../utils.h"
+#include "cpu/cost.h"
 #include "cpu/general_cpu.h"
 #include "cpu/mips_r4000/cpu.h"
 #include "cpu/mips_r4000/debug.h"
@@ -37,7 +40,10 @@ static const cpu_ops_t r4k_cpu = {
     .convert_addr = (convert_addr_func_t) r4k_cpu_convert_addr,
     .reg_dump = (reg_dump_func_t) r4k_reg_dump,
     .set_pc = (set_pc_func_t) r4k_set_pc,
-    .sc_access = (sc_access_func_t) r4k_sc_access
+    .sc_access = (sc_access_func_t) r4k_sc_access,
+    .state = (state_func_t) r4k_state,
+    .value = (value_func_t) r4k_value,
+    .inject = (inject_func_t) r4k_inject
 };
 
 /** Initialization
@@ -244,6 +250,24 @@ static bool dr4kcpu_rd(token_t *parm, device_t *dev)
     return true;
 }
 
+/** Fpd command implementation
+ *
+ */
+static bool dr4kcpu_fpd(token_t *parm, device_t *dev)
+{
+    r4k_fpu_dump(get_r4k(dev));
+    return true;
+}
+
+/** Cost command implementation
+ *
+ */
+static bool dr4kcpu_cost(token_t *parm, device_t *dev)
+{
+    r4k_cpu_t *cpu = get_r4k(dev);
+    return cost_cmd(&cpu->cost, parm);
+}
+
 /** Goto command implementation
  *
  */
@@ -270,7 +294,13 @@ static bool dr4kcpu_goto(token_t *parm, device_t *dev)
 static bool dr4kcpu_break(token_t *parm, device_t *dev)
 {
     r4k_cpu_t *cpu = get_r4k(dev);
-    uint64_t _addr = ALIGN_DOWN(parm_uint_next(&parm), 4);
+    uint64_t _addr;
+
+    if (!symtab_parm_addr(parm, false, &_addr)) {
+        return false;
+    }
+
+    _addr = ALIGN_DOWN(_addr, 4);
 
     if (!virt_range(_addr)) {
         error("Virtual address out of range");
@@ -282,8 +312,18 @@ static bool dr4kcpu_break(token_t *parm, device_t *dev)
     // when the emulated CPU is 32bit.
     addr.ptr = UINT64_C(0xffffffff00000000) | _addr;
 
+    breakpoint_action_t action;
+    bpcond_t cond;
+
+    parm_next(&parm);
+    if (!breakpoint_parse_condition(parm, &action, &cond, r4k_regname)) {
+        return false;
+    }
+
     breakpoint_t *bp = breakpoint_init(addr,
             BREAKPOINT_KIND_SIMULATOR);
+    bp->action = action;
+    bp->cond = cond;
     list_append(&cpu->bps, &bp->item);
 
     return true;
@@ -297,7 +337,7 @@ static bool dr4kcpu_bd(token_t *parm, device_t *dev)
     r4k_cpu_t *cpu = get_r4k(dev);
     breakpoint_t *bp;
 
-    printf("[address ] [hits              ] [kind    ]\n");
+    printf("[address ] [hits              ] [matches           ] [kind    ]\n");
 
     for_each(cpu->bps, bp, breakpoint_t)
     {
@@ -305,8 +345,21 @@ static bool dr4kcpu_bd(token_t *parm, device_t *dev)
                 ? "Simulator"
                 : "Debugger";
 
-        printf("%#018" PRIx64 " %20" PRIu64 " %s\n",
-                bp->pc.ptr, bp->hits, kind);
+        printf("%#018" PRIx64 " %20" PRIu64 " %20" PRIu64 " %s",
+                bp->pc.ptr, bp->hits, bp->matches, kind);
+
+        uint64_t offset;
+        const char *name = symtab_find(bp->pc.ptr, &offset);
+        if (name != NULL) {
+            printf(" (%s+%#" PRIx64 ")", name, offset);
+        }
+
+        if (bp->kind == BREAKPOINT_KIND_SIMULATOR) {
+            printf(" ");
+            breakpoint_print_condition(bp->action, &bp->cond, r4k_regname);
+        }
+
+        printf("\n");
     }
 
     return true;
@@ -318,7 +371,13 @@ static bool dr4kcpu_bd(token_t *parm, device_t *dev)
 static bool dr4kcpu_br(token_t *parm, device_t *dev)
 {
     r4k_cpu_t *cpu = get_r4k(dev);
-    uint64_t addr = ALIGN_DOWN(parm_uint_next(&parm), 4);
+    uint64_t addr;
+
+    if (!symtab_parm_addr(parm, false, &addr)) {
+        return false;
+    }
+
+    addr = ALIGN_DOWN(addr, 4);
 
     if (!virt_range(addr)) {
         error("Virtual address out of range");
@@ -355,6 +414,14 @@ static void dr4kcpu_done(device_t *dev)
     safe_free(dev->data);
 }
 
+/** Account the host memory of the processor
+ *
+ */
+static void dr4kcpu_memusage(device_t *dev, memusage_t *usage)
+{
+    r4k_memusage(get_r4k(dev), usage);
+}
+
 /** Execute one processor step
  *
  */
@@ -429,6 +496,28 @@ cmd_t dr4kcpu_cmds[] = {
             "Dump contents of CPU general registers",
             "Dump contents of CPU general registers",
             NOCMD },
+    { "fpd",
+            (fcmd_t) dr4kcpu_fpd,
+            DEFAULT,
+            DEFAULT,
+            "Dump contents of the floating-point registers",
+            "Dump contents of the floating-point registers and FCR31",
+            NOCMD },
+    { "cost",
+            (fcmd_t) dr4kcpu_cost,
+            DEFAULT,
+            DEFAULT,
+            "Instruction cost model",
+            "Charge extra cycles to multiplications, divisions, load-use "
+            "dependencies, conditional branches mispredicted by a bimodal "
+            "predictor, atomic operations and CP0 accesses. The extra "
+            "cycles stall the processor while its counters and timers "
+            "advance. The model is enabled and disabled by on and off, "
+            "a class name (mul, div, loaduse, mispredict, amo or csr) "
+            "followed by a number sets the extra cycles of the class. "
+            "Without a parameter the model is printed.",
+            OPT STR "class/on, off or instruction class" NEXT
+                    OPT INT "cycles/extra cycles" END },
     { "goto",
             (fcmd_t) dr4kcpu_goto,
             DEFAULT,
@@ -441,8 +530,12 @@ cmd_t dr4kcpu_cmds[] = {
             DEFAULT,
             DEFAULT,
             "Add code breakpoint",
-            "Add code breakpoint",
-            REQ INT "addr/address" END },
+            "Add code breakpoint at an address or a symbol. The optional "
+            "action (stop, log or count) is taken when the optional "
+            "condition holds.",
+            REQ VAR "addr/address or symbol" NEXT
+                    OPT STR "action/stop, log or count" NEXT
+                            OPT STR "cond/condition" END },
     { "bd",
             (fcmd_t) dr4kcpu_bd,
             DEFAULT,
@@ -455,8 +548,8 @@ cmd_t dr4kcpu_cmds[] = {
             DEFAULT,
             DEFAULT,
             "Remove code breakpoint",
-            "Remove code breakpoint",
-            REQ INT "addr/address" END },
+            "Remove code breakpoint at an address or a symbol",
+            REQ VAR "addr/address or symbol" END },
     LAST_CMD
 };
 
@@ -476,6 +569,7 @@ device_type_t dr4kcpu = {
     /* Functions */
     .done = dr4kcpu_done,
     .step = dr4kcpu_step,
+    .memusage = dr4kcpu_memusage,
 
     /* Commands */
     .cmds = dr4kcpu_cmds
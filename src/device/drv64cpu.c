@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V RV64IMA device
+ *
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "../assert.h"
+#include "../debug/memusage.h"
+#include "../fault.h"
+#include "../main.h"
+#include "../utils.h"
+#include "cpu/general_cpu.h"
+#include "cpu/riscv_rv_ima/rv_ima.h"
+#include "drv64cpu.h"
+
+#define get_rv64(dev) ((struct rv64_cpu *) (((general_cpu_t *) (dev)->data)->data))
+
+/**
+ * Initialization
+ */
+static bool drv64cpu_init(token_t *parm, device_t *dev)
+{
+    unsigned int id = get_free_cpuno();
+
+    if (id == MAX_CPUS) {
+        error("Maximum CPU count exceeded (%u)", MAX_CPUS);
+        return false;
+    }
+
+    general_cpu_t *gen_cpu = safe_malloc_t(general_cpu_t);
+    gen_cpu->cpuno = id;
+    gen_cpu->data = rv64_cpu_create(id);
+    gen_cpu->type = &rv64_cpu_ops;
+
+    add_cpu(gen_cpu);
+
+    dev->data = gen_cpu;
+
+    return true;
+}
+
+/**
+ * Info command implementation
+ */
+static bool drv64cpu_info(token_t *parm, device_t *dev)
+{
+    printf("RV64IMA (processor ID: %i)\n", ((general_cpu_t *) dev->data)->cpuno);
+    return true;
+}
+
+/**
+ * RD command implementation
+ */
+static bool drv64cpu_rd(token_t *parm, device_t *dev)
+{
+    ASSERT(dev != NULL);
+
+    rv64_reg_dump(get_rv64(dev));
+    return true;
+}
+
+/**
+ * TLBFLUSH command implementation
+ */
+static bool drv64cpu_tlb_flush(token_t *parm, device_t *dev)
+{
+    ASSERT(dev != NULL);
+
+    rv64_tlb_flush(get_rv64(dev));
+    return true;
+}
+
+/**
+ * Done device operation
+ */
+static void drv64cpu_done(device_t *dev)
+{
+    rv64_cpu_destroy(get_rv64(dev));
+    safe_free(dev->data)
+}
+
+/**
+ * Host memory accounting
+ */
+static void drv64cpu_memusage(device_t *dev, memusage_t *usage)
+{
+    rv64_memusage(get_rv64(dev), usage);
+}
+
+/**
+ * Step device operation
+ */
+static void drv64cpu_step(device_t *dev)
+{
+    rv64_cpu_step(get_rv64(dev));
+}
+
+/**
+ * Device commands specification
+ */
+cmd_t drv64cpu_cmds[] = {
+    { "init",
+            (fcmd_t) drv64cpu_init,
+            DEFAULT,
+            DEFAULT,
+            "Initialization",
+            "Initialization",
+            REQ STR "pname/processor name" END },
+    { "help",
+            (fcmd_t) dev_generic_help,
+            DEFAULT,
+            DEFAULT,
+            "Display this help text",
+            "Display this help text",
+            OPT STR "cmd/command name" END },
+    { "info",
+            (fcmd_t) drv64cpu_info,
+            DEFAULT,
+            DEFAULT,
+            "Display configuration information",
+            "Display configuration information",
+            NOCMD },
+    { "rd",
+            (fcmd_t) drv64cpu_rd,
+            DEFAULT,
+            DEFAULT,
+            "Dump content of CPU general registers",
+            "Dump content of CPU general registers",
+            NOCMD },
+    { "tlbflush",
+            (fcmd_t) drv64cpu_tlb_flush,
+            DEFAULT,
+            DEFAULT,
+            "Flushes the TLB",
+            "Removes all entries from the TLB.",
+            NOCMD }
+};
+
+/**
+ * Device type specification
+ */
+device_type_t drv64cpu = {
+    .nondet = false,
+
+    .name = "drv64cpu",
+
+    .brief = "RISC-V RV64IMA processor",
+
+    .full = "RISC-V processor with 64-bit registers, supporting M and A "
+            "extensions, with support for Machine, Supervisor and User mode "
+            "and with Sv39 virtual memory support.",
+
+    .done = drv64cpu_done,
+    .step = drv64cpu_step,
+    .memusage = drv64cpu_memusage,
+
+    .cmds = drv64cpu_cmds
+};
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V RV64IMA device
+ *
+ */
+
+#ifndef DRV64CPU_H_
+#define DRV64CPU_H_
+
+#include "device.h"
+
+extern device_type_t drv64cpu;
+
+#endif // DRV64CPU_H_
@@ -17,13 +17,17 @@
 #include <string.h>
 
 #include "../assert.h"
+#include "../debug/memusage.h"
 #include "../fault.h"
 #include "../main.h"
 #include "../utils.h"
+#include "cpu/cost.h"
 #include "cpu/general_cpu.h"
 #include "cpu/riscv_rv32ima/cpu.h"
 #include "cpu/riscv_rv32ima/csr.h"
 #include "cpu/riscv_rv32ima/debug.h"
+#include "cpu/riscv_rv32ima/lockstep.h"
+#include "cpu/riscv_rv_ima/rv_ima.h"
 #include "drvcpu.h"
 
 static bool rv_convert_add_wrapper(void *cpu, ptr64_t virt, ptr36_t *phys, bool write)
@@ -46,14 +50,48 @@ static const cpu_ops_t rv_cpu = {
     .reg_dump = (reg_dump_func_t) rv_reg_dump,
 
     .set_pc = (set_pc_func_t) rv_set_pc_wrapper,
-    .sc_access = (sc_access_func_t) rv_sc_access
+    .sc_access = (sc_access_func_t) rv_sc_access,
+    .state = (state_func_t) rv_state,
+    .value = (value_func_t) rv_value,
+    .inject = (inject_func_t) rv_inject
 };
 
+/** Tells whether the device uses the specialized build of the generic core */
+static bool drvcpu_is_generic(device_t *dev)
+{
+    return ((general_cpu_t *) dev->data)->type == &rv32_cpu_ops;
+}
+
+/** Reports an error if the command needs the rv32ima core */
+static bool drvcpu_check_rv32ima(device_t *dev)
+{
+    if (drvcpu_is_generic(dev)) {
+        error("Command not supported by the generic core");
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * Initialization
  */
 static bool drvcpu_init(token_t *parm, device_t *dev)
 {
+    parm_next(&parm);
+
+    bool generic = false;
+
+    if (parm_type(parm) == tt_str) {
+        const char *core = parm_str(parm);
+
+        if (strcmp(core, "generic") == 0) {
+            generic = true;
+        } else if (strcmp(core, "rv32ima") != 0) {
+            error("Unknown core <%s>, expected rv32ima or generic", core);
+            return false;
+        }
+    }
 
     unsigned int id = get_free_cpuno();
 
@@ -62,12 +100,18 @@ static bool drvcpu_init(token_t *parm, device_t *dev)
         return false;
     }
 
-    rv_cpu_t *cpu = safe_malloc_t(rv_cpu_t);
-    rv_cpu_init(cpu, id);
     general_cpu_t *gen_cpu = safe_malloc_t(general_cpu_t);
     gen_cpu->cpuno = id;
-    gen_cpu->data = cpu;
-    gen_cpu->type = &rv_cpu;
+
+    if (generic) {
+        gen_cpu->data = rv32_cpu_create(id);
+        gen_cpu->type = &rv32_cpu_ops;
+    } else {
+        rv_cpu_t *cpu = safe_malloc_t(rv_cpu_t);
+        rv_cpu_init(cpu, id);
+        gen_cpu->data = cpu;
+        gen_cpu->type = &rv_cpu;
+    }
 
     add_cpu(gen_cpu);
 
@@ -81,7 +125,9 @@ static bool drvcpu_init(token_t *parm, device_t *dev)
  */
 static bool drvcpu_info(token_t *parm, device_t *dev)
 {
-    printf("RV32IMA (processor ID: %i)\n", ((general_cpu_t *) dev->data)->cpuno);
+    printf("RV32IMA%s (processor ID: %i)\n",
+            drvcpu_is_generic(dev) ? ", generic core" : "",
+            ((general_cpu_t *) dev->data)->cpuno);
     return true;
 }
 
@@ -92,7 +138,23 @@ static bool drvcpu_rd(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
 
-    rv_reg_dump(get_rv(dev));
+    general_cpu_t *gen_cpu = (general_cpu_t *) dev->data;
+    gen_cpu->type->reg_dump(gen_cpu->data);
+    return true;
+}
+
+/**
+ * FPD command implementation
+ */
+static bool drvcpu_fpd(token_t *parm, device_t *dev)
+{
+    ASSERT(dev != NULL);
+
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
+    rv_fp_dump(get_rv(dev));
     return true;
 }
 
@@ -103,6 +165,10 @@ static bool drvcpu_csr_dump(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
 
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
     if (parm->ttype == tt_end) {
         rv_csr_dump_reduced(get_rv(dev));
         return true;
@@ -141,6 +207,10 @@ static bool drvcpu_tr(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
 
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
     uint64_t addr = parm_uint_next(&parm);
 
     if (addr > (uint64_t) UINT32_MAX) {
@@ -158,6 +228,10 @@ static bool drvcpu_str(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
 
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
     ptr36_t root_phys = parm_uint_next(&parm);
 
     if (!IS_ALIGNED(root_phys, RV_PAGEBYTES)) {
@@ -187,6 +261,10 @@ static bool drvcpu_ptd(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
 
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
     if (parm->ttype == tt_end) {
         return rv_pagetable_dump(get_rv(dev), false);
     }
@@ -208,6 +286,10 @@ static bool drvcpu_sptd(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
 
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
     ptr36_t root_phys = parm_uint_next(&parm);
 
     if (!IS_ALIGNED(root_phys, RV_PAGEBYTES)) {
@@ -235,6 +317,10 @@ static bool drvcpu_sptd(token_t *parm, device_t *dev)
 static bool drvcpu_tlb_dump(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
+
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
     rv_tlb_dump(&get_rv(dev)->tlb);
     return true;
 }
@@ -246,6 +332,10 @@ static bool drvcpu_tlb_resize(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
 
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
     size_t new_tlb_size = parm_uint_next(&parm);
 
     if (new_tlb_size == 0) {
@@ -262,6 +352,11 @@ static bool drvcpu_tlb_flush(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
 
+    if (drvcpu_is_generic(dev)) {
+        rv32_tlb_flush(((general_cpu_t *) dev->data)->data);
+        return true;
+    }
+
     rv_tlb_t *tlb = &get_rv(dev)->tlb;
 
     rv_tlb_flush(tlb);
@@ -276,6 +371,10 @@ static bool drvcpu_set_asid_len(token_t *parm, device_t *dev)
 {
     ASSERT(dev != NULL);
 
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
     size_t new_asid_len = parm_uint_next(&parm);
 
     if (new_asid_len > rv_asid_len) {
@@ -288,22 +387,139 @@ static bool drvcpu_set_asid_len(token_t *parm, device_t *dev)
     return true;
 }
 
+/**
+ * LOCKSTEP command implementation
+ */
+static bool drvcpu_lockstep(token_t *parm, device_t *dev)
+{
+    ASSERT(dev != NULL);
+
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
+    rv_cpu_t *cpu = get_rv(dev);
+
+    if (parm_type(parm) == tt_end) {
+        rv_lockstep_info(cpu);
+        return true;
+    }
+
+    const char *mode = parm_str_next(&parm);
+
+    if (strcmp(mode, "on") == 0) {
+        rv_lockstep_engine_t engine = RV_LOCKSTEP_INTERP;
+
+        if (parm_type(parm) != tt_end) {
+            const char *name = parm_str(parm);
+
+            if (strcmp(name, "generic") == 0) {
+                engine = RV_LOCKSTEP_GENERIC;
+            } else if (strcmp(name, "interp") != 0) {
+                error("Unknown engine <%s>, expected interp or generic", name);
+                return false;
+            }
+        }
+
+        rv_lockstep_enable(cpu, engine);
+    } else if (strcmp(mode, "off") == 0) {
+        rv_lockstep_disable(cpu);
+    } else {
+        error("Expected on or off");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * MISALIGNED command implementation
+ */
+static bool drvcpu_misaligned(token_t *parm, device_t *dev)
+{
+    ASSERT(dev != NULL);
+
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
+    rv_cpu_t *cpu = get_rv(dev);
+
+    if (parm_type(parm) == tt_end) {
+        printf("Misaligned accesses %s, performed: %" PRIu64 "\n",
+                cpu->misaligned_access ? "enabled" : "trap",
+                cpu->misaligned_count);
+        return true;
+    }
+
+    const char *mode = parm_str(parm);
+
+    if (strcmp(mode, "on") == 0) {
+        cpu->misaligned_access = true;
+    } else if (strcmp(mode, "off") == 0) {
+        cpu->misaligned_access = false;
+    } else {
+        error("Expected on or off");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * COST command implementation
+ */
+static bool drvcpu_cost(token_t *parm, device_t *dev)
+{
+    ASSERT(dev != NULL);
+
+    if (!drvcpu_check_rv32ima(dev)) {
+        return false;
+    }
+
+    return cost_cmd(&get_rv(dev)->cost, parm);
+}
+
 /**
  * Done device operation
  */
 static void drvcpu_done(device_t *dev)
 {
-    rv_cpu_done(get_rv(dev));
-    safe_free(((general_cpu_t *) dev->data)->data);
+    if (drvcpu_is_generic(dev)) {
+        rv32_cpu_destroy(((general_cpu_t *) dev->data)->data);
+    } else {
+        rv_lockstep_disable(get_rv(dev));
+        rv_cpu_done(get_rv(dev));
+        safe_free(((general_cpu_t *) dev->data)->data);
+    }
+
     safe_free(dev->data)
 }
 
+/**
+ * Host memory accounting
+ */
+static void drvcpu_memusage(device_t *dev, memusage_t *usage)
+{
+    if (drvcpu_is_generic(dev)) {
+        rv32_memusage(((general_cpu_t *) dev->data)->data, usage);
+    } else {
+        rv_tlb_memusage(&get_rv(dev)->tlb, usage);
+    }
+}
+
 /**
  * Step device operation
  */
 static void drvcpu_step(device_t *dev)
 {
-    rv_cpu_step(get_rv(dev));
+    if (drvcpu_is_generic(dev)) {
+        rv32_cpu_step(((general_cpu_t *) dev->data)->data);
+    } else if (rv_lockstep_count > 0) {
+        rv_lockstep_step(get_rv(dev));
+    } else {
+        rv_cpu_step(get_rv(dev));
+    }
 }
 
 /**
@@ -315,8 +531,10 @@ cmd_t drvcpu_cmds[] = {
             DEFAULT,
             DEFAULT,
             "Initialization",
-            "Initialization",
-            REQ STR "pname/processor name" END },
+            "Initialization, the optional core parameter selects the "
+            "rv32ima core (default) or the RV32 build of the generic core",
+            REQ STR "pname/processor name" NEXT
+                    OPT STR "core/rv32ima or generic" END },
     { "help",
             (fcmd_t) dev_generic_help,
             DEFAULT,
@@ -338,6 +556,13 @@ cmd_t drvcpu_cmds[] = {
             "Dump content of CPU general registers",
             "Dump content of CPU general registers",
             NOCMD },
+    { "fpd",
+            (fcmd_t) drvcpu_fpd,
+            DEFAULT,
+            DEFAULT,
+            "Dump content of the floating-point registers",
+            "Dump content of the floating-point registers and fcsr",
+            NOCMD },
     { "csrd",
             (fcmd_t) drvcpu_csr_dump,
             DEFAULT,
@@ -402,7 +627,46 @@ cmd_t drvcpu_cmds[] = {
             DEFAULT,
             "Changes the bit-length of ASIDs",
             "Changes the number of usable bits in the ASID field of the SATP CSR, zeroes-out any deactivated bits and flushes the TLB.",
-            REQ INT "ASID length" END }
+            REQ INT "ASID length" END },
+    { "lockstep",
+            (fcmd_t) drvcpu_lockstep,
+            DEFAULT,
+            DEFAULT,
+            "Lock-step differential execution",
+            "Execute every instruction also on a shadow copy of the processor "
+            "and compare the architectural states. The first mismatch is "
+            "reported with the last executed instructions and the simulation "
+            "enters the interactive mode. The shadow is executed by the "
+            "interpreter (interp, the default) or by the RV32 build of the "
+            "generic core (generic). Without a parameter the statistics "
+            "are printed.",
+            OPT STR "mode/on or off" NEXT OPT STR "engine/interp or generic" END },
+    { "misaligned",
+            (fcmd_t) drvcpu_misaligned,
+            DEFAULT,
+            DEFAULT,
+            "Misaligned loads and stores",
+            "Perform misaligned loads and stores directly instead of raising "
+            "the address misaligned exceptions. Accesses spanning two pages "
+            "are translated as a whole. Atomic accesses still trap. Without "
+            "a parameter the number of performed misaligned accesses is "
+            "printed.",
+            OPT STR "mode/on or off" END },
+    { "cost",
+            (fcmd_t) drvcpu_cost,
+            DEFAULT,
+            DEFAULT,
+            "Instruction cost model",
+            "Charge extra cycles to multiplications, divisions, load-use "
+            "dependencies, conditional branches mispredicted by a bimodal "
+            "predictor, atomic operations and CSR accesses. The extra "
+            "cycles stall the processor while its counters and timers "
+            "advance. The model is enabled and disabled by on and off, "
+            "a class name (mul, div, loaduse, mispredict, amo or csr) "
+            "followed by a number sets the extra cycles of the class. "
+            "Without a parameter the model is printed.",
+            OPT STR "class/on, off or instruction class" NEXT
+                    OPT INT "cycles/extra cycles" END }
 };
 
 /**
@@ -419,6 +683,7 @@ device_type_t drvcpu = {
 
     .done = drvcpu_done,
     .step = drvcpu_step,
+    .memusage = drvcpu_memusage,
 
     .cmds = drvcpu_cmds
 };
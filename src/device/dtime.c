@@ -7,6 +7,11 @@
  *
  *  Time device
  *
+ * The time is either computed from the machine cycles at a configured
+ * frequency (simulated mode) or read from the host (host mode). The
+ * simulated time is deterministic and it advances with the simulated
+ * execution regardless of the speed of the host.
+ *
  */
 
 #include <inttypes.h>
@@ -18,6 +23,8 @@
 
 #include "../assert.h"
 #include "../fault.h"
+#include "../main.h"
+#include "../replay.h"
 #include "../utils.h"
 #include "device.h"
 #include "dtime.h"
@@ -29,11 +36,46 @@
 #define REGISTER_USEC 4
 #define REGISTER_LIMIT 8
 
+/** Default simulated frequency (100 MHz) */
+#define DEFAULT_FREQUENCY UINT64_C(100000000)
+
+/** Maximal simulated frequency (the microseconds must not overflow) */
+#define MAX_FREQUENCY UINT64_C(1000000000000)
+
+/** Time source */
+typedef enum {
+    DTIME_SIMULATED, /**< Machine cycles at the simulated frequency */
+    DTIME_HOST /**< Host time */
+} dtime_mode_t;
+
 /** Dtime instance data structure */
 typedef struct {
     ptr36_t addr; /**< Memory location */
+    dtime_mode_t mode; /**< Time source */
+    uint64_t frequency; /**< Simulated frequency (Hz) */
+    uint64_t epoch; /**< Simulated time at cycle 0 (seconds since the Epoch) */
 } dtime_data_t;
 
+/** Get the current time of the device
+ *
+ * @param data    Device data
+ * @param timeval Current time (returned)
+ *
+ */
+static void dtime_get(dtime_data_t *data, struct timeval *timeval)
+{
+    if (data->mode == DTIME_HOST) {
+        replay_gettimeofday(timeval);
+        return;
+    }
+
+    uint64_t sec = machine_steps / data->frequency;
+    uint64_t rem = machine_steps % data->frequency;
+
+    timeval->tv_sec = (time_t) (data->epoch + sec);
+    timeval->tv_usec = (suseconds_t) ((rem * 1000000) / data->frequency);
+}
+
 /** Init command implementation
  *
  * @param parm Command-line parameters
@@ -70,7 +112,89 @@ static bool dtime_init(token_t *parm, device_t *dev)
     dev->data = data;
 
     data->addr = addr;
+    data->frequency = DEFAULT_FREQUENCY;
+    data->epoch = 0;
+
+    /*
+     * Host time is used only when non-determinism is explicitly
+     * enabled, record and replay runs use the simulated time.
+     */
+    if ((machine_nondet) && (replay_mode == REPLAY_MODE_NONE)) {
+        data->mode = DTIME_HOST;
+    } else {
+        data->mode = DTIME_SIMULATED;
+    }
+
+    dev_map_region(dev, addr, REGISTER_LIMIT);
+
+    return true;
+}
+
+/** Mode command implementation
+ *
+ * @param parm Command-line parameters
+ * @param dev  Device instance structure
+ *
+ * @return True if successful
+ *
+ */
+static bool dtime_mode(token_t *parm, device_t *dev)
+{
+    dtime_data_t *data = (dtime_data_t *) dev->data;
+    const char *const mode = parm_str(parm);
+
+    if (strcmp(mode, "sim") == 0) {
+        data->mode = DTIME_SIMULATED;
+    } else if (strcmp(mode, "host") == 0) {
+        if (!machine_nondet) {
+            error("Host time is non-deterministic, use the -n option");
+            return false;
+        }
+
+        data->mode = DTIME_HOST;
+    } else {
+        error("Unknown mode %s, expecting sim or host.", mode);
+        return false;
+    }
+
+    return true;
+}
+
+/** Freq command implementation
+ *
+ * @param parm Command-line parameters
+ * @param dev  Device instance structure
+ *
+ * @return True if successful
+ *
+ */
+static bool dtime_freq(token_t *parm, device_t *dev)
+{
+    dtime_data_t *data = (dtime_data_t *) dev->data;
+    uint64_t frequency = parm_uint(parm);
+
+    if ((frequency == 0) || (frequency > MAX_FREQUENCY)) {
+        error("Frequency out of range 1 .. %" PRIu64 " Hz", MAX_FREQUENCY);
+        return false;
+    }
+
+    data->frequency = frequency;
+    return true;
+}
 
+/** Epoch command implementation
+ *
+ * @param parm Command-line parameters
+ * @param dev  Device instance structure
+ *
+ * @return True (always successful)
+ *
+ */
+static bool dtime_epoch(token_t *parm, device_t *dev)
+{
+    dtime_data_t *data = (dtime_data_t *) dev->data;
+
+    data->epoch = parm_uint(parm);
     return true;
 }
 
@@ -86,8 +210,10 @@ static bool dtime_info(token_t *parm, device_t *dev)
 {
     dtime_data_t *data = (dtime_data_t *) dev->data;
 
-    printf("[address ]\n");
-    printf("%#11" PRIx64 "\n", data->addr);
+    printf("[address ] [mode] [frequency ] [epoch     ]\n");
+    printf("%#11" PRIx64 " %-6s %-12" PRIu64 " %" PRIu64 "\n", data->addr,
+            (data->mode == DTIME_HOST) ? "host" : "sim", data->frequency,
+            data->epoch);
 
     return true;
 }
@@ -118,7 +244,7 @@ static void dtime_done(device_t *dev)
 
 /** Read command implementation (32 bits)
  *
- * Read host time via gettimeofday().
+ * Read the simulated or the host time.
  *
  * @param dev  Device pointer
  * @param addr Address of the read operation
@@ -137,11 +263,11 @@ static void dtime_read32(unsigned int procno, device_t *dev, ptr36_t addr, uint3
 
     switch (addr - data->addr) {
     case REGISTER_SEC:
-        gettimeofday(&timeval, NULL);
+        dtime_get(data, &timeval);
         *val = (uint32_t) timeval.tv_sec;
         break;
     case REGISTER_USEC:
-        gettimeofday(&timeval, NULL);
+        dtime_get(data, &timeval);
         *val = (uint32_t) timeval.tv_usec;
         break;
     }
@@ -149,7 +275,7 @@ static void dtime_read32(unsigned int procno, device_t *dev, ptr36_t addr, uint3
 
 /** Read command implementation (64 bits)
  *
- * Read host time via gettimeofday().
+ * Read the simulated or the host time.
  *
  * @param dev  Device pointer
  * @param addr Address of the read operation
@@ -165,13 +291,15 @@ static void dtime_read64(unsigned int procno, device_t *dev, ptr36_t addr, uint6
 
     /* Get actual time */
     struct timeval timeval;
-    uint32_t sec = (uint32_t) timeval.tv_sec;
-    uint32_t usec = (uint32_t) timeval.tv_usec;
+    uint32_t sec;
+    uint32_t usec;
 
     /* Pack the values in little-endian fashion */
     switch (addr - data->addr) {
     case REGISTER_SEC:
-        gettimeofday(&timeval, NULL);
+        dtime_get(data, &timeval);
+        sec = (uint32_t) timeval.tv_sec;
+        usec = (uint32_t) timeval.tv_usec;
         *val = ((uint64_t) sec) | ((uint64_t) usec << 32);
         break;
     }
@@ -207,21 +335,44 @@ static cmd_t dtime_cmds[] = {
             "Display device statictics",
             "display device statictics",
             NOCMD },
+    { "mode",
+            (fcmd_t) dtime_mode,
+            DEFAULT,
+            DEFAULT,
+            "Set time source",
+            "Set time source (sim for the machine cycles, host for the "
+            "host time)",
+            REQ STR "mode/time source (sim, host)" END },
+    { "freq",
+            (fcmd_t) dtime_freq,
+            DEFAULT,
+            DEFAULT,
+            "Set simulated frequency",
+            "Set the frequency of the machine cycles in the simulated mode",
+            REQ INT "freq/frequency in Hz" END },
+    { "epoch",
+            (fcmd_t) dtime_epoch,
+            DEFAULT,
+            DEFAULT,
+            "Set simulated time at cycle 0",
+            "Set the time at cycle 0 in the simulated mode",
+            REQ INT "sec/seconds since the Epoch" END },
     LAST_CMD
 };
 
 /** Dtime object structure */
 device_type_t dtime = {
-    /* Real-time device induces non-determinism */
-    .nondet = true,
+    /* Host time is allowed only in the non-deterministic mode */
+    .nondet = false,
 
     /* Type name and description */
     .name = "dtime",
     .brief = "Real-time",
-    .full = "The time device brings the host real time to the simulated "
-            "environment. One memory-mapped register allows programs"
-            "to read hosts time since the Epoch as specified in the"
-            "POSIX.",
+    .full = "The time device brings the time to the simulated "
+            "environment. One memory-mapped register allows programs "
+            "to read the time since the Epoch as specified in the "
+            "POSIX. The time is derived from the machine cycles or "
+            "taken from the host.",
 
     /* Functions */
     .done = dtime_done,
@@ -21,7 +21,10 @@
 #include <sys/types.h>
 
 #include "../arch/mmap.h"
+#include "../assert.h"
+#include "../debug/memusage.h"
 #include "../fault.h"
+#include "../machine.h"
 #include "../parser.h"
 #include "../physmem.h"
 #include "../text.h"
@@ -36,7 +39,8 @@
 const char *txt_mem_type[] = {
     "none",
     "mem",
-    "fmap"
+    "fmap",
+    "image"
 };
 
 /** Cleanup the memory
@@ -54,6 +58,7 @@ static void physmem_cleanup(physmem_area_t *area)
         // safe_free(area->trans);
         break;
     case MEMT_FMAP:
+    case MEMT_IMAGE:
         physmem_unwire(area);
         try_munmap(area->data, FRAMES2SIZE(area->count));
         // safe_free(area->trans);
@@ -174,6 +179,9 @@ static bool mem_load(token_t *parm, device_t *dev)
         return false;
     }
 
+    /* The contents are saved in a compiled machine */
+    machine_record_skip();
+
     // FIXME: invalidate binary translation
     size_t rd = fread(area->data, 1, fsize, file);
     if (rd != fsize) {
@@ -225,6 +233,11 @@ static bool mem_fill(token_t *parm, device_t *dev)
         return false;
     }
 
+    if (area->type != MEMT_FMAP) {
+        /* The contents are saved in a compiled machine */
+        machine_record_skip();
+    }
+
     // FIXME: invalidate binary translation
     memset(area->data, c, FRAMES2SIZE(area->count));
     return true;
@@ -384,15 +397,65 @@ static bool mem_generic(token_t *parm, device_t *dev)
 
     area->type = MEMT_MEM;
     area->count = SIZE2FRAMES(size);
-    area->data = safe_malloc(host_size);
-    // Set whole memory to 0
-    memset(area->data, 0, host_size);
+    // Zeroed lazily by the host (only the touched pages are committed)
+    area->data = calloc(1, host_size);
+    if (area->data == NULL) {
+        die(ERR_MEM, "Not enough memory");
+    }
     // area->trans = safe_malloc(sizeof(r4k_instr_fnc_t) * SIZE2INSTRS(host_size));
     physmem_wire(area);
 
     return true;
 }
 
+/** Map a memory area from a compiled machine
+ *
+ * The current contents of the area are replaced by a private mapping
+ * of the file, so the pages are read on the first access and copied
+ * on the first write (the file is never modified).
+ *
+ * @param dev    Memory device with a generic memory area.
+ * @param file   Compiled machine file.
+ * @param offset Offset of the area contents in the file.
+ * @param path   File name.
+ *
+ * @return True if the area has been mapped.
+ *
+ */
+bool mem_map_image(device_t *dev, FILE *file, uint64_t offset,
+        const char *path)
+{
+    physmem_area_t *area = (physmem_area_t *) dev->data;
+
+    ASSERT(area != NULL);
+    ASSERT(area->type != MEMT_NONE);
+
+    int fd = fileno(file);
+    if (fd == -1) {
+        io_error(path);
+        return false;
+    }
+
+    pfn_t count = area->count;
+    void *ptr = mmap(0, FRAMES2SIZE(count), PROT_READ | PROT_WRITE,
+            MAP_PRIVATE, fd, (off_t) offset);
+
+    if (ptr == MAP_FAILED) {
+        io_error(path);
+        error("%s", txt_file_map_fail);
+        return false;
+    }
+
+    physmem_cleanup(area);
+
+    area->type = MEMT_IMAGE;
+    area->count = count;
+    area->data = (uint8_t *) ptr;
+    physmem_wire(area);
+
+    return true;
+}
+
 /** Save command implementation
  *
  * Save the content of the memory to the file specified.
@@ -447,6 +510,19 @@ static void mem_done(device_t *dev)
     }
 }
 
+/** Account the memory contents (configured and resident)
+ *
+ */
+static void mem_memusage(device_t *dev, memusage_t *usage)
+{
+    physmem_area_t *area = (physmem_area_t *) dev->data;
+
+    if ((area != NULL) && (area->type != MEMT_NONE)) {
+        memusage_add_mapped(usage, MEMUSAGE_GUEST_RAM, area->data,
+                FRAMES2SIZE(area->count));
+    }
+}
+
 cmd_t dmem_cmds[] = {
     { "init",
             (fcmd_t) mem_init,
@@ -519,6 +595,7 @@ device_type_t drom = {
 
     /* Functions */
     .done = mem_done,
+    .memusage = mem_memusage,
 
     /* Commands */
     .cmds = dmem_cmds
@@ -535,6 +612,7 @@ device_type_t drwm = {
 
     /* Functions */
     .done = mem_done,
+    .memusage = mem_memusage,
 
     /* Commands */
     .cmds = dmem_cmds
@@ -12,9 +12,16 @@
 #ifndef MEM_H_
 #define MEM_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
 #include "device.h"
 
 extern device_type_t drom;
 extern device_type_t drwm;
 
+extern bool mem_map_image(device_t *dev, FILE *file, uint64_t offset,
+        const char *path);
+
 #endif
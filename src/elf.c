@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  ELF32 executable reader
+ *
+ * Only little-endian 32-bit files are supported, which covers both
+ * simulated architectures. The fields are decoded byte by byte, so
+ * the reader does not depend on the host byte order or on the host
+ * <elf.h>.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "assert.h"
+#include "elf.h"
+#include "fault.h"
+#include "physmem.h"
+#include "utils.h"
+
+/** Size of the file header */
+#define ELF_HEADER_SIZE 52
+
+#define ELF_CLASS_32 1
+#define ELF_DATA_LSB 1
+
+/** Size of a symbol table entry */
+#define ELF_SYMBOL_SIZE 16
+
+/** Special section indices */
+#define ELF_SECTION_UNDEF 0
+#define ELF_SECTION_ABS 0xfff1
+
+static uint16_t get16(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *data)
+{
+    return get16(data) | ((uint32_t) get16(data + 2) << 16);
+}
+
+/** Read data from the ELF file
+ *
+ * @param elf    Opened ELF file.
+ * @param offset File offset of the data.
+ * @param buf    Buffer for the data.
+ * @param size   Size of the data.
+ *
+ * @return True if all the data were read.
+ *
+ */
+bool elf_read(elf_t *elf, uint32_t offset, void *buf, size_t size)
+{
+    ASSERT(elf != NULL);
+    ASSERT(elf->file != NULL);
+
+    if (fseek(elf->file, (long) offset, SEEK_SET) != 0) {
+        io_error(elf->path);
+        return false;
+    }
+
+    if (fread(buf, 1, size, elf->file) != size) {
+        error("Unexpected end of file (%s)", elf->path);
+        return false;
+    }
+
+    return true;
+}
+
+static bool elf_read_segments(elf_t *elf, uint16_t phentsize)
+{
+    if ((elf->segment_count > 0) && (phentsize < ELF_SEGMENT_HEADER_SIZE)) {
+        error("Invalid program header size (%s)", elf->path);
+        return false;
+    }
+
+    elf->segments = safe_malloc(sizeof(elf_segment_t) * (elf->segment_count + 1));
+
+    for (unsigned int i = 0; i < elf->segment_count; i++) {
+        uint8_t data[ELF_SEGMENT_HEADER_SIZE];
+
+        if (!elf_read(elf, elf->phoff + i * phentsize, data, sizeof(data))) {
+            return false;
+        }
+
+        elf_segment_t *segment = &elf->segments[i];
+        segment->type = get32(data);
+        segment->offset = get32(data + 4);
+        segment->vaddr = get32(data + 8);
+        segment->paddr = get32(data + 12);
+        segment->filesz = get32(data + 16);
+        segment->memsz = get32(data + 20);
+        segment->flags = get32(data + 24);
+        segment->align = get32(data + 28);
+
+        if (segment->filesz > segment->memsz) {
+            error("Segment %u is larger in the file than in the memory (%s)",
+                    i, elf->path);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool elf_read_sections(elf_t *elf, uint16_t shentsize)
+{
+    if ((elf->section_count > 0) && (shentsize < ELF_SECTION_HEADER_SIZE)) {
+        error("Invalid section header size (%s)", elf->path);
+        return false;
+    }
+
+    elf->sections = safe_malloc(sizeof(elf_section_t) * (elf->section_count + 1));
+
+    for (unsigned int i = 0; i < elf->section_count; i++) {
+        uint8_t data[ELF_SECTION_HEADER_SIZE];
+
+        if (!elf_read(elf, elf->shoff + i * shentsize, data, sizeof(data))) {
+            return false;
+        }
+
+        elf_section_t *section = &elf->sections[i];
+        section->name = get32(data);
+        section->type = get32(data + 4);
+        section->flags = get32(data + 8);
+        section->addr = get32(data + 12);
+        section->offset = get32(data + 16);
+        section->size = get32(data + 20);
+        section->link = get32(data + 24);
+        section->info = get32(data + 28);
+        section->addralign = get32(data + 32);
+        section->entsize = get32(data + 36);
+    }
+
+    return true;
+}
+
+/** Open an ELF file and read its headers
+ *
+ * Errors are reported to the user.
+ *
+ * @param elf  ELF file structure to initialize.
+ * @param path Path to the file.
+ *
+ * @return True if the file is a valid ELF32 file.
+ *
+ */
+bool elf_open(elf_t *elf, const char *path)
+{
+    ASSERT(elf != NULL);
+    ASSERT(path != NULL);
+
+    memset(elf, 0, sizeof(elf_t));
+
+    elf->file = try_fopen(path, "rb");
+    if (elf->file == NULL) {
+        return false;
+    }
+
+    elf->path = safe_strdup(path);
+
+    uint8_t header[ELF_HEADER_SIZE];
+
+    if (!elf_read(elf, 0, header, sizeof(header))) {
+        elf_close(elf);
+        return false;
+    }
+
+    if (memcmp(header, "\177ELF", 4) != 0) {
+        error("Not an ELF file (%s)", path);
+        elf_close(elf);
+        return false;
+    }
+
+    if ((header[4] != ELF_CLASS_32) || (header[5] != ELF_DATA_LSB)) {
+        error("Only little-endian 32-bit ELF files are supported (%s)", path);
+        elf_close(elf);
+        return false;
+    }
+
+    elf->type = get16(header + 16);
+    elf->machine = get16(header + 18);
+    elf->entry = get32(header + 24);
+    elf->phoff = get32(header + 28);
+    elf->shoff = get32(header + 32);
+    elf->segment_count = get16(header + 44);
+    elf->section_count = (elf->shoff != 0) ? get16(header + 48) : 0;
+
+    if (!elf_read_segments(elf, get16(header + 42))) {
+        elf_close(elf);
+        return false;
+    }
+
+    if (!elf_read_sections(elf, get16(header + 46))) {
+        elf_close(elf);
+        return false;
+    }
+
+    return true;
+}
+
+/** Close the ELF file and release its structures */
+void elf_close(elf_t *elf)
+{
+    ASSERT(elf != NULL);
+
+    if (elf->file != NULL) {
+        safe_fclose(elf->file, elf->path);
+        elf->file = NULL;
+    }
+
+    safe_free(elf->segments);
+    safe_free(elf->sections);
+    safe_free(elf->path);
+    elf->segment_count = 0;
+    elf->section_count = 0;
+}
+
+/** Extend a 32-bit address to the address used by the processor
+ *
+ * The MIPS processors work with sign-extended 64-bit addresses.
+ *
+ */
+uint64_t elf_virt(const elf_t *elf, uint32_t addr)
+{
+    if (elf->machine == ELF_MACHINE_MIPS) {
+        return (uint64_t) (int64_t) (int32_t) addr;
+    }
+
+    return addr;
+}
+
+/** Physical address of a segment
+ *
+ * MIPS kernels are usually linked for KSEG0 or KSEG1 with the physical
+ * address equal to the virtual one. Such addresses are translated
+ * the same way as the processor translates them.
+ *
+ */
+ptr36_t elf_segment_phys(const elf_t *elf, const elf_segment_t *segment)
+{
+    if ((elf->machine == ELF_MACHINE_MIPS) && (segment->paddr >= UINT32_C(0x80000000))
+            && (segment->paddr < UINT32_C(0xc0000000))) {
+        return segment->paddr & UINT32_C(0x1fffffff);
+    }
+
+    return segment->paddr;
+}
+
+/** Load the segments into the physical memory
+ *
+ * The content of the loadable segments is read from the file directly
+ * into the memory areas (frame by frame, without an intermediate
+ * buffer), the rest of each segment is zeroed. The memory areas
+ * must already exist, read-only areas are written as well.
+ *
+ * @return False if a segment is not backed by memory or the file
+ *         cannot be read.
+ *
+ */
+bool elf_load_segments(elf_t *elf)
+{
+    ASSERT(elf != NULL);
+
+    for (unsigned int i = 0; i < elf->segment_count; i++) {
+        elf_segment_t *segment = &elf->segments[i];
+
+        if ((segment->type != ELF_SEGMENT_LOAD) || (segment->memsz == 0)) {
+            continue;
+        }
+
+        ptr36_t addr = elf_segment_phys(elf, segment);
+
+        if ((segment->filesz > 0)
+                && (fseek(elf->file, (long) segment->offset, SEEK_SET) != 0)) {
+            io_error(elf->path);
+            return false;
+        }
+
+        for (uint32_t pos = 0; pos < segment->memsz;) {
+            frame_t *frame = physmem_find_frame(addr + pos);
+
+            if (frame == NULL) {
+                error("Segment %u is not backed by memory at %#011" PRIx64
+                      " (%s)",
+                        i, addr + pos, elf->path);
+                return false;
+            }
+
+            uint8_t *data = frame->data + ((addr + pos) & FRAME_MASK);
+            uint32_t chunk = FRAME_SIZE - ((addr + pos) & FRAME_MASK);
+            if (chunk > segment->memsz - pos) {
+                chunk = segment->memsz - pos;
+            }
+
+            uint32_t from_file = 0;
+            if (pos < segment->filesz) {
+                from_file = segment->filesz - pos;
+                from_file = (from_file > chunk) ? chunk : from_file;
+
+                if (fread(data, 1, from_file, elf->file) != from_file) {
+                    error("Unexpected end of file (%s)", elf->path);
+                    return false;
+                }
+            }
+
+            memset(data + from_file, 0, chunk - from_file);
+
+            /* Invalidate binary translation */
+            frame->valid = false;
+
+            pos += chunk;
+        }
+    }
+
+    return true;
+}
+
+/** Check whether a symbol names a code or data location
+ *
+ * Section and file symbols, absolute values and the local labels and
+ * mapping symbols generated by assemblers ($x, $d, .L...) are skipped.
+ *
+ */
+static bool elf_symbol_useful(const char *name, uint8_t type, uint16_t shndx)
+{
+    if ((type != ELF_SYMBOL_NOTYPE) && (type != ELF_SYMBOL_OBJECT)
+            && (type != ELF_SYMBOL_FUNC)) {
+        return false;
+    }
+
+    if ((shndx == ELF_SECTION_UNDEF) || (shndx == ELF_SECTION_ABS)) {
+        return false;
+    }
+
+    return (name[0] != 0) && (name[0] != '$') && (strncmp(name, ".L", 2) != 0);
+}
+
+/** Read the symbol table
+ *
+ * Only the symbols naming code or data locations are returned.
+ * A file without a symbol table yields an empty array.
+ *
+ * @param elf     Opened ELF file.
+ * @param symbols Returned array of the symbols (release with
+ *                elf_free_symbols).
+ * @param count   Returned number of the symbols.
+ *
+ * @return False if the symbol table is damaged.
+ *
+ */
+bool elf_read_symbols(elf_t *elf, elf_symbol_t **symbols, size_t *count)
+{
+    ASSERT(elf != NULL);
+    ASSERT(symbols != NULL);
+    ASSERT(count != NULL);
+
+    *symbols = NULL;
+    *count = 0;
+
+    elf_section_t *symtab = NULL;
+
+    for (unsigned int i = 0; i < elf->section_count; i++) {
+        if (elf->sections[i].type == ELF_SECTION_SYMTAB) {
+            symtab = &elf->sections[i];
+            break;
+        }
+    }
+
+    if (symtab == NULL) {
+        return true;
+    }
+
+    if (symtab->link >= elf->section_count) {
+        error("Invalid string table of the symbol table (%s)", elf->path);
+        return false;
+    }
+
+    elf_section_t *strtab = &elf->sections[symtab->link];
+    size_t entries = symtab->size / ELF_SYMBOL_SIZE;
+
+    uint8_t *table = safe_malloc(symtab->size + 1);
+    char *strings = safe_malloc(strtab->size + 1);
+
+    if ((!elf_read(elf, symtab->offset, table, symtab->size))
+            || (!elf_read(elf, strtab->offset, strings, strtab->size))) {
+        safe_free(table);
+        safe_free(strings);
+        return false;
+    }
+
+    /* Make sure the last string is terminated */
+    strings[strtab->size] = 0;
+
+    *symbols = safe_malloc(sizeof(elf_symbol_t) * (entries + 1));
+
+    for (size_t i = 0; i < entries; i++) {
+        const uint8_t *entry = table + i * ELF_SYMBOL_SIZE;
+        uint32_t name = get32(entry);
+        uint8_t type = entry[12] & 0x0f;
+        uint16_t shndx = get16(entry + 14);
+
+        if ((name >= strtab->size)
+                || (!elf_symbol_useful(strings + name, type, shndx))) {
+            continue;
+        }
+
+        elf_symbol_t *symbol = &(*symbols)[*count];
+        symbol->name = safe_strdup(strings + name);
+        symbol->value = get32(entry + 4);
+        symbol->size = get32(entry + 8);
+        symbol->type = type;
+        (*count)++;
+    }
+
+    safe_free(table);
+    safe_free(strings);
+    return true;
+}
+
+/** Release symbols returned by elf_read_symbols */
+void elf_free_symbols(elf_symbol_t *symbols, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        safe_free(symbols[i].name);
+    }
+
+    safe_free(symbols);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  ELF32 executable reader
+ *
+ */
+
+#ifndef ELF_H_
+#define ELF_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "main.h"
+
+/** Machine types */
+#define ELF_MACHINE_MIPS 8
+#define ELF_MACHINE_RISCV 243
+
+/** File types */
+#define ELF_TYPE_EXEC 2
+#define ELF_TYPE_DYN 3
+
+/** Segment types */
+#define ELF_SEGMENT_LOAD 1
+#define ELF_SEGMENT_INTERP 3
+#define ELF_SEGMENT_PHDR 6
+
+/** Segment flags */
+#define ELF_SEGMENT_X 1
+#define ELF_SEGMENT_W 2
+#define ELF_SEGMENT_R 4
+
+/** Size of a program header */
+#define ELF_SEGMENT_HEADER_SIZE 32
+
+/** Section types */
+#define ELF_SECTION_SYMTAB 2
+
+/** Size of a section header */
+#define ELF_SECTION_HEADER_SIZE 40
+
+/** Symbol types */
+#define ELF_SYMBOL_NOTYPE 0
+#define ELF_SYMBOL_OBJECT 1
+#define ELF_SYMBOL_FUNC 2
+
+/** Program header */
+typedef struct {
+    uint32_t type;
+    uint32_t offset;
+    uint32_t vaddr;
+    uint32_t paddr;
+    uint32_t filesz;
+    uint32_t memsz;
+    uint32_t flags;
+    uint32_t align;
+} elf_segment_t;
+
+/** Section header */
+typedef struct {
+    uint32_t name;
+    uint32_t type;
+    uint32_t flags;
+    uint32_t addr;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t link;
+    uint32_t info;
+    uint32_t addralign;
+    uint32_t entsize;
+} elf_section_t;
+
+/** Symbol imported from the symbol table */
+typedef struct {
+    char *name;
+    uint32_t value;
+    uint32_t size;
+    uint8_t type;
+} elf_symbol_t;
+
+/** Opened ELF file */
+typedef struct {
+    FILE *file;
+    char *path;
+
+    uint16_t type;
+    uint16_t machine;
+    uint32_t entry;
+
+    /** File offset of the program headers */
+    uint32_t phoff;
+
+    /** File offset of the section headers */
+    uint32_t shoff;
+
+    unsigned int segment_count;
+    elf_segment_t *segments;
+
+    unsigned int section_count;
+    elf_section_t *sections;
+} elf_t;
+
+extern bool elf_open(elf_t *elf, const char *path);
+extern void elf_close(elf_t *elf);
+
+extern bool elf_read(elf_t *elf, uint32_t offset, void *buf, size_t size);
+extern uint64_t elf_virt(const elf_t *elf, uint32_t addr);
+extern ptr36_t elf_segment_phys(const elf_t *elf, const elf_segment_t *segment);
+extern bool elf_load_segments(elf_t *elf);
+
+extern bool elf_read_symbols(elf_t *elf, elf_symbol_t **symbols, size_t *count);
+extern void elf_free_symbols(elf_symbol_t *symbols, size_t count);
+
+#endif
@@ -14,6 +14,7 @@
 #include <string.h>
 
 #include "assert.h"
+#include "debug/roi.h"
 #include "device/cpu/mips_r4000/cpu.h"
 #include "device/cpu/mips_r4000/debug.h"
 #include "device/cpu/riscv_rv32ima/debug.h"
@@ -210,6 +211,22 @@ const env_t global_env[] = {
             vt_bool,
             &machine_trace,
             NULL },
+    { "profile",
+            "Count executed instructions per address",
+            "Count how many times each instruction has been executed. "
+            "The most frequent instructions are printed at the end of "
+            "the region of interest or by the profile command.",
+            vt_bool,
+            &machine_profile,
+            NULL },
+    { "fast",
+            "Fast-forward mode",
+            "Disable tracing, profiling and processor statistics until "
+            "the guest enters the region of interest. The instrumentation "
+            "settings are restored when leaving the fast-forward mode.",
+            vt_bool,
+            &machine_fast,
+            roi_set_fast },
     LAST_ENV
 };
 
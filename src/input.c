@@ -24,6 +24,7 @@
 #include "input.h"
 #include "main.h"
 #include "parser.h"
+#include "replay.h"
 #include "utils.h"
 
 #define PROMPT ("[" PACKAGE_NAME "] ")
@@ -151,9 +152,25 @@ void interactive_control(void)
     stepping = 0;
 
     while (machine_interactive) {
-        input_back();
-        char *cmdline = readline(PROMPT);
-        input_shadow();
+        char *cmdline;
+
+        if (replay_mode == REPLAY_MODE_REPLAY) {
+            /* Commands recorded at this cycle */
+            cmdline = replay_command();
+            if (cmdline != NULL) {
+                printf("%s%s\n", PROMPT, cmdline);
+            } else {
+                alert("Replay: No more commands recorded");
+            }
+        } else {
+            input_back();
+            cmdline = readline(PROMPT);
+            input_shadow();
+
+            if (cmdline) {
+                replay_record_command(cmdline);
+            }
+        }
 
         if (!cmdline) {
             /* User break in readline */
@@ -180,7 +197,7 @@ void interactive_control(void)
  */
 int input_is_terminal(void)
 {
-    return input_term;
+    return replay_is_terminal(input_term);
 }
 
 void input_end(void)
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Precompiled machine descriptions
+ *
+ * A configuration script is compiled by running it and saving the
+ * resulting machine into a binary file which can be used as the
+ * configuration file later. The file contains
+ *
+ *  - the configuration commands which have been interpreted
+ *    successfully (the commands setting the contents of the
+ *    generic memory areas are left out as empty lines),
+ *  - the contents of the generic memory areas.
+ *
+ * When the file is used, the commands are interpreted to create the
+ * devices and the memory areas are mapped from the file (privately,
+ * the file is never modified). No memory image is read or copied
+ * until the simulated machine touches it, so even large machines
+ * start instantly.
+ *
+ * The file layout (all numbers in the host byte order):
+ *
+ *   header   magic "MSIMMACH", version, byte order mark,
+ *            script length, number of areas
+ *   script   configuration commands
+ *   areas    for each area: start, size, offset in the file,
+ *            device name length, device name
+ *   images   area contents, aligned to MACHINE_ALIGN
+ *
+ * The frames containing only zeros are not written, so the file
+ * is sparse on the file systems supporting it.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assert.h"
+#include "device/device.h"
+#include "device/mem.h"
+#include "fault.h"
+#include "machine.h"
+#include "physmem.h"
+#include "utils.h"
+
+#define MACHINE_MAGIC "MSIMMACH"
+#define MACHINE_MAGIC_SIZE 8
+#define MACHINE_VERSION 1
+
+/** Byte order mark */
+#define MACHINE_ENDIAN UINT32_C(0x01020304)
+
+/** Alignment of the memory images (mapping granularity on all hosts) */
+#define MACHINE_ALIGN 65536
+
+/** Maximal length of a device name */
+#define MACHINE_NAME_LENGTH 256
+
+/** Configuration commands are being recorded */
+bool machine_compiling = false;
+
+/** Recorded configuration commands */
+static string_t compiled_script;
+
+/** The current command sets memory contents only */
+static bool skip_command = false;
+
+/** Start recording of the configuration commands
+ *
+ */
+void machine_compile_start(void)
+{
+    string_init(&compiled_script);
+    machine_compiling = true;
+}
+
+/** Record a configuration command
+ *
+ * @param line   Command line (not necessarily terminated).
+ * @param length Length of the command line.
+ *
+ */
+void machine_record(const char *line, size_t length)
+{
+    ASSERT(line != NULL);
+
+    if (!machine_compiling) {
+        return;
+    }
+
+    if ((length > 0) && (line[length - 1] == '\n')) {
+        length--;
+    }
+
+    /* Keep the line numbers of the script */
+    if (skip_command) {
+        length = 0;
+    }
+
+    string_printf(&compiled_script, "%.*s\n", (int) length, line);
+    skip_command = false;
+}
+
+/** Leave out the current command from the compiled script
+ *
+ * Used by the commands whose only effect is the contents
+ * of a generic memory area, which is saved as a whole.
+ *
+ */
+void machine_record_skip(void)
+{
+    skip_command = machine_compiling;
+}
+
+/** Stop recording of the configuration commands
+ *
+ */
+void machine_compile_done(void)
+{
+    if (machine_compiling) {
+        string_done(&compiled_script);
+        machine_compiling = false;
+    }
+}
+
+static bool write_data(FILE *file, const void *data, size_t size,
+        const char *path)
+{
+    if (fwrite(data, 1, size, file) != size) {
+        io_error(path);
+        return false;
+    }
+
+    return true;
+}
+
+static bool write_uint32(FILE *file, uint32_t val, const char *path)
+{
+    return write_data(file, &val, sizeof(val), path);
+}
+
+static bool write_uint64(FILE *file, uint64_t val, const char *path)
+{
+    return write_data(file, &val, sizeof(val), path);
+}
+
+static bool seek_data(FILE *file, long offset, int whence, const char *path)
+{
+    if (fseek(file, offset, whence) != 0) {
+        io_error(path);
+        return false;
+    }
+
+    return true;
+}
+
+static bool read_data(FILE *file, void *data, size_t size, const char *path)
+{
+    if (fread(data, 1, size, file) != size) {
+        error("Compiled machine \"%s\" is truncated", path);
+        return false;
+    }
+
+    return true;
+}
+
+static bool read_uint32(FILE *file, uint32_t *val, const char *path)
+{
+    return read_data(file, val, sizeof(*val), path);
+}
+
+static bool read_uint64(FILE *file, uint64_t *val, const char *path)
+{
+    return read_data(file, val, sizeof(*val), path);
+}
+
+/** Generic memory area of a device
+ *
+ * The areas mapped from a compiled machine are generic as well,
+ * so a compiled machine can be compiled again.
+ *
+ * @return The area or NULL if the device has no generic memory.
+ *
+ */
+static physmem_area_t *machine_area(device_t *dev)
+{
+    physmem_area_t *area = (physmem_area_t *) dev->data;
+
+    if ((area == NULL)
+            || ((area->type != MEMT_MEM) && (area->type != MEMT_IMAGE))) {
+        return NULL;
+    }
+
+    return area;
+}
+
+/** Write the contents of a memory area, leaving holes for zero frames
+ *
+ */
+static bool write_area(FILE *file, physmem_area_t *area, const char *path)
+{
+    static const uint8_t zero[FRAME_SIZE];
+    bool hole = false;
+
+    for (pfn_t pfn = 0; pfn < area->count; pfn++) {
+        const uint8_t *frame = area->data + FRAMES2SIZE(pfn);
+
+        if (memcmp(frame, zero, FRAME_SIZE) == 0) {
+            if (!seek_data(file, FRAME_SIZE, SEEK_CUR, path)) {
+                return false;
+            }
+
+            hole = true;
+            continue;
+        }
+
+        if (!write_data(file, frame, FRAME_SIZE, path)) {
+            return false;
+        }
+
+        hole = false;
+    }
+
+    /* Extend the file over the trailing hole */
+    if (hole) {
+        if ((!seek_data(file, -1, SEEK_CUR, path))
+                || (!write_data(file, zero, 1, path))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** Write the compiled machine
+ *
+ * @param path File name.
+ *
+ * @return True if the file has been written.
+ *
+ */
+bool machine_compile_write(const char *path)
+{
+    ASSERT(path != NULL);
+    ASSERT(machine_compiling);
+
+    uint32_t areas = 0;
+    size_t table_size = 0;
+
+    device_t *dev = NULL;
+    while (dev_next(&dev, DEVICE_FILTER_MEMORY)) {
+        if (machine_area(dev) != NULL) {
+            areas++;
+            table_size += 3 * sizeof(uint64_t) + sizeof(uint32_t)
+                    + strlen(dev->name);
+        }
+    }
+
+    FILE *file = try_fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    uint64_t script_length = compiled_script.pos;
+    bool ok = (write_data(file, MACHINE_MAGIC, MACHINE_MAGIC_SIZE, path))
+            && (write_uint32(file, MACHINE_VERSION, path))
+            && (write_uint32(file, MACHINE_ENDIAN, path))
+            && (write_uint64(file, script_length, path))
+            && (write_uint32(file, areas, path))
+            && (write_data(file, compiled_script.str, script_length, path));
+
+    /* Area table */
+    uint64_t offset = MACHINE_MAGIC_SIZE + 3 * sizeof(uint32_t)
+            + sizeof(uint64_t) + script_length + table_size;
+
+    dev = NULL;
+    while ((ok) && (dev_next(&dev, DEVICE_FILTER_MEMORY))) {
+        physmem_area_t *area = machine_area(dev);
+        if (area == NULL) {
+            continue;
+        }
+
+        uint32_t name_length = strlen(dev->name);
+        offset = ALIGN_UP(offset, MACHINE_ALIGN);
+
+        ok = (write_uint64(file, FRAME2ADDR(area->start), path))
+                && (write_uint64(file, FRAMES2SIZE(area->count), path))
+                && (write_uint64(file, offset, path))
+                && (write_uint32(file, name_length, path))
+                && (write_data(file, dev->name, name_length, path));
+
+        offset += FRAMES2SIZE(area->count);
+    }
+
+    /* Area contents */
+    dev = NULL;
+    while ((ok) && (dev_next(&dev, DEVICE_FILTER_MEMORY))) {
+        physmem_area_t *area = machine_area(dev);
+        if (area == NULL) {
+            continue;
+        }
+
+        long pos = ftell(file);
+        ok = (pos >= 0)
+                && (seek_data(file, ALIGN_UP(pos, MACHINE_ALIGN), SEEK_SET, path))
+                && (write_area(file, area, path));
+    }
+
+    safe_fclose(file, path);
+
+    if (!ok) {
+        error("Error writing compiled machine \"%s\"", path);
+    }
+
+    return ok;
+}
+
+/** Check whether a configuration file is a compiled machine
+ *
+ * The file position is left after the magic if it is,
+ * otherwise at the beginning of the file.
+ *
+ */
+bool machine_is_compiled(FILE *file)
+{
+    ASSERT(file != NULL);
+
+    char magic[MACHINE_MAGIC_SIZE];
+    size_t rd = fread(magic, 1, MACHINE_MAGIC_SIZE, file);
+
+    if ((rd == MACHINE_MAGIC_SIZE)
+            && (memcmp(magic, MACHINE_MAGIC, MACHINE_MAGIC_SIZE) == 0)) {
+        return true;
+    }
+
+    rewind(file);
+    return false;
+}
+
+/** Number of memory areas of the compiled machine */
+static uint32_t compiled_areas = 0;
+
+/** Read the configuration commands of a compiled machine
+ *
+ * @param file   File positioned after the magic.
+ * @param path   File name.
+ * @param script Output string for the commands.
+ *
+ * @return True if the commands have been read.
+ *
+ */
+bool machine_read_script(FILE *file, const char *path, string_t *script)
+{
+    ASSERT(file != NULL);
+    ASSERT(path != NULL);
+    ASSERT(script != NULL);
+
+    uint32_t version;
+    uint32_t endian;
+    uint64_t script_length;
+
+    if ((!read_uint32(file, &version, path))
+            || (!read_uint32(file, &endian, path))
+            || (!read_uint64(file, &script_length, path))
+            || (!read_uint32(file, &compiled_areas, path))) {
+        return false;
+    }
+
+    if (version != MACHINE_VERSION) {
+        error("Unsupported version %" PRIu32 " of compiled machine \"%s\"",
+                version, path);
+        return false;
+    }
+
+    if (endian != MACHINE_ENDIAN) {
+        error("Compiled machine \"%s\" has a different byte order", path);
+        return false;
+    }
+
+    char *buf = safe_malloc(script_length + 1);
+    if (!read_data(file, buf, script_length, path)) {
+        safe_free(buf);
+        return false;
+    }
+
+    buf[script_length] = 0;
+    string_append(script, buf);
+    safe_free(buf);
+
+    return true;
+}
+
+/** Map the memory areas of a compiled machine
+ *
+ * Called after the commands of the machine have been interpreted.
+ *
+ * @param file File positioned after the commands.
+ * @param path File name.
+ *
+ * @return True if all areas have been mapped.
+ *
+ */
+bool machine_map_memory(FILE *file, const char *path)
+{
+    ASSERT(file != NULL);
+    ASSERT(path != NULL);
+
+    for (uint32_t i = 0; i < compiled_areas; i++) {
+        uint64_t start;
+        uint64_t size;
+        uint64_t offset;
+        uint32_t name_length;
+        char name[MACHINE_NAME_LENGTH];
+
+        if ((!read_uint64(file, &start, path))
+                || (!read_uint64(file, &size, path))
+                || (!read_uint64(file, &offset, path))
+                || (!read_uint32(file, &name_length, path))) {
+            return false;
+        }
+
+        if (name_length >= MACHINE_NAME_LENGTH) {
+            error("Invalid device name in compiled machine \"%s\"", path);
+            return false;
+        }
+
+        if (!read_data(file, name, name_length, path)) {
+            return false;
+        }
+
+        name[name_length] = 0;
+
+        device_t *dev = dev_by_name(name);
+        physmem_area_t *area = (dev != NULL) ? machine_area(dev) : NULL;
+
+        if ((area == NULL) || (FRAME2ADDR(area->start) != start)
+                || (FRAMES2SIZE(area->count) != size)) {
+            error("Memory area \"%s\" does not match compiled machine \"%s\"",
+                    name, path);
+            return false;
+        }
+
+        if (!mem_map_image(dev, file, offset, path)) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Precompiled machine descriptions
+ *
+ */
+
+#ifndef MACHINE_H_
+#define MACHINE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "utils.h"
+
+/** Configuration commands are being recorded */
+extern bool machine_compiling;
+
+extern void machine_compile_start(void);
+extern void machine_record(const char *line, size_t length);
+extern void machine_record_skip(void);
+extern bool machine_compile_write(const char *path);
+extern void machine_compile_done(void);
+
+extern bool machine_is_compiled(FILE *file);
+extern bool machine_read_script(FILE *file, const char *path, string_t *script);
+extern bool machine_map_memory(FILE *file, const char *path);
+
+#endif
@@ -23,6 +23,10 @@
 #include "cmd.h"
 #include "debug/breakpoint.h"
 #include "debug/gdb.h"
+#include "debug/inject.h"
+#include "debug/memusage.h"
+#include "debug/sample.h"
+#include "debug/statehash.h"
 #include "device/cpu/general_cpu.h"
 #include "device/cpu/mips_r4000/cpu.h"
 #include "device/cpu/mips_r4000/debug.h"
@@ -34,8 +38,11 @@
 #include "env.h"
 #include "fault.h"
 #include "input.h"
+#include "machine.h"
 #include "parser.h"
+#include "replay.h"
 #include "text.h"
+#include "user.h"
 #include "utils.h"
 
 /** Configuration file name */
@@ -83,6 +90,12 @@ bool machine_specific_instructions = true;
 /** Allow XINT even when terminal is not available. */
 bool machine_allow_interactive_without_tty = false;
 
+/** Fast-forward mode (instrumentation disabled) */
+bool machine_fast = false;
+
+/** Count executed instructions per address */
+bool machine_profile = false;
+
 /**
  * Number of steps to run before switching
  * to interactive mode. Zero means infinite.
@@ -93,7 +106,7 @@ uint64_t stepping = 0;
 list_t sc_list;
 
 /** Total number of machine steps completed */
-static uint64_t steps = 0;
+uint64_t machine_steps = 0;
 
 /** Command line options */
 static struct option long_options[] = {
@@ -133,9 +146,38 @@ static struct option long_options[] = {
             no_argument,
             0,
             'X' },
+    { "record",
+            required_argument,
+            0,
+            'R' },
+    { "replay",
+            required_argument,
+            0,
+            'P' },
+    { "user",
+            no_argument,
+            0,
+            'u' },
+    { "memusage",
+            required_argument,
+            0,
+            'M' },
+    { "compile",
+            required_argument,
+            0,
+            'C' },
     { NULL, 0, NULL, 0 }
 };
 
+/** User-mode emulation of a single program */
+static bool user_mode = false;
+
+/** File for the host memory usage written at exit */
+static char *memusage_file = NULL;
+
+/** File for the compiled machine */
+static char *compile_file = NULL;
+
 static void setup_remote_gdb(const char *opt)
 {
     ASSERT(opt != NULL);
@@ -163,7 +205,8 @@ static bool parse_cmdline(int argc, char *args[])
     while (true) {
         int option_index = 0;
 
-        int c = getopt_long(argc, args, "tVic:hg:nXI",
+        /* Stop at the first non-option (the arguments of a user program) */
+        int c = getopt_long(argc, args, "+tVic:hg:nXIR:P:uM:C:",
                 long_options, &option_index);
 
         if (c == -1) {
@@ -202,6 +245,36 @@ static bool parse_cmdline(int argc, char *args[])
         case 'X':
             machine_specific_instructions = false;
             break;
+        case 'R':
+            if (replay_mode != REPLAY_MODE_NONE) {
+                die(ERR_PARM, "Only one replay log can be used");
+            }
+            replay_record_open(optarg);
+            break;
+        case 'P':
+            if (replay_mode != REPLAY_MODE_NONE) {
+                die(ERR_PARM, "Only one replay log can be used");
+            }
+            replay_open(optarg);
+
+            /* All nondeterministic inputs come from the log */
+            machine_nondet = true;
+            break;
+        case 'u':
+            user_mode = true;
+            break;
+        case 'M':
+            if (memusage_file) {
+                safe_free(memusage_file);
+            }
+            memusage_file = safe_strdup(optarg);
+            break;
+        case 'C':
+            if (compile_file) {
+                safe_free(compile_file);
+            }
+            compile_file = safe_strdup(optarg);
+            break;
         case '?':
             die(ERR_PARM, "Unknown parameter or argument required");
             break;
@@ -210,10 +283,22 @@ static bool parse_cmdline(int argc, char *args[])
         }
     }
 
-    if (optind < argc) {
+    if (user_mode) {
+        if (optind >= argc) {
+            die(ERR_PARM, "Program to run in user mode expected");
+        }
+    } else if (optind < argc) {
         die(ERR_PARM, "Unexpected arguments");
     }
 
+    if ((user_mode) && (compile_file != NULL)) {
+        die(ERR_PARM, "User mode cannot be compiled");
+    }
+
+    if ((remote_gdb) && (replay_mode != REPLAY_MODE_NONE)) {
+        die(ERR_PARM, "Remote GDB cannot be combined with record or replay");
+    }
+
     return true;
 }
 
@@ -258,11 +343,26 @@ static void machine_step(void)
     }
 
     /* Increase machine cycle counter */
-    steps++;
+    machine_steps++;
+
+    /* Sampled simulation mode switch */
+    if (machine_steps == sample_next) {
+        sample_event();
+    }
+
+    /* Periodic state hashing */
+    if (machine_steps == statehash_next) {
+        statehash_event();
+    }
+
+    /* Fault injection */
+    if (machine_steps == inject_next) {
+        inject_event();
+    }
 
     /* Every 4096th cycle execute
        the step4k device functions */
-    if ((steps % 4096) == 0) {
+    if ((machine_steps % 4096) == 0) {
         dev = NULL;
         while (dev_next(&dev, DEVICE_FILTER_STEP4K)) {
             dev->type->step4k(dev);
@@ -312,6 +412,15 @@ static void machine_run(void)
             }
         }
 
+        /*
+         * Interactive commands recorded at this cycle
+         * (the simulation might have been interrupted
+         * by the user).
+         */
+        if (replay_command_pending()) {
+            machine_interactive = true;
+        }
+
         /* Interactive mode control */
         if (machine_interactive) {
             interactive_control();
@@ -344,6 +453,9 @@ static void cleanup()
         free_device(dev);
     }
     input_end();
+    replay_done();
+    statehash_stop();
+    inject_stop();
 }
 
 int main(int argc, char *args[])
@@ -367,7 +479,25 @@ int main(int argc, char *args[])
         return 0;
     }
 
-    script();
+    if (user_mode) {
+        /* The program uses the terminal in its usual mode */
+        input_back();
+        user_init(argc - optind, args + optind);
+    } else if (compile_file != NULL) {
+        /* Configure the machine, save it and exit */
+        machine_compile_start();
+        script();
+
+        bool ok = machine_compile_write(compile_file);
+        machine_compile_done();
+        safe_free(compile_file);
+
+        input_back();
+        cleanup();
+        return ok ? 0 : ERR_IO;
+    } else {
+        script();
+    }
 
     if (machine_interactive) {
         alert("MSIM %s", PACKAGE_VERSION);
@@ -383,11 +513,16 @@ int main(int argc, char *args[])
      * Finalization
      */
     input_back();
-    if (steps > 0) {
-        printf("\nCycles: %" PRIu64 "\n", steps);
+    if ((machine_steps > 0) && (!user_mode)) {
+        printf("\nCycles: %" PRIu64 "\n", machine_steps);
+    }
+
+    if (memusage_file != NULL) {
+        memusage_write(memusage_file);
+        safe_free(memusage_file);
     }
 
     cleanup();
 
-    return 0;
+    return user_mode ? user_exit_status : 0;
 }
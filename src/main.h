@@ -76,6 +76,9 @@ extern bool machine_newline;
 extern bool machine_undefined;
 extern bool machine_specific_instructions;
 extern bool machine_allow_interactive_without_tty;
+extern bool machine_fast;
+extern bool machine_profile;
 extern uint64_t stepping;
+extern uint64_t machine_steps;
 
 #endif
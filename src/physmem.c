@@ -15,6 +15,7 @@
 
 #include "assert.h"
 #include "debug/breakpoint.h"
+#include "debug/memusage.h"
 #include "device/cpu/general_cpu.h"
 #include "device/device.h"
 #include "endian.h"
@@ -372,6 +373,7 @@ void physmem_unwire(physmem_area_t *area)
 
         if (ftl1_empty) {
             safe_free(ftl1);
+            ftl0[(addr >> FTL1_SHIFT) & FTL1_MASK] = NULL;
         }
     }
 }
@@ -389,11 +391,180 @@ frame_t *physmem_find_frame(ptr36_t addr)
     return NULL;
 }
 
+/** Dirty frame tracking
+ *
+ * When enabled, the frames written since the last collection
+ * are recorded in the order of the first write.
+ *
+ */
+
+#define DIRTY_INITIAL_SIZE 256
+
+static bool dirty_tracking = false;
+
+static ptr36_t *dirty_frames = NULL;
+static size_t dirty_count = 0;
+static size_t dirty_size = 0;
+
+/** Collected frames handed over to the caller */
+static ptr36_t *dirty_collected = NULL;
+static size_t dirty_collected_size = 0;
+
+static void physmem_mark_dirty(frame_t *frame, ptr36_t addr)
+{
+    if (dirty_count == dirty_size) {
+        size_t new_size = (dirty_size == 0) ? DIRTY_INITIAL_SIZE : 2 * dirty_size;
+        ptr36_t *new_frames = safe_malloc(new_size * sizeof(ptr36_t));
+
+        if (dirty_count > 0) {
+            memcpy(new_frames, dirty_frames, dirty_count * sizeof(ptr36_t));
+        }
+
+        safe_free(dirty_frames);
+        dirty_frames = new_frames;
+        dirty_size = new_size;
+    }
+
+    frame->dirty = true;
+    dirty_frames[dirty_count++] = addr & ~((ptr36_t) FRAME_MASK);
+}
+
+/** Clear the dirty flags of the recorded frames */
+static void physmem_dirty_clear(void)
+{
+    for (size_t i = 0; i < dirty_count; i++) {
+        frame_t *frame = physmem_find_frame(dirty_frames[i]);
+
+        /* The frame might have been unwired meanwhile */
+        if (frame != NULL) {
+            frame->dirty = false;
+        }
+    }
+
+    dirty_count = 0;
+}
+
+/** Enable or disable the dirty frame tracking
+ *
+ * @param enable True to start tracking (from a clean state).
+ *
+ */
+void physmem_dirty_tracking(bool enable)
+{
+    physmem_dirty_clear();
+    safe_free(dirty_collected);
+    dirty_collected_size = 0;
+
+    dirty_tracking = enable;
+}
+
+/** Collect the frames written since the last collection
+ *
+ * @param frames Physical addresses of the frames. The array
+ *               is valid until the next call.
+ *
+ * @return Number of the frames.
+ *
+ */
+size_t physmem_dirty_collect(ptr36_t **frames)
+{
+    ASSERT(frames != NULL);
+
+    size_t count = dirty_count;
+    physmem_dirty_clear();
+
+    /* Hand over the array and start a new one */
+    safe_free(dirty_collected);
+    dirty_collected = dirty_frames;
+    dirty_collected_size = dirty_size;
+
+    dirty_frames = NULL;
+    dirty_size = 0;
+
+    *frames = dirty_collected;
+    return count;
+}
+
+/** Account the frame tables and the dirty frame buffers */
+void physmem_memusage(memusage_t *usage)
+{
+    memusage_add(usage, MEMUSAGE_FRAMES, sizeof(ftl0));
+
+    for (size_t i = 0; i < FTL1_COUNT; i++) {
+        ftl1_t *ftl1 = ftl0[i];
+        if (ftl1 == NULL) {
+            continue;
+        }
+
+        memusage_add(usage, MEMUSAGE_FRAMES, sizeof(ftl1_t));
+
+        for (size_t j = 0; j < FTL2_COUNT; j++) {
+            if ((*ftl1)[j] != NULL) {
+                memusage_add(usage, MEMUSAGE_FRAMES, sizeof(frame_t));
+            }
+        }
+    }
+
+    memusage_add(usage, MEMUSAGE_TRACE,
+            (dirty_size + dirty_collected_size) * sizeof(ptr36_t));
+}
+
+/** Number of accesses to device registers
+ *
+ * Unlike memory, device registers can have side effects
+ * on reading and writing.
+ *
+ */
+uint64_t physmem_device_accesses = 0;
+
+/** Memory breakpoints are not checked (during the lock-step shadow execution) */
+bool physmem_breakpoints_muted = false;
+
+/** Stores are compared with the memory content instead of performed
+ *
+ * Set during the lock-step shadow execution. The memory holds the
+ * result of the same store performed by the reference already, so a
+ * store of another value or to another address shows up as a difference
+ * and it does not overwrite the result of the reference.
+ *
+ */
+physmem_store_check_t *physmem_store_check = NULL;
+
+/** Record a checked store
+ *
+ * @param addr   Address of the store.
+ * @param size   Size of the store.
+ * @param val    Value of the store.
+ * @param memory Memory content at the address.
+ * @param device The store addresses a device.
+ *
+ */
+static void physmem_store_compare(ptr36_t addr, unsigned int size,
+        uint64_t val, uint64_t memory, bool device)
+{
+    physmem_store_check_t *check = physmem_store_check;
+
+    if ((!device) && (val == memory)) {
+        return;
+    }
+
+    if (check->mismatches == 0) {
+        check->addr = addr;
+        check->size = size;
+        check->value = val;
+        check->memory = memory;
+        check->device = device;
+    }
+
+    check->mismatches++;
+}
+
 /** Find an activated memory breakpoint
  *
  * Find an activated memory breakpoint which would be hit for specified
  * memory address and access conditions.
  *
+ * @param procno       Id of processor performing the access.
  * @param addr         Address, where the breakpoint can be hit.
  * @param size         Size of the access operation.
  * @param access_flags Specifies the access condition, under the breakpoint
@@ -402,9 +573,13 @@ frame_t *physmem_find_frame(ptr36_t addr)
  * @return Found breakpoint structure or NULL if there is not any.
  *
  */
-static void physmem_breakpoint_find(ptr36_t addr, len36_t size,
-        access_t access_type)
+static void physmem_breakpoint_find(unsigned int procno, ptr36_t addr,
+        len36_t size, access_t access_type)
 {
+    if (physmem_breakpoints_muted) {
+        return;
+    }
+
     physmem_breakpoint_t *breakpoint;
 
     for_each(physmem_breakpoints, breakpoint, physmem_breakpoint_t)
@@ -417,8 +592,8 @@ static void physmem_breakpoint_find(ptr36_t addr, len36_t size,
             continue;
         }
 
-        if ((access_type & breakpoint->access_flags) != 0) {
-            physmem_breakpoint_hit(breakpoint, access_type);
+        if (((access_type & breakpoint->access_flags) != 0)
+                && (physmem_breakpoint_hit(breakpoint, access_type, procno))) {
             break;
         }
     }
@@ -426,13 +601,14 @@ static void physmem_breakpoint_find(ptr36_t addr, len36_t size,
 
 static uint8_t devmem_read8(unsigned int procno, ptr36_t addr)
 {
+    physmem_device_accesses++;
+
     uint32_t val = (uint32_t) DEFAULT_MEMORY_VALUE;
 
-    /* List for each device */
-    device_t *dev = NULL;
-    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
-        if (dev->type->read32) {
-            dev->type->read32(procno, dev, addr, &val);
+    /* Each device handling the address */
+    for (device_t *const *dev = dev_decode(addr); *dev != NULL; dev++) {
+        if ((*dev)->type->read32) {
+            (*dev)->type->read32(procno, *dev, addr, &val);
         }
     }
 
@@ -441,13 +617,14 @@ static uint8_t devmem_read8(unsigned int procno, ptr36_t addr)
 
 static uint16_t devmem_read16(unsigned int procno, ptr36_t addr)
 {
+    physmem_device_accesses++;
+
     uint32_t val = (uint32_t) DEFAULT_MEMORY_VALUE;
 
-    /* List for each device */
-    device_t *dev = NULL;
-    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
-        if (dev->type->read32) {
-            dev->type->read32(procno, dev, addr, &val);
+    /* Each device handling the address */
+    for (device_t *const *dev = dev_decode(addr); *dev != NULL; dev++) {
+        if ((*dev)->type->read32) {
+            (*dev)->type->read32(procno, *dev, addr, &val);
         }
     }
 
@@ -456,13 +633,14 @@ static uint16_t devmem_read16(unsigned int procno, ptr36_t addr)
 
 static uint32_t devmem_read32(unsigned int procno, ptr36_t addr)
 {
+    physmem_device_accesses++;
+
     uint32_t val = (uint32_t) DEFAULT_MEMORY_VALUE;
 
-    /* List for each device */
-    device_t *dev = NULL;
-    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
-        if (dev->type->read32) {
-            dev->type->read32(procno, dev, addr, &val);
+    /* Each device handling the address */
+    for (device_t *const *dev = dev_decode(addr); *dev != NULL; dev++) {
+        if ((*dev)->type->read32) {
+            (*dev)->type->read32(procno, *dev, addr, &val);
         }
     }
 
@@ -471,13 +649,14 @@ static uint32_t devmem_read32(unsigned int procno, ptr36_t addr)
 
 static uint64_t devmem_read64(unsigned int procno, ptr36_t addr)
 {
+    physmem_device_accesses++;
+
     uint64_t val = (uint64_t) DEFAULT_MEMORY_VALUE;
 
-    /* List for each device */
-    device_t *dev = NULL;
-    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
-        if (dev->type->read64) {
-            dev->type->read64(procno, dev, addr, &val);
+    /* Each device handling the address */
+    for (device_t *const *dev = dev_decode(addr); *dev != NULL; dev++) {
+        if ((*dev)->type->read64) {
+            (*dev)->type->read64(procno, *dev, addr, &val);
         }
     }
 
@@ -513,7 +692,7 @@ uint8_t physmem_read8(unsigned int procno, ptr36_t addr, bool protected)
 
     /* Check for memory read breakpoints */
     if (protected) {
-        physmem_breakpoint_find(addr, 1, ACCESS_READ);
+        physmem_breakpoint_find(procno, addr, 1, ACCESS_READ);
     }
 
     ASSERT(frame->data);
@@ -551,7 +730,7 @@ uint16_t physmem_read16(unsigned int procno, ptr36_t addr, bool protected)
 
     /* Check for memory read breakpoints */
     if (protected) {
-        physmem_breakpoint_find(addr, 2, ACCESS_READ);
+        physmem_breakpoint_find(procno, addr, 2, ACCESS_READ);
     }
 
     ASSERT(frame->data);
@@ -589,7 +768,7 @@ uint32_t physmem_read32(unsigned int procno, ptr36_t addr, bool protected)
 
     /* Check for memory read breakpoints */
     if (protected) {
-        physmem_breakpoint_find(addr, 4, ACCESS_READ);
+        physmem_breakpoint_find(procno, addr, 4, ACCESS_READ);
     }
 
     ASSERT(frame->data);
@@ -627,7 +806,7 @@ uint64_t physmem_read64(unsigned int procno, ptr36_t addr, bool protected)
 
     /* Check for memory read breakpoints */
     if (protected) {
-        physmem_breakpoint_find(addr, 8, ACCESS_READ);
+        physmem_breakpoint_find(procno, addr, 8, ACCESS_READ);
     }
 
     ASSERT(frame->data);
@@ -638,66 +817,62 @@ uint64_t physmem_read64(unsigned int procno, ptr36_t addr, bool protected)
 
 static bool devmem_write8(unsigned int procno, ptr36_t addr, uint8_t val)
 {
-    bool written = false;
-
-    /* List for each device */
-    device_t *dev = NULL;
-    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
-        if (dev->type->write32) {
-            dev->type->write32(procno, dev, addr, val);
-            written = true;
+    physmem_device_accesses++;
+
+    /* Each device handling the address */
+    for (device_t *const *dev = dev_decode(addr); *dev != NULL; dev++) {
+        if ((*dev)->type->write32) {
+            (*dev)->type->write32(procno, *dev, addr, val);
         }
     }
 
-    return written;
+    /* Report the write whenever some device implements it */
+    return dev_any_write32();
 }
 
 static bool devmem_write16(unsigned int procno, ptr36_t addr, uint16_t val)
 {
-    bool written = false;
-
-    /* List for each device */
-    device_t *dev = NULL;
-    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
-        if (dev->type->write32) {
-            dev->type->write32(procno, dev, addr, val);
-            written = true;
+    physmem_device_accesses++;
+
+    /* Each device handling the address */
+    for (device_t *const *dev = dev_decode(addr); *dev != NULL; dev++) {
+        if ((*dev)->type->write32) {
+            (*dev)->type->write32(procno, *dev, addr, val);
         }
     }
 
-    return written;
+    /* Report the write whenever some device implements it */
+    return dev_any_write32();
 }
 
 static bool devmem_write32(unsigned int procno, ptr36_t addr, uint32_t val)
 {
-    bool written = false;
-
-    /* List for each device */
-    device_t *dev = NULL;
-    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
-        if (dev->type->write32) {
-            dev->type->write32(procno, dev, addr, val);
-            written = true;
+    physmem_device_accesses++;
+
+    /* Each device handling the address */
+    for (device_t *const *dev = dev_decode(addr); *dev != NULL; dev++) {
+        if ((*dev)->type->write32) {
+            (*dev)->type->write32(procno, *dev, addr, val);
         }
     }
 
-    return written;
+    /* Report the write whenever some device implements it */
+    return dev_any_write32();
 }
 
 static bool devmem_write64(unsigned int procno, ptr36_t addr, uint64_t val)
 {
-    bool written = false;
-
-    /* List for each device */
-    device_t *dev = NULL;
-    while (dev_next(&dev, DEVICE_FILTER_ALL)) {
-        if (dev->type->write64) {
-            dev->type->write64(procno, dev, addr, val);
-            written = true;
+    physmem_device_accesses++;
+
+    /* Each device handling the address */
+    for (device_t *const *dev = dev_decode(addr); *dev != NULL; dev++) {
+        if ((*dev)->type->write64) {
+            (*dev)->type->write64(procno, *dev, addr, val);
         }
     }
 
-    return written;
+    /* Report the write whenever some device implements it */
+    return dev_any_write64();
 }
 
 /** SC-LL tracking
@@ -793,6 +968,11 @@ bool physmem_write8(unsigned int procno, ptr36_t addr, uint8_t val, bool protect
 
     /* No frame found, try to write the value to appropriate device */
     if (frame == NULL) {
+        if (physmem_store_check != NULL) {
+            physmem_store_compare(addr, 1, val, 0, true);
+            return true;
+        }
+
         return devmem_write8(procno, addr, val);
     }
 
@@ -804,16 +984,26 @@ bool physmem_write8(unsigned int procno, ptr36_t addr, uint8_t val, bool protect
         return false;
     }
 
+    if (physmem_store_check != NULL) {
+        physmem_store_compare(addr, 1, val,
+                physmem_read8(procno, addr, false), false);
+        return true;
+    }
+
     sc_control(addr, 1);
 
     /* Check for memory write breakpoints */
     if (protected) {
-        physmem_breakpoint_find(addr, 1, ACCESS_WRITE);
+        physmem_breakpoint_find(procno, addr, 1, ACCESS_WRITE);
     }
 
     /* Invalidate binary translation */
     frame->valid = false;
 
+    if ((dirty_tracking) && (!frame->dirty)) {
+        physmem_mark_dirty(frame, addr);
+    }
+
     uint8_t *data = frame->data + (addr & FRAME_MASK);
     *data = convert_uint8_t_endian(val);
 
@@ -843,6 +1033,11 @@ bool physmem_write16(unsigned int procno, ptr36_t addr, uint16_t val, bool prote
 
     /* No frame found, try to write the value to appropriate device */
     if (frame == NULL) {
+        if (physmem_store_check != NULL) {
+            physmem_store_compare(addr, 2, val, 0, true);
+            return true;
+        }
+
         return devmem_write16(procno, addr, val);
     }
 
@@ -854,16 +1049,26 @@ bool physmem_write16(unsigned int procno, ptr36_t addr, uint16_t val, bool prote
         return false;
     }
 
+    if (physmem_store_check != NULL) {
+        physmem_store_compare(addr, 2, val,
+                physmem_read16(procno, addr, false), false);
+        return true;
+    }
+
     sc_control(addr, 2);
 
     /* Check for memory write breakpoints */
     if (protected) {
-        physmem_breakpoint_find(addr, 2, ACCESS_WRITE);
+        physmem_breakpoint_find(procno, addr, 2, ACCESS_WRITE);
     }
 
     /* Invalidate binary translation */
     frame->valid = false;
 
+    if ((dirty_tracking) && (!frame->dirty)) {
+        physmem_mark_dirty(frame, addr);
+    }
+
     uint16_t *data = (uint16_t *) (frame->data + (addr & FRAME_MASK));
     *data = convert_uint16_t_endian(val);
 
@@ -893,6 +1098,11 @@ bool physmem_write32(unsigned int procno, ptr36_t addr, uint32_t val, bool prote
 
     /* No frame found, try to write the value to appropriate device */
     if (frame == NULL) {
+        if (physmem_store_check != NULL) {
+            physmem_store_compare(addr, 4, val, 0, true);
+            return true;
+        }
+
         return devmem_write32(procno, addr, val);
     }
 
@@ -904,16 +1114,26 @@ bool physmem_write32(unsigned int procno, ptr36_t addr, uint32_t val, bool prote
         return false;
     }
 
+    if (physmem_store_check != NULL) {
+        physmem_store_compare(addr, 4, val,
+                physmem_read32(procno, addr, false), false);
+        return true;
+    }
+
     sc_control(addr, 4);
 
     /* Check for memory write breakpoints */
     if (protected) {
-        physmem_breakpoint_find(addr, 4, ACCESS_WRITE);
+        physmem_breakpoint_find(procno, addr, 4, ACCESS_WRITE);
     }
 
     /* Invalidate binary translation */
     frame->valid = false;
 
+    if ((dirty_tracking) && (!frame->dirty)) {
+        physmem_mark_dirty(frame, addr);
+    }
+
     uint32_t *data = (uint32_t *) (frame->data + (addr & FRAME_MASK));
     *data = convert_uint32_t_endian(val);
 
@@ -943,6 +1163,11 @@ bool physmem_write64(unsigned int procno, ptr36_t addr, uint64_t val, bool prote
 
     /* No frame found, try to write the value to appropriate device */
     if (frame == NULL) {
+        if (physmem_store_check != NULL) {
+            physmem_store_compare(addr, 8, val, 0, true);
+            return true;
+        }
+
         return devmem_write64(procno, addr, val);
     }
 
@@ -954,16 +1179,26 @@ bool physmem_write64(unsigned int procno, ptr36_t addr, uint64_t val, bool prote
         return false;
     }
 
+    if (physmem_store_check != NULL) {
+        physmem_store_compare(addr, 8, val,
+                physmem_read64(procno, addr, false), false);
+        return true;
+    }
+
     sc_control(addr, 8);
 
     /* Check for memory write breakpoints */
     if (protected) {
-        physmem_breakpoint_find(addr, 8, ACCESS_WRITE);
+        physmem_breakpoint_find(procno, addr, 8, ACCESS_WRITE);
     }
 
     /* Invalidate binary translation */
     frame->valid = false;
 
+    if ((dirty_tracking) && (!frame->dirty)) {
+        physmem_mark_dirty(frame, addr);
+    }
+
     uint64_t *data = (uint64_t *) (frame->data + (addr & FRAME_MASK));
     *data = convert_uint64_t_endian(val);
 
@@ -44,7 +44,8 @@
 typedef enum {
     MEMT_NONE = 0, /**< Uninitialized */
     MEMT_MEM = 1, /**< Generic */
-    MEMT_FMAP = 2 /**< File mapped */
+    MEMT_FMAP = 2, /**< File mapped */
+    MEMT_IMAGE = 3 /**< Privately mapped compiled machine image */
 } physmem_type_t;
 
 typedef struct {
@@ -71,6 +72,9 @@ typedef struct frame {
 
     /* Binary translation valid flag */
     bool valid;
+
+    /* Written since the last dirty frame collection */
+    bool dirty;
 } frame_t;
 
 /** Physical memory management */
@@ -79,6 +83,25 @@ extern void physmem_unwire(physmem_area_t *area);
 
 extern frame_t *physmem_find_frame(ptr36_t addr);
 
+/** Number of accesses to device registers */
+extern uint64_t physmem_device_accesses;
+
+/** Memory breakpoints are not checked */
+extern bool physmem_breakpoints_muted;
+
+/** Result of the stores checked instead of performed */
+typedef struct {
+    uint64_t mismatches; /**< Stores differing from the memory content */
+    ptr36_t addr; /**< Address of the first differing store */
+    unsigned int size; /**< Size of the first differing store */
+    uint64_t value; /**< Value of the first differing store */
+    uint64_t memory; /**< Memory content at its address */
+    bool device; /**< The first differing store addresses a device */
+} physmem_store_check_t;
+
+/** Stores are compared with the memory content instead of performed */
+extern physmem_store_check_t *physmem_store_check;
+
 /** Physical memory access */
 extern uint8_t physmem_read8(unsigned int cpu, ptr36_t addr, bool protected);
 extern uint16_t physmem_read16(unsigned int cpu, ptr36_t addr, bool protected);
@@ -94,6 +117,14 @@ extern bool physmem_write32(unsigned int cpu, ptr36_t addr, uint32_t val,
 extern bool physmem_write64(unsigned int cpu, ptr36_t addr, uint64_t val,
         bool protected);
 
+/** Dirty frame tracking */
+extern void physmem_dirty_tracking(bool enable);
+extern size_t physmem_dirty_collect(ptr36_t **frames);
+
+/** Host memory accounting */
+struct memusage;
+extern void physmem_memusage(struct memusage *usage);
+
 /** Store-conditional control */
 extern void sc_register(unsigned int procno);
 extern void sc_unregister(unsigned int procno);
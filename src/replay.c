@@ -0,0 +1,476 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Record and replay of nondeterministic inputs
+ *
+ * In the record mode every nondeterministic input of the simulation
+ * is written to a log file together with the machine cycle when it
+ * has been observed. The inputs are
+ *
+ *  - characters read from the keyboard (dkeyboard),
+ *  - host time readings (dtime),
+ *  - host-synchronized mtime samples of RISC-V harts
+ *    (only the changes are recorded),
+ *  - commands entered in the interactive mode,
+ *  - whether the standard input is a terminal.
+ *
+ * In the replay mode the inputs are taken from the log file instead,
+ * so the simulation is fully deterministic, it does not need a terminal
+ * and it is not paced by the host time.
+ *
+ * The log is a text file with one event per line:
+ *
+ *   <cycle> key <code>
+ *   <cycle> time <sec> <usec>
+ *   <cycle> mtime <hart> <value>
+ *   <cycle> cmd <command line>
+ *   <cycle> tty <0|1>
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arch/stdin.h"
+#include "assert.h"
+#include "debug/memusage.h"
+#include "fault.h"
+#include "list.h"
+#include "main.h"
+#include "replay.h"
+#include "utils.h"
+
+/** Header of the log file */
+#define REPLAY_HEADER "# MSIM replay log"
+
+/** Maximal length of a log line */
+#define REPLAY_LINE_LENGTH 4096
+
+typedef enum {
+    EVENT_KEY,
+    EVENT_TIME,
+    EVENT_MTIME,
+    EVENT_CMD,
+    EVENT_TTY,
+    EVENT_COUNT
+} event_type_t;
+
+static const char *event_names[EVENT_COUNT] = {
+    "key",
+    "time",
+    "mtime",
+    "cmd",
+    "tty"
+};
+
+/** Recorded event */
+typedef struct {
+    item_t item;
+
+    uint64_t cycle;
+    event_type_t type;
+    unsigned int hart;
+    uint64_t val1;
+    uint64_t val2;
+    char *text;
+} event_t;
+
+/** Current mode */
+replay_mode_t replay_mode = REPLAY_MODE_NONE;
+
+/** Log file */
+static FILE *log_file = NULL;
+static char *log_name = NULL;
+
+/** Events of the replayed log */
+static list_t events = LIST_INITIALIZER;
+
+/** Next event of each type to be replayed */
+static event_t *cursor[EVENT_COUNT];
+static event_t *mtime_cursor[MAX_CPUS];
+
+/** Last mtime value of each hart */
+static uint64_t mtime_last[MAX_CPUS];
+static bool mtime_known[MAX_CPUS];
+
+/** Replayed terminal status */
+static bool replay_terminal = false;
+
+/** Divergence has been already reported */
+static bool diverged = false;
+
+static void replay_diverged(const char *what)
+{
+    if (!diverged) {
+        alert("Replay: Simulation diverged from the log at cycle %" PRIu64
+              " (%s)",
+                machine_steps, what);
+        diverged = true;
+    }
+}
+
+/** Find the first event of the given type starting from the given one */
+static event_t *next_event(event_t *event, event_type_t type)
+{
+    while ((event != NULL) && (event->type != type)) {
+        event = (event_t *) event->item.next;
+    }
+
+    return event;
+}
+
+/** Find the first mtime event of the given hart starting from the given one */
+static event_t *next_mtime_event(event_t *event, unsigned int hart)
+{
+    while ((event != NULL) && ((event->type != EVENT_MTIME) || (event->hart != hart))) {
+        event = (event_t *) event->item.next;
+    }
+
+    return event;
+}
+
+static void advance(event_type_t type)
+{
+    ASSERT(cursor[type] != NULL);
+
+    cursor[type] = next_event((event_t *) cursor[type]->item.next, type);
+}
+
+/** Start recording to the given log file
+ *
+ * @param filename Name of the log file.
+ *
+ */
+void replay_record_open(const char *filename)
+{
+    ASSERT(filename != NULL);
+
+    log_file = try_fopen(filename, "w");
+    if (log_file == NULL) {
+        die(ERR_IO, "Unable to create the replay log");
+    }
+
+    log_name = safe_strdup(filename);
+    replay_mode = REPLAY_MODE_RECORD;
+
+    fprintf(log_file, "%s\n", REPLAY_HEADER);
+}
+
+static event_t *parse_event(const char *line, size_t lineno)
+{
+    event_t *event = safe_malloc_t(event_t);
+    memset(event, 0, sizeof(event_t));
+    item_init(&event->item);
+
+    char name[16];
+    int pos = 0;
+
+    if (sscanf(line, "%" SCNu64 " %15s %n", &event->cycle, name, &pos) < 2) {
+        die(ERR_PARM, "Malformed replay log line %zu", lineno);
+    }
+
+    event_type_t type;
+    for (type = 0; type < EVENT_COUNT; type++) {
+        if (strcmp(name, event_names[type]) == 0) {
+            break;
+        }
+    }
+
+    const char *args = line + pos;
+    int count = 0;
+
+    switch (type) {
+    case EVENT_KEY:
+    case EVENT_TTY:
+        count = sscanf(args, "%" SCNu64, &event->val1) == 1;
+        break;
+    case EVENT_TIME:
+        count = sscanf(args, "%" SCNu64 " %" SCNu64,
+                        &event->val1, &event->val2)
+                == 2;
+        break;
+    case EVENT_MTIME:
+        count = (sscanf(args, "%u %" SCNu64, &event->hart, &event->val1) == 2)
+                && (event->hart < MAX_CPUS);
+        break;
+    case EVENT_CMD:
+        event->text = safe_strdup(args);
+        count = 1;
+        break;
+    default:
+        die(ERR_PARM, "Unknown event \"%s\" in replay log line %zu",
+                name, lineno);
+    }
+
+    if (!count) {
+        die(ERR_PARM, "Malformed replay log line %zu", lineno);
+    }
+
+    event->type = type;
+    return event;
+}
+
+/** Start replaying the given log file
+ *
+ * @param filename Name of the log file.
+ *
+ */
+void replay_open(const char *filename)
+{
+    ASSERT(filename != NULL);
+
+    FILE *file = try_fopen(filename, "r");
+    if (file == NULL) {
+        die(ERR_IO, "Unable to open the replay log");
+    }
+
+    char line[REPLAY_LINE_LENGTH];
+    size_t lineno = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineno++;
+        line[strcspn(line, "\r\n")] = 0;
+
+        if ((line[0] == '#') || (line[0] == 0)) {
+            continue;
+        }
+
+        event_t *event = parse_event(line, lineno);
+        list_append(&events, &event->item);
+    }
+
+    safe_fclose(file, filename);
+
+    event_type_t type;
+    for (type = 0; type < EVENT_COUNT; type++) {
+        cursor[type] = next_event((event_t *) events.head, type);
+    }
+
+    unsigned int hart;
+    for (hart = 0; hart < MAX_CPUS; hart++) {
+        mtime_cursor[hart] = next_mtime_event((event_t *) events.head, hart);
+    }
+
+    if (cursor[EVENT_TTY] != NULL) {
+        replay_terminal = cursor[EVENT_TTY]->val1 != 0;
+    }
+
+    replay_mode = REPLAY_MODE_REPLAY;
+}
+
+/** Finish recording or replaying */
+void replay_done(void)
+{
+    if (log_file != NULL) {
+        safe_fclose(log_file, log_name);
+        log_file = NULL;
+        safe_free(log_name);
+    }
+
+    while (!is_empty(&events)) {
+        event_t *event = (event_t *) events.head;
+        list_remove(&events, &event->item);
+        safe_free(event->text);
+        safe_free(event);
+    }
+
+    replay_mode = REPLAY_MODE_NONE;
+}
+
+/** Account the events of the replayed log */
+void replay_memusage(memusage_t *usage)
+{
+    event_t *event;
+    for_each(events, event, event_t)
+    {
+        memusage_add(usage, MEMUSAGE_TRACE, sizeof(event_t));
+
+        if (event->text != NULL) {
+            memusage_add(usage, MEMUSAGE_TRACE, strlen(event->text) + 1);
+        }
+    }
+}
+
+/** Host time in milliseconds as observed by the given hart
+ *
+ * @param hart Number of the hart.
+ *
+ */
+uint64_t replay_timestamp(unsigned int hart)
+{
+    ASSERT(hart < MAX_CPUS);
+
+    switch (replay_mode) {
+    case REPLAY_MODE_RECORD: {
+        uint64_t val = current_timestamp();
+        if ((!mtime_known[hart]) || (mtime_last[hart] != val)) {
+            fprintf(log_file, "%" PRIu64 " mtime %u %" PRIu64 "\n",
+                    machine_steps, hart, val);
+            mtime_last[hart] = val;
+            mtime_known[hart] = true;
+        }
+        return val;
+    }
+    case REPLAY_MODE_REPLAY: {
+        event_t *event = mtime_cursor[hart];
+        if ((event != NULL) && (event->cycle <= machine_steps)) {
+            mtime_last[hart] = event->val1;
+            mtime_cursor[hart] = next_mtime_event(
+                    (event_t *) event->item.next, hart);
+        }
+        return mtime_last[hart];
+    }
+    default:
+        return current_timestamp();
+    }
+}
+
+/** Host time of day
+ *
+ * @param tv Time value to fill in.
+ *
+ */
+void replay_gettimeofday(struct timeval *tv)
+{
+    ASSERT(tv != NULL);
+
+    switch (replay_mode) {
+    case REPLAY_MODE_RECORD:
+        gettimeofday(tv, NULL);
+        fprintf(log_file, "%" PRIu64 " time %" PRIu64 " %" PRIu64 "\n",
+                machine_steps, (uint64_t) tv->tv_sec,
+                (uint64_t) tv->tv_usec);
+        break;
+    case REPLAY_MODE_REPLAY: {
+        event_t *event = cursor[EVENT_TIME];
+        if (event == NULL) {
+            replay_diverged("no more time readings");
+            tv->tv_sec = 0;
+            tv->tv_usec = 0;
+            break;
+        }
+
+        if (event->cycle != machine_steps) {
+            replay_diverged("time reading");
+        }
+
+        tv->tv_sec = (time_t) event->val1;
+        tv->tv_usec = (suseconds_t) event->val2;
+        advance(EVENT_TIME);
+        break;
+    }
+    default:
+        gettimeofday(tv, NULL);
+    }
+}
+
+/** Poll the keyboard
+ *
+ * @param key Character read.
+ *
+ * @return True if a character has been read.
+ *
+ */
+bool replay_stdin_poll(char *key)
+{
+    ASSERT(key != NULL);
+
+    switch (replay_mode) {
+    case REPLAY_MODE_RECORD:
+        if (stdin_poll(key)) {
+            fprintf(log_file, "%" PRIu64 " key %u\n", machine_steps,
+                    (unsigned int) (unsigned char) *key);
+            return true;
+        }
+        return false;
+    case REPLAY_MODE_REPLAY: {
+        event_t *event = cursor[EVENT_KEY];
+        if ((event == NULL) || (event->cycle > machine_steps)) {
+            return false;
+        }
+
+        if (event->cycle < machine_steps) {
+            replay_diverged("key press");
+        }
+
+        *key = (char) event->val1;
+        advance(EVENT_KEY);
+        return true;
+    }
+    default:
+        return stdin_poll(key);
+    }
+}
+
+/** Terminal status of the standard input
+ *
+ * @param terminal Actual terminal status.
+ *
+ * @return Terminal status to be used by the simulation.
+ *
+ */
+bool replay_is_terminal(bool terminal)
+{
+    switch (replay_mode) {
+    case REPLAY_MODE_RECORD: {
+        static bool recorded = false;
+        if (!recorded) {
+            fprintf(log_file, "%" PRIu64 " tty %u\n", machine_steps,
+                    terminal ? 1 : 0);
+            recorded = true;
+        }
+        return terminal;
+    }
+    case REPLAY_MODE_REPLAY:
+        return replay_terminal;
+    default:
+        return terminal;
+    }
+}
+
+/** Check for a replayed interactive command at the current cycle */
+bool replay_command_pending(void)
+{
+    event_t *event = cursor[EVENT_CMD];
+    return (replay_mode == REPLAY_MODE_REPLAY) && (event != NULL) && (event->cycle == machine_steps);
+}
+
+/** Get the next replayed interactive command
+ *
+ * @return Command line (to be freed by the caller) or NULL
+ *         if no command has been recorded at the current cycle.
+ *
+ */
+char *replay_command(void)
+{
+    if (!replay_command_pending()) {
+        return NULL;
+    }
+
+    char *cmdline = safe_strdup(cursor[EVENT_CMD]->text);
+    advance(EVENT_CMD);
+
+    return cmdline;
+}
+
+/** Record an interactive command
+ *
+ * @param cmdline Command line entered by the user.
+ *
+ */
+void replay_record_command(const char *cmdline)
+{
+    ASSERT(cmdline != NULL);
+
+    if (replay_mode == REPLAY_MODE_RECORD) {
+        fprintf(log_file, "%" PRIu64 " cmd %s\n", machine_steps, cmdline);
+        fflush(log_file);
+    }
+}
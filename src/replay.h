@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Record and replay of nondeterministic inputs
+ *
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+typedef enum {
+    REPLAY_MODE_NONE,
+    REPLAY_MODE_RECORD,
+    REPLAY_MODE_REPLAY
+} replay_mode_t;
+
+extern replay_mode_t replay_mode;
+
+extern void replay_record_open(const char *filename);
+extern void replay_open(const char *filename);
+extern void replay_done(void);
+
+struct memusage;
+extern void replay_memusage(struct memusage *usage);
+
+/** Nondeterministic inputs */
+extern uint64_t replay_timestamp(unsigned int hart);
+extern void replay_gettimeofday(struct timeval *tv);
+extern bool replay_stdin_poll(char *key);
+extern bool replay_is_terminal(bool terminal);
+
+/** Interactive commands */
+extern bool replay_command_pending(void);
+extern char *replay_command(void);
+extern void replay_record_command(const char *cmdline);
+
+#endif
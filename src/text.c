@@ -83,6 +83,11 @@ const char txt_help[] = "  -V, --version               display version info\n"
                         "  -t, --trace                 enter trace mode\n"
                         "  -g, --remote-gdb=port       enter gdb mode\n"
                         "  -n, --non-deterministic     enable non-deterministic behaviour\n"
-                        "  -X, --no-extra-instructions disable MSIM-specific instructions\n";
+                        "  -X, --no-extra-instructions disable MSIM-specific instructions\n"
+                        "  -R, --record=file_name      record non-deterministic inputs\n"
+                        "  -P, --replay=file_name      replay recorded non-deterministic inputs\n"
+                        "  -u, --user program [args]   run a static RV32 Linux program in user mode\n"
+                        "  -M, --memusage=file_name    write host memory usage in JSON at exit\n"
+                        "  -C, --compile=file_name     save the configured machine for a fast start\n";
 
 const char hexchar[] = "0123456789abcdef";
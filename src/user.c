@@ -0,0 +1,1207 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  User-mode emulation
+ *
+ * Runs a static RV32IMA Linux executable without simulating the whole
+ * system. The program is loaded into a flat address space (there is
+ * no MMU, no devices and no interrupts), the processor starts in the
+ * U-mode and the environment calls are translated to the system calls
+ * of the host.
+ *
+ * The address space consists of three rwm areas:
+ *
+ *   image  the ELF segments followed by the brk heap
+ *   mmap   anonymous and private file mappings (from 0x40000000)
+ *   stack  8 MB below 0x80000000
+ *
+ * The file descriptors of the program are the host file descriptors,
+ * the program does not get any environment variables.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "assert.h"
+#include "cmd.h"
+#include "device/cpu/general_cpu.h"
+#include "device/cpu/riscv_rv32ima/cpu.h"
+#include "elf.h"
+#include "fault.h"
+#include "main.h"
+#include "physmem.h"
+#include "user.h"
+#include "utils.h"
+
+/** Address space layout */
+#define USER_PAGE_SIZE 4096
+#define USER_HEAP_SIZE UINT32_C(0x04000000)
+#define USER_MMAP_BASE UINT32_C(0x40000000)
+#define USER_MMAP_SIZE UINT32_C(0x04000000)
+#define USER_STACK_TOP UINT64_C(0x80000000)
+#define USER_STACK_SIZE UINT32_C(0x00800000)
+
+/** The program runs on the first processor */
+#define USER_CPU 0
+
+/** Longest path accepted by the system calls */
+#define USER_PATH_MAX 4096
+
+/** Largest chunk transferred by a single read or write */
+#define USER_IO_CHUNK (1024 * 1024)
+
+/** Argument and result registers */
+#define REG_SP 2
+#define REG_A0 10
+#define REG_A7 17
+
+/** Linux system call numbers (RV32) */
+enum {
+    USER_SYS_getcwd = 17,
+    USER_SYS_dup = 23,
+    USER_SYS_dup3 = 24,
+    USER_SYS_fcntl64 = 25,
+    USER_SYS_ioctl = 29,
+    USER_SYS_mkdirat = 34,
+    USER_SYS_unlinkat = 35,
+    USER_SYS_faccessat = 48,
+    USER_SYS_openat = 56,
+    USER_SYS_close = 57,
+    USER_SYS_pipe2 = 59,
+    USER_SYS_llseek = 62,
+    USER_SYS_read = 63,
+    USER_SYS_write = 64,
+    USER_SYS_readv = 65,
+    USER_SYS_writev = 66,
+    USER_SYS_pread64 = 67,
+    USER_SYS_pwrite64 = 68,
+    USER_SYS_readlinkat = 78,
+    USER_SYS_fsync = 82,
+    USER_SYS_exit = 93,
+    USER_SYS_exit_group = 94,
+    USER_SYS_set_tid_address = 96,
+    USER_SYS_set_robust_list = 99,
+    USER_SYS_clock_gettime = 113,
+    USER_SYS_kill = 129,
+    USER_SYS_tkill = 130,
+    USER_SYS_tgkill = 131,
+    USER_SYS_rt_sigaction = 134,
+    USER_SYS_rt_sigprocmask = 135,
+    USER_SYS_uname = 160,
+    USER_SYS_getpid = 172,
+    USER_SYS_getppid = 173,
+    USER_SYS_getuid = 174,
+    USER_SYS_geteuid = 175,
+    USER_SYS_getgid = 176,
+    USER_SYS_getegid = 177,
+    USER_SYS_gettid = 178,
+    USER_SYS_brk = 214,
+    USER_SYS_munmap = 215,
+    USER_SYS_mmap2 = 222,
+    USER_SYS_mprotect = 226,
+    USER_SYS_madvise = 233,
+    USER_SYS_riscv_flush_icache = 259,
+    USER_SYS_prlimit64 = 261,
+    USER_SYS_getrandom = 278,
+    USER_SYS_statx = 291,
+    USER_SYS_clock_gettime64 = 403
+};
+
+/** Linux error numbers */
+#define LINUX_EIO 5
+#define LINUX_EBADF 9
+#define LINUX_EAGAIN 11
+#define LINUX_ENOMEM 12
+#define LINUX_EFAULT 14
+#define LINUX_EINVAL 22
+#define LINUX_ENOTTY 25
+#define LINUX_ENAMETOOLONG 36
+#define LINUX_ENOSYS 38
+#define LINUX_ENOTEMPTY 39
+#define LINUX_ELOOP 40
+
+/** Linux flags and constants */
+#define LINUX_AT_FDCWD (-100)
+#define LINUX_AT_SYMLINK_NOFOLLOW 0x100
+#define LINUX_AT_REMOVEDIR 0x200
+#define LINUX_AT_EMPTY_PATH 0x1000
+
+#define LINUX_O_ACCMODE 03
+#define LINUX_O_CREAT 0100
+#define LINUX_O_EXCL 0200
+#define LINUX_O_NOCTTY 0400
+#define LINUX_O_TRUNC 01000
+#define LINUX_O_APPEND 02000
+#define LINUX_O_NONBLOCK 04000
+#define LINUX_O_DIRECTORY 0200000
+#define LINUX_O_NOFOLLOW 0400000
+#define LINUX_O_CLOEXEC 02000000
+
+#define LINUX_F_DUPFD 0
+#define LINUX_F_GETFD 1
+#define LINUX_F_SETFD 2
+#define LINUX_F_GETFL 3
+#define LINUX_F_SETFL 4
+#define LINUX_F_DUPFD_CLOEXEC 1030
+
+#define LINUX_MAP_FIXED 0x10
+#define LINUX_MAP_ANONYMOUS 0x20
+
+#define LINUX_TCGETS 0x5401
+#define LINUX_TERMIOS_SIZE 36
+
+#define LINUX_RLIMIT_STACK 3
+
+#define LINUX_SIGILL 4
+#define LINUX_SIGTRAP 5
+#define LINUX_SIGSEGV 11
+
+/** Auxiliary vector entries */
+#define AT_NULL 0
+#define AT_PHDR 3
+#define AT_PHENT 4
+#define AT_PHNUM 5
+#define AT_PAGESZ 6
+#define AT_ENTRY 9
+#define AT_UID 11
+#define AT_EUID 12
+#define AT_GID 13
+#define AT_EGID 14
+#define AT_HWCAP 16
+#define AT_CLKTCK 17
+#define AT_SECURE 23
+#define AT_RANDOM 25
+#define AT_EXECFN 31
+
+#define USER_AUXV_COUNT 16
+
+/** Exit status of the emulated program */
+int user_exit_status = 0;
+
+/** Path of the program (for /proc/self/exe) */
+static char *user_program = NULL;
+
+/** Program break */
+static uint32_t brk_start;
+static uint32_t brk_current;
+static uint32_t brk_end;
+
+/** Next free address of the mmap area */
+static uint32_t mmap_next;
+
+/** State of the generator of the random bytes
+ *
+ * The program gets the same random bytes in every run,
+ * so the emulation stays deterministic.
+ */
+static uint64_t random_state = UINT64_C(0x853c49e6748fea9b);
+
+/*
+ * Guest memory access
+ */
+
+static bool guest_range_valid(uint32_t addr, uint32_t size)
+{
+    uint64_t end = (uint64_t) addr + size;
+
+    for (uint64_t page = ALIGN_DOWN((uint64_t) addr, FRAME_SIZE);
+            page < end; page += FRAME_SIZE) {
+        if (physmem_find_frame(page) == NULL) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void guest_read(uint32_t addr, void *buf, size_t size)
+{
+    uint8_t *data = (uint8_t *) buf;
+
+    for (size_t i = 0; i < size; i++) {
+        data[i] = physmem_read8(USER_CPU, addr + i, false);
+    }
+}
+
+static void guest_write(uint32_t addr, const void *buf, size_t size)
+{
+    const uint8_t *data = (const uint8_t *) buf;
+
+    for (size_t i = 0; i < size; i++) {
+        physmem_write8(USER_CPU, addr + i, data[i], false);
+    }
+}
+
+static void guest_fill(uint32_t addr, uint8_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        physmem_write8(USER_CPU, addr + i, value, false);
+    }
+}
+
+static void guest_write32(uint32_t addr, uint32_t value)
+{
+    physmem_write32(USER_CPU, addr, value, false);
+}
+
+static void guest_write64(uint32_t addr, uint64_t value)
+{
+    guest_write32(addr, (uint32_t) value);
+    guest_write32(addr + 4, (uint32_t) (value >> 32));
+}
+
+/** Read a zero-terminated string from the guest memory
+ *
+ * @return False if the string is not accessible or too long.
+ *
+ */
+static bool guest_string(uint32_t addr, char *buf, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        if (!guest_range_valid(addr + i, 1)) {
+            return false;
+        }
+
+        buf[i] = physmem_read8(USER_CPU, addr + i, false);
+        if (buf[i] == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint64_t random_next(void)
+{
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    return random_state * UINT64_C(0x2545f4914f6cdd1d);
+}
+
+/*
+ * Host interface
+ */
+
+/** Translate the host errno to a negative Linux error number */
+static int32_t user_errno(void)
+{
+    switch (errno) {
+    case EAGAIN:
+        return -LINUX_EAGAIN;
+    case ENAMETOOLONG:
+        return -LINUX_ENAMETOOLONG;
+    case ENOSYS:
+        return -LINUX_ENOSYS;
+    case ENOTEMPTY:
+        return -LINUX_ENOTEMPTY;
+    case ELOOP:
+        return -LINUX_ELOOP;
+    default:
+        /* The classic error numbers are the same on all hosts */
+        return (errno <= 34) ? -errno : -LINUX_EIO;
+    }
+}
+
+static int32_t user_result(long result)
+{
+    return (result < 0) ? user_errno() : (int32_t) result;
+}
+
+static int user_dirfd(uint32_t fd)
+{
+    return ((int32_t) fd == LINUX_AT_FDCWD) ? AT_FDCWD : (int32_t) fd;
+}
+
+static int user_open_flags(uint32_t flags)
+{
+    int host = flags & LINUX_O_ACCMODE;
+
+    host |= (flags & LINUX_O_CREAT) ? O_CREAT : 0;
+    host |= (flags & LINUX_O_EXCL) ? O_EXCL : 0;
+    host |= (flags & LINUX_O_NOCTTY) ? O_NOCTTY : 0;
+    host |= (flags & LINUX_O_TRUNC) ? O_TRUNC : 0;
+    host |= (flags & LINUX_O_APPEND) ? O_APPEND : 0;
+    host |= (flags & LINUX_O_NONBLOCK) ? O_NONBLOCK : 0;
+    host |= (flags & LINUX_O_DIRECTORY) ? O_DIRECTORY : 0;
+    host |= (flags & LINUX_O_NOFOLLOW) ? O_NOFOLLOW : 0;
+    host |= (flags & LINUX_O_CLOEXEC) ? O_CLOEXEC : 0;
+
+    return host;
+}
+
+static uint32_t linux_open_flags(int host)
+{
+    uint32_t flags = host & O_ACCMODE;
+
+    flags |= (host & O_APPEND) ? LINUX_O_APPEND : 0;
+    flags |= (host & O_NONBLOCK) ? LINUX_O_NONBLOCK : 0;
+
+    return flags;
+}
+
+/** Terminate the program with the given exit status */
+static void user_terminate(int status)
+{
+    user_exit_status = status;
+    machine_halt = true;
+}
+
+/*
+ * System calls
+ */
+
+static int32_t sys_openat(uint32_t dirfd, uint32_t path_addr, uint32_t flags, uint32_t mode)
+{
+    char path[USER_PATH_MAX];
+
+    if (!guest_string(path_addr, path, sizeof(path))) {
+        return -LINUX_EFAULT;
+    }
+
+    return user_result(openat(user_dirfd(dirfd), path, user_open_flags(flags), (mode_t) mode));
+}
+
+static int32_t sys_close(uint32_t fd)
+{
+    /* The simulator keeps its standard streams */
+    if (fd <= 2) {
+        return 0;
+    }
+
+    return user_result(close(fd));
+}
+
+static int32_t sys_read(uint32_t fd, uint32_t buf, uint32_t count, int64_t offset)
+{
+    count = (count > USER_IO_CHUNK) ? USER_IO_CHUNK : count;
+
+    if (!guest_range_valid(buf, count)) {
+        return -LINUX_EFAULT;
+    }
+
+    uint8_t *data = safe_malloc(count + 1);
+    ssize_t result = (offset < 0) ? read(fd, data, count) : pread(fd, data, count, offset);
+
+    if (result > 0) {
+        guest_write(buf, data, result);
+    }
+
+    safe_free(data);
+    return user_result(result);
+}
+
+static int32_t sys_write(uint32_t fd, uint32_t buf, uint32_t count, int64_t offset)
+{
+    count = (count > USER_IO_CHUNK) ? USER_IO_CHUNK : count;
+
+    if (!guest_range_valid(buf, count)) {
+        return -LINUX_EFAULT;
+    }
+
+    uint8_t *data = safe_malloc(count + 1);
+    guest_read(buf, data, count);
+
+    ssize_t result = (offset < 0) ? write(fd, data, count) : pwrite(fd, data, count, offset);
+
+    safe_free(data);
+    return user_result(result);
+}
+
+static int32_t sys_readv_writev(uint32_t fd, uint32_t iov, uint32_t iovcnt, bool wr)
+{
+    if ((iovcnt > 1024) || (!guest_range_valid(iov, iovcnt * 8))) {
+        return -LINUX_EFAULT;
+    }
+
+    int32_t total = 0;
+
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        uint32_t base = physmem_read32(USER_CPU, iov + i * 8, false);
+        uint32_t len = physmem_read32(USER_CPU, iov + i * 8 + 4, false);
+
+        int32_t result = wr ? sys_write(fd, base, len, -1) : sys_read(fd, base, len, -1);
+
+        if (result < 0) {
+            return (total > 0) ? total : result;
+        }
+
+        total += result;
+
+        if ((uint32_t) result < len) {
+            break;
+        }
+    }
+
+    return total;
+}
+
+static int32_t sys_llseek(uint32_t fd, uint32_t offset_high, uint32_t offset_low,
+        uint32_t result_addr, uint32_t whence)
+{
+    if (!guest_range_valid(result_addr, 8)) {
+        return -LINUX_EFAULT;
+    }
+
+    off_t offset = (off_t) (((uint64_t) offset_high << 32) | offset_low);
+    off_t result = lseek(fd, offset, whence);
+
+    if (result < 0) {
+        return user_errno();
+    }
+
+    guest_write64(result_addr, (uint64_t) result);
+    return 0;
+}
+
+static int32_t sys_statx(uint32_t dirfd, uint32_t path_addr, uint32_t flags, uint32_t buf)
+{
+    char path[USER_PATH_MAX];
+
+    if ((!guest_string(path_addr, path, sizeof(path))) || (!guest_range_valid(buf, 256))) {
+        return -LINUX_EFAULT;
+    }
+
+    struct stat st;
+    int result;
+
+    if ((path[0] == 0) && (flags & LINUX_AT_EMPTY_PATH)) {
+        result = fstat(user_dirfd(dirfd), &st);
+    } else {
+        int host_flags = (flags & LINUX_AT_SYMLINK_NOFOLLOW) ? AT_SYMLINK_NOFOLLOW : 0;
+        result = fstatat(user_dirfd(dirfd), path, &st, host_flags);
+    }
+
+    if (result < 0) {
+        return user_errno();
+    }
+
+    uint8_t statx[256];
+    memset(statx, 0, sizeof(statx));
+
+#define put32(offset, value) \
+    { \
+        uint32_t _value = (value); \
+        for (unsigned int _i = 0; _i < 4; _i++) { \
+            statx[(offset) + _i] = _value >> (_i * 8); \
+        } \
+    }
+
+#define put64(offset, value) \
+    { \
+        uint64_t _value64 = (value); \
+        put32((offset), (uint32_t) _value64); \
+        put32((offset) + 4, (uint32_t) (_value64 >> 32)); \
+    }
+
+    /* STATX_BASIC_STATS */
+    put32(0, 0x7ff);
+    put32(4, st.st_blksize);
+    put32(16, st.st_nlink);
+    put32(20, st.st_uid);
+    put32(24, st.st_gid);
+    statx[28] = st.st_mode;
+    statx[29] = st.st_mode >> 8;
+    put64(32, st.st_ino);
+    put64(40, st.st_size);
+    put64(48, st.st_blocks);
+    put64(64, st.st_atime);
+    put64(96, st.st_ctime);
+    put64(112, st.st_mtime);
+
+#undef put64
+#undef put32
+
+    guest_write(buf, statx, sizeof(statx));
+    return 0;
+}
+
+static int32_t sys_uname(uint32_t buf)
+{
+    static const char *const fields[] = {
+        "Linux", "msim", "6.1.0", "#1", "riscv32", ""
+    };
+
+    if (!guest_range_valid(buf, 6 * 65)) {
+        return -LINUX_EFAULT;
+    }
+
+    guest_fill(buf, 0, 6 * 65);
+
+    for (unsigned int i = 0; i < 6; i++) {
+        guest_write(buf + i * 65, fields[i], strlen(fields[i]));
+    }
+
+    return 0;
+}
+
+static int32_t sys_clock_gettime(uint32_t clock, uint32_t tp, bool time64)
+{
+    if (!guest_range_valid(tp, time64 ? 16 : 8)) {
+        return -LINUX_EFAULT;
+    }
+
+    clockid_t host_clock;
+
+    switch (clock) {
+    case 0: /* CLOCK_REALTIME */
+    case 5: /* CLOCK_REALTIME_COARSE */
+        host_clock = CLOCK_REALTIME;
+        break;
+    case 1: /* CLOCK_MONOTONIC */
+    case 4: /* CLOCK_MONOTONIC_RAW */
+    case 6: /* CLOCK_MONOTONIC_COARSE */
+    case 7: /* CLOCK_BOOTTIME */
+        host_clock = CLOCK_MONOTONIC;
+        break;
+    case 2: /* CLOCK_PROCESS_CPUTIME_ID */
+    case 3: /* CLOCK_THREAD_CPUTIME_ID */
+        host_clock = CLOCK_PROCESS_CPUTIME_ID;
+        break;
+    default:
+        return -LINUX_EINVAL;
+    }
+
+    struct timespec ts;
+
+    if (clock_gettime(host_clock, &ts) < 0) {
+        return user_errno();
+    }
+
+    if (time64) {
+        guest_write64(tp, (uint64_t) ts.tv_sec);
+        guest_write64(tp + 8, (uint64_t) ts.tv_nsec);
+    } else {
+        guest_write32(tp, (uint32_t) ts.tv_sec);
+        guest_write32(tp + 4, (uint32_t) ts.tv_nsec);
+    }
+
+    return 0;
+}
+
+static int32_t sys_brk(uint32_t addr)
+{
+    if ((addr < brk_start) || (addr > brk_end)) {
+        return brk_current;
+    }
+
+    /* Released memory has to be zero when the break grows again */
+    if (addr < brk_current) {
+        guest_fill(addr, 0, brk_current - addr);
+    }
+
+    brk_current = addr;
+    return brk_current;
+}
+
+static int32_t sys_mmap2(uint32_t addr, uint32_t length, uint32_t prot,
+        uint32_t flags, uint32_t fd, uint32_t pgoffset)
+{
+    if (length == 0) {
+        return -LINUX_EINVAL;
+    }
+
+    uint64_t size = ALIGN_UP((uint64_t) length, USER_PAGE_SIZE);
+
+    if (flags & LINUX_MAP_FIXED) {
+        if ((!IS_ALIGNED(addr, USER_PAGE_SIZE)) || (!guest_range_valid(addr, size))) {
+            return -LINUX_ENOMEM;
+        }
+    } else {
+        if (mmap_next + size > USER_MMAP_BASE + USER_MMAP_SIZE) {
+            return -LINUX_ENOMEM;
+        }
+
+        addr = mmap_next;
+        mmap_next += size;
+    }
+
+    guest_fill(addr, 0, size);
+
+    if (!(flags & LINUX_MAP_ANONYMOUS)) {
+        /* Private file mapping, the content is copied */
+        off_t offset = (off_t) pgoffset * USER_PAGE_SIZE;
+
+        for (uint32_t done = 0; done < length;) {
+            uint32_t chunk = length - done;
+            chunk = (chunk > USER_IO_CHUNK) ? USER_IO_CHUNK : chunk;
+
+            int32_t result = sys_read(fd, addr + done, chunk, offset + done);
+            if (result < 0) {
+                return result;
+            }
+
+            if (result == 0) {
+                break;
+            }
+
+            done += result;
+        }
+    }
+
+    return addr;
+}
+
+static int32_t sys_munmap(uint32_t addr, uint32_t length)
+{
+    uint32_t size = ALIGN_UP(length, USER_PAGE_SIZE);
+
+    /* Only the last mapping is returned to the mmap area */
+    if (addr + size == mmap_next) {
+        mmap_next = addr;
+    }
+
+    return 0;
+}
+
+static int32_t sys_readlinkat(uint32_t dirfd, uint32_t path_addr, uint32_t buf, uint32_t size)
+{
+    char path[USER_PATH_MAX];
+    char target[USER_PATH_MAX];
+
+    if (!guest_string(path_addr, path, sizeof(path))) {
+        return -LINUX_EFAULT;
+    }
+
+    ssize_t length;
+
+    if (strcmp(path, "/proc/self/exe") == 0) {
+        if (realpath(user_program, target) == NULL) {
+            return user_errno();
+        }
+
+        length = strlen(target);
+    } else {
+        length = readlinkat(user_dirfd(dirfd), path, target, sizeof(target));
+        if (length < 0) {
+            return user_errno();
+        }
+    }
+
+    length = ((size_t) length > size) ? size : (size_t) length;
+
+    if (!guest_range_valid(buf, length)) {
+        return -LINUX_EFAULT;
+    }
+
+    guest_write(buf, target, length);
+    return length;
+}
+
+static int32_t sys_getcwd(uint32_t buf, uint32_t size)
+{
+    char cwd[USER_PATH_MAX];
+
+    if (getcwd(cwd, sizeof(cwd)) == NULL) {
+        return user_errno();
+    }
+
+    uint32_t length = strlen(cwd) + 1;
+
+    if (length > size) {
+        return -34; /* ERANGE */
+    }
+
+    if (!guest_range_valid(buf, length)) {
+        return -LINUX_EFAULT;
+    }
+
+    guest_write(buf, cwd, length);
+    return length;
+}
+
+static int32_t sys_path_call(uint32_t syscall, uint32_t dirfd, uint32_t path_addr, uint32_t arg)
+{
+    char path[USER_PATH_MAX];
+
+    if (!guest_string(path_addr, path, sizeof(path))) {
+        return -LINUX_EFAULT;
+    }
+
+    switch (syscall) {
+    case USER_SYS_mkdirat:
+        return user_result(mkdirat(user_dirfd(dirfd), path, (mode_t) arg));
+    case USER_SYS_unlinkat:
+        return user_result(unlinkat(user_dirfd(dirfd), path,
+                (arg & LINUX_AT_REMOVEDIR) ? AT_REMOVEDIR : 0));
+    case USER_SYS_faccessat:
+        return user_result(faccessat(user_dirfd(dirfd), path, arg, 0));
+    default:
+        return -LINUX_ENOSYS;
+    }
+}
+
+static int32_t sys_fcntl(uint32_t fd, uint32_t cmd, uint32_t arg)
+{
+    switch (cmd) {
+    case LINUX_F_DUPFD:
+        return user_result(fcntl(fd, F_DUPFD, arg));
+    case LINUX_F_DUPFD_CLOEXEC:
+        return user_result(fcntl(fd, F_DUPFD_CLOEXEC, arg));
+    case LINUX_F_GETFD:
+        return user_result(fcntl(fd, F_GETFD));
+    case LINUX_F_SETFD:
+        return user_result(fcntl(fd, F_SETFD, arg));
+    case LINUX_F_GETFL: {
+        int flags = fcntl(fd, F_GETFL);
+        return (flags < 0) ? user_errno() : (int32_t) linux_open_flags(flags);
+    }
+    case LINUX_F_SETFL:
+        return user_result(fcntl(fd, F_SETFL, user_open_flags(arg) & ~O_ACCMODE));
+    default:
+        return -LINUX_EINVAL;
+    }
+}
+
+static int32_t sys_pipe2(uint32_t fds_addr)
+{
+    if (!guest_range_valid(fds_addr, 8)) {
+        return -LINUX_EFAULT;
+    }
+
+    int fds[2];
+
+    if (pipe(fds) < 0) {
+        return user_errno();
+    }
+
+    guest_write32(fds_addr, fds[0]);
+    guest_write32(fds_addr + 4, fds[1]);
+    return 0;
+}
+
+static int32_t sys_prlimit64(uint32_t resource, uint32_t old_limit)
+{
+    if (old_limit != 0) {
+        if (!guest_range_valid(old_limit, 16)) {
+            return -LINUX_EFAULT;
+        }
+
+        uint64_t limit = (resource == LINUX_RLIMIT_STACK) ? USER_STACK_SIZE : UINT64_MAX;
+        guest_write64(old_limit, limit);
+        guest_write64(old_limit + 8, limit);
+    }
+
+    return 0;
+}
+
+static int32_t sys_getrandom(uint32_t buf, uint32_t count)
+{
+    if (!guest_range_valid(buf, count)) {
+        return -LINUX_EFAULT;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        physmem_write8(USER_CPU, buf + i, (uint8_t) random_next(), false);
+    }
+
+    return count;
+}
+
+/** Zero the optional output structure of a system call */
+static int32_t sys_clear(uint32_t addr, uint32_t size)
+{
+    if (addr != 0) {
+        if (!guest_range_valid(addr, size)) {
+            return -LINUX_EFAULT;
+        }
+
+        guest_fill(addr, 0, size);
+    }
+
+    return 0;
+}
+
+static int32_t sys_kill(uint32_t sig)
+{
+    if (sig == 0) {
+        return 0;
+    }
+
+    alert("Program terminated by signal %" PRIu32, sig);
+    user_terminate(128 + sig);
+    return 0;
+}
+
+/** Execute the system call requested by the environment call */
+static int32_t user_syscall(rv_cpu_t *cpu)
+{
+    uint32_t nr = cpu->regs[REG_A7];
+    uint32_t *a = &cpu->regs[REG_A0];
+
+    switch (nr) {
+    case USER_SYS_getcwd:
+        return sys_getcwd(a[0], a[1]);
+    case USER_SYS_dup:
+        return user_result(dup(a[0]));
+    case USER_SYS_dup3:
+        if (a[0] == a[1]) {
+            return -LINUX_EINVAL;
+        }
+        return user_result(dup2(a[0], a[1]));
+    case USER_SYS_fcntl64:
+        return sys_fcntl(a[0], a[1], a[2]);
+    case USER_SYS_ioctl:
+        if ((a[1] == LINUX_TCGETS) && (isatty(a[0]))) {
+            return sys_clear(a[2], LINUX_TERMIOS_SIZE);
+        }
+        return -LINUX_ENOTTY;
+    case USER_SYS_mkdirat:
+    case USER_SYS_unlinkat:
+    case USER_SYS_faccessat:
+        return sys_path_call(nr, a[0], a[1], a[2]);
+    case USER_SYS_openat:
+        return sys_openat(a[0], a[1], a[2], a[3]);
+    case USER_SYS_close:
+        return sys_close(a[0]);
+    case USER_SYS_pipe2:
+        return sys_pipe2(a[0]);
+    case USER_SYS_llseek:
+        return sys_llseek(a[0], a[1], a[2], a[3], a[4]);
+    case USER_SYS_read:
+        return sys_read(a[0], a[1], a[2], -1);
+    case USER_SYS_write:
+        return sys_write(a[0], a[1], a[2], -1);
+    case USER_SYS_readv:
+        return sys_readv_writev(a[0], a[1], a[2], false);
+    case USER_SYS_writev:
+        return sys_readv_writev(a[0], a[1], a[2], true);
+    case USER_SYS_pread64:
+        return sys_read(a[0], a[1], a[2], ((int64_t) a[4] << 32) | a[3]);
+    case USER_SYS_pwrite64:
+        return sys_write(a[0], a[1], a[2], ((int64_t) a[4] << 32) | a[3]);
+    case USER_SYS_readlinkat:
+        return sys_readlinkat(a[0], a[1], a[2], a[3]);
+    case USER_SYS_fsync:
+        return user_result(fsync(a[0]));
+    case USER_SYS_exit:
+    case USER_SYS_exit_group:
+        user_terminate(a[0] & 0xff);
+        return 0;
+    case USER_SYS_set_tid_address:
+    case USER_SYS_getpid:
+    case USER_SYS_gettid:
+        return getpid();
+    case USER_SYS_getppid:
+        return getppid();
+    case USER_SYS_getuid:
+        return getuid();
+    case USER_SYS_geteuid:
+        return geteuid();
+    case USER_SYS_getgid:
+        return getgid();
+    case USER_SYS_getegid:
+        return getegid();
+    case USER_SYS_clock_gettime:
+        return sys_clock_gettime(a[0], a[1], false);
+    case USER_SYS_clock_gettime64:
+        return sys_clock_gettime(a[0], a[1], true);
+    case USER_SYS_kill:
+    case USER_SYS_tkill:
+        return sys_kill(a[1]);
+    case USER_SYS_tgkill:
+        return sys_kill(a[2]);
+    case USER_SYS_rt_sigaction:
+        /* No signals are delivered, all handlers are default */
+        return sys_clear(a[2], 16);
+    case USER_SYS_rt_sigprocmask:
+        return sys_clear(a[2], 8);
+    case USER_SYS_uname:
+        return sys_uname(a[0]);
+    case USER_SYS_brk:
+        return sys_brk(a[0]);
+    case USER_SYS_munmap:
+        return sys_munmap(a[0], a[1]);
+    case USER_SYS_mmap2:
+        return sys_mmap2(a[0], a[1], a[2], a[3], a[4], a[5]);
+    case USER_SYS_set_robust_list:
+    case USER_SYS_mprotect:
+    case USER_SYS_madvise:
+    case USER_SYS_riscv_flush_icache:
+        return 0;
+    case USER_SYS_prlimit64:
+        return sys_prlimit64(a[1], a[3]);
+    case USER_SYS_getrandom:
+        return sys_getrandom(a[0], a[1]);
+    case USER_SYS_statx:
+        return sys_statx(a[0], a[1], a[2], a[4]);
+    default:
+        alert("Unsupported system call %" PRIu32 " at address 0x%08" PRIx32,
+                nr, cpu->pc);
+        return -LINUX_ENOSYS;
+    }
+}
+
+/** Trap hook of the processor
+ *
+ * The environment calls are executed as system calls, any other
+ * exception terminates the program as the corresponding signal.
+ *
+ */
+static bool user_trap(rv_cpu_t *cpu, rv_exc_t ex)
+{
+    if (ex == rv_exc_umode_environment_call) {
+        cpu->regs[REG_A0] = (uint32_t) user_syscall(cpu);
+        return true;
+    }
+
+    int sig;
+
+    switch (ex) {
+    case rv_exc_illegal_instruction:
+        sig = LINUX_SIGILL;
+        break;
+    case rv_exc_breakpoint:
+        sig = LINUX_SIGTRAP;
+        break;
+    default:
+        sig = LINUX_SIGSEGV;
+        break;
+    }
+
+    error("Exception %u at address 0x%08" PRIx32 " (tval 0x%08" PRIx32 ")",
+            (unsigned int) ex, cpu->pc, cpu->csr.tval_next);
+    user_terminate(128 + sig);
+    return true;
+}
+
+/*
+ * Program loading
+ */
+
+static void user_command(const char *fmt, ...)
+{
+    string_t cmd;
+    string_init(&cmd);
+
+    va_list args;
+    va_start(args, fmt);
+    string_vprintf(&cmd, fmt, args);
+    va_end(args);
+
+    if (!interpret(cmd.str)) {
+        die(ERR_INIT, "User-mode setup failed: %s", cmd.str);
+    }
+
+    string_done(&cmd);
+}
+
+static void user_load_segments(elf_t *elf)
+{
+    for (unsigned int i = 0; i < elf->segment_count; i++) {
+        elf_segment_t *segment = &elf->segments[i];
+
+        if ((segment->type != ELF_SEGMENT_LOAD) || (segment->filesz == 0)) {
+            continue;
+        }
+
+        uint8_t *data = safe_malloc(segment->filesz);
+
+        if (!elf_read(elf, segment->offset, data, segment->filesz)) {
+            die(ERR_INIT, "Cannot load program");
+        }
+
+        guest_write(segment->vaddr, data, segment->filesz);
+        safe_free(data);
+    }
+}
+
+/** Find the address of the program headers in the memory */
+static uint32_t user_phdr(elf_t *elf)
+{
+    for (unsigned int i = 0; i < elf->segment_count; i++) {
+        elf_segment_t *segment = &elf->segments[i];
+
+        if (segment->type == ELF_SEGMENT_PHDR) {
+            return segment->vaddr;
+        }
+    }
+
+    for (unsigned int i = 0; i < elf->segment_count; i++) {
+        elf_segment_t *segment = &elf->segments[i];
+
+        if ((segment->type == ELF_SEGMENT_LOAD) && (elf->phoff >= segment->offset)
+                && (elf->phoff < segment->offset + segment->filesz)) {
+            return segment->vaddr + (elf->phoff - segment->offset);
+        }
+    }
+
+    return 0;
+}
+
+/** Push data to the stack under construction */
+static uint32_t user_push(uint32_t sp, const void *data, size_t size)
+{
+    sp -= size;
+    guest_write(sp, data, size);
+    return sp;
+}
+
+/** Build the initial stack of the program
+ *
+ * The layout follows the Linux ABI: argc, argv, envp and the auxiliary
+ * vector, followed by the strings and the random bytes.
+ *
+ * @return The initial stack pointer.
+ *
+ */
+static uint32_t user_setup_stack(elf_t *elf, int argc, char *argv[])
+{
+    uint32_t sp = (uint32_t) USER_STACK_TOP;
+    uint32_t *argv_addr = safe_malloc(sizeof(uint32_t) * argc);
+
+    for (int i = argc - 1; i >= 0; i--) {
+        sp = user_push(sp, argv[i], strlen(argv[i]) + 1);
+        argv_addr[i] = sp;
+    }
+
+    uint8_t random[16];
+    for (unsigned int i = 0; i < sizeof(random); i++) {
+        random[i] = (uint8_t) random_next();
+    }
+
+    sp = user_push(ALIGN_DOWN(sp, 16), random, sizeof(random));
+    uint32_t random_addr = sp;
+
+    uint32_t auxv[USER_AUXV_COUNT][2] = {
+        { AT_PHDR, user_phdr(elf) },
+        { AT_PHENT, ELF_SEGMENT_HEADER_SIZE },
+        { AT_PHNUM, elf->segment_count },
+        { AT_PAGESZ, USER_PAGE_SIZE },
+        { AT_ENTRY, elf->entry },
+        { AT_UID, getuid() },
+        { AT_EUID, geteuid() },
+        { AT_GID, getgid() },
+        { AT_EGID, getegid() },
+        /* I, M, A, F, D and C extensions (as advertised by misa) */
+        { AT_HWCAP, (1 << ('i' - 'a')) | (1 << ('m' - 'a')) | (1 << ('a' - 'a'))
+                | (1 << ('f' - 'a')) | (1 << ('d' - 'a')) | (1 << ('c' - 'a')) },
+        { AT_CLKTCK, 100 },
+        { AT_SECURE, 0 },
+        { AT_RANDOM, random_addr },
+        { AT_EXECFN, argv_addr[0] },
+        { AT_NULL, 0 }
+    };
+
+    /* argc, argv with NULL, empty envp with NULL, auxiliary vector */
+    uint32_t words = 1 + argc + 1 + 1 + 2 * USER_AUXV_COUNT;
+    sp = ALIGN_DOWN(sp - words * 4, 16);
+
+    uint32_t addr = sp;
+    guest_write32(addr, argc);
+    addr += 4;
+
+    for (int i = 0; i < argc; i++) {
+        guest_write32(addr, argv_addr[i]);
+        addr += 4;
+    }
+
+    /* argv and envp terminators */
+    guest_write32(addr, 0);
+    guest_write32(addr + 4, 0);
+    addr += 8;
+
+    guest_write(addr, auxv, sizeof(auxv));
+
+    safe_free(argv_addr);
+    return sp;
+}
+
+/** Set up the machine and load the program
+ *
+ * @param argc Number of the program arguments (including the program).
+ * @param argv Program arguments, the first one is the ELF executable.
+ *
+ */
+void user_init(int argc, char *argv[])
+{
+    ASSERT(argc > 0);
+
+    elf_t elf;
+
+    if (!elf_open(&elf, argv[0])) {
+        die(ERR_INIT, "Cannot load program");
+    }
+
+    if (elf.machine != ELF_MACHINE_RISCV) {
+        die(ERR_INIT, "Not a RISC-V executable (%s)", argv[0]);
+    }
+
+    uint64_t lo = UINT64_MAX;
+    uint64_t hi = 0;
+
+    for (unsigned int i = 0; i < elf.segment_count; i++) {
+        elf_segment_t *segment = &elf.segments[i];
+
+        if (segment->type == ELF_SEGMENT_INTERP) {
+            die(ERR_INIT, "Only static executables are supported (%s)", argv[0]);
+        }
+
+        if (segment->type == ELF_SEGMENT_LOAD) {
+            lo = (segment->vaddr < lo) ? segment->vaddr : lo;
+            hi = ((uint64_t) segment->vaddr + segment->memsz > hi)
+                    ? (uint64_t) segment->vaddr + segment->memsz
+                    : hi;
+        }
+    }
+
+    if ((elf.type != ELF_TYPE_EXEC) || (lo >= hi)) {
+        die(ERR_INIT, "Not an executable (%s)", argv[0]);
+    }
+
+    uint32_t image_start = ALIGN_DOWN(lo, USER_PAGE_SIZE);
+    brk_start = ALIGN_UP(hi, USER_PAGE_SIZE);
+    brk_current = brk_start;
+    brk_end = brk_start + USER_HEAP_SIZE;
+    mmap_next = USER_MMAP_BASE;
+
+    if ((uint64_t) brk_start + USER_HEAP_SIZE > USER_MMAP_BASE) {
+        die(ERR_INIT, "Program does not fit below %#" PRIx32, USER_MMAP_BASE);
+    }
+
+    user_command("add drvcpu cpu0");
+    /* Linux handles misaligned accesses transparently */
+    user_command("cpu0 misaligned on");
+    user_command("add rwm image %#" PRIx32, image_start);
+    user_command("image generic %#" PRIx32, brk_end - image_start);
+    user_command("add rwm mmap %#" PRIx32, USER_MMAP_BASE);
+    user_command("mmap generic %#" PRIx32, USER_MMAP_SIZE);
+    user_command("add rwm stack %#" PRIx64, USER_STACK_TOP - USER_STACK_SIZE);
+    user_command("stack generic %#" PRIx32, USER_STACK_SIZE);
+
+    user_load_segments(&elf);
+    user_program = safe_strdup(argv[0]);
+
+    rv_cpu_t *cpu = (rv_cpu_t *) get_cpu(0)->data;
+
+    cpu->regs[REG_SP] = user_setup_stack(&elf, argc, argv);
+    cpu->priv_mode = rv_umode;
+    rv_cpu_set_pc(cpu, elf.entry);
+
+    /* Allow reading the cycle, time and instret counters */
+    cpu->csr.mcounteren = 0x7;
+    cpu->csr.scounteren = 0x7;
+
+    /* Linux enables the floating-point unit for every process */
+    cpu->csr.mstatus |= (uint64_t) rv_fs_initial << rv_csr_sstatus_fs_pos;
+
+    rv_trap_hook = user_trap;
+
+    elf_close(&elf);
+}
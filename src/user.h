@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  User-mode emulation
+ *
+ */
+
+#ifndef USER_H_
+#define USER_H_
+
+/** Exit status of the emulated program */
+extern int user_exit_status;
+
+extern void user_init(int argc, char *argv[]);
+
+#endif
@@ -11,6 +11,7 @@
 
 #include <inttypes.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -435,3 +436,109 @@ uint64_t current_timestamp(void)
     uint64_t milliseconds = te.tv_sec * 1000LL + te.tv_usec / 1000; // calculate milliseconds
     return milliseconds;
 }
+
+#define HASH_PRIME1 UINT64_C(0x9E3779B185EBCA87)
+#define HASH_PRIME2 UINT64_C(0xC2B2AE3D27D4EB4F)
+#define HASH_PRIME3 UINT64_C(0x165667B19E3779F9)
+#define HASH_PRIME4 UINT64_C(0x85EBCA77C2B2AE63)
+#define HASH_PRIME5 UINT64_C(0x27D4EB2F165667C5)
+
+/** Number of independent lanes of the hash */
+#define HASH_LANES 4
+
+static uint64_t hash_rotl(uint64_t val, unsigned int shift)
+{
+    return (val << shift) | (val >> (64 - shift));
+}
+
+static uint64_t hash_round(uint64_t acc, uint64_t input)
+{
+    acc += input * HASH_PRIME2;
+    acc = hash_rotl(acc, 31);
+    return acc * HASH_PRIME1;
+}
+
+static uint64_t hash_merge(uint64_t acc, uint64_t lane)
+{
+    acc ^= hash_round(0, lane);
+    return acc * HASH_PRIME1 + HASH_PRIME4;
+}
+
+static uint64_t hash_load(const uint8_t *ptr)
+{
+    uint64_t val;
+    memcpy(&val, ptr, sizeof(val));
+    return val;
+}
+
+/** Compute a 64-bit hash of a memory block
+ *
+ * The bulk of the data is processed in four independent lanes
+ * (in the fashion of xxHash64), so the compiler can keep the lanes
+ * in vector registers and the hash runs close to the memory bandwidth.
+ *
+ * The hash depends on the host byte order.
+ *
+ * @param data Data to hash.
+ * @param size Size of the data in bytes.
+ * @param seed Initial value (allows chaining of several blocks).
+ *
+ * @return Hash value.
+ *
+ */
+uint64_t hash64(const void *data, size_t size, uint64_t seed)
+{
+    const uint8_t *ptr = (const uint8_t *) data;
+    const uint8_t *end = ptr + size;
+    uint64_t hash;
+
+    if (size >= HASH_LANES * sizeof(uint64_t)) {
+        uint64_t lanes[HASH_LANES] = {
+            seed + HASH_PRIME1 + HASH_PRIME2,
+            seed + HASH_PRIME2,
+            seed,
+            seed - HASH_PRIME1
+        };
+
+        while (end - ptr >= (ptrdiff_t) (HASH_LANES * sizeof(uint64_t))) {
+            for (unsigned int i = 0; i < HASH_LANES; i++) {
+                lanes[i] = hash_round(lanes[i],
+                        hash_load(ptr + i * sizeof(uint64_t)));
+            }
+
+            ptr += HASH_LANES * sizeof(uint64_t);
+        }
+
+        hash = hash_rotl(lanes[0], 1) + hash_rotl(lanes[1], 7)
+                + hash_rotl(lanes[2], 12) + hash_rotl(lanes[3], 18);
+
+        for (unsigned int i = 0; i < HASH_LANES; i++) {
+            hash = hash_merge(hash, lanes[i]);
+        }
+    } else {
+        hash = seed + HASH_PRIME5;
+    }
+
+    hash += size;
+
+    while (end - ptr >= (ptrdiff_t) sizeof(uint64_t)) {
+        hash ^= hash_round(0, hash_load(ptr));
+        hash = hash_rotl(hash, 27) * HASH_PRIME1 + HASH_PRIME4;
+        ptr += sizeof(uint64_t);
+    }
+
+    while (ptr < end) {
+        hash ^= (*ptr) * HASH_PRIME5;
+        hash = hash_rotl(hash, 11) * HASH_PRIME1;
+        ptr++;
+    }
+
+    /* Final avalanche */
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
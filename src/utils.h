@@ -98,4 +98,6 @@ extern void try_munmap(void *ptr, size_t size);
 
 extern uint64_t current_timestamp(void);
 
+extern uint64_t hash64(const void *data, size_t size, uint64_t seed);
+
 #endif
@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+
+"""
+Guest workload benchmarks.
+
+Every workload is run by MSIM until the guest halts the machine. The
+simulation speed, the wall time and the peak resident set size of the
+simulator are reported in JSON, so that changes of the simulator speed
+can be measured and compared.
+
+With --scaling the SMP scaling workloads are run with increasing numbers
+of processors and the host time per simulated instruction is reported
+for every processor count.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import threading
+import time
+
+WORKLOADS = [
+    "rv32-integer",
+    "rv32-ptrchase",
+    "rv32-tlb",
+    "rv32-trap",
+    "rv32-smp",
+    "rv32-io",
+    "mips32-integer",
+    "mips32-ptrchase",
+    "mips32-tlb",
+    "mips32-trap",
+    "mips32-smp",
+    "mips32-io"
+]
+
+SCALING_WORKLOADS = [
+    "rv32-scale",
+    "rv32-scale-atomic",
+    "mips32-scale",
+    "mips32-scale-atomic"
+]
+
+SCALING_CPUS = [1, 2, 4, 8, 16, 32]
+
+MSIM_PATH = "../../msim"
+
+CONFIG_FILENAME = "msim.conf"
+SCALING_CONFIG_FILENAME = "scaling.conf"
+MEMUSAGE_FILENAME = "memusage.json"
+
+CYCLES_PATTERN = re.compile(r"^Cycles: (\d+)$", re.MULTILINE)
+CPU_PATTERN = re.compile(r"^\s*add\s+(dr4kcpu|drvcpu)\s", re.MULTILINE)
+CPU_LINE_PATTERN = re.compile(r"^\s*add\s+(dr4kcpu|drvcpu)\s+\S+\s*$", re.MULTILINE)
+
+
+class BenchmarkError(Exception):
+    pass
+
+
+def count_cpus(workload):
+    with open(os.path.join(workload, CONFIG_FILENAME)) as f:
+        return len(CPU_PATTERN.findall(f.read()))
+
+
+def write_scaling_config(workload, cpus):
+    """Replicate the processor of the workload configuration."""
+    with open(os.path.join(workload, CONFIG_FILENAME)) as f:
+        config = f.read()
+
+    match = CPU_LINE_PATTERN.search(config)
+    if match is None:
+        raise BenchmarkError("{w}: no processor in the configuration".format(
+            w=workload))
+
+    processors = "\n".join(
+        "add {t} cpu{i}".format(t=match.group(1), i=i) for i in range(cpus))
+    config = config[:match.start()] + processors + config[match.end():]
+
+    with open(os.path.join(workload, SCALING_CONFIG_FILENAME), "w") as f:
+        f.write(config)
+
+
+def peak_rss_kb(rusage):
+    # Linux reports kilobytes, macOS bytes
+    if sys.platform == "darwin":
+        return rusage.ru_maxrss // 1024
+    return rusage.ru_maxrss
+
+
+def read_memusage(workload):
+    filename = os.path.join(workload, MEMUSAGE_FILENAME)
+    try:
+        with open(filename) as f:
+            usage = json.load(f)
+    except (OSError, ValueError) as e:
+        raise BenchmarkError("{w}: no memory usage ({e})".format(
+            w=workload, e=e))
+    finally:
+        if os.path.exists(filename):
+            os.remove(filename)
+
+    # Resident bytes of every component
+    return {
+        name: value["resident"]
+        for name, value in usage["components"].items()
+    }
+
+
+def run_once(msim, workload, timeout, config=CONFIG_FILENAME):
+    start = time.monotonic()
+    proc = subprocess.Popen([msim, "--config=" + config,
+                             "--memusage=" + MEMUSAGE_FILENAME],
+                            cwd=workload, stdin=subprocess.DEVNULL,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            text=True, errors="replace")
+
+    timer = threading.Timer(timeout, proc.kill)
+    timer.start()
+    try:
+        output = proc.stdout.read()
+        _, status, rusage = os.wait4(proc.pid, 0)
+    finally:
+        timer.cancel()
+        proc.stdout.close()
+
+    wall_time = time.monotonic() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+
+    if proc.returncode != 0:
+        raise BenchmarkError("{w}: MSIM exited with {c}".format(
+            w=workload, c=proc.returncode))
+
+    match = CYCLES_PATTERN.search(output)
+    if match is None:
+        raise BenchmarkError("{w}: no cycle count in the output".format(
+            w=workload))
+
+    return int(match.group(1)), wall_time, peak_rss_kb(rusage), read_memusage(workload)
+
+
+def run_workload(msim, workload, repeat, timeout):
+    cpus = count_cpus(workload)
+    best = None
+
+    for _ in range(repeat):
+        cycles, wall_time, rss, memory = run_once(msim, workload, timeout)
+        if (best is None) or (wall_time < best[1]):
+            best = (cycles, wall_time, rss, memory)
+
+    cycles, wall_time, rss, memory = best
+
+    # Every processor executes one instruction per machine cycle
+    instructions = cycles * cpus
+
+    return {
+        "name": workload,
+        "arch": workload.split("-")[0],
+        "cpus": cpus,
+        "cycles": cycles,
+        "instructions": instructions,
+        "wall_time": round(wall_time, 6),
+        "instructions_per_second": round(instructions / wall_time),
+        "peak_rss_kb": rss,
+        "memory": memory
+    }
+
+
+def run_scaling(msim, workload, cpus, repeat, timeout):
+    write_scaling_config(workload, cpus)
+
+    best = None
+    try:
+        for _ in range(repeat):
+            cycles, wall_time, _, _ = run_once(msim, workload, timeout,
+                                               SCALING_CONFIG_FILENAME)
+            if (best is None) or (wall_time < best[1]):
+                best = (cycles, wall_time)
+    finally:
+        os.remove(os.path.join(workload, SCALING_CONFIG_FILENAME))
+
+    cycles, wall_time = best
+    instructions = cycles * cpus
+
+    # Constant host time per instruction means linear scaling
+    return {
+        "name": workload,
+        "arch": workload.split("-")[0],
+        "cpus": cpus,
+        "cycles": cycles,
+        "instructions": instructions,
+        "wall_time": round(wall_time, 6),
+        "ns_per_instruction": round(wall_time * 1e9 / instructions, 3),
+        "ns_per_cycle": round(wall_time * 1e9 / cycles, 3)
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run the MSIM guest workload benchmarks.")
+    parser.add_argument("workloads", nargs="*", metavar="workload",
+                        help="workloads to run (all by default)")
+    parser.add_argument("--msim", default=MSIM_PATH,
+                        help="path to the MSIM binary")
+    parser.add_argument("--output", "-o",
+                        help="write the results to a file instead of stdout")
+    parser.add_argument("--repeat", "-r", type=int, default=1,
+                        help="run every workload several times and report the fastest run")
+    parser.add_argument("--timeout", type=float, default=300,
+                        help="timeout of a single run in seconds")
+    parser.add_argument("--scaling", action="store_true",
+                        help="run the SMP scaling workloads with 1 to 32 processors")
+    parser.add_argument("--cpus", type=lambda arg: [int(n) for n in arg.split(",")],
+                        default=SCALING_CPUS,
+                        help="comma-separated processor counts of the scaling runs")
+    args = parser.parse_args()
+
+    os.chdir(os.path.dirname(os.path.abspath(__file__)))
+    msim = os.path.abspath(args.msim)
+
+    known = SCALING_WORKLOADS if args.scaling else WORKLOADS
+    workloads = args.workloads if args.workloads else known
+    for workload in workloads:
+        if workload not in known:
+            parser.error("unknown workload {w}".format(w=workload))
+
+    for cpus in args.cpus:
+        if (cpus < 1) or (cpus > 32):
+            parser.error("processor count {n} out of range 1..32".format(n=cpus))
+
+    results = []
+    try:
+        for workload in workloads:
+            if args.scaling:
+                for cpus in args.cpus:
+                    print("bench: {w} ({n} cpus)".format(w=workload, n=cpus),
+                          file=sys.stderr)
+                    results.append(run_scaling(msim, workload, cpus,
+                                               args.repeat, args.timeout))
+            else:
+                print("bench: {w}".format(w=workload), file=sys.stderr)
+                results.append(run_workload(msim, workload, args.repeat, args.timeout))
+    except (BenchmarkError, OSError) as e:
+        print("failure! ({e})".format(e=e), file=sys.stderr)
+        exit(1)
+
+    report = json.dumps({"scaling" if args.scaling else "workloads": results}, indent=4)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(report + "\n")
+    else:
+        print(report)
+
+
+if __name__ == "__main__":
+    main()
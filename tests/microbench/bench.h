@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Host microbenchmarks of the simulator hot paths
+ *
+ */
+
+#ifndef MICROBENCH_BENCH_H_
+#define MICROBENCH_BENCH_H_
+
+#include <stdint.h>
+
+/** Benchmarked operation repeated the given number of times */
+typedef void (*bench_func_t)(uint64_t iterations);
+
+/** Sink for the results of the benchmarked operations */
+extern volatile uint64_t bench_sink;
+
+extern void bench_run(const char *name, bench_func_t func);
+extern void bench_setup(const char *command);
+
+/** Benchmark groups */
+extern void bench_physmem(void);
+extern void bench_riscv(void);
+extern void bench_r4k(void);
+extern void bench_breakpoints(void);
+extern void bench_devmem(void);
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Code breakpoint benchmarks
+ *
+ */
+
+#include <stdio.h>
+
+#include "../../src/debug/breakpoint.h"
+#include "../../src/device/cpu/mips_r4000/cpu.h"
+#include "../../src/device/device.h"
+#include "../../src/device/dr4kcpu.h"
+#include "bench.h"
+
+/** Addresses of the breakpoints (never hit) */
+#define BREAKPOINT_ADDRESS UINT64_C(0xffffffff90000000)
+
+static void check_code_breakpoints(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += breakpoint_check_for_code_breakpoints();
+    }
+
+    bench_sink = sum;
+}
+
+void bench_breakpoints(void)
+{
+    static const unsigned int counts[] = { 0, 1, 16, 256 };
+
+    bench_setup("add dr4kcpu bench_cpu");
+    r4k_cpu_t *cpu = get_r4k(dev_by_name("bench_cpu"));
+    unsigned int breakpoints = 0;
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        while (breakpoints < counts[i]) {
+            ptr64_t addr = { .ptr = BREAKPOINT_ADDRESS + breakpoints * 4 };
+            breakpoint_t *bp = breakpoint_init(addr, BREAKPOINT_KIND_SIMULATOR);
+            list_append(&cpu->bps, &bp->item);
+            breakpoints++;
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name),
+                "breakpoint_check_for_code_breakpoints (%u)", breakpoints);
+        bench_run(name, check_code_breakpoints);
+    }
+}
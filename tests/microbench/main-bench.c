@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Host microbenchmarks of the simulator hot paths
+ *
+ * Every benchmark repeats a single operation until the measurement
+ * takes at least the minimal time and reports the average time of
+ * the operation in nanoseconds.
+ *
+ * Usage: microbench [--json] [--time seconds] [filter]
+ *
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../src/cmd.h"
+#include "../../src/fault.h"
+#include "../../src/main.h"
+#include "bench.h"
+
+/*
+ * MSIM main.cpp MOCK
+ */
+
+/** Configuration file name */
+char *config_file = NULL;
+
+/** Remote GDB debugging */
+bool remote_gdb = false;
+unsigned int remote_gdb_port = 0;
+bool remote_gdb_conn = false;
+bool remote_gdb_listen = false;
+bool remote_gdb_step = false;
+
+/** General simulator behaviour */
+bool machine_nondet = false;
+
+bool machine_trace = false;
+bool machine_halt = false;
+bool machine_break = false;
+bool machine_interactive = false;
+bool machine_newline = false;
+bool machine_undefined = false;
+bool machine_specific_instructions = true;
+bool machine_allow_interactive_without_tty = false;
+bool machine_fast = false;
+bool machine_profile = false;
+uint64_t stepping = 0;
+uint64_t machine_steps = 0;
+
+/*
+ * Benchmark harness
+ */
+
+volatile uint64_t bench_sink = 0;
+
+/** Minimal time of a measurement (in seconds) */
+static double min_time = 0.2;
+
+/** Print the results in JSON */
+static bool json = false;
+static bool json_first = true;
+
+/** Run only the benchmarks containing the filter in their name */
+static const char *filter = NULL;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static double measure(bench_func_t func, uint64_t iterations)
+{
+    double start = now();
+    func(iterations);
+    return now() - start;
+}
+
+/** Measure and report a single benchmark
+ *
+ * @param name Name of the benchmark.
+ * @param func Benchmarked operation.
+ *
+ */
+void bench_run(const char *name, bench_func_t func)
+{
+    if ((filter != NULL) && (strstr(name, filter) == NULL)) {
+        return;
+    }
+
+    /* Warm up and calibrate */
+    uint64_t iterations = 1;
+    double elapsed;
+
+    while (true) {
+        elapsed = measure(func, iterations);
+        if (elapsed >= min_time) {
+            break;
+        }
+
+        iterations *= (elapsed < min_time / 100) ? 100 : 2;
+    }
+
+    double ns = elapsed * 1e9 / (double) iterations;
+
+    if (json) {
+        printf("%s\n        { \"name\": \"%s\", \"ns_per_op\": %.3f, "
+               "\"iterations\": %" PRIu64 " }",
+                json_first ? "" : ",", name, ns, iterations);
+        json_first = false;
+    } else {
+        printf("%-48s %12.2f ns/op\n", name, ns);
+    }
+
+    fflush(stdout);
+}
+
+/** Execute a configuration command needed by a benchmark */
+void bench_setup(const char *command)
+{
+    if (!interpret(command)) {
+        die(ERR_INTERN, "Benchmark setup failed: %s", command);
+    }
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [--json] [--time seconds] [filter]\n", name);
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if ((strcmp(argv[i], "--time") == 0) && (i + 1 < argc)) {
+            min_time = atof(argv[++i]);
+            if (min_time <= 0) {
+                usage(argv[0]);
+            }
+        } else if ((argv[i][0] != '-') && (filter == NULL)) {
+            filter = argv[i];
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    if (json) {
+        printf("{\n    \"benchmarks\": [");
+    }
+
+    bench_physmem();
+    bench_riscv();
+    bench_r4k();
+    bench_breakpoints();
+
+    /* Adds devices, so it has to be the last one */
+    bench_devmem();
+
+    if (json) {
+        printf("\n    ]\n}\n");
+    }
+
+    return 0;
+}
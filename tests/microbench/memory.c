@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  Physical memory and device memory benchmarks
+ *
+ */
+
+#include <stdio.h>
+
+#include "../../src/physmem.h"
+#include "bench.h"
+
+/** Memory layout of the benchmarks */
+#define RAM_ADDRESS UINT64_C(0x00000000)
+#define RAM_MASK UINT64_C(0x000ffffc)
+#define DEVICE_ADDRESS UINT64_C(0x90000000)
+#define DEVICE_STRIDE 8
+#define UNMAPPED_ADDRESS UINT64_C(0x800000000)
+
+/** Register of the last added device */
+static ptr36_t device_register;
+
+static void read32_ram(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += physmem_read32(0, RAM_ADDRESS + ((i * 68) & RAM_MASK), true);
+    }
+
+    bench_sink = sum;
+}
+
+static void write32_ram(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++) {
+        physmem_write32(0, RAM_ADDRESS + ((i * 68) & RAM_MASK), i, true);
+    }
+}
+
+static void read32_device(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += physmem_read32(0, device_register, true);
+    }
+
+    bench_sink = sum;
+}
+
+static void write32_device(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++) {
+        physmem_write32(0, device_register, i, true);
+    }
+}
+
+static void read32_unmapped(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        sum += physmem_read32(0, UNMAPPED_ADDRESS, true);
+    }
+
+    bench_sink = sum;
+}
+
+static void write32_unmapped(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++) {
+        physmem_write32(0, UNMAPPED_ADDRESS, i, true);
+    }
+}
+
+static unsigned int devices = 0;
+
+static void add_device(void)
+{
+    char command[64];
+    device_register = DEVICE_ADDRESS + devices * DEVICE_STRIDE;
+
+    snprintf(command, sizeof(command), "add dcycle bench_dev%u %#" PRIx64,
+            devices, device_register);
+    bench_setup(command);
+
+    devices++;
+}
+
+void bench_physmem(void)
+{
+    bench_setup("add rwm bench_ram 0");
+    bench_setup("bench_ram generic 1M");
+    add_device();
+
+    bench_run("physmem_read32 (RAM)", read32_ram);
+    bench_run("physmem_write32 (RAM)", write32_ram);
+    bench_run("physmem_read32 (MMIO)", read32_device);
+    bench_run("physmem_write32 (MMIO)", write32_device);
+    bench_run("physmem_read32 (unmapped)", read32_unmapped);
+    bench_run("physmem_write32 (unmapped)", write32_unmapped);
+}
+
+/** Device memory dispatch with an increasing number of devices */
+void bench_devmem(void)
+{
+    static const unsigned int counts[] = { 4, 16, 64 };
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        while (devices < counts[i]) {
+            add_device();
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "devmem read32 (%u devices)", devices);
+        bench_run(name, read32_device);
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  MIPS R4000 processor benchmarks
+ *
+ */
+
+#include "../../src/device/cpu/mips_r4000/cpu.h"
+#include "../../src/physmem.h"
+#include "bench.h"
+
+/** Pages mapped by the TLB (one entry maps a pair of pages) */
+#define REGION_VIRT UINT64_C(0x00000000)
+#define REGION_PHYS UINT64_C(0x00080000)
+#define PAIR_SIZE (2 * FRAME_SIZE)
+#define UNMAPPED_VIRT UINT64_C(0x01000000)
+
+/** Code of the stepping benchmarks (in KSEG0) */
+#define CODE_PHYS UINT32_C(0x00004000)
+#define CODE_VIRT UINT64_C(0xffffffff80004000)
+#define INSTR_BRANCH_TO_SELF UINT32_C(0x1000ffff)
+#define INSTR_NOP UINT32_C(0x00000000)
+
+static r4k_cpu_t cpu;
+
+static void setup_tlb(void)
+{
+    /* Kernel mode, no error level */
+    cp0_status(&cpu).val = 0;
+
+    for (unsigned int i = 0; i < TLB_ENTRIES; i++) {
+        tlb_entry_t *entry = &cpu.tlb[i];
+
+        entry->mask = (uint32_t) cp0_entryhi_vpn2_mask;
+        entry->vpn2 = (REGION_VIRT + i * PAIR_SIZE) & entry->mask;
+        entry->global = true;
+        entry->asid = 0;
+
+        for (unsigned int pg = 0; pg < 2; pg++) {
+            entry->pg[pg].pfn = REGION_PHYS + i * PAIR_SIZE + pg * FRAME_SIZE;
+            entry->pg[pg].dirty = true;
+            entry->pg[pg].valid = true;
+        }
+    }
+}
+
+/*
+ * The TLB lookup (tlb_look) is private to the processor,
+ * it is measured through the address conversion of KUSEG.
+ */
+
+static void convert_addr_hit_same(uint64_t iterations)
+{
+    uint64_t sum = 0;
+    ptr64_t virt = { .ptr = REGION_VIRT + (TLB_ENTRIES - 1) * PAIR_SIZE };
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        ptr36_t phys;
+        r4k_convert_addr(&cpu, virt, &phys, false, true);
+        sum += phys;
+    }
+
+    bench_sink = sum;
+}
+
+static void convert_addr_hit_all(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        ptr36_t phys;
+        ptr64_t virt = { .ptr = REGION_VIRT + (i % TLB_ENTRIES) * PAIR_SIZE };
+        r4k_convert_addr(&cpu, virt, &phys, false, true);
+        sum += phys;
+    }
+
+    bench_sink = sum;
+}
+
+static void convert_addr_miss(uint64_t iterations)
+{
+    uint64_t sum = 0;
+    ptr64_t virt = { .ptr = UNMAPPED_VIRT };
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        ptr36_t phys;
+        sum += r4k_convert_addr(&cpu, virt, &phys, false, false);
+    }
+
+    bench_sink = sum;
+}
+
+static void step_hit(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++) {
+        r4k_step(&cpu);
+    }
+}
+
+static void step_redecode(uint64_t iterations)
+{
+    /* Writing to the code frame invalidates its decoded instructions */
+    for (uint64_t i = 0; i < iterations; i++) {
+        physmem_write32(0, CODE_PHYS + 8, INSTR_NOP, false);
+        r4k_step(&cpu);
+    }
+}
+
+void bench_r4k(void)
+{
+    r4k_init(&cpu, 0);
+    setup_tlb();
+
+    bench_run("r4k tlb_look (hit, same entry)", convert_addr_hit_same);
+    bench_run("r4k tlb_look (hit, all entries)", convert_addr_hit_all);
+    bench_run("r4k tlb_look (miss)", convert_addr_miss);
+
+    /* Branch to self with a delay slot */
+    physmem_write32(0, CODE_PHYS, INSTR_BRANCH_TO_SELF, false);
+    physmem_write32(0, CODE_PHYS + 4, INSTR_NOP, false);
+
+    ptr64_t pc = { .ptr = CODE_VIRT };
+    r4k_set_pc(&cpu, pc);
+
+    bench_run("r4k_step (fetch hit)", step_hit);
+    bench_run("r4k_step (fetch redecode)", step_redecode);
+
+    r4k_done(&cpu);
+}
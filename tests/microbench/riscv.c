@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2026 MSIM contributors
+ * All rights reserved.
+ *
+ * Distributed under the terms of GPL.
+ *
+ *
+ *  RISC-V processor benchmarks
+ *
+ */
+
+#include <stdio.h>
+
+#include "../../src/device/cpu/riscv_rv32ima/cpu.h"
+#include "../../src/device/cpu/riscv_rv32ima/instr.h"
+#include "../../src/device/cpu/riscv_rv32ima/tlb.h"
+#include "../../src/device/cpu/riscv_rv32ima/virt_mem.h"
+#include "../../src/physmem.h"
+#include "bench.h"
+
+/** Page tables (in the RAM of the physical memory benchmarks) */
+#define ROOT_TABLE UINT32_C(0x00001000)
+#define LEAF_TABLE UINT32_C(0x00002000)
+
+/** Mapped region */
+#define REGION_VIRT UINT32_C(0x40000000)
+#define REGION_PHYS UINT32_C(0x00080000)
+#define REGION_PAGES 128
+
+/** Valid, readable, writable, executable, accessed, dirty */
+#define PTE_FLAGS 0xcf
+
+/** Code of the stepping benchmarks */
+#define CODE_PHYS UINT32_C(0x00003000)
+#define INSTR_JUMP_TO_SELF UINT32_C(0x0000006f)
+#define INSTR_NOP UINT32_C(0x00000013)
+
+static rv_cpu_t cpu;
+static rv_tlb_t tlb;
+static size_t tlb_entries;
+
+static void setup_page_tables(void)
+{
+    physmem_write32(0, ROOT_TABLE + (REGION_VIRT >> 22) * 4,
+            ((LEAF_TABLE >> 12) << 10) | 1, false);
+
+    for (unsigned int i = 0; i < REGION_PAGES; i++) {
+        uint32_t ppn = (REGION_PHYS >> 12) + i;
+        physmem_write32(0, LEAF_TABLE + i * 4, (ppn << 10) | PTE_FLAGS, false);
+    }
+
+    cpu.csr.satp = rv_csr_satp_mode_mask | (ROOT_TABLE >> 12);
+    cpu.priv_mode = rv_smode;
+}
+
+static void convert_addr_hit(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        ptr36_t phys;
+        rv_convert_addr(&cpu, REGION_VIRT, &phys, false, false, true);
+        sum += phys;
+    }
+
+    bench_sink = sum;
+}
+
+static void convert_addr_miss(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    /* The region spans more pages than the TLB holds */
+    for (uint64_t i = 0; i < iterations; i++) {
+        ptr36_t phys;
+        uint32_t virt = REGION_VIRT + (i % REGION_PAGES) * FRAME_SIZE;
+        rv_convert_addr(&cpu, virt, &phys, false, false, true);
+        sum += phys;
+    }
+
+    bench_sink = sum;
+}
+
+static void tlb_get_mapping_hit(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        sv32_pte_t pte;
+        bool megapage;
+        uint32_t virt = (i % tlb_entries) * FRAME_SIZE;
+        rv_tlb_get_mapping(&tlb, 1, virt, &pte, &megapage, true);
+        sum += pte.ppn;
+    }
+
+    bench_sink = sum;
+}
+
+static void tlb_get_mapping_miss(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        sv32_pte_t pte;
+        bool megapage;
+        sum += rv_tlb_get_mapping(&tlb, 1, REGION_VIRT, &pte, &megapage, true);
+    }
+
+    bench_sink = sum;
+}
+
+/** Mix of instructions for the decoder */
+static const uint32_t decode_mix[] = {
+    0x00b50533, /* add a0, a0, a1 */
+    0x00150513, /* addi a0, a0, 1 */
+    0x0005a503, /* lw a0, 0(a1) */
+    0x00a5a023, /* sw a0, 0(a1) */
+    0x00b50463, /* beq a0, a1, 8 */
+    0x008000ef, /* jal ra, 8 */
+    0x123452b7, /* lui t0, 0x12345 */
+    0x00000297, /* auipc t0, 0 */
+    0x02b50533, /* mul a0, a0, a1 */
+    0x02b54533, /* div a0, a0, a1 */
+    0x00b5252f, /* amoadd.w a0, a1, (a0) */
+    0x1005a52f, /* lr.w a0, (a1) */
+    0x34051073, /* csrw mscratch, a0 */
+    0x00000073, /* ecall */
+    0x00351513, /* slli a0, a0, 3 */
+    0x00b53533 /* sltu a0, a0, a1 */
+};
+
+#define DECODE_MIX_COUNT (sizeof(decode_mix) / sizeof(decode_mix[0]))
+
+static void instr_decode(uint64_t iterations)
+{
+    uint64_t sum = 0;
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        rv_instr_t instr = { .val = decode_mix[i % DECODE_MIX_COUNT] };
+        sum += (uintptr_t) rv_instr_decode(instr);
+    }
+
+    bench_sink = sum;
+}
+
+static void step_hit(uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; i++) {
+        rv_cpu_step(&cpu);
+    }
+}
+
+static void step_redecode(uint64_t iterations)
+{
+    /* Writing to the code frame invalidates its decoded instructions */
+    for (uint64_t i = 0; i < iterations; i++) {
+        physmem_write32(0, CODE_PHYS + 4, INSTR_NOP, false);
+        rv_cpu_step(&cpu);
+    }
+}
+
+void bench_riscv(void)
+{
+    rv_cpu_init(&cpu, 0);
+    setup_page_tables();
+
+    bench_run("rv_convert_addr (TLB hit)", convert_addr_hit);
+    bench_run("rv_convert_addr (TLB miss)", convert_addr_miss);
+
+    static const size_t sizes[] = { 16, 48, 256, 1024 };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        tlb_entries = sizes[s];
+        rv_tlb_init(&tlb, tlb_entries);
+
+        for (size_t i = 0; i < tlb_entries; i++) {
+            sv32_pte_t pte = { 0 };
+            pte.ppn = i;
+            rv_tlb_add_mapping(&tlb, 1, i * FRAME_SIZE, pte, false, false);
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "rv_tlb_get_mapping (hit, %zu entries)", tlb_entries);
+        bench_run(name, tlb_get_mapping_hit);
+        snprintf(name, sizeof(name), "rv_tlb_get_mapping (miss, %zu entries)", tlb_entries);
+        bench_run(name, tlb_get_mapping_miss);
+
+        rv_tlb_done(&tlb);
+    }
+
+    bench_run("rv_instr_decode", instr_decode);
+
+    /* Jump to self in the machine mode */
+    physmem_write32(0, CODE_PHYS, INSTR_JUMP_TO_SELF, false);
+    cpu.priv_mode = rv_mmode;
+    rv_cpu_set_pc(&cpu, CODE_PHYS);
+
+    bench_run("rv_cpu_step (fetch hit)", step_hit);
+    bench_run("rv_cpu_step (fetch redecode)", step_redecode);
+
+    rv_cpu_done(&cpu);
+}
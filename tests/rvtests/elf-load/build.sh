@@ -0,0 +1,4 @@
+#!/bin/bash
+riscv64-unknown-elf-gcc -march=rv32ima -mabi=ilp32 -msmall-data-limit=0 -mstrict-align -fno-pic -fno-builtin -ffreestanding -nostdlib -nostdinc -c -o main.o main.S
+riscv64-unknown-elf-ld -m elf32lriscv -T main.lds -o main.elf main.o
+riscv64-unknown-elf-objdump -d -C -S main.elf > main.dis
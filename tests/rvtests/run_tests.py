@@ -28,7 +28,12 @@ TESTS = [
     "external-SEIP",
     "m-mode-STIP",
     "mprv-fetch",
-    "tlb"
+    "tlb",
+    "rv64",
+    "elf-load",
+    "misaligned",
+    "fp",
+    "compressed"
 ]
 
 MSIM_PATH = "../../msim"
@@ -0,0 +1,4 @@
+#!/bin/bash
+riscv64-unknown-elf-gcc -march=rv64ima -mabi=lp64 -msmall-data-limit=0 -mstrict-align -fno-pic -fno-builtin -ffreestanding -nostdlib -nostdinc -c -o main.raw main.S
+riscv64-unknown-elf-objdump -d -C -S main.raw > main.dis
+riscv64-unknown-elf-objcopy -O binary main.raw main.bin
@@ -7,11 +7,17 @@
 #include "../../../src/device/cpu/riscv_rv32ima/instructions/control_transfer.h"
 #include "../../../src/device/cpu/riscv_rv32ima/instructions/mem_ops.h"
 #include "../../../src/device/cpu/riscv_rv32ima/instructions/system.h"
+#include "../../../src/device/cpu/riscv_rv32ima/mnemonics.h"
 
 PCUT_INIT
 
 PCUT_TEST_SUITE(instruction_decoding);
 
+PCUT_TEST_BEFORE
+{
+    rv_instr_decode_init();
+}
+
 /*******************
  * OP instructions *
  *******************/
@@ -597,4 +603,51 @@ PCUT_TEST(lui_decode)
     PCUT_ASSERT_EQUALS(rv_lui_instr, rv_instr_decode(instr));
 }
 
+/*****************************
+ * Instruction specification *
+ *****************************/
+
+static const struct {
+    rv_instr_id_t id;
+    uint32_t mask;
+    uint32_t match;
+} spec[] = {
+#define RV_INSTR(name, func, mask, match, machine_specific) \
+    { rv_instr_##name, mask, match },
+#include "../../../src/device/cpu/riscv_rv32ima/instr.def"
+#undef RV_INSTR
+};
+
+#define SPEC_COUNT (sizeof(spec) / sizeof(spec[0]))
+
+PCUT_TEST(spec_identify)
+{
+    for (size_t i = 0; i < SPEC_COUNT; i++) {
+        rv_instr_t instr = { .val = spec[i].match };
+        PCUT_ASSERT_INT_EQUALS(spec[i].id, rv_instr_identify(instr));
+
+        // the bits outside of the mask are operands
+        instr.val = spec[i].match | ~spec[i].mask;
+        PCUT_ASSERT_INT_EQUALS(spec[i].id, rv_instr_identify(instr));
+    }
+}
+
+PCUT_TEST(spec_disjoint)
+{
+    for (size_t i = 0; i < SPEC_COUNT; i++) {
+        for (size_t j = i + 1; j < SPEC_COUNT; j++) {
+            uint32_t common = spec[i].mask & spec[j].mask;
+            PCUT_ASSERT_FALSE((spec[i].match & common) == (spec[j].match & common));
+        }
+    }
+}
+
+PCUT_TEST(spec_mnemonics)
+{
+    for (size_t i = 0; i < SPEC_COUNT; i++) {
+        rv_instr_t instr = { .val = spec[i].match };
+        PCUT_ASSERT_FALSE(rv_decode_mnemonics(instr) == undefined_mnemonics);
+    }
+}
+
 PCUT_EXPORT(instruction_decoding);
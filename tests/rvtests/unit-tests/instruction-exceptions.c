@@ -6,6 +6,7 @@
 #include "../../../src/device/cpu/riscv_rv32ima/instr.h"
 #include "../../../src/device/cpu/riscv_rv32ima/instructions/computations.h"
 #include "../../../src/device/cpu/riscv_rv32ima/instructions/control_transfer.h"
+#include "../../../src/device/cpu/riscv_rv32ima/instructions/fp_ops.h"
 #include "../../../src/device/cpu/riscv_rv32ima/instructions/mem_ops.h"
 #include "../../../src/device/cpu/riscv_rv32ima/instructions/system.h"
 
@@ -33,31 +34,36 @@ PCUT_TEST(add_no_ex)
     PCUT_ASSERT_INT_EQUALS(rv_exc_none, ex);
 }
 
-PCUT_TEST(jal_address_misaligned)
+/* With the C extension (IALIGN=16) halfword aligned targets are valid */
+
+PCUT_TEST(jal_address_halfword_aligned)
 {
     rv_instr_t instr = { .j = {
                                  .opcode = rv_opcJAL,
+                                 .rd = 1,
                                  .imm10_1 = 1 } };
+    cpu1.pc_next = cpu1.pc + 2;
 
     rv_exc_t ex = rv_jal_instr(&cpu1, instr);
 
-    PCUT_ASSERT_INT_EQUALS(rv_exc_instruction_address_misaligned, ex);
+    PCUT_ASSERT_INT_EQUALS(rv_exc_none, ex);
+    PCUT_ASSERT_INT_EQUALS(cpu1.pc + 2, cpu1.pc_next);
+    PCUT_ASSERT_INT_EQUALS(cpu1.pc + 2, cpu1.regs[1]);
 }
 
-PCUT_TEST(jalr_address_misaligned)
+PCUT_TEST(jalr_address_halfword_aligned)
 {
     rv_instr_t instr = { .i = {
                                  .opcode = rv_opcJALR,
-                                 .imm = 2 } };
+                                 .imm = 3 } };
 
     rv_exc_t ex = rv_jalr_instr(&cpu1, instr);
 
-    PCUT_ASSERT_INT_EQUALS(rv_exc_instruction_address_misaligned, ex);
+    PCUT_ASSERT_INT_EQUALS(rv_exc_none, ex);
+    PCUT_ASSERT_INT_EQUALS(2, cpu1.pc_next);
 }
 
-// These tests should be ran for all BRANCH instructions, but I think one should suffice
-
-PCUT_TEST(beq_address_misaligned_taken)
+PCUT_TEST(beq_address_halfword_aligned_taken)
 {
     rv_instr_t instr = { .b = {
                                  .opcode = rv_opcBRANCH,
@@ -69,7 +75,8 @@ PCUT_TEST(beq_address_misaligned_taken)
     cpu1.regs[1] = 0;
 
     rv_exc_t ex = rv_beq_instr(&cpu1, instr);
-    PCUT_ASSERT_INT_EQUALS(rv_exc_instruction_address_misaligned, ex);
+    PCUT_ASSERT_INT_EQUALS(rv_exc_none, ex);
+    PCUT_ASSERT_INT_EQUALS(cpu1.pc + 2, cpu1.pc_next);
 }
 
 PCUT_TEST(beq_address_misaligned_not_taken)
@@ -297,6 +304,52 @@ PCUT_TEST(amo_address_missaligned)
     PCUT_ASSERT_INT_EQUALS(rv_exc_store_amo_address_misaligned, ex);
 }
 
+PCUT_TEST(lw_misaligned_in_hardware)
+{
+    rv_instr_t instr = { .i = {
+                                 .opcode = rv_opcLOAD,
+                                 .funct3 = rv_func_LW,
+                                 .imm = 2 } };
+
+    cpu1.misaligned_access = true;
+
+    rv_exc_t ex = rv_lw_instr(&cpu1, instr);
+
+    PCUT_ASSERT_INT_EQUALS(rv_exc_none, ex);
+    PCUT_ASSERT_INT_EQUALS(1, cpu1.misaligned_count);
+}
+
+PCUT_TEST(sh_misaligned_in_hardware)
+{
+    rv_instr_t instr = { .s = {
+                                 .opcode = rv_opcSTORE,
+                                 .funct3 = rv_func_SH,
+                                 .imm4_0 = 1 } };
+
+    cpu1.misaligned_access = true;
+
+    rv_exc_t ex = rv_sh_instr(&cpu1, instr);
+
+    PCUT_ASSERT_INT_EQUALS(rv_exc_none, ex);
+    PCUT_ASSERT_INT_EQUALS(1, cpu1.misaligned_count);
+}
+
+PCUT_TEST(amo_misaligned_in_hardware)
+{
+    rv_instr_t instr = { .r = {
+                                 .opcode = rv_opcAMO,
+                                 .funct7 = rv_funcAMOSWAP << 2,
+                                 .funct3 = RV_AMO_32_WLEN,
+                                 .rs1 = 0,
+                         } };
+
+    cpu1.regs[0] = 2;
+    cpu1.misaligned_access = true;
+
+    rv_exc_t ex = rv_amoswap_instr(&cpu1, instr);
+    PCUT_ASSERT_INT_EQUALS(rv_exc_store_amo_address_misaligned, ex);
+}
+
 PCUT_TEST(csrrw_non_existent_csr)
 {
     rv_instr_t instr = { .i = {
@@ -602,4 +655,76 @@ PCUT_TEST(csrrc_WPRI_field_ignores_writes)
     PCUT_ASSERT_INT_EQUALS(expected_mstatus, cpu1.csr.mstatus);
 }
 
+PCUT_TEST(fp_instr_illegal_fs_off)
+{
+    rv_instr_t instr = { .r = {
+                                 .opcode = rv_opcOP_FP,
+                                 .funct3 = rv_rmDYN,
+                                 .rd = 1,
+                                 .rs1 = 2,
+                                 .rs2 = 3 } };
+
+    rv_exc_t ex = rv_fadd_s_instr(&cpu1, instr);
+
+    PCUT_ASSERT_INT_EQUALS(rv_exc_illegal_instruction, ex);
+    PCUT_ASSERT_INT_EQUALS(rv_fs_off, rv_csr_sstatus_fs(&cpu1));
+}
+
+PCUT_TEST(fcsr_illegal_fs_off)
+{
+    rv_instr_t instr = { .i = {
+                                 .opcode = rv_opcSYSTEM,
+                                 .funct3 = rv_funcCSRRS,
+                                 .imm = csr_fcsr,
+                                 .rs1 = 0,
+                                 .rd = 1 } };
+    cpu1.priv_mode = rv_mmode;
+
+    rv_exc_t ex = rv_csrrs_instr(&cpu1, instr);
+
+    PCUT_ASSERT_INT_EQUALS(rv_exc_illegal_instruction, ex);
+}
+
+PCUT_TEST(fp_instr_reserved_rounding_mode)
+{
+    rv_instr_t instr = { .r = {
+                                 .opcode = rv_opcOP_FP,
+                                 .funct3 = 5,
+                                 .rd = 1,
+                                 .rs1 = 2,
+                                 .rs2 = 3 } };
+    cpu1.csr.mstatus |= (uint64_t) rv_fs_initial << rv_csr_sstatus_fs_pos;
+
+    rv_exc_t ex = rv_fadd_s_instr(&cpu1, instr);
+
+    PCUT_ASSERT_INT_EQUALS(rv_exc_illegal_instruction, ex);
+
+    // Reserved rounding mode in frm selected dynamically
+    instr.r.funct3 = rv_rmDYN;
+    cpu1.csr.fcsr = 5 << rv_csr_fcsr_frm_pos;
+
+    ex = rv_fadd_s_instr(&cpu1, instr);
+
+    PCUT_ASSERT_INT_EQUALS(rv_exc_illegal_instruction, ex);
+}
+
+PCUT_TEST(fp_instr_sets_fs_dirty)
+{
+    rv_instr_t instr = { .r = {
+                                 .opcode = rv_opcOP_FP,
+                                 .funct3 = rv_rmRNE,
+                                 .rd = 1,
+                                 .rs1 = 2,
+                                 .rs2 = 3 } };
+    cpu1.csr.mstatus |= (uint64_t) rv_fs_clean << rv_csr_sstatus_fs_pos;
+
+    rv_exc_t ex = rv_fadd_s_instr(&cpu1, instr);
+
+    PCUT_ASSERT_INT_EQUALS(rv_exc_none, ex);
+    PCUT_ASSERT_INT_EQUALS(rv_fs_dirty, rv_csr_sstatus_fs(&cpu1));
+
+    // The registers are zero (not NaN-boxed), so the result is the canonical NaN
+    PCUT_ASSERT_INT_EQUALS(0x7fc00000, (uint32_t) cpu1.fregs[1]);
+}
+
 PCUT_EXPORT(instruction_exceptions);
@@ -0,0 +1,305 @@
+#include <stdint.h>
+#include <pcut/pcut.h>
+
+#include "../../../src/device/cpu/riscv_rv32ima/cpu.h"
+#include "../../../src/device/cpu/riscv_rv32ima/instr.h"
+#include "../../../src/device/cpu/riscv_rv32ima/instructions/computations.h"
+#include "../../../src/device/cpu/riscv_rv32ima/instructions/control_transfer.h"
+
+PCUT_INIT
+
+PCUT_TEST_SUITE(instruction_expansion);
+
+PCUT_TEST_BEFORE
+{
+    rv_instr_decode_init();
+}
+
+/*
+ * The expected values are the encodings of the equivalent base ISA
+ * instructions (as produced by the assembler).
+ */
+
+// c.addi4spn x8, x2, 1020
+PCUT_TEST(c_addi4spn_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x3fc10413, rv_instr_expand(0x1fe0).val);
+}
+
+// c.fld f9, 248(x10)
+PCUT_TEST(c_fld_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x0f853487, rv_instr_expand(0x3d64).val);
+}
+
+// c.lw x15, 124(x8)
+PCUT_TEST(c_lw_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x07c42783, rv_instr_expand(0x5c7c).val);
+}
+
+// c.flw f8, 64(x9)
+PCUT_TEST(c_flw_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x0404a407, rv_instr_expand(0x60a0).val);
+}
+
+// c.fsd f9, 8(x10)
+PCUT_TEST(c_fsd_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00953427, rv_instr_expand(0xa504).val);
+}
+
+// c.sw x9, 4(x15)
+PCUT_TEST(c_sw_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x0097a223, rv_instr_expand(0xc3c4).val);
+}
+
+// c.fsw f10, 120(x11)
+PCUT_TEST(c_fsw_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x06a5ac27, rv_instr_expand(0xfda8).val);
+}
+
+// c.nop
+PCUT_TEST(c_nop_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00000013, rv_instr_expand(0x0001).val);
+}
+
+// c.addi x5, -32
+PCUT_TEST(c_addi_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0xfe028293, rv_instr_expand(0x1281).val);
+}
+
+// c.jal -2048
+PCUT_TEST(c_jal_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x801ff0ef, rv_instr_expand(0x3001).val);
+}
+
+// c.li x6, 31
+PCUT_TEST(c_li_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x01f00313, rv_instr_expand(0x437d).val);
+}
+
+// c.addi16sp x2, -512
+PCUT_TEST(c_addi16sp_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0xe0010113, rv_instr_expand(0x7101).val);
+}
+
+// c.lui x7, 0xfffe1
+PCUT_TEST(c_lui_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0xfffe13b7, rv_instr_expand(0x7385).val);
+}
+
+// c.srli x8, 31
+PCUT_TEST(c_srli_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x01f45413, rv_instr_expand(0x807d).val);
+}
+
+// c.srai x9, 1
+PCUT_TEST(c_srai_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x4014d493, rv_instr_expand(0x8485).val);
+}
+
+// c.andi x10, -1
+PCUT_TEST(c_andi_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0xfff57513, rv_instr_expand(0x997d).val);
+}
+
+// c.sub x8, x9
+PCUT_TEST(c_sub_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x40940433, rv_instr_expand(0x8c05).val);
+}
+
+// c.xor x10, x11
+PCUT_TEST(c_xor_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00b54533, rv_instr_expand(0x8d2d).val);
+}
+
+// c.or x12, x13
+PCUT_TEST(c_or_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00d66633, rv_instr_expand(0x8e55).val);
+}
+
+// c.and x14, x15
+PCUT_TEST(c_and_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00f77733, rv_instr_expand(0x8f7d).val);
+}
+
+// c.j 2046
+PCUT_TEST(c_j_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x7fe0006f, rv_instr_expand(0xaffd).val);
+}
+
+// c.beqz x8, -256
+PCUT_TEST(c_beqz_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0xf00400e3, rv_instr_expand(0xd001).val);
+}
+
+// c.bnez x9, 254
+PCUT_TEST(c_bnez_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x0e049f63, rv_instr_expand(0xecfd).val);
+}
+
+// c.slli x5, 17
+PCUT_TEST(c_slli_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x01129293, rv_instr_expand(0x02c6).val);
+}
+
+// c.fldsp f3, 504(x2)
+PCUT_TEST(c_fldsp_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x1f813187, rv_instr_expand(0x31fe).val);
+}
+
+// c.lwsp x4, 252(x2)
+PCUT_TEST(c_lwsp_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x0fc12203, rv_instr_expand(0x527e).val);
+}
+
+// c.flwsp f5, 4(x2)
+PCUT_TEST(c_flwsp_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00412287, rv_instr_expand(0x6292).val);
+}
+
+// c.jr x1
+PCUT_TEST(c_jr_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00008067, rv_instr_expand(0x8082).val);
+}
+
+// c.mv x6, x7
+PCUT_TEST(c_mv_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00700333, rv_instr_expand(0x831e).val);
+}
+
+// c.ebreak
+PCUT_TEST(c_ebreak_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00100073, rv_instr_expand(0x9002).val);
+}
+
+// c.jalr x8
+PCUT_TEST(c_jalr_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x000400e7, rv_instr_expand(0x9402).val);
+}
+
+// c.add x9, x10
+PCUT_TEST(c_add_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00a484b3, rv_instr_expand(0x94aa).val);
+}
+
+// c.fsdsp f6, 504(x2)
+PCUT_TEST(c_fsdsp_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x1e613c27, rv_instr_expand(0xbf9a).val);
+}
+
+// c.swsp x11, 252(x2)
+PCUT_TEST(c_swsp_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x0eb12e23, rv_instr_expand(0xdfae).val);
+}
+
+// c.fswsp f7, 0(x2)
+PCUT_TEST(c_fswsp_expand)
+{
+    PCUT_ASSERT_INT_EQUALS(0x00712027, rv_instr_expand(0xe01e).val);
+}
+
+/**********************
+ * Reserved encodings *
+ **********************/
+
+PCUT_TEST(illegal_all_zeros)
+{
+    PCUT_ASSERT_EQUALS(rv_illegal_instr, rv_instr_decode(rv_instr_expand(0x0000)));
+}
+
+PCUT_TEST(c_addi4spn_zero_immediate_reserved)
+{
+    // c.addi4spn x9, x2, 0
+    PCUT_ASSERT_EQUALS(rv_illegal_instr, rv_instr_decode(rv_instr_expand(0x0004)));
+}
+
+PCUT_TEST(c_addi16sp_zero_immediate_reserved)
+{
+    PCUT_ASSERT_EQUALS(rv_illegal_instr, rv_instr_decode(rv_instr_expand(0x6101)));
+}
+
+PCUT_TEST(c_lui_zero_immediate_reserved)
+{
+    PCUT_ASSERT_EQUALS(rv_illegal_instr, rv_instr_decode(rv_instr_expand(0x6381)));
+}
+
+PCUT_TEST(c_lwsp_x0_reserved)
+{
+    PCUT_ASSERT_EQUALS(rv_illegal_instr, rv_instr_decode(rv_instr_expand(0x4002)));
+}
+
+PCUT_TEST(c_jr_x0_reserved)
+{
+    PCUT_ASSERT_EQUALS(rv_illegal_instr, rv_instr_decode(rv_instr_expand(0x8002)));
+}
+
+PCUT_TEST(c_slli_rv64_shift_reserved)
+{
+    // c.slli x5, 32
+    PCUT_ASSERT_EQUALS(rv_illegal_instr, rv_instr_decode(rv_instr_expand(0x1282)));
+}
+
+PCUT_TEST(c_subw_rv64_only)
+{
+    // c.subw x8, x9
+    PCUT_ASSERT_EQUALS(rv_illegal_instr, rv_instr_decode(rv_instr_expand(0x9c05)));
+}
+
+PCUT_TEST(quadrant0_reserved)
+{
+    PCUT_ASSERT_EQUALS(rv_illegal_instr, rv_instr_decode(rv_instr_expand(0x8000)));
+}
+
+/************
+ * Decoding *
+ ************/
+
+PCUT_TEST(c_add_decode)
+{
+    PCUT_ASSERT_EQUALS(rv_add_instr, rv_instr_decode(rv_instr_expand(0x94aa)));
+}
+
+PCUT_TEST(c_jalr_decode)
+{
+    PCUT_ASSERT_EQUALS(rv_jalr_instr, rv_instr_decode(rv_instr_expand(0x9402)));
+}
+
+PCUT_TEST(instr_length)
+{
+    PCUT_ASSERT_INT_EQUALS(2, RV_INSTR_LENGTH(0x94aa));
+    PCUT_ASSERT_INT_EQUALS(4, RV_INSTR_LENGTH(0x00a484b3));
+}
+
+PCUT_EXPORT(instruction_expansion);
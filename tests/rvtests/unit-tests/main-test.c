@@ -28,13 +28,17 @@ bool machine_newline = false;
 bool machine_undefined = false;
 bool machine_specific_instructions = true;
 bool machine_allow_interactive_without_tty = false;
+bool machine_fast = false;
+bool machine_profile = false;
 uint64_t stepping = 0;
+uint64_t machine_steps = 0;
 
 PCUT_INIT
 
 PCUT_IMPORT(instruction_immediates);
 PCUT_IMPORT(instruction_decoding);
 PCUT_IMPORT(instruction_exceptions);
+PCUT_IMPORT(instruction_expansion);
 PCUT_IMPORT(tlb);
 PCUT_IMPORT(asid_len);
 
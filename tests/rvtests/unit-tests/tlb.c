@@ -389,4 +389,28 @@ PCUT_TEST(flush_by_asid_and_addr_ignores_global)
     PCUT_ASSERT_EQUALS(true, success);
 }
 
+PCUT_TEST(drop_every_entry)
+{
+    uint32_t virt = 0x0;
+    ptr36_t phys = 0x0;
+    unsigned asid = 1;
+
+    sv32_pte_t added_pte = { 0 };
+    added_pte.ppn = phys >> 12;
+
+    rv_tlb_add_mapping(&tlb, asid, virt, added_pte, false, false);
+
+    // Dropping invalid entries (and wrapping around) does no harm
+    for (size_t i = 0; i <= DEFAULT_RV_TLB_SIZE; i++) {
+        rv_tlb_drop(&tlb, i);
+    }
+
+    sv32_pte_t pte;
+    bool megapage;
+
+    bool success = rv_tlb_get_mapping(&tlb, asid, virt, &pte, &megapage, true);
+
+    PCUT_ASSERT_EQUALS(false, success);
+}
+
 PCUT_EXPORT(tlb);
@@ -97,3 +97,282 @@ load "common"
     exit_success=false \
     msim_command_check
 }
+
+@test "Conditional memory breakpoint" {
+    config="
+        break 0x1000 4 rw count \"r8 >= 2 && mem32[0x100] & 0x10\"
+        break 0x2000 8 w
+        dumpbreak
+    " \
+    expected="
+        [address         ] [mode] [hits              ] [matches           ]
+        0x0000000000001000 rw                        0                    0 count if r8 >= 0x2 && mem32[0x100] & 0x10
+        0x0000000000002000 -w                        0                    0 stop
+    " \
+    msim_command_check
+}
+
+@test "Invalid breakpoint condition terminates with error" {
+    config="
+        break 0x1000 4 r log \"pc = 4\"
+    " \
+    expected="
+        <msim> Error in msim.conf on line 1:
+        Comparison operator expected
+        <msim> Fault in msim.conf on line 1:
+        Error in configuration file
+    " \
+    exit_success=false \
+    msim_command_check
+}
+
+@test "Host memory usage in JSON" {
+    cat >"$MSIM_TEST_TMPDIR/msim.conf" <<EOF_CONF
+add rwm mainmem 0
+mainmem generic 16K
+add dr4kcpu cpu0
+break 0x1000 4 rw
+memusage json "memusage.json"
+quit
+EOF_CONF
+
+    run bash -c "cd '$MSIM_TEST_TMPDIR' && '$MSIM'"
+    test "$status" -eq 0
+
+    python3 - "$MSIM_TEST_TMPDIR/memusage.json" <<EOF_CHECK || fail "Unexpected memory usage."
+import json, sys
+usage = json.load(open(sys.argv[1]))
+components = usage["components"]
+assert components["guest_ram"]["size"] == 16384
+assert usage["devices"]["mainmem"]["size"] == 16384
+assert usage["devices"]["cpu0"]["size"] > 0
+assert components["breakpoints"]["size"] > 0
+assert components["device_images"]["size"] == 0
+assert usage["total"]["size"] == sum(c["size"] for c in components.values())
+EOF_CHECK
+}
+
+@test "Link device synchronizes only when attached" {
+    config="
+        add dlink link 0x1000 3
+        link info
+        link sync 4096
+    " \
+    expected="
+        [address  ] [int] [side] [quantum           ] [status] [file]
+        0x000001000 3     -      -                    -        (not attached)
+        <msim> Error in msim.conf on line 3:
+        Link not attached
+        <msim> Fault in msim.conf on line 3:
+        Error in configuration file
+    " \
+    exit_success=false \
+    msim_command_check
+}
+
+@test "Link device transfers packets without sync only with -n" {
+    for mode in det nondet; do
+        if [ "$mode" = "det" ]; then
+            flags=""
+        else
+            flags="-n"
+        fi
+
+        sed -e "s#\"boot.bin\"#\"$( dirname "$BATS_TEST_FILENAME" )/mips32-dlink/boot.bin\"#" \
+            -e "s#\"link.shm\"#\"$mode.shm\"#" \
+            -e '/sync/d' \
+            "$( dirname "$BATS_TEST_FILENAME" )/mips32-dlink/msim-0.conf" >"$MSIM_TEST_TMPDIR/msim.conf"
+        echo "step 8192" >>"$MSIM_TEST_TMPDIR/msim.conf"
+
+        run bash -c "cd '$MSIM_TEST_TMPDIR' && printf 'link stat\nquit\n' | '$MSIM' $flags"
+        test "$status" -eq 0
+        echo "$output" >"$MSIM_TEST_TMPDIR/$mode.output"
+    done
+
+    cd "$MSIM_TEST_TMPDIR"
+    test "$( grep -c "Link link: not synchronized" det.output )" -eq 1
+    test "$( grep -c "not synchronized" nondet.output )" -eq 0
+
+    # Sent packets and failed commands
+    test "$( grep -A1 '^\[interrupts' det.output | tail -1 | awk '{ print $2, $4 }' )" = "0 1"
+    test "$( grep -A1 '^\[interrupts' nondet.output | tail -1 | awk '{ print $2, $4 }' )" = "1 0"
+}
+
+@test "Time device uses simulated time without -n" {
+    config="
+        add dtime time 0x1000
+        time freq 1000
+        time info
+        time mode host
+    " \
+    expected="
+        [address ] [mode] [frequency ] [epoch     ]
+             0x1000 sim    1000         0
+        <msim> Error in msim.conf on line 4:
+        Host time is non-deterministic, use the -n option
+        <msim> Fault in msim.conf on line 4:
+        Error in configuration file
+    " \
+    exit_success=false \
+    msim_command_check
+}
+
+@test "Fault injection log replays the injected faults" {
+    cat >"$MSIM_TEST_TMPDIR/random.sched" <<EOF_SCHED
+seed 42
+prob 0.05 0 memflip 0x800 0x800 1
+every 40 0 tlbdrop 0
+at 50 irq 0 3
+EOF_SCHED
+
+    for run in first second; do
+        if [ "$run" = "first" ]; then
+            schedule="random.sched"
+        else
+            schedule="first.log"
+        fi
+
+        cat >"$MSIM_TEST_TMPDIR/msim.conf" <<EOF_CONF
+add dr4kcpu cpu0
+add rwm mainmem 0
+mainmem generic 4K
+add rom boot 0x1FC00000
+boot generic 4K
+boot load "$( dirname "$BATS_TEST_FILENAME" )/mips32-inject/boot.bin"
+add dprinter printer 0x10000000
+printer redir "$run.output"
+inject "$schedule" "$run.log"
+EOF_CONF
+
+        run bash -c "cd '$MSIM_TEST_TMPDIR' && '$MSIM' </dev/null"
+        test "$status" -eq 0
+    done
+
+    cd "$MSIM_TEST_TMPDIR"
+    test "$( grep -c '^at ' first.log )" -gt 3
+    diff first.log second.log || fail "Replayed injections differ."
+    diff first.output second.output || fail "Guest output differs."
+}
+
+@test "Fault injection rejects interrupts the processor does not have" {
+    cat >"$MSIM_TEST_TMPDIR/irq.sched" <<EOF_SCHED
+at 10 irq 0 9
+at 10 sysxor 0 13 0x100
+at 20 irq 0 0
+at 20 irq 0 1
+EOF_SCHED
+
+    cat >"$MSIM_TEST_TMPDIR/msim.conf" <<EOF_CONF
+add dr4kcpu cpu0
+add rwm mainmem 0
+mainmem generic 4K
+add rom boot 0x1FC00000
+boot generic 4K
+boot load "$( dirname "$BATS_TEST_FILENAME" )/mips32-inject/boot.bin"
+add dprinter printer 0x10000000
+printer redir "printer.output"
+inject "irq.sched"
+EOF_CONF
+
+    run bash -c "cd '$MSIM_TEST_TMPDIR' && printf 'step 30\\ncpu0 cp0d 13\\nquit\\n' | '$MSIM' -i"
+    {
+        echo
+        echo "# MSIM output (stdout and stderr interleaved)"
+        echo "$output" | sed 's:.*:#  | &:'
+    } >&2
+
+    test "$status" -eq 0
+    echo "$output" | grep -q '^<msim> Alert: Inject: Target of the fault on line 1 does not exist (at 10 irq 0 9)$'
+    echo "$output" | grep -q '^<msim> Alert: Inject: at 20 irq 0 1$'
+
+    # IP0 set before the spurious interrupt stays asserted, IP1 is lowered
+    echo "$output" | grep -q '^  0d Cause.00000100 '
+}
+
+@test "Compiled machine runs without its memory images" {
+    cp "$( dirname "$BATS_TEST_FILENAME" )/mips32-hello/boot.bin" "$MSIM_TEST_TMPDIR/boot.bin"
+
+    cat >"$MSIM_TEST_TMPDIR/msim.conf" <<EOF_CONF
+add dr4kcpu cpu0
+add rwm mainmem 0
+mainmem generic 1M
+add rom boot 0x1FC00000
+boot generic 4K
+boot load "boot.bin"
+add dprinter printer 0x10000000
+printer redir "output"
+EOF_CONF
+
+    run bash -c "cd '$MSIM_TEST_TMPDIR' && '$MSIM' -C machine.bin </dev/null"
+    test "$status" -eq 0
+
+    cd "$MSIM_TEST_TMPDIR"
+    test ! -s output
+    rm boot.bin
+
+    run bash -c "cd '$MSIM_TEST_TMPDIR' && '$MSIM' -c machine.bin </dev/null"
+    test "$status" -eq 0
+    test "$( cat output )" = "Hello!"
+}
+
+@test "Replay log reproduces a run reading the host time" {
+    cat >"$MSIM_TEST_TMPDIR/msim.conf" <<EOF_CONF
+add dr4kcpu cpu0
+add rom boot 0x1FC00000
+boot generic 4K
+boot load "$( dirname "$BATS_TEST_FILENAME" )/mips32-dtime/boot.bin"
+add dprinter printer 0x10000000
+add dtime time 0x10001000
+time mode host
+EOF_CONF
+
+    cd "$MSIM_TEST_TMPDIR"
+
+    run bash -c "'$MSIM' -n -R run.log </dev/null >record.output 2>&1"
+    test "$status" -eq 0
+    test "$( grep -c ' time ' run.log )" -gt 1
+
+    run bash -c "'$MSIM' -P run.log </dev/null >replay.output 2>&1"
+    test "$status" -eq 0
+
+    grep -q '^Cycles: ' record.output || fail "No cycle count in the output."
+    diff record.output replay.output || fail "Replayed run differs."
+
+    run "$MSIM" -P run.log -g 10000
+    test "$status" -ne 0
+    test "$output" = "<msim> Fault: Remote GDB cannot be combined with record or replay"
+}
+
+@test "State hash logs show where two runs diverge" {
+    echo "at 500 regxor 0 16 0x100" >"$MSIM_TEST_TMPDIR/change.sched"
+
+    for run in first second changed; do
+        cat >"$MSIM_TEST_TMPDIR/msim.conf" <<EOF_CONF
+add dr4kcpu cpu0
+add rom boot 0x1FC00000
+boot generic 4K
+boot load "$( dirname "$BATS_TEST_FILENAME" )/mips32-dtime/boot.bin"
+add dprinter printer 0x10000000
+add dtime time 0x10001000
+time freq 1000
+statehash 100 "$run.log"
+EOF_CONF
+        if [ "$run" = "changed" ]; then
+            echo 'inject "change.sched" "change.log"' >>"$MSIM_TEST_TMPDIR/msim.conf"
+        fi
+
+        run bash -c "cd '$MSIM_TEST_TMPDIR' && '$MSIM' </dev/null"
+        test "$status" -eq 0
+    done
+
+    config="
+        statecmp \"first.log\" \"second.log\"
+        statecmp \"first.log\" \"changed.log\"
+    " \
+    expected="
+        No divergence in 10 intervals
+        First divergence between cycles 500 and 600
+        cpu0: register 16 0 vs. 0x100
+    " \
+    msim_command_check
+}
@@ -82,7 +82,8 @@ msim_run_code() {
 
     echo "quit" >>"$MSIM_TEST_TMPDIR/msim.conf"
     (
-        sed "s#\"boot.bin\"#\"$test_dir/boot.bin\"#" <"$test_dir/msim.conf"
+        sed -e "s#\"boot.bin\"#\"$test_dir/boot.bin\"#" \
+            -e "s#\"faults.sched\"#\"$test_dir/faults.sched\"#" <"$test_dir/msim.conf"
         echo "printer redir \"$MSIM_TEST_TMPDIR/printer.output\""
     ) >"$MSIM_TEST_TMPDIR/msim.conf"
 
@@ -129,3 +130,73 @@ msim_run_code() {
         } | fail
     fi
 }
+
+msim_run_link_pair() {
+    local test_dir="$( dirname "$BATS_TEST_FILENAME" )/$1"
+    local expected_from_simulator="$( cat "$test_dir/host.expected" )"
+    local side
+
+    for side in 0 1; do
+        (
+            sed "s#\"boot.bin\"#\"$test_dir/boot.bin\"#" <"$test_dir/msim-$side.conf"
+            echo "printer redir \"$MSIM_TEST_TMPDIR/printer-$side.output\""
+        ) >"$MSIM_TEST_TMPDIR/msim-$side.conf"
+
+        {
+            echo
+            echo "# MSIM configuration msim-$side.conf"
+            sed 's:.*:#  | &:' "$MSIM_TEST_TMPDIR/msim-$side.conf"
+        } >&2
+    done
+
+    # Both instances have to run at the same time
+    ( cd "$MSIM_TEST_TMPDIR" && "$MSIM" -c msim-0.conf </dev/null >host-0.output 2>&1 ) &
+    local peer_pid=$!
+    run bash -c "cd '$MSIM_TEST_TMPDIR' && '$MSIM' -c msim-1.conf </dev/null"
+    local peer_status=0
+    wait "$peer_pid" || peer_status=$?
+
+    {
+        echo
+        echo "# MSIM output of side 0 (stdout and stderr interleaved)"
+        sed 's:.*:#  | &:' "$MSIM_TEST_TMPDIR/host-0.output"
+        echo "# MSIM output of side 1 (stdout and stderr interleaved)"
+        echo "$output" | sed 's:.*:#  | &:'
+    } >&2
+
+    if [ "$status" -ne 0 ] || [ "$peer_status" -ne 0 ]; then
+        fail "MSIM failed with exit codes $peer_status and $status."
+    fi
+
+    local peer_output="$( sed 's#^\[msim\] $#[msim]#' "$MSIM_TEST_TMPDIR/host-0.output" )"
+    output="$( echo "$output" | sed 's#^\[msim\] $#[msim]#' )"
+
+    for output in "$peer_output" "$output"; do
+        if [ "$output" != "$expected_from_simulator" ]; then
+            {
+                echo "Failure: unexpected simulator output."
+                echo "-- Expected --"
+                echo "$expected_from_simulator"
+                echo "-- Actual --"
+                echo "$output"
+                echo "--"
+            } | fail
+        fi
+    done
+
+    for side in 0 1; do
+        local expected_from_guest="$( cat "$test_dir/guest-$side.expected" )"
+        local guest_output="$( cat "$MSIM_TEST_TMPDIR/printer-$side.output" )"
+
+        if [ "$guest_output" != "$expected_from_guest" ]; then
+            {
+                echo "Failure: unexpected guest output of side $side."
+                echo "-- Expected --"
+                echo "$expected_from_guest"
+                echo "-- Actual --"
+                echo "$guest_output"
+                echo "--"
+            } | fail
+        fi
+    done
+}
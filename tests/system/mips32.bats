@@ -29,3 +29,39 @@ load "common"
 @test "MIPS32: Register dumps" {
     msim_run_code "mips32-rd"
 }
+
+@test "MIPS32: Region of interest markers" {
+    msim_run_code "mips32-roi"
+}
+
+@test "MIPS32: Fast-forward until an address" {
+    msim_run_code "mips32-sample"
+}
+
+@test "MIPS32: Conditional code breakpoints" {
+    msim_run_code "mips32-cond-break"
+}
+
+@test "MIPS32: Floating-point unit" {
+    msim_run_code "mips32-fpu"
+}
+
+@test "MIPS32: Time derived from machine cycles" {
+    msim_run_code "mips32-dtime"
+}
+
+@test "MIPS32: Synchronized link between two instances" {
+    msim_run_link_pair "mips32-dlink"
+}
+
+@test "MIPS32: Performance counters" {
+    msim_run_code "mips32-perfcnt"
+}
+
+@test "MIPS32: Fault injection" {
+    msim_run_code "mips32-inject"
+}
+
+@test "MIPS32: Instruction cost model" {
+    msim_run_code "mips32-cost"
+}
@@ -0,0 +1,22 @@
+#!/usr/bin/env bats
+
+load "common"
+
+@test "RISC-V user mode: arguments, brk and exit status" {
+    local program="$( dirname "$BATS_TEST_FILENAME" )/riscv32-user-hello/hello"
+
+    run "$MSIM" --user "$program" first "second argument"
+    if [ "$status" -ne 2 ]; then
+        fail "Expected exit code 2, got $status."
+    fi
+
+    expected="$( printf 'first\nsecond argument\nbrk ok' )"
+    if [ "$output" != "$expected" ]; then
+        fail "Unexpected output: '$output'."
+    fi
+}
+
+@test "RISC-V user mode: program is required" {
+    run "$MSIM" --user
+    test "$status" -ne 0
+}
@@ -0,0 +1,56 @@
+#!/usr/bin/env bats
+
+load "common"
+
+msim_run_lockstep() {
+    local test_dir="$( dirname "$BATS_TEST_FILENAME" )/riscv32-${1:-lockstep}"
+
+    (
+        sed "s#\"boot.bin\"#\"$test_dir/boot.bin\"#" <"$test_dir/msim.conf"
+        echo "$extra_config"
+    ) >"$MSIM_TEST_TMPDIR/msim.conf"
+
+    run bash -c "cd '$MSIM_TEST_TMPDIR' && printf '$commands' | '$MSIM'"
+    {
+        echo
+        echo "# MSIM output (stdout and stderr interleaved)"
+        echo "$output" | sed 's:.*:#  | &:'
+    } >&2
+
+    test "$status" -eq 0
+}
+
+@test "RISC-V: Lock-step execution against the generic core" {
+    extra_config="" \
+    commands='cpu0 lockstep\ncontinue\n' \
+    msim_run_lockstep
+
+    echo "$output" | grep -q '^Engine: generic$'
+    echo "$output" | grep -q '^Checked: 1334 instructions, synchronized: 0, mismatches: 0$'
+    echo "$output" | grep -q '^000516BE$'
+    echo "$output" | grep -q '^Cycles: 1405$'
+}
+
+@test "RISC-V: Lock-step execution reports a divergence" {
+    echo "at 200 regxor 0 9 0x100" >"$MSIM_TEST_TMPDIR/change.sched"
+
+    extra_config='inject "change.sched" "change.log"' \
+    commands='cpu0 lockstep\nquit\n' \
+    msim_run_lockstep
+
+    echo "$output" | grep -q '^<msim> Alert: Lock-step: cpu0 diverged after 201 instructions$'
+    echo "$output" | grep -q '^s1: 0x0000010f (reference) vs. 0x0000000f (shadow)$'
+    echo "$output" | grep -q '^Checked: 201 instructions, synchronized: 0, mismatches: 1$'
+}
+
+@test "RISC-V: Lock-step shadow does not overwrite the stores of the reference" {
+    extra_config="" \
+    commands='cpu0 lockstep\ndumpmem 0x1000 1\ndumpmem 0x4000 1\nquit\n' \
+    msim_run_lockstep lockstep-store
+
+    echo "$output" | grep -q '^<msim> Alert: Lock-step: cpu0 diverged after 30 instructions$'
+    echo "$output" | grep -q '^store at 0x000004000: 0 (memory) vs. 0x2 (shadow, 4 bytes)$'
+    echo "$output" | grep -q '^Checked: 30 instructions, synchronized: 1, mismatches: 1$'
+    echo "$output" | grep -q '^  0x000001000   00000002 $'
+    echo "$output" | grep -q '^  0x000004000   00000000 $'
+}